@@ -0,0 +1,479 @@
+/**
+ * @file fee_bench.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Benchmark suite of the fee library codec entry points. Every benchmark is run after a warmup for a number of
+ *  repetitions, and the time per packet (median and percentiles) and throughput are reported in a table and,
+ *  optionally, in a JSON file that can be compared between releases.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fee.h>
+
+#define BENCH_DEFAULT_REPETITIONS 30
+#define BENCH_DEFAULT_WARMUP 3
+/*Minimum duration of a repetition. Fast functions are run several times per repetition*/
+#define BENCH_MIN_SAMPLE_NS 2000000.0
+#define BENCH_MAX_RESULTS 64
+#define BENCH_NAME_LENGTH 64
+
+/*PTD geometry of a benchmark*/
+typedef struct
+{
+    const char *Name;
+    uint16_t WOISIZE;
+    uint16_t NBTAIL;
+    spatialbinning_t SPATIALBINNINGMODE;
+    uint16_t BinningSize[5]; /*Without the offset*/
+    uint16_t BandSize[5];
+
+} BenchGeometry_t;
+
+static const BenchGeometry_t BenchGeometries[] = {
+    {"small", 16, 4, SPATALBIN_NOTENABLE, {1, 1, 1, 1, 1}, {32, 0, 0, 0, 0}},
+    /*Configuration of the CHANNEL_2 2022-03-14 captures*/
+    {"typical", 282, 0, SPATALBIN_NOTENABLE, {1, 1, 1, 1, 1}, {225, 0, 0, 0, 0}},
+    /*Largest frame allowed by the TC limits*/
+    {"maximum", TC_WOISIZE_MAX, TC_NBTAIL_MAX, SPATALBIN_NOTENABLE, {1, 1, 1, 1, 1},
+     {TC_FREQBINNINGBAND_1_BANDSIZE_MAX, TC_FREQBINNINGBAND_2_BANDSIZE_MAX, TC_FREQBINNINGBAND_3_BANDSIZE_MAX,
+      TC_FREQBINNINGBAND_4_BANDSIZE_MAX, TC_FREQBINNINGBAND_5_BANDSIZE_MAX}},
+};
+
+#define BENCH_NUM_GEOMETRIES (sizeof(BenchGeometries) / sizeof(BenchGeometries[0]))
+
+/*Data shared by the benchmarked functions*/
+typedef struct
+{
+    fee_TC_t TC;
+    fee_TM_t TM;
+    fee_TC_Packet_t TC_Packet;
+    fee_TM_Packet_t TM_Packet;
+    fee_PTD_t PTD;
+    uint8_t *PTD_Packet;
+    uint8_t *PTD_PacketGenerated;
+
+} BenchData_t;
+
+/*Benchmarked function. It returns FEE_EXIT_SUCCESS or FEE_EXIT_ERROR*/
+typedef int (*BenchFunction_t)(BenchData_t *Data);
+
+typedef struct
+{
+    char Name[BENCH_NAME_LENGTH];
+    const char *Geometry;
+    size_t PacketBytes;
+    size_t Iterations; /*Calls per repetition*/
+    size_t Repetitions;
+    double Min, Median, P90, P99, Max, Mean; /*Nanoseconds per packet*/
+    double GBps;                             /*Throughput of the median*/
+
+} BenchResult_t;
+
+typedef struct
+{
+    size_t Repetitions;
+    size_t Warmup;
+    const char *JsonFile;
+    const char *Filter;
+    const char *GeometryFilter;
+
+} BenchOptions_t;
+
+static BenchResult_t BenchResults[BENCH_MAX_RESULTS];
+static size_t BenchNumResults = 0;
+static volatile int BenchSink = 0;
+
+static double NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+
+    return (da > db) - (da < db);
+}
+
+static double Percentile(const double *Sorted, size_t Num, double Fraction)
+{
+    size_t Index = (size_t)(Fraction * (double)(Num - 1) + 0.5);
+
+    return Sorted[Index < Num ? Index : Num - 1];
+}
+
+/*Benchmarked functions*/
+static int BenchTCWrite(BenchData_t *Data) { return fee_TC_Write(Data->TC, Data->TC_Packet); }
+static int BenchTCRead(BenchData_t *Data) { return fee_TC_Read(Data->TC_Packet, &Data->TC); }
+static int BenchTMWrite(BenchData_t *Data) { return fee_TM_Write(Data->TM, Data->TM_Packet); }
+static int BenchTMRead(BenchData_t *Data) { return fee_TM_Read(Data->TM_Packet, &Data->TM); }
+static int BenchTCChecksum(BenchData_t *Data) { return fee_CheckTeleCommandChecksum(Data->TC_Packet); }
+static int BenchTMChecksum(BenchData_t *Data) { return fee_CheckTelemetryChecksum(Data->TM_Packet); }
+static int BenchPTDChecksum(BenchData_t *Data) { return fee_CheckPTDChecksum(Data->PTD_Packet, Data->PTD.PTDSizes); }
+static int BenchPTDRead(BenchData_t *Data) { return fee_PTD_Read(Data->PTD_Packet, Data->TM, &Data->PTD); }
+static int BenchPTDWrite(BenchData_t *Data) { return fee_PTD_Write(Data->TM, Data->PTD, Data->PTD_PacketGenerated); }
+
+static int BenchPTDSizes(BenchData_t *Data)
+{
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+
+    return fee_Calculate_PTD_Sizes(Data->TM, &PTDSizes, &ImageMatrixSizes);
+}
+
+static int BenchConvertTM(BenchData_t *Data)
+{
+    fee_TM_Float_t TM_Float;
+
+    return fee_convert_TM_parameters(Data->TM, &TM_Float);
+}
+
+/**
+ * @brief Function that runs a benchmark and stores its result.
+ *
+ * @param Options [Input] Benchmark options.
+ * @param Name [Input] Name of the benchmark.
+ * @param Geometry [Input] Name of the PTD geometry.
+ * @param Function [Input] Benchmarked function.
+ * @param Data [Input] Data of the function.
+ * @param PacketBytes [Input] Bytes processed per call. Used to calculate the throughput.
+ * @return int - The function returns FEE_EXIT_ERROR if the benchmarked function fails. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+static int RunBenchmark(const BenchOptions_t *Options, const char *Name, const char *Geometry,
+                        BenchFunction_t Function, BenchData_t *Data, size_t PacketBytes)
+{
+    BenchResult_t *Result;
+    double *Samples;
+    double Start, Elapsed, Sum = 0.0;
+    size_t Iterations = 1, Rep, It;
+    int Status = FEE_EXIT_SUCCESS;
+
+    if (Options->Filter != NULL && strstr(Name, Options->Filter) == NULL)
+    {
+        return FEE_EXIT_SUCCESS;
+    }
+
+    if (BenchNumResults == BENCH_MAX_RESULTS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Calibrate the number of calls per repetition*/
+    for (;;)
+    {
+        Start = NowNs();
+        for (It = 0; It < Iterations; It++)
+        {
+            Status |= Function(Data);
+        }
+        Elapsed = NowNs() - Start;
+
+        if (Status != FEE_EXIT_SUCCESS)
+        {
+            fprintf(stderr, "Error at %s (%s)\n", Name, Geometry);
+            return FEE_EXIT_ERROR;
+        }
+        if (Elapsed >= BENCH_MIN_SAMPLE_NS || Iterations >= ((size_t)1 << 30))
+        {
+            break;
+        }
+        Iterations *= 2;
+    }
+
+    /*Warmup*/
+    for (Rep = 0; Rep < Options->Warmup; Rep++)
+    {
+        for (It = 0; It < Iterations; It++)
+        {
+            Status |= Function(Data);
+        }
+    }
+
+    Samples = malloc(Options->Repetitions * sizeof(double));
+    if (Samples == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (Rep = 0; Rep < Options->Repetitions; Rep++)
+    {
+        Start = NowNs();
+        for (It = 0; It < Iterations; It++)
+        {
+            Status |= Function(Data);
+        }
+        Samples[Rep] = (NowNs() - Start) / (double)Iterations;
+        Sum += Samples[Rep];
+    }
+    BenchSink += Status;
+
+    qsort(Samples, Options->Repetitions, sizeof(double), CompareDouble);
+
+    Result = &BenchResults[BenchNumResults++];
+    snprintf(Result->Name, sizeof(Result->Name), "%s", Name);
+    Result->Geometry = Geometry;
+    Result->PacketBytes = PacketBytes;
+    Result->Iterations = Iterations;
+    Result->Repetitions = Options->Repetitions;
+    Result->Min = Samples[0];
+    Result->Median = Percentile(Samples, Options->Repetitions, 0.50);
+    Result->P90 = Percentile(Samples, Options->Repetitions, 0.90);
+    Result->P99 = Percentile(Samples, Options->Repetitions, 0.99);
+    Result->Max = Samples[Options->Repetitions - 1];
+    Result->Mean = Sum / (double)Options->Repetitions;
+    Result->GBps = Result->Median > 0.0 ? (double)PacketBytes / Result->Median : 0.0;
+
+    printf("%-28s %-8s %10zu %12.1f %12.1f %12.1f %12.1f %9.3f\n", Result->Name, Result->Geometry, Result->PacketBytes,
+           Result->Median, Result->P90, Result->P99, Result->Min, Result->GBps);
+    fflush(stdout);
+
+    free(Samples);
+
+    return Status;
+}
+
+/**
+ * @brief Function that fills the TC and TM structures of a geometry.
+ */
+static void FillTM(const BenchGeometry_t *Geometry, fee_TM_t *TM)
+{
+    fee_TC_t *TC = &TM->Returned_TC;
+
+    memset(TM, 0, sizeof(fee_TM_t));
+
+    TC->TC_COUNTER = 1;
+    TC->OPMODE = OPMODE_OPERATIONAL;
+    TC->EXPO_TIME = 4280;
+    TC->DUOUTDRAINTVLTG = 174;
+    TC->NBSMEAR = 62;
+    TC->WOISTART = 255;
+    TC->WOISIZE = Geometry->WOISIZE;
+    TC->SPATIALBINNINGMODE = Geometry->SPATIALBINNINGMODE;
+    TC->RESETCKONTIME = 3;
+    TC->HCNBSAMPLE = 8;
+    TC->NBTAIL = Geometry->NBTAIL;
+    TC->PIXEL_MAX = 65535;
+    TC->CDSPARAMS = fee_fill_cdsparam_parameter(DEFAULT_CDS, 250);
+    TC->FREQBINNINGBAND_1 = fee_fill_freqbinningband_parameter(Geometry->BinningSize[0], Geometry->BandSize[0]);
+    TC->FREQBINNINGBAND_2 = fee_fill_freqbinningband_parameter(Geometry->BinningSize[1], Geometry->BandSize[1]);
+    TC->FREQBINNINGBAND_3 = fee_fill_freqbinningband_parameter(Geometry->BinningSize[2], Geometry->BandSize[2]);
+    TC->FREQBINNINGBAND_4 = fee_fill_freqbinningband_parameter(Geometry->BinningSize[3], Geometry->BandSize[3]);
+    TC->FREQBINNINGBAND_5 = fee_fill_freqbinningband_parameter(Geometry->BinningSize[4], Geometry->BandSize[4]);
+
+    TM->TM_COUNTER = 42;
+    TM->CCDTEMP_MEAS1 = 32376;
+    TM->CCDTEMP_MEAS2 = 32304;
+    TM->VAUTEMP_MEAS = 19856;
+    TM->FPPETEMP_MEAS = 20173;
+    TM->VODE_MEAS = 24;
+    TM->VODF_MEAS = 24;
+    TM->VODG_MEAS = 24;
+    TM->VODH_MEAS = 30;
+    TM->VRD_MEAS = 32;
+    TM->VDD_MEAS = 2056;
+    TM->VOG_MEAS = 64;
+    TM->IPHIH_MEAS = 14408;
+    TM->SPHIH_MEAS = 14198;
+    TM->RPHIH_MEAS = 14415;
+    TM->PHIRH_MEAS = 16568;
+    TM->VDGH_MEAS = 16548;
+    TM->VANAP_MEAS = 22669;
+    TM->VANAN_MEAS = 21656;
+    TM->VDET_MEAS = 10392;
+    TM->VDRV_MEAS = 13560;
+    TM->VDIG_MEAS = 22760;
+    TM->IDIG_MEAS = 9121;
+}
+
+/**
+ * @brief Function that prepares the TM, TC and PTD packets of a geometry.
+ */
+static int PrepareData(const BenchGeometry_t *Geometry, BenchData_t *Data)
+{
+    size_t Pixel, NumPixels;
+    int CCD;
+
+    memset(Data, 0, sizeof(BenchData_t));
+    FillTM(Geometry, &Data->TM);
+    Data->TC = Data->TM.Returned_TC;
+
+    if (fee_TC_Write(Data->TC, Data->TC_Packet) != FEE_EXIT_SUCCESS ||
+        fee_TM_Write(Data->TM, Data->TM_Packet) != FEE_EXIT_SUCCESS ||
+        fee_Calculate_PTD_Sizes(Data->TM, &Data->PTD.PTDSizes, &Data->PTD.PTDImageMatrixTotalSizes) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Data->PTD_Packet = malloc(Data->PTD.PTDSizes.DataPacketTotalBytes);
+    Data->PTD_PacketGenerated = malloc(Data->PTD.PTDSizes.DataPacketTotalBytes);
+    if (Data->PTD_Packet == NULL || Data->PTD_PacketGenerated == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Ramp image*/
+    NumPixels = Data->PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes / sizeof(uint16_t);
+    for (CCD = 0; CCD < FEE_NUM_CCD; CCD++)
+    {
+        Data->PTD.ImageMatrix[CCD] = malloc(Data->PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes);
+        if (Data->PTD.ImageMatrix[CCD] == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        for (Pixel = 0; Pixel < NumPixels; Pixel++)
+        {
+            Data->PTD.ImageMatrix[CCD][Pixel] = (uint16_t)(Pixel * 7 + CCD);
+        }
+    }
+    Data->PTD.PIXEL_DATA_COUNTER = 1;
+    Data->PTD.VOLTAGES_REFERENCES[0] = 100;
+
+    return fee_PTD_Write(Data->TM, Data->PTD, Data->PTD_Packet);
+}
+
+static void ReleaseData(BenchData_t *Data)
+{
+    int CCD;
+
+    for (CCD = 0; CCD < FEE_NUM_CCD; CCD++)
+    {
+        free(Data->PTD.ImageMatrix[CCD]);
+    }
+    free(Data->PTD_Packet);
+    free(Data->PTD_PacketGenerated);
+}
+
+static int WriteJson(const char *FileName)
+{
+    FILE *fp;
+    size_t i;
+
+    fp = fopen(FileName, "w");
+    if (fp == NULL)
+    {
+        perror("Error opening JSON file");
+        return FEE_EXIT_ERROR;
+    }
+
+    fprintf(fp, "{\n  \"library\": \"fee\",\n  \"unit\": \"ns/packet\",\n  \"results\": [\n");
+    for (i = 0; i < BenchNumResults; i++)
+    {
+        const BenchResult_t *r = &BenchResults[i];
+
+        fprintf(fp, "    {\"name\": \"%s\", \"geometry\": \"%s\", \"packet_bytes\": %zu, \"iterations\": %zu, "
+                    "\"repetitions\": %zu, \"min_ns\": %.3f, \"median_ns\": %.3f, \"p90_ns\": %.3f, \"p99_ns\": %.3f, "
+                    "\"max_ns\": %.3f, \"mean_ns\": %.3f, \"gb_per_s\": %.6f}%s\n",
+                r->Name, r->Geometry, r->PacketBytes, r->Iterations, r->Repetitions, r->Min, r->Median, r->P90,
+                r->P99, r->Max, r->Mean, r->GBps, i + 1 < BenchNumResults ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+static void Usage(const char *Program)
+{
+    printf("Usage: %s [--reps N] [--warmup N] [--filter NAME] [--geometry small|typical|maximum] [--json FILE]\n", Program);
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions_t Options = {BENCH_DEFAULT_REPETITIONS, BENCH_DEFAULT_WARMUP, NULL, NULL, NULL};
+    BenchData_t Data;
+    size_t g;
+    int i, Status = FEE_EXIT_SUCCESS;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+        {
+            Options.Repetitions = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+        {
+            Options.Warmup = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            Options.Filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--geometry") == 0 && i + 1 < argc)
+        {
+            Options.GeometryFilter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            Options.JsonFile = argv[++i];
+        }
+        else
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (Options.Repetitions == 0)
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%-28s %-8s %10s %12s %12s %12s %12s %9s\n", "benchmark", "geometry", "bytes", "median(ns)", "p90(ns)",
+           "p99(ns)", "min(ns)", "GB/s");
+
+    for (g = 0; g < BENCH_NUM_GEOMETRIES; g++)
+    {
+        const BenchGeometry_t *Geometry = &BenchGeometries[g];
+
+        if (Options.GeometryFilter != NULL && strcmp(Options.GeometryFilter, Geometry->Name) != 0)
+        {
+            continue;
+        }
+
+        if (PrepareData(Geometry, &Data) != FEE_EXIT_SUCCESS)
+        {
+            fprintf(stderr, "Error preparing geometry %s\n", Geometry->Name);
+            ReleaseData(&Data);
+            return EXIT_FAILURE;
+        }
+
+        /*TC and TM packets do not depend on the geometry. They are measured with the first one*/
+        if (Options.GeometryFilter != NULL || g == 0)
+        {
+            Status |= RunBenchmark(&Options, "fee_TC_Write", "-", BenchTCWrite, &Data, TC_PACKET_BYTES);
+            Status |= RunBenchmark(&Options, "fee_TC_Read", "-", BenchTCRead, &Data, TC_PACKET_BYTES);
+            Status |= RunBenchmark(&Options, "fee_TM_Write", "-", BenchTMWrite, &Data, TM_PACKET_BYTES);
+            Status |= RunBenchmark(&Options, "fee_TM_Read", "-", BenchTMRead, &Data, TM_PACKET_BYTES);
+            Status |= RunBenchmark(&Options, "fee_CheckTeleCommandChecksum", "-", BenchTCChecksum, &Data, TC_PACKET_BYTES);
+            Status |= RunBenchmark(&Options, "fee_CheckTelemetryChecksum", "-", BenchTMChecksum, &Data, TM_PACKET_BYTES);
+            Status |= RunBenchmark(&Options, "fee_convert_TM_parameters", "-", BenchConvertTM, &Data, TM_PACKET_BYTES);
+        }
+
+        Status |= RunBenchmark(&Options, "fee_Calculate_PTD_Sizes", Geometry->Name, BenchPTDSizes, &Data, TM_PACKET_BYTES);
+        Status |= RunBenchmark(&Options, "fee_CheckPTDChecksum", Geometry->Name, BenchPTDChecksum, &Data,
+                               Data.PTD.PTDSizes.DataPacketTotalBytes);
+        Status |= RunBenchmark(&Options, "fee_PTD_Read", Geometry->Name, BenchPTDRead, &Data,
+                               Data.PTD.PTDSizes.DataPacketTotalBytes);
+        Status |= RunBenchmark(&Options, "fee_PTD_Write", Geometry->Name, BenchPTDWrite, &Data,
+                               Data.PTD.PTDSizes.DataPacketTotalBytes);
+
+        ReleaseData(&Data);
+    }
+
+    if (Options.JsonFile != NULL && WriteJson(Options.JsonFile) != FEE_EXIT_SUCCESS)
+    {
+        return EXIT_FAILURE;
+    }
+
+    return Status == FEE_EXIT_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -30,6 +30,132 @@
 #define TC_PACKET_BYTES 75
 #define TM_PACKET_BYTES 140
 
+/*TC packet field byte offsets (fields are serialized with network endianess)*/
+#define TC_OFFSET_TC_COUNTER 0
+#define TC_OFFSET_OPMODE 2
+#define TC_OFFSET_EXPO_TIME 4
+#define TC_OFFSET_DUOUTDRAINTVLTG 9
+#define TC_OFFSET_DURESETVLTG 10
+#define TC_OFFSET_DUDUMPVLTG 11
+#define TC_OFFSET_DUOUTGATEVLTG 12
+#define TC_OFFSET_DUIMGCKHVLTG 13
+#define TC_OFFSET_DUSTGCKHVLTG 14
+#define TC_OFFSET_DUREGCKHVLTG 15
+#define TC_OFFSET_DUDUMPCKHVLTG 16
+#define TC_OFFSET_DURESETCKHVLTG 17
+#define TC_OFFSET_NBSMEAR 18
+#define TC_OFFSET_WOISTART 20
+#define TC_OFFSET_WOISIZE 22
+#define TC_OFFSET_SPATIALBINNINGMODE 24
+#define TC_OFFSET_FTPTIME 26
+#define TC_OFFSET_IMGSTGCKRFTIME 27
+#define TC_OFFSET_IMGSTGCKOVTIME 28
+#define TC_OFFSET_IMGSTGCKPWTIME 29
+#define TC_OFFSET_REGLINADVTIME 30
+#define TC_OFFSET_LINADVREGTIME 31
+#define TC_OFFSET_RCKPTIME 32
+#define TC_OFFSET_REGCKOVTIME 33
+#define TC_OFFSET_R1REGCKONTIME 34
+#define TC_OFFSET_R3REGCKONTIME 35
+#define TC_OFFSET_R2CKRISEDELTIME 37
+#define TC_OFFSET_RESETCKONTIME 38
+#define TC_OFFSET_RESETCKFALLDELTIME 39
+#define TC_OFFSET_ADC1TIME 40
+#define TC_OFFSET_ADC2TIME 41
+#define TC_OFFSET_ADC1RDDLY 42
+#define TC_OFFSET_ADC2RDDLY 43
+#define TC_OFFSET_DULAMBDA 44
+#define TC_OFFSET_FREQBINNINGBAND_1 46
+#define TC_OFFSET_FREQBINNINGBAND_2 48
+#define TC_OFFSET_FREQBINNINGBAND_3 50
+#define TC_OFFSET_FREQBINNINGBAND_4 52
+#define TC_OFFSET_FREQBINNINGBAND_5 54
+#define TC_OFFSET_PIXEL_MIN 56
+#define TC_OFFSET_PIXEL_MAX 58
+#define TC_OFFSET_SYNTPATTERN 60
+#define TC_OFFSET_CDSPARAMS 62
+#define TC_OFFSET_HCNBSAMPLE 64
+#define TC_OFFSET_NBTAIL 66
+#define TC_OFFSET_ACQSTARTDELAY 68
+#define TC_OFFSET_CHECKSUM 74
+
+/*TM packet field byte offsets (fields are serialized with network endianess)*/
+#define TM_OFFSET_TM_COUNTER 0
+#define TM_OFFSET_TC_COUNTER 4
+#define TM_OFFSET_OPMODE 6
+#define TM_OFFSET_EXPO_TIME 8
+#define TM_OFFSET_DUOUTDRAINTVLTG 13
+#define TM_OFFSET_DURESETVLTG 14
+#define TM_OFFSET_DUDUMPVLTG 15
+#define TM_OFFSET_DUOUTGATEVLTG 16
+#define TM_OFFSET_DUIMGCKHVLTG 17
+#define TM_OFFSET_DUSTGCKHVLTG 18
+#define TM_OFFSET_DUREGCKHVLTG 19
+#define TM_OFFSET_DUDUMPCKHVLTG 20
+#define TM_OFFSET_DURESETCKHVLTG 21
+#define TM_OFFSET_NBSMEAR 22
+#define TM_OFFSET_WOISTART 24
+#define TM_OFFSET_WOISIZE 26
+#define TM_OFFSET_SPATIALBINNINGMODE 28
+#define TM_OFFSET_FTPTIME 30
+#define TM_OFFSET_IMGSTGCKRFTIME 31
+#define TM_OFFSET_IMGSTGCKOVTIME 32
+#define TM_OFFSET_IMGSTGCKPWTIME 33
+#define TM_OFFSET_REGLINADVTIME 34
+#define TM_OFFSET_LINADVREGTIME 35
+#define TM_OFFSET_RCKPTIME 36
+#define TM_OFFSET_REGCKOVTIME 37
+#define TM_OFFSET_R1REGCKONTIME 38
+#define TM_OFFSET_R3REGCKONTIME 39
+#define TM_OFFSET_R2CKRISEDELTIME 41
+#define TM_OFFSET_RESETCKONTIME 42
+#define TM_OFFSET_RESETCKFALLDELTIME 43
+#define TM_OFFSET_ADC1TIME 44
+#define TM_OFFSET_ADC2TIME 45
+#define TM_OFFSET_ADC1RDDLY 46
+#define TM_OFFSET_ADC2RDDLY 47
+#define TM_OFFSET_DULAMBDA 48
+#define TM_OFFSET_FREQBINNINGBAND_1 50
+#define TM_OFFSET_FREQBINNINGBAND_2 52
+#define TM_OFFSET_FREQBINNINGBAND_3 54
+#define TM_OFFSET_FREQBINNINGBAND_4 56
+#define TM_OFFSET_FREQBINNINGBAND_5 58
+#define TM_OFFSET_PIXEL_MIN 60
+#define TM_OFFSET_PIXEL_MAX 62
+#define TM_OFFSET_SYNTPATTERN 64
+#define TM_OFFSET_CDSPARAMS 66
+#define TM_OFFSET_HCNBSAMPLE 68
+#define TM_OFFSET_NBTAIL 70
+#define TM_OFFSET_CCDTEMP_MEAS1 72
+#define TM_OFFSET_CCDTEMP_MEAS2 74
+#define TM_OFFSET_VAUTEMP_MEAS 76
+#define TM_OFFSET_FPPETEMP_MEAS 78
+#define TM_OFFSET_VODE_MEAS 80
+#define TM_OFFSET_VODF_MEAS 82
+#define TM_OFFSET_VODG_MEAS 84
+#define TM_OFFSET_VODH_MEAS 86
+#define TM_OFFSET_VRD_MEAS 88
+#define TM_OFFSET_VDD_MEAS 90
+#define TM_OFFSET_VOG_MEAS 92
+#define TM_OFFSET_IPHIH_MEAS 94
+#define TM_OFFSET_SPHIH_MEAS 96
+#define TM_OFFSET_RPHIH_MEAS 98
+#define TM_OFFSET_PHIRH_MEAS 100
+#define TM_OFFSET_VDGH_MEAS 102
+#define TM_OFFSET_VANAP_MEAS 104
+#define TM_OFFSET_VANAN_MEAS 106
+#define TM_OFFSET_VDET_MEAS 108
+#define TM_OFFSET_VDRV_MEAS 110
+#define TM_OFFSET_VDIG_MEAS 112
+#define TM_OFFSET_IDIG_MEAS 114
+#define TM_OFFSET_TC_ERROR 116
+#define TM_OFFSET_VAU_ERROR 118
+#define TM_OFFSET_ACQSTARTDELAY 120
+#define TM_OFFSET_CHECKSUM 138
+
+/*PTD packet field byte offsets*/
+#define PTD_OFFSET_PIXEL_DATA_COUNTER 0
+
 /*TM (HC signals) register ranges*/
 #define TM_HC_SIGNAL_MIN 0
 #define TM_HC_SIGNAL_MAX 65520
@@ -305,6 +431,71 @@ typedef enum
 
 } fee_VAU_Error_t;
 
+/*
+TC bounds violation bits. Every checked field (FREQBINNINGBAND_n and CDSPARAMS are checked per sub-field)
+has a bit in the violation mask returned by fee_TC_BoundsCheck_Mask: bit n is set if the field n is out of range.
+*/
+typedef enum
+{
+    TC_FIELD_TC_COUNTER = 0,
+    TC_FIELD_OPMODE = 1,
+    TC_FIELD_EXPO_TIME = 2,
+    TC_FIELD_DUOUTDRAINTVLTG = 3,
+    TC_FIELD_DURESETVLTG = 4,
+    TC_FIELD_DUDUMPVLTG = 5,
+    TC_FIELD_DUOUTGATEVLTG = 6,
+    TC_FIELD_DUIMGCKHVLTG = 7,
+    TC_FIELD_DUSTGCKHVLTG = 8,
+    TC_FIELD_DUREGCKHVLTG = 9,
+    TC_FIELD_DUDUMPCKHVLTG = 10,
+    TC_FIELD_DURESETCKHVLTG = 11,
+    TC_FIELD_NBSMEAR = 12,
+    TC_FIELD_WOISTART = 13,
+    TC_FIELD_WOISIZE = 14,
+    TC_FIELD_SPATIALBINNINGMODE = 15,
+    TC_FIELD_FTPTIME = 16,
+    TC_FIELD_IMGSTGCKRFTIME = 17,
+    TC_FIELD_IMGSTGCKOVTIME = 18,
+    TC_FIELD_IMGSTGCKPWTIME = 19,
+    TC_FIELD_REGLINADVTIME = 20,
+    TC_FIELD_LINADVREGTIME = 21,
+    TC_FIELD_RCKPTIME = 22,
+    TC_FIELD_REGCKOVTIME = 23,
+    TC_FIELD_R1REGCKONTIME = 24,
+    TC_FIELD_R3REGCKONTIME = 25,
+    TC_FIELD_R2CKRISEDELTIME = 26,
+    TC_FIELD_RESETCKONTIME = 27,
+    TC_FIELD_RESETCKFALLDELTIME = 28,
+    TC_FIELD_ADC1TIME = 29,
+    TC_FIELD_ADC2TIME = 30,
+    TC_FIELD_ADC1RDDLY = 31,
+    TC_FIELD_ADC2RDDLY = 32,
+    TC_FIELD_DULAMBDA = 33,
+    TC_FIELD_FREQBINNINGBAND_1_BINNINGSIZE = 34,
+    TC_FIELD_FREQBINNINGBAND_1_BANDSIZE = 35,
+    TC_FIELD_FREQBINNINGBAND_2_BINNINGSIZE = 36,
+    TC_FIELD_FREQBINNINGBAND_2_BANDSIZE = 37,
+    TC_FIELD_FREQBINNINGBAND_3_BINNINGSIZE = 38,
+    TC_FIELD_FREQBINNINGBAND_3_BANDSIZE = 39,
+    TC_FIELD_FREQBINNINGBAND_4_BINNINGSIZE = 40,
+    TC_FIELD_FREQBINNINGBAND_4_BANDSIZE = 41,
+    TC_FIELD_FREQBINNINGBAND_5_BINNINGSIZE = 42,
+    TC_FIELD_FREQBINNINGBAND_5_BANDSIZE = 43,
+    TC_FIELD_PIXEL_MIN = 44,
+    TC_FIELD_PIXEL_MAX = 45,
+    TC_FIELD_SYNTPATTERN = 46,
+    TC_FIELD_CDSPARAMS_MODE = 47,
+    TC_FIELD_CDSPARAMS_DIGITAL_OFFSET = 48,
+    TC_FIELD_HCNBSAMPLE = 49,
+    TC_FIELD_NBTAIL = 50,
+    TC_FIELD_ACQSTARTDELAY = 51,
+    TC_FIELD_NUM = 52
+
+} fee_TC_Field_t;
+
+/*Bit of a field in the TC bounds violation mask*/
+#define TC_FIELD_BIT(field) ((uint64_t)1 << (field))
+
 typedef struct
 {
 
@@ -517,6 +708,34 @@ int fee_CheckTeleCommandChecksum(fee_TC_Packet_t TC_Packet);
  */
 int fee_TC_BoundsCheck(fee_TC_t TC_Data_Struct);
 
+/**
+ * @brief The function checks every bound of the TC information and reports all the fields which are out of range.
+ *
+ * @param TC_Data_Struct [Input] TC Data information structure.
+ * @param ViolationMask [Output] Mask with the bit TC_FIELD_BIT(n) set for every field n (fee_TC_Field_t) out of range.
+ * @return int - The function returns FEE_EXIT_SUCCESS if the information is correclty bounded. Otherwise, FEE_EXIT_ERROR wil be returned.
+ */
+int fee_TC_BoundsCheck_Mask(fee_TC_t TC_Data_Struct, uint64_t *ViolationMask);
+
+/**
+ * @brief The function checks the bounds of an array of TC information structures. 
+ *  The fields of several structures are compared at once.
+ *
+ * @param TC_Data_Array [Input] Array of TC Data information structures.
+ * @param NumTC [Input] Number of elements of TC_Data_Array.
+ * @param ViolationMasks [Output] Array of NumTC violation masks (see fee_TC_BoundsCheck_Mask).
+ * @return int - The function returns FEE_EXIT_SUCCESS if every structure is correclty bounded. Otherwise, FEE_EXIT_ERROR wil be returned.
+ */
+int fee_TC_BoundsCheck_Batch(const fee_TC_t *TC_Data_Array, size_t NumTC, uint64_t *ViolationMasks);
+
+/**
+ * @brief Function that returns the name of a TC checked field.
+ *
+ * @param Field [Input] Field of the violation mask.
+ * @return const char* - Name of the field. NULL if Field is not valid.
+ */
+const char *fee_TC_FieldName(fee_TC_Field_t Field);
+
 /**
  * @brief The fuction deserelized the information of a TM Packet and store it in a stuctre.
  *
@@ -593,6 +812,37 @@ int fee_Calculate_PTD_Sizes(fee_TM_t TmInformation, fee_PTDSizes_t *PTDSizes, fe
  */
 int fee_CheckPTDChecksum(fee_TM_Packet_t PTD_Packet, fee_PTDSizes_t PTDSizes);
 
+/**
+ * @brief Function that returns the PTD serialization kernel used for the geometry of a TM. fee_PTD_Read and
+ *  fee_PTD_Write use kernels specialized for the row lengths of the production geometries and a generic loop
+ *  otherwise. If the CPU-feature dispatch (fee_dispatch.h) selects a vector tier, a kernel of any row length with
+ *  the pixel loops of that tier is used instead. The kernels are disabled if the environment variable
+ *  FEE_PTD_KERNELS is "generic".
+ *
+ * @param TmInformation [Input] TM information structure
+ * @return const char* - Name of the kernel ("row<pixels>" or "vector-<tier>") or "generic".
+ */
+const char *fee_PTD_KernelName(fee_TM_t TmInformation);
+
+/**
+ * @brief Function that enables or disables the PTD serialization kernels at run time, as FEE_PTD_KERNELS does at
+ *  start-up. With the kernels disabled, fee_PTD_Read and fee_PTD_Write use the generic loop, which is the reference
+ *  the kernels are verified against. It must not be called while other threads use the library.
+ *
+ * @param Enable [Input] 0 to use the generic loop for every geometry. Any other value enables the kernels.
+ */
+void fee_PTD_EnableKernels(int Enable);
+
+/**
+ * @brief Function that returns the index of a pixel in the ImageMatrix of a CCD of fee_PTD_t.
+ *
+ * @param RowIndex [Input] Row of the pixel.
+ * @param ColIndex [Input] Column of the pixel.
+ * @param NumColumns [Input] Number of columns of the image (ImageTotalColumns of fee_ImageMatrixTotalSizes_t).
+ * @return size_t Index of the pixel.
+ */
+size_t fee_PTDImageIndx(size_t RowIndex, size_t ColIndex, size_t NumColumns);
+
 /**
  * @brief Function tat gets the binninsize and bansize parameters from the freqbinningband paramer. 
  *  freqbinningband = binningsize [13:15]  spare [9:12] bandsize[0:8] where 0 is the LSB
@@ -642,6 +892,75 @@ uint16_t fee_fill_cdsparam_parameter(cds_params_t cds_mode, int digital_offset);
 uint16_t fee_fill_freqbinningband_parameter(int binningsize, int bandsize);
 
 
+/**
+ * @brief Function that updates a 16 bits xor checksum (TM and PTD packets) after patching some bytes of the packet, 
+ *  without recalculating it over the whole packet. The cost only depends on the length of the patched region.
+ *
+ * @param checksum [Input] Checksum of the packet before the patch, as stored in the packet.
+ * @param offset [Input] Byte offset of the patched region from the beginning of the packet.
+ * @param old_data [Input] Bytes of the region before the patch.
+ * @param new_data [Input] Bytes of the region after the patch.
+ * @param length [Input] Length, in bytes, of the patched region.
+ * @return uint16_t The function returns the checksum of the patched packet.
+ */
+uint16_t fee_checksum16_patch(uint16_t checksum, size_t offset, const uint8_t *old_data, const uint8_t *new_data, size_t length);
+
+/**
+ * @brief Function that updates an 8 bits xor checksum (TC packets) after patching some bytes of the packet, 
+ *  without recalculating it over the whole packet.
+ *
+ * @param checksum [Input] Checksum of the packet before the patch.
+ * @param old_data [Input] Bytes of the region before the patch.
+ * @param new_data [Input] Bytes of the region after the patch.
+ * @param length [Input] Length, in bytes, of the patched region.
+ * @return uint8_t The function returns the checksum of the patched packet.
+ */
+uint8_t fee_checksum8_patch(uint8_t checksum, const uint8_t *old_data, const uint8_t *new_data, size_t length);
+
+/**
+ * @brief Function that overwrites a field of an already serialized TC packet and keeps its checksum consistent.
+ *
+ * @param TC_Packet [Input/Output] TC packet to be patched.
+ * @param offset [Input] Byte offset of the field (TC_OFFSET_* constants).
+ * @param parameter_length_bytes [Input] Length in bytes of the field (1, 2 or 4).
+ * @param value [Input] New value of the field. It is serialized with network endianess.
+ * @return int - The function returns FEE_EXIT_ERROR if the field is out of the packet, overlaps the checksum or
+ *  the value does not fit in the field. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_TC_SetParameter(fee_TC_Packet_t TC_Packet, size_t offset, int parameter_length_bytes, uint32_t value);
+
+/**
+ * @brief Function that overwrites a field of an already serialized TM packet and keeps its checksum consistent.
+ *
+ * @param TM_Packet [Input/Output] TM packet to be patched.
+ * @param offset [Input] Byte offset of the field (TM_OFFSET_* constants).
+ * @param parameter_length_bytes [Input] Length in bytes of the field (1, 2 or 4).
+ * @param value [Input] New value of the field. It is serialized with network endianess.
+ * @return int - The function returns FEE_EXIT_ERROR if the field is out of the packet, overlaps the checksum or
+ *  the value does not fit in the field. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_TM_SetParameter(fee_TM_Packet_t TM_Packet, size_t offset, int parameter_length_bytes, uint32_t value);
+
+/**
+ * @brief Function that overwrites a field of an already serialized PTD packet and keeps its checksum consistent.
+ *  The cost does not depend on the size of the PTD packet.
+ *
+ * @param PixelDataPacket [Input/Output] PTD packet to be patched.
+ * @param PTDSizes [Input] Structure with sizes information of the PTD packet
+ * @param offset [Input] Byte offset of the field (PTD_OFFSET_PIXEL_DATA_COUNTER or the offset of a pixel parameter).
+ * @param parameter_length_bytes [Input] Length in bytes of the field (1, 2 or 4).
+ * @param value [Input] New value of the field. It is serialized with network endianess.
+ * @return int - The function returns FEE_EXIT_ERROR if the field is out of the packet, overlaps the checksum or
+ *  the value does not fit in the field. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_PTD_SetParameter(uint8_t *PixelDataPacket, fee_PTDSizes_t PTDSizes, size_t offset, int parameter_length_bytes, uint32_t value);
+
+
 /**@}*/
 
+/*Inline definitions of the hot functions (fee_inline.h)*/
+#ifdef FEE_INLINE
+#include <fee_inline.h>
+#endif
+
 #endif
@@ -0,0 +1,455 @@
+/**
+ * @file fee.hpp
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Header-only C++ companion of fee.h. The TC/TM packet layouts are described by constexpr tables that are
+ *  checked at compile time against TC_PACKET_BYTES/TM_PACKET_BYTES, and fee::decode_ptd<Geometry> generates a PTD
+ *  decoder for a band geometry known at compile time, so that fixed production configurations are decoded without
+ *  runtime size arithmetic. TMs with any other geometry are decoded by the C API. Requires C++17.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_HPP
+#define FEE_HPP
+
+#if __cplusplus < 201703L
+#error "fee.hpp requires C++17"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+extern "C"
+{
+#include <fee.h>
+}
+
+namespace fee
+{
+
+/* --------------------- */
+/* ---- Layouts -------- */
+/* --------------------- */
+
+namespace layout
+{
+
+/*Field of a packet. Multi-byte fields are big-endian*/
+struct field
+{
+    std::string_view name;
+    std::size_t offset;
+    std::size_t bytes;
+};
+
+/*TC packet fields, in packet order. Gaps between fields are spare bytes*/
+inline constexpr field tc_fields[] = {
+    {"TC_COUNTER", TC_OFFSET_TC_COUNTER, 2},
+    {"OPMODE", TC_OFFSET_OPMODE, FEE_OPMODE_BYTESIZE},
+    {"EXPO_TIME", TC_OFFSET_EXPO_TIME, 4},
+    {"DUOUTDRAINTVLTG", TC_OFFSET_DUOUTDRAINTVLTG, 1},
+    {"DURESETVLTG", TC_OFFSET_DURESETVLTG, 1},
+    {"DUDUMPVLTG", TC_OFFSET_DUDUMPVLTG, 1},
+    {"DUOUTGATEVLTG", TC_OFFSET_DUOUTGATEVLTG, 1},
+    {"DUIMGCKHVLTG", TC_OFFSET_DUIMGCKHVLTG, 1},
+    {"DUSTGCKHVLTG", TC_OFFSET_DUSTGCKHVLTG, 1},
+    {"DUREGCKHVLTG", TC_OFFSET_DUREGCKHVLTG, 1},
+    {"DUDUMPCKHVLTG", TC_OFFSET_DUDUMPCKHVLTG, 1},
+    {"DURESETCKHVLTG", TC_OFFSET_DURESETCKHVLTG, 1},
+    {"NBSMEAR", TC_OFFSET_NBSMEAR, 2},
+    {"WOISTART", TC_OFFSET_WOISTART, 2},
+    {"WOISIZE", TC_OFFSET_WOISIZE, 2},
+    {"SPATIALBINNINGMODE", TC_OFFSET_SPATIALBINNINGMODE, FEE_SPATIALBINNING_BYTESIZE},
+    {"FTPTIME", TC_OFFSET_FTPTIME, 1},
+    {"IMGSTGCKRFTIME", TC_OFFSET_IMGSTGCKRFTIME, 1},
+    {"IMGSTGCKOVTIME", TC_OFFSET_IMGSTGCKOVTIME, 1},
+    {"IMGSTGCKPWTIME", TC_OFFSET_IMGSTGCKPWTIME, 1},
+    {"REGLINADVTIME", TC_OFFSET_REGLINADVTIME, 1},
+    {"LINADVREGTIME", TC_OFFSET_LINADVREGTIME, 1},
+    {"RCKPTIME", TC_OFFSET_RCKPTIME, 1},
+    {"REGCKOVTIME", TC_OFFSET_REGCKOVTIME, 1},
+    {"R1REGCKONTIME", TC_OFFSET_R1REGCKONTIME, 1},
+    {"R3REGCKONTIME", TC_OFFSET_R3REGCKONTIME, 1},
+    {"R2CKRISEDELTIME", TC_OFFSET_R2CKRISEDELTIME, 1},
+    {"RESETCKONTIME", TC_OFFSET_RESETCKONTIME, 1},
+    {"RESETCKFALLDELTIME", TC_OFFSET_RESETCKFALLDELTIME, 1},
+    {"ADC1TIME", TC_OFFSET_ADC1TIME, 1},
+    {"ADC2TIME", TC_OFFSET_ADC2TIME, 1},
+    {"ADC1RDDLY", TC_OFFSET_ADC1RDDLY, 1},
+    {"ADC2RDDLY", TC_OFFSET_ADC2RDDLY, 1},
+    {"DULAMBDA", TC_OFFSET_DULAMBDA, 2},
+    {"FREQBINNINGBAND_1", TC_OFFSET_FREQBINNINGBAND_1, 2},
+    {"FREQBINNINGBAND_2", TC_OFFSET_FREQBINNINGBAND_2, 2},
+    {"FREQBINNINGBAND_3", TC_OFFSET_FREQBINNINGBAND_3, 2},
+    {"FREQBINNINGBAND_4", TC_OFFSET_FREQBINNINGBAND_4, 2},
+    {"FREQBINNINGBAND_5", TC_OFFSET_FREQBINNINGBAND_5, 2},
+    {"PIXEL_MIN", TC_OFFSET_PIXEL_MIN, 2},
+    {"PIXEL_MAX", TC_OFFSET_PIXEL_MAX, 2},
+    {"SYNTPATTERN", TC_OFFSET_SYNTPATTERN, FEE_SYNPATTERN_BYTESIZE},
+    {"CDSPARAMS", TC_OFFSET_CDSPARAMS, FEE_CDSPARAMS_BYTESIZE},
+    {"HCNBSAMPLE", TC_OFFSET_HCNBSAMPLE, 2},
+    {"NBTAIL", TC_OFFSET_NBTAIL, 2},
+    {"ACQSTARTDELAY", TC_OFFSET_ACQSTARTDELAY, 2},
+};
+
+/*TM packet fields, in packet order. Gaps between fields are spare bytes*/
+inline constexpr field tm_fields[] = {
+    {"TM_COUNTER", TM_OFFSET_TM_COUNTER, 4},
+    {"TC_COUNTER", TM_OFFSET_TC_COUNTER, 2},
+    {"OPMODE", TM_OFFSET_OPMODE, FEE_OPMODE_BYTESIZE},
+    {"EXPO_TIME", TM_OFFSET_EXPO_TIME, 4},
+    {"DUOUTDRAINTVLTG", TM_OFFSET_DUOUTDRAINTVLTG, 1},
+    {"DURESETVLTG", TM_OFFSET_DURESETVLTG, 1},
+    {"DUDUMPVLTG", TM_OFFSET_DUDUMPVLTG, 1},
+    {"DUOUTGATEVLTG", TM_OFFSET_DUOUTGATEVLTG, 1},
+    {"DUIMGCKHVLTG", TM_OFFSET_DUIMGCKHVLTG, 1},
+    {"DUSTGCKHVLTG", TM_OFFSET_DUSTGCKHVLTG, 1},
+    {"DUREGCKHVLTG", TM_OFFSET_DUREGCKHVLTG, 1},
+    {"DUDUMPCKHVLTG", TM_OFFSET_DUDUMPCKHVLTG, 1},
+    {"DURESETCKHVLTG", TM_OFFSET_DURESETCKHVLTG, 1},
+    {"NBSMEAR", TM_OFFSET_NBSMEAR, 2},
+    {"WOISTART", TM_OFFSET_WOISTART, 2},
+    {"WOISIZE", TM_OFFSET_WOISIZE, 2},
+    {"SPATIALBINNINGMODE", TM_OFFSET_SPATIALBINNINGMODE, FEE_SPATIALBINNING_BYTESIZE},
+    {"FTPTIME", TM_OFFSET_FTPTIME, 1},
+    {"IMGSTGCKRFTIME", TM_OFFSET_IMGSTGCKRFTIME, 1},
+    {"IMGSTGCKOVTIME", TM_OFFSET_IMGSTGCKOVTIME, 1},
+    {"IMGSTGCKPWTIME", TM_OFFSET_IMGSTGCKPWTIME, 1},
+    {"REGLINADVTIME", TM_OFFSET_REGLINADVTIME, 1},
+    {"LINADVREGTIME", TM_OFFSET_LINADVREGTIME, 1},
+    {"RCKPTIME", TM_OFFSET_RCKPTIME, 1},
+    {"REGCKOVTIME", TM_OFFSET_REGCKOVTIME, 1},
+    {"R1REGCKONTIME", TM_OFFSET_R1REGCKONTIME, 1},
+    {"R3REGCKONTIME", TM_OFFSET_R3REGCKONTIME, 1},
+    {"R2CKRISEDELTIME", TM_OFFSET_R2CKRISEDELTIME, 1},
+    {"RESETCKONTIME", TM_OFFSET_RESETCKONTIME, 1},
+    {"RESETCKFALLDELTIME", TM_OFFSET_RESETCKFALLDELTIME, 1},
+    {"ADC1TIME", TM_OFFSET_ADC1TIME, 1},
+    {"ADC2TIME", TM_OFFSET_ADC2TIME, 1},
+    {"ADC1RDDLY", TM_OFFSET_ADC1RDDLY, 1},
+    {"ADC2RDDLY", TM_OFFSET_ADC2RDDLY, 1},
+    {"DULAMBDA", TM_OFFSET_DULAMBDA, 2},
+    {"FREQBINNINGBAND_1", TM_OFFSET_FREQBINNINGBAND_1, 2},
+    {"FREQBINNINGBAND_2", TM_OFFSET_FREQBINNINGBAND_2, 2},
+    {"FREQBINNINGBAND_3", TM_OFFSET_FREQBINNINGBAND_3, 2},
+    {"FREQBINNINGBAND_4", TM_OFFSET_FREQBINNINGBAND_4, 2},
+    {"FREQBINNINGBAND_5", TM_OFFSET_FREQBINNINGBAND_5, 2},
+    {"PIXEL_MIN", TM_OFFSET_PIXEL_MIN, 2},
+    {"PIXEL_MAX", TM_OFFSET_PIXEL_MAX, 2},
+    {"SYNTPATTERN", TM_OFFSET_SYNTPATTERN, FEE_SYNPATTERN_BYTESIZE},
+    {"CDSPARAMS", TM_OFFSET_CDSPARAMS, FEE_CDSPARAMS_BYTESIZE},
+    {"HCNBSAMPLE", TM_OFFSET_HCNBSAMPLE, 2},
+    {"NBTAIL", TM_OFFSET_NBTAIL, 2},
+    {"CCDTEMP_MEAS1", TM_OFFSET_CCDTEMP_MEAS1, 2},
+    {"CCDTEMP_MEAS2", TM_OFFSET_CCDTEMP_MEAS2, 2},
+    {"VAUTEMP_MEAS", TM_OFFSET_VAUTEMP_MEAS, 2},
+    {"FPPETEMP_MEAS", TM_OFFSET_FPPETEMP_MEAS, 2},
+    {"VODE_MEAS", TM_OFFSET_VODE_MEAS, 2},
+    {"VODF_MEAS", TM_OFFSET_VODF_MEAS, 2},
+    {"VODG_MEAS", TM_OFFSET_VODG_MEAS, 2},
+    {"VODH_MEAS", TM_OFFSET_VODH_MEAS, 2},
+    {"VRD_MEAS", TM_OFFSET_VRD_MEAS, 2},
+    {"VDD_MEAS", TM_OFFSET_VDD_MEAS, 2},
+    {"VOG_MEAS", TM_OFFSET_VOG_MEAS, 2},
+    {"IPHIH_MEAS", TM_OFFSET_IPHIH_MEAS, 2},
+    {"SPHIH_MEAS", TM_OFFSET_SPHIH_MEAS, 2},
+    {"RPHIH_MEAS", TM_OFFSET_RPHIH_MEAS, 2},
+    {"PHIRH_MEAS", TM_OFFSET_PHIRH_MEAS, 2},
+    {"VDGH_MEAS", TM_OFFSET_VDGH_MEAS, 2},
+    {"VANAP_MEAS", TM_OFFSET_VANAP_MEAS, 2},
+    {"VANAN_MEAS", TM_OFFSET_VANAN_MEAS, 2},
+    {"VDET_MEAS", TM_OFFSET_VDET_MEAS, 2},
+    {"VDRV_MEAS", TM_OFFSET_VDRV_MEAS, 2},
+    {"VDIG_MEAS", TM_OFFSET_VDIG_MEAS, 2},
+    {"IDIG_MEAS", TM_OFFSET_IDIG_MEAS, 2},
+    {"TC_ERROR", TM_OFFSET_TC_ERROR, 2},
+    {"VAU_ERROR", TM_OFFSET_VAU_ERROR, 2},
+    {"ACQSTARTDELAY", TM_OFFSET_ACQSTARTDELAY, 2},
+};
+
+/*Checksum fields. The TC checksum is 8 bits and the TM one 16 bits*/
+inline constexpr field tc_checksum = {"CHECKSUM", TC_OFFSET_CHECKSUM, 1};
+inline constexpr field tm_checksum = {"CHECKSUM", TM_OFFSET_CHECKSUM, 2};
+
+/*Fields are sorted, do not overlap and end before the checksum, which is the last field of the packet*/
+template <std::size_t N>
+constexpr bool is_valid(const field (&fields)[N], const field &checksum, std::size_t packet_bytes)
+{
+    for (std::size_t i = 0; i + 1 < N; i++)
+    {
+        if (fields[i].bytes == 0 || fields[i].offset + fields[i].bytes > fields[i + 1].offset)
+        {
+            return false;
+        }
+    }
+
+    return fields[N - 1].offset + fields[N - 1].bytes <= checksum.offset &&
+           checksum.offset + checksum.bytes == packet_bytes;
+}
+
+/*Field of a table by name. A field with 0 bytes is returned if it does not exist*/
+template <std::size_t N>
+constexpr field find(const field (&fields)[N], std::string_view name)
+{
+    for (std::size_t i = 0; i < N; i++)
+    {
+        if (fields[i].name == name)
+        {
+            return fields[i];
+        }
+    }
+
+    return field{name, 0, 0};
+}
+
+static_assert(is_valid(tc_fields, tc_checksum, TC_PACKET_BYTES), "TC_OFFSET_* do not match TC_PACKET_BYTES");
+static_assert(is_valid(tm_fields, tm_checksum, TM_PACKET_BYTES), "TM_OFFSET_* do not match TM_PACKET_BYTES");
+static_assert(sizeof(tc_fields) / sizeof(tc_fields[0]) == 46, "A TC field is missing");
+static_assert(sizeof(tm_fields) / sizeof(tm_fields[0]) == 71, "A TM field is missing");
+
+/*The TM echoes the TC fields (but ACQSTARTDELAY) after TM_COUNTER*/
+static_assert(find(tm_fields, "NBTAIL").offset - find(tc_fields, "NBTAIL").offset == TM_OFFSET_TC_COUNTER,
+              "The TC echo of the TM is not contiguous");
+
+/*Decoded fields are wide enough*/
+static_assert(sizeof(fee_TM_t::TM_COUNTER) == find(tm_fields, "TM_COUNTER").bytes, "TM_COUNTER size");
+static_assert(sizeof(fee_TC_t::TC_COUNTER) == find(tc_fields, "TC_COUNTER").bytes, "TC_COUNTER size");
+static_assert(sizeof(fee_TC_t::EXPO_TIME) == find(tc_fields, "EXPO_TIME").bytes, "EXPO_TIME size");
+static_assert(sizeof(fee_TC_t::FREQBINNINGBAND_1) == find(tc_fields, "FREQBINNINGBAND_1").bytes, "FREQBINNINGBAND size");
+
+} // namespace layout
+
+/* --------------------- */
+/* ---- PTD geometry --- */
+/* --------------------- */
+
+/*FREQBINNINGBAND register of a band (see fee_fill_freqbinningband_parameter). 0 disables the band*/
+constexpr std::uint16_t freq_binning_band(unsigned binning_size, unsigned band_size)
+{
+    return static_cast<std::uint16_t>((((binning_size - 1) & 0x7u) << 13) | (band_size & 0x1FFu));
+}
+
+/**
+ * Band geometry of a PTD packet known at compile time. Sizes are calculated as fee_Calculate_PTD_Sizes does.
+ *
+ * @tparam WoiSize WOISIZE
+ * @tparam NbTail NBTAIL
+ * @tparam SpatialBinning SPATIALBINNINGMODE
+ * @tparam Band1..Band5 FREQBINNINGBAND_1..5 registers (see freq_binning_band)
+ */
+template <std::uint16_t WoiSize, std::uint16_t NbTail, spatialbinning_t SpatialBinning, std::uint16_t Band1,
+          std::uint16_t Band2 = 0, std::uint16_t Band3 = 0, std::uint16_t Band4 = 0, std::uint16_t Band5 = 0>
+struct ptd_geometry
+{
+  private:
+    static constexpr std::size_t binning(std::uint16_t band) { return ((band >> 13) & 0x7u) + 1; }
+    static constexpr std::size_t size(std::uint16_t band) { return band & 0x1FFu; }
+    static constexpr bool valid(std::uint16_t band) { return band == 0 || (size(band) != 0 && size(band) % binning(band) == 0); }
+    static constexpr std::size_t pixels(std::uint16_t band) { return size(band) / binning(band); }
+
+    /*An odd WOISIZE with spatial binning drops the last row of the window and of the over-scan*/
+    static constexpr bool odd = (WoiSize % 2 != 0) && SpatialBinning == SPATIALBIN_ENABLE;
+
+  public:
+    static_assert(valid(Band1) && valid(Band2) && valid(Band3) && valid(Band4) && valid(Band5),
+                  "Band sizes must be multiples of their binning sizes");
+
+    static constexpr std::size_t num_dark_columns = 2;
+    static constexpr std::size_t num_voltage_references = 4;
+    static constexpr std::size_t checksum_bytes = 2;
+
+    /*Pixels of a row of each CCD*/
+    static constexpr std::size_t row_pixels = pixels(Band1) + pixels(Band2) + pixels(Band3) + pixels(Band4) + pixels(Band5);
+
+    static constexpr std::size_t data_rows = (WoiSize - (odd ? 1 : 0)) / (static_cast<std::size_t>(SpatialBinning) + 1);
+    static constexpr std::size_t overscan_rows = (NbTail - (odd ? 1 : 0)) / (static_cast<std::size_t>(SpatialBinning) + 1);
+    static constexpr std::size_t smear_rows = FEE_NUM_SMEAR_ROWS;
+
+    /*Image of each CCD*/
+    static constexpr std::size_t image_rows = data_rows + smear_rows + overscan_rows;
+    static constexpr std::size_t image_columns = num_dark_columns + row_pixels;
+    static constexpr std::size_t image_bytes = sizeof(std::uint16_t) * image_rows * image_columns;
+
+    /*Packet*/
+    static constexpr std::size_t row_parameters = FEE_NUM_CCD * image_columns;
+    static constexpr std::size_t smear_parameters = FEE_NUM_SMEAR_ROWS * FEE_NUM_CCD * row_pixels;
+    static constexpr std::size_t packet_bytes =
+        sizeof(std::uint32_t) +
+        sizeof(std::uint16_t) * (row_parameters * (data_rows + overscan_rows) + smear_parameters + num_voltage_references) +
+        checksum_bytes;
+
+    /*Not 0 if a TM describes this geometry*/
+    static bool matches(const fee_TM_t &tm)
+    {
+        const fee_TC_t &tc = tm.Returned_TC;
+
+        return tc.OPMODE == OPMODE_OPERATIONAL && tm.VAU_ERROR == 0 && tm.TC_ERROR == 0 &&
+               tc.WOISIZE == WoiSize && tc.NBTAIL == NbTail && tc.SPATIALBINNINGMODE == SpatialBinning &&
+               tc.FREQBINNINGBAND_1 == Band1 && tc.FREQBINNINGBAND_2 == Band2 && tc.FREQBINNINGBAND_3 == Band3 &&
+               tc.FREQBINNINGBAND_4 == Band4 && tc.FREQBINNINGBAND_5 == Band5;
+    }
+
+    /*Sizes as returned by fee_Calculate_PTD_Sizes*/
+    static void sizes(fee_PTDSizes_t &ptd_sizes, fee_ImageMatrixTotalSizes_t &image_sizes)
+    {
+        ptd_sizes = fee_PTDSizes_t{};
+        ptd_sizes.NumDataRows = data_rows;
+        ptd_sizes.NumDataParametersPerRow_EveryCDD = row_parameters;
+        ptd_sizes.NumSmearRows = smear_rows;
+        ptd_sizes.NumOverScanRows = overscan_rows;
+        ptd_sizes.NumSmearParameters_EveryCCD = smear_parameters;
+        ptd_sizes.NumDarkInfoPerRow_EveryCCD = FEE_NUM_CCD * num_dark_columns;
+        ptd_sizes.DataPacketTotalBytes = packet_bytes;
+
+        image_sizes.ImageTotalRows = image_rows;
+        image_sizes.ImageTotalColumns = image_columns;
+        image_sizes.ImageMatrixBytes = image_bytes;
+    }
+};
+
+/* --------------------- */
+/* ---- PTD decoders --- */
+/* --------------------- */
+
+namespace detail
+{
+
+inline std::uint16_t load16(const std::uint8_t *p)
+{
+    return static_cast<std::uint16_t>((p[0] << 8) | p[1]);
+}
+
+inline std::uint32_t load32(const std::uint8_t *p)
+{
+    return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+           (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+}
+
+/*Pointers to a row of the image of every CCD*/
+template <class Geometry>
+inline void row_pointers(fee_PTD_t *ptd, std::size_t row, std::uint16_t *(&rows)[FEE_NUM_CCD])
+{
+    for (std::size_t ccd = 0; ccd < FEE_NUM_CCD; ccd++)
+    {
+        rows[ccd] = ptd->ImageMatrix[ccd] + row * Geometry::image_columns;
+    }
+}
+
+/*Decode the dark info of every CCD at the beginning of a data or over-scan row*/
+template <class Geometry>
+inline const std::uint8_t *decode_dark(const std::uint8_t *p, std::uint16_t *(&rows)[FEE_NUM_CCD])
+{
+    for (std::size_t ccd = 0; ccd < FEE_NUM_CCD; ccd++)
+    {
+        for (std::size_t dark = 0; dark < Geometry::num_dark_columns; dark++, p += 2)
+        {
+            rows[ccd][dark] = load16(p);
+        }
+    }
+
+    return p;
+}
+
+/*Decode the pixels of a row, interleaved by CCD, after the dark columns*/
+template <class Geometry>
+inline const std::uint8_t *decode_pixels(const std::uint8_t *p, std::uint16_t *(&rows)[FEE_NUM_CCD])
+{
+    for (std::size_t pixel = 0; pixel < Geometry::row_pixels; pixel++)
+    {
+        for (std::size_t ccd = 0; ccd < FEE_NUM_CCD; ccd++, p += 2)
+        {
+            rows[ccd][Geometry::num_dark_columns + pixel] = load16(p);
+        }
+    }
+
+    return p;
+}
+
+} // namespace detail
+
+/**
+ * @brief Function that deserializes a PTD packet of a known geometry. Every size and loop bound is a compile-time
+ *  constant. If the TM does not describe Geometry, the packet is decoded by fee_PTD_Read. The output is the same as
+ *  fee_PTD_Read's.
+ *
+ * @tparam Geometry ptd_geometry of the packet.
+ * @param packet [Input] PTD packet.
+ * @param tm [Input] TM information structure.
+ * @param ptd [Output] Deserialized PTD. ImageMatrix must point to, at least, Geometry::image_bytes bytes for each CCD.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+template <class Geometry>
+int decode_ptd(std::uint8_t *packet, const fee_TM_t &tm, fee_PTD_t *ptd)
+{
+    if (!Geometry::matches(tm))
+    {
+        return fee_PTD_Read(packet, tm, ptd);
+    }
+
+    Geometry::sizes(ptd->PTDSizes, ptd->PTDImageMatrixTotalSizes);
+
+    const std::uint8_t *p = packet;
+    std::size_t row = 0;
+
+    ptd->PIXEL_DATA_COUNTER = detail::load32(p);
+    p += sizeof(std::uint32_t);
+
+    for (std::size_t it = 0; it < Geometry::data_rows; it++, row++)
+    {
+        std::uint16_t *rows[FEE_NUM_CCD];
+        detail::row_pointers<Geometry>(ptd, row, rows);
+        p = detail::decode_dark<Geometry>(p, rows);
+        p = detail::decode_pixels<Geometry>(p, rows);
+    }
+
+    /*Smear rows have no dark info*/
+    for (std::size_t it = 0; it < Geometry::smear_rows; it++, row++)
+    {
+        std::uint16_t *rows[FEE_NUM_CCD];
+        detail::row_pointers<Geometry>(ptd, row, rows);
+        for (std::size_t ccd = 0; ccd < FEE_NUM_CCD; ccd++)
+        {
+            for (std::size_t dark = 0; dark < Geometry::num_dark_columns; dark++)
+            {
+                rows[ccd][dark] = 0;
+            }
+        }
+        p = detail::decode_pixels<Geometry>(p, rows);
+    }
+
+    for (std::size_t it = 0; it < Geometry::overscan_rows; it++, row++)
+    {
+        std::uint16_t *rows[FEE_NUM_CCD];
+        detail::row_pointers<Geometry>(ptd, row, rows);
+        p = detail::decode_dark<Geometry>(p, rows);
+        p = detail::decode_pixels<Geometry>(p, rows);
+    }
+
+    for (std::size_t it = 0; it < Geometry::num_voltage_references; it++, p += 2)
+    {
+        ptd->VOLTAGES_REFERENCES[it] = detail::load16(p);
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/**
+ * @brief Function that deserializes a PTD packet of any geometry with the C API.
+ *
+ * @param packet [Input] PTD packet.
+ * @param tm [Input] TM information structure.
+ * @param ptd [Output] Deserialized PTD.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+inline int decode_ptd(std::uint8_t *packet, const fee_TM_t &tm, fee_PTD_t *ptd)
+{
+    return fee_PTD_Read(packet, tm, ptd);
+}
+
+} // namespace fee
+
+#endif
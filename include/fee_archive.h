@@ -0,0 +1,203 @@
+/**
+ * @file fee_archive.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Compressed archive of TM packets. Packets are encoded in blocks: timestamps and TM_COUNTER as
+ *  delta-of-delta, the Returned_TC echo as runs of unchanged echoes, every measurement word as a bit-packed zig-zag
+ *  delta column and valid checksums as a single bit. Blocks decode back into the exact fee_TM_Packet_t bytes, and
+ *  their headers carry the timestamp range, so scans skip blocks without decoding them.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_ARCHIVE_H
+#define FEE_ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup ArchiveConstants
+ * @{
+ */
+
+/*Default number of packets of a block*/
+#define FEE_TM_ARCHIVE_DEFAULT_BLOCK_PACKETS 1024
+
+/*Version of the archive layout. Readers reject archives of other versions*/
+#define FEE_TM_ARCHIVE_VERSION 1
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup ArchiveDataTypes
+ * @{
+ */
+
+/*Archive file being written*/
+typedef struct fee_tm_archive_writer fee_tm_archive_writer_t;
+
+/*Archive file mapped for reading*/
+typedef struct fee_tm_archive_reader fee_tm_archive_reader_t;
+
+/*Header information of an encoded block*/
+typedef struct
+{
+    uint32_t NumPackets;
+    uint64_t FirstTimestamp; /*Lowest timestamp of the block (ms)*/
+    uint64_t LastTimestamp;  /*Highest timestamp of the block (ms)*/
+    size_t BlockBytes;       /*Size of the encoded block, header included*/
+
+} fee_tm_archive_block_info_t;
+
+typedef struct
+{
+    uint64_t NumPackets;
+    uint64_t NumBlocks;
+    uint64_t ArchiveBytes;   /*Size of the archive file*/
+
+} fee_tm_archive_info_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Archive Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that returns the largest size of an encoded block.
+ *
+ * @param NumPackets [Input] Packets of the block.
+ * @return size_t - Bytes that fee_tm_archive_encode_block may write.
+ */
+size_t fee_tm_archive_block_bound(size_t NumPackets);
+
+/**
+ * @brief Function that encodes a block of TM packets. Any byte content is accepted, including wrong checksums.
+ *
+ * @param Timestamps [Input] Timestamps of the packets (ms).
+ * @param Packets [Input] Packets.
+ * @param NumPackets [Input] Number of packets. From 1 to UINT32_MAX.
+ * @param Block [Output] Encoded block.
+ * @param Capacity [Input] Size of Block. fee_tm_archive_block_bound(NumPackets) bytes are always enough.
+ * @param BlockBytes [Output] Size of the encoded block.
+ * @return int - The function returns FEE_EXIT_ERROR if NumPackets is not valid or the block does not fit. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_encode_block(const uint64_t *Timestamps, const fee_TM_Packet_t *Packets, size_t NumPackets,
+                                uint8_t *Block, size_t Capacity, size_t *BlockBytes);
+
+/**
+ * @brief Function that reads the header of an encoded block without decoding it.
+ *
+ * @param Block [Input] Encoded block.
+ * @param Bytes [Input] Available bytes from Block.
+ * @param Info [Output] Header information.
+ * @return int - The function returns FEE_EXIT_ERROR if the header is not valid or the block is longer than Bytes. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_block_info(const uint8_t *Block, size_t Bytes, fee_tm_archive_block_info_t *Info);
+
+/**
+ * @brief Function that decodes a block of TM packets.
+ *
+ * @param Block [Input] Encoded block.
+ * @param Bytes [Input] Available bytes from Block.
+ * @param Timestamps [Output] Timestamps of the packets (ms).
+ * @param Packets [Output] Packets, byte for byte as they were encoded.
+ * @param Capacity [Input] Number of packets that fit in Timestamps and Packets.
+ * @return int - The function returns FEE_EXIT_ERROR if the block is corrupted or has more than Capacity packets. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_decode_block(const uint8_t *Block, size_t Bytes, uint64_t *Timestamps, fee_TM_Packet_t *Packets,
+                                size_t Capacity);
+
+/**
+ * @brief Function that creates an archive file. Existing files are replaced.
+ *
+ * @param Path [Input] Path of the archive.
+ * @param BlockPackets [Input] Packets of every block. 0 selects FEE_TM_ARCHIVE_DEFAULT_BLOCK_PACKETS.
+ * @param Writer [Output] Created writer.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_writer_open(const char *Path, uint32_t BlockPackets, fee_tm_archive_writer_t **Writer);
+
+/**
+ * @brief Function that appends a packet to an archive. It is written when its block is full.
+ *
+ * @param Writer [Input] Writer.
+ * @param Timestamp [Input] Timestamp of the packet (ms).
+ * @param Packet [Input] Packet.
+ * @return int - The function returns FEE_EXIT_ERROR if a block cannot be written. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_append(fee_tm_archive_writer_t *Writer, uint64_t Timestamp, const fee_TM_Packet_t Packet);
+
+/**
+ * @brief Function that writes the last block of an archive and closes it.
+ *
+ * @param Writer [Input] Writer. It may be NULL.
+ * @return int - The function returns FEE_EXIT_ERROR if the archive cannot be written. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_writer_close(fee_tm_archive_writer_t *Writer);
+
+/**
+ * @brief Function that maps an archive file for reading.
+ *
+ * @param Path [Input] Path of the archive.
+ * @param Reader [Output] Opened reader, positioned at the first packet.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs or the file is not an archive. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_reader_open(const char *Path, fee_tm_archive_reader_t **Reader);
+
+/**
+ * @brief Function that unmaps an archive.
+ *
+ * @param Reader [Input] Reader. It may be NULL.
+ */
+void fee_tm_archive_reader_close(fee_tm_archive_reader_t *Reader);
+
+/**
+ * @brief Function that returns the next packet of an archive.
+ *
+ * @param Reader [Input] Reader.
+ * @param Timestamp [Output] Timestamp of the packet (ms).
+ * @param Packet [Output] Packet.
+ * @return int - The function returns FEE_EXIT_ERROR at the end of the archive or if a block is corrupted. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_next(fee_tm_archive_reader_t *Reader, uint64_t *Timestamp, fee_TM_Packet_t Packet);
+
+/**
+ * @brief Function that positions a reader at the first packet at or after a timestamp. Blocks whose timestamps are all
+ *  earlier are skipped from their headers, without decoding them. The packets of the archive must be in timestamp order.
+ *
+ * @param Reader [Input] Reader.
+ * @param Timestamp [Input] Timestamp (ms).
+ * @return int - The function returns FEE_EXIT_ERROR if a block is corrupted. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_seek(fee_tm_archive_reader_t *Reader, uint64_t Timestamp);
+
+/**
+ * @brief Function that counts the packets and blocks of an archive from the block headers.
+ *
+ * @param Reader [Input] Reader.
+ * @param Info [Output] Archive information.
+ * @return int - The function returns FEE_EXIT_ERROR if a block header is corrupted. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_archive_info(const fee_tm_archive_reader_t *Reader, fee_tm_archive_info_t *Info);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,783 @@
+/**
+ * @file fee_async.hpp
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Header-only C++20 coroutine adapter of the fee decoder. fee::decode_stream is an asynchronous generator of
+ *  decoded frames read from a byte source: it suspends while the source waits for packet bytes and decodes every
+ *  frame on an executor, so many channel streams can be multiplexed on a few threads. Errors of a frame are
+ *  returned as fee::frame_result values, whose value() throws fee::frame_error. Requires C++20.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_ASYNC_HPP
+#define FEE_ASYNC_HPP
+
+#if __cplusplus < 202002L || !defined(__cpp_impl_coroutine)
+#error "fee_async.hpp requires C++20 coroutines"
+#endif
+
+#include <algorithm>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fee.hpp>
+
+namespace fee
+{
+
+/* --------------------- */
+/* ---- Errors --------- */
+/* --------------------- */
+
+/*Errors of a decoded frame*/
+enum class frame_errc
+{
+    tm_checksum = 1, /*Wrong TM checksum. It ends the stream, as the length of the PTD is unknown*/
+    tm_decode = 2,   /*fee_TM_Read failed. It ends the stream*/
+    ptd_size = 3,    /*The TM does not describe a valid PTD geometry. It ends the stream*/
+    ptd_checksum = 4,/*Wrong PTD checksum*/
+    ptd_decode = 5,  /*fee_PTD_Read failed*/
+    truncated = 6    /*The source ended inside a packet. It ends the stream*/
+};
+
+/**
+ * @brief Function that returns the name of a frame error.
+ *
+ * @param errc [Input] Error.
+ * @return const char* - Name of the error.
+ */
+inline const char *frame_errc_name(frame_errc errc) noexcept
+{
+    switch (errc)
+    {
+    case frame_errc::tm_checksum:
+        return "wrong TM checksum";
+    case frame_errc::tm_decode:
+        return "TM decode error";
+    case frame_errc::ptd_size:
+        return "wrong PTD geometry";
+    case frame_errc::ptd_checksum:
+        return "wrong PTD checksum";
+    case frame_errc::ptd_decode:
+        return "PTD decode error";
+    case frame_errc::truncated:
+        return "truncated packet";
+    }
+    return "unknown frame error";
+}
+
+/*Exception thrown by frame_result::value() on an error*/
+class frame_error : public std::runtime_error
+{
+public:
+    explicit frame_error(frame_errc errc) : std::runtime_error(frame_errc_name(errc)), errc_(errc) {}
+
+    frame_errc code() const noexcept { return errc_; }
+
+private:
+    frame_errc errc_;
+};
+
+/* --------------------- */
+/* ---- Frames --------- */
+/* --------------------- */
+
+/*Decoded frame. ptd.ImageMatrix points into planes, so frames can be moved but not copied*/
+struct frame
+{
+    fee_TM_t tm{};
+    fee_PTD_t ptd{};
+    std::vector<std::uint16_t> planes;
+
+    frame() = default;
+    frame(frame &&) noexcept = default;
+    frame &operator=(frame &&) noexcept = default;
+    frame(const frame &) = delete;
+    frame &operator=(const frame &) = delete;
+};
+
+/*Decoded frame or the error that prevented its decode*/
+class frame_result
+{
+public:
+    frame_result(frame &&decoded) : frame_(std::move(decoded)) {}
+    frame_result(frame_errc errc) : errc_(errc) {}
+
+    bool has_value() const noexcept { return frame_.has_value(); }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    /*Error of the frame. Only meaningful if has_value() is false*/
+    frame_errc error() const noexcept { return errc_; }
+
+    frame &value() &
+    {
+        if (!frame_)
+        {
+            throw frame_error(errc_);
+        }
+        return *frame_;
+    }
+
+    frame &&value() &&
+    {
+        return std::move(value());
+    }
+
+private:
+    std::optional<frame> frame_;
+    frame_errc errc_{};
+};
+
+/* --------------------- */
+/* ---- Coroutines ----- */
+/* --------------------- */
+
+template <class T = void>
+class task;
+
+namespace detail
+{
+
+/*Resumes the awaiting coroutine when a task or generator finishes*/
+template <class Promise>
+struct final_awaiter
+{
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        std::coroutine_handle<> continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct task_promise_base
+{
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+};
+
+template <class T>
+struct task_promise : task_promise_base
+{
+    std::optional<T> value;
+
+    task<T> get_return_object() noexcept;
+    final_awaiter<task_promise> final_suspend() const noexcept { return {}; }
+
+    template <class U>
+    void return_value(U &&result)
+    {
+        value.emplace(std::forward<U>(result));
+    }
+};
+
+template <>
+struct task_promise<void> : task_promise_base
+{
+    task<void> get_return_object() noexcept;
+    final_awaiter<task_promise> final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+};
+
+/*Coroutine started at once and never awaited. It must not throw*/
+struct detached
+{
+    struct promise_type
+    {
+        detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/*Lazy coroutine. It starts when it is awaited and resumes the awaiting coroutine when it finishes*/
+template <class T>
+class task
+{
+public:
+    using promise_type = detail::task_promise<T>;
+
+    task(task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+            {
+                handle.promise().continuation = continuation;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                if (handle.promise().exception)
+                {
+                    std::rethrow_exception(handle.promise().exception);
+                }
+                if constexpr (!std::is_void_v<T>)
+                {
+                    return std::move(*handle.promise().value);
+                }
+            }
+        };
+        return awaiter{handle_};
+    }
+
+private:
+    friend promise_type;
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail
+{
+
+template <class T>
+task<T> task_promise<T>::get_return_object() noexcept
+{
+    return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept
+{
+    return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+template <class T, class State>
+detached sync_wait_driver(task<T> &work, State &state)
+{
+    try
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await std::move(work);
+        }
+        else
+        {
+            state.value.emplace(co_await std::move(work));
+        }
+    }
+    catch (...)
+    {
+        state.exception = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.done = true;
+    state.cv.notify_one();
+}
+
+} // namespace detail
+
+/**
+ * @brief Function that runs a task and blocks the calling thread until it finishes, wherever the task resumes.
+ *
+ * @tparam T Result of the task.
+ * @param work [Input] Task.
+ * @return T - Result of the task. Its exception, if any, is rethrown.
+ */
+template <class T>
+T sync_wait(task<T> work)
+{
+    struct state
+    {
+        std::mutex lock;
+        std::condition_variable cv;
+        bool done = false;
+        std::exception_ptr exception;
+        std::optional<std::conditional_t<std::is_void_v<T>, char, T>> value;
+    } wait_state;
+
+    detail::sync_wait_driver(work, wait_state);
+
+    std::unique_lock<std::mutex> guard(wait_state.lock);
+    wait_state.cv.wait(guard, [&] { return wait_state.done; });
+
+    if (wait_state.exception)
+    {
+        std::rethrow_exception(wait_state.exception);
+    }
+    if constexpr (!std::is_void_v<T>)
+    {
+        return std::move(*wait_state.value);
+    }
+}
+
+/**
+ * Asynchronous generator. Every co_await next() resumes the generator until its next co_yield and returns the
+ * yielded value, or std::nullopt when the generator has finished. An exception of the generator is rethrown by next().
+ */
+template <class T>
+class async_generator
+{
+public:
+    struct promise_type
+    {
+        std::optional<T> current;
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        async_generator get_return_object() noexcept
+        {
+            return async_generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        detail::final_awaiter<promise_type> final_suspend() const noexcept { return {}; }
+        detail::final_awaiter<promise_type> yield_value(T value)
+        {
+            current.emplace(std::move(value));
+            return {};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    async_generator(async_generator &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    async_generator &operator=(async_generator &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~async_generator()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    auto next() noexcept
+    {
+        struct awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+            {
+                handle.promise().continuation = continuation;
+                return handle;
+            }
+
+            std::optional<T> await_resume()
+            {
+                if (handle.promise().exception)
+                {
+                    std::rethrow_exception(std::exchange(handle.promise().exception, {}));
+                }
+                std::optional<T> value = std::move(handle.promise().current);
+                handle.promise().current.reset();
+                return value;
+            }
+        };
+        return awaiter{handle_};
+    }
+
+private:
+    explicit async_generator(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/* --------------------- */
+/* ---- Executors ------ */
+/* --------------------- */
+
+/*Executor of a decode stream: co_await schedule() resumes the coroutine on one of its threads*/
+template <class E>
+concept executor = requires(E &e) { e.schedule(); };
+
+/*Executor that decodes on the thread that resumed the stream*/
+class inline_executor
+{
+public:
+    std::suspend_never schedule() const noexcept { return {}; }
+};
+
+/*Executor with a fixed number of threads and a FIFO queue of coroutines*/
+class thread_executor
+{
+public:
+    explicit thread_executor(std::size_t num_threads = std::thread::hardware_concurrency())
+    {
+        num_threads = std::max<std::size_t>(num_threads, 1);
+        for (std::size_t it = 0; it < num_threads; it++)
+        {
+            threads_.emplace_back([this] { run(); });
+        }
+    }
+
+    /*Queued coroutines are resumed before the threads stop*/
+    ~thread_executor()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    thread_executor(const thread_executor &) = delete;
+    thread_executor &operator=(const thread_executor &) = delete;
+
+    auto schedule() noexcept
+    {
+        struct awaiter
+        {
+            thread_executor *executor;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor->post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{this};
+    }
+
+    void post(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            queue_.push_back(handle);
+        }
+        cv_.notify_one();
+    }
+
+    std::size_t size() const noexcept { return threads_.size(); }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> guard(lock_);
+        for (;;)
+        {
+            cv_.wait(guard, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty())
+            {
+                return;
+            }
+            std::coroutine_handle<> handle = queue_.front();
+            queue_.pop_front();
+            guard.unlock();
+            handle.resume();
+            guard.lock();
+        }
+    }
+
+    std::mutex lock_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> queue_;
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+/* --------------------- */
+/* ---- Sources -------- */
+/* --------------------- */
+
+/**
+ * Byte source of a decode stream: co_await read(Buffer, Bytes) suspends until Bytes bytes have been copied to
+ * Buffer or the source has ended, and returns the number of copied bytes.
+ */
+template <class S>
+concept byte_source = requires(S &s, std::uint8_t *buffer, std::size_t bytes) {
+    { s.read(buffer, bytes).await_resume() } -> std::convertible_to<std::size_t>;
+};
+
+/*Source over bytes already in memory. It never suspends*/
+class memory_source
+{
+public:
+    memory_source(const std::uint8_t *data, std::size_t bytes) noexcept : data_(data), bytes_(bytes) {}
+
+    auto read(std::uint8_t *buffer, std::size_t bytes) noexcept
+    {
+        struct awaiter
+        {
+            std::size_t copied;
+
+            bool await_ready() const noexcept { return true; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            std::size_t await_resume() const noexcept { return copied; }
+        };
+        std::size_t copied = std::min(bytes, bytes_ - offset_);
+        std::memcpy(buffer, data_ + offset_, copied);
+        offset_ += copied;
+        return awaiter{copied};
+    }
+
+private:
+    const std::uint8_t *data_;
+    std::size_t bytes_;
+    std::size_t offset_ = 0;
+};
+
+/**
+ * Source fed by another thread (e.g. a socket or capture reader). push() and close() may be called from any
+ * thread; the waiting reader is resumed on the thread that completes its read. It has a single reader.
+ */
+class channel_source
+{
+    struct read_awaiter;
+
+public:
+    void push(const std::uint8_t *data, std::size_t bytes)
+    {
+        std::unique_lock<std::mutex> guard(lock_);
+        buffer_.insert(buffer_.end(), data, data + bytes);
+        resume_reader(guard);
+    }
+
+    /*No more bytes will be pushed. The pending read returns the remaining bytes*/
+    void close()
+    {
+        std::unique_lock<std::mutex> guard(lock_);
+        closed_ = true;
+        resume_reader(guard);
+    }
+
+    read_awaiter read(std::uint8_t *buffer, std::size_t bytes) noexcept { return read_awaiter{this, buffer, bytes, 0, {}}; }
+
+private:
+    struct read_awaiter
+    {
+        channel_source *channel;
+        std::uint8_t *buffer;
+        std::size_t bytes;
+        std::size_t copied;
+        std::coroutine_handle<> handle;
+
+        bool await_ready() noexcept
+        {
+            std::lock_guard<std::mutex> guard(channel->lock_);
+            return channel->try_read(*this);
+        }
+
+        bool await_suspend(std::coroutine_handle<> reader) noexcept
+        {
+            std::lock_guard<std::mutex> guard(channel->lock_);
+            if (channel->try_read(*this))
+            {
+                return false;
+            }
+            handle = reader;
+            channel->reader_ = this;
+            return true;
+        }
+
+        std::size_t await_resume() const noexcept { return copied; }
+    };
+
+    /*Complete a read if there are enough bytes or the source has ended. The lock must be held*/
+    bool try_read(read_awaiter &read) noexcept
+    {
+        std::size_t available = buffer_.size() - head_;
+        if (available < read.bytes && !closed_)
+        {
+            return false;
+        }
+        read.copied = std::min(read.bytes, available);
+        std::memcpy(read.buffer, buffer_.data() + head_, read.copied);
+        head_ += read.copied;
+        if (head_ == buffer_.size())
+        {
+            buffer_.clear();
+            head_ = 0;
+        }
+        return true;
+    }
+
+    void resume_reader(std::unique_lock<std::mutex> &guard)
+    {
+        if (reader_ == nullptr || !try_read(*reader_))
+        {
+            return;
+        }
+        std::coroutine_handle<> handle = std::exchange(reader_, nullptr)->handle;
+        guard.unlock();
+        handle.resume();
+    }
+
+    std::mutex lock_;
+    std::vector<std::uint8_t> buffer_;
+    std::size_t head_ = 0;
+    bool closed_ = false;
+    read_awaiter *reader_ = nullptr;
+};
+
+/* --------------------- */
+/* ---- Decode stream -- */
+/* --------------------- */
+
+/*Options of a decode stream*/
+struct decode_options
+{
+    bool check_checksum = true; /*Verify the TM and PTD checksums*/
+    /*Decoder of the TM packets. A failure is yielded as frame_errc::tm_decode and ends the stream*/
+    int (*tm_decoder)(std::uint8_t *packet, fee_TM_t *tm) = fee_TM_Read;
+    /*Decoder of the PTD packets, e.g. an instrumented one. nullptr uses fee::decode_ptd<Geometry>. A failure is
+      yielded as frame_errc::ptd_decode and the stream goes on*/
+    int (*ptd_decoder)(std::uint8_t *packet, const fee_TM_t &tm, fee_PTD_t *ptd) = nullptr;
+};
+
+/**
+ * @brief Function that returns an asynchronous generator of the frames of a byte source. Every frame is a TM packet
+ *  followed by the PTD packet it describes. The generator suspends while the source waits for bytes, and the PTD
+ *  is checked and decoded after resuming on the executor (so the awaiting coroutine continues there). Errors of
+ *  a PTD are yielded as frame_result errors and the stream goes on; TM and truncation errors are yielded and end
+ *  the stream, as the next packet cannot be found. Exceptions of the source end the stream and are rethrown by next().
+ *
+ * @tparam Geometry ptd_geometry of fee::decode_ptd<Geometry>. void decodes any geometry with fee_PTD_Read.
+ * @param source [Input] Byte source. It must outlive the generator.
+ * @param exec [Input] Executor of the decode. It must outlive the generator.
+ * @param options [Input] Options.
+ * @return async_generator<frame_result> - Generator of decoded frames.
+ */
+template <class Geometry = void, byte_source Source, executor Executor>
+async_generator<frame_result> decode_stream(Source &source, Executor &exec, decode_options options = {})
+{
+    fee_TM_Packet_t tm_packet;
+    std::vector<std::uint8_t> ptd_packet;
+
+    for (;;)
+    {
+        std::size_t copied = co_await source.read(tm_packet, TM_PACKET_BYTES);
+        if (copied == 0)
+        {
+            co_return;
+        }
+        if (copied < TM_PACKET_BYTES)
+        {
+            co_yield frame_result(frame_errc::truncated);
+            co_return;
+        }
+
+        frame decoded;
+        fee_ImageMatrixTotalSizes_t &image_sizes = decoded.ptd.PTDImageMatrixTotalSizes;
+
+        if (options.check_checksum && fee_CheckTelemetryChecksum(tm_packet) != FEE_EXIT_SUCCESS)
+        {
+            co_yield frame_result(frame_errc::tm_checksum);
+            co_return;
+        }
+        if (options.tm_decoder(tm_packet, &decoded.tm) != FEE_EXIT_SUCCESS)
+        {
+            co_yield frame_result(frame_errc::tm_decode);
+            co_return;
+        }
+        if (fee_Calculate_PTD_Sizes(decoded.tm, &decoded.ptd.PTDSizes, &image_sizes) != FEE_EXIT_SUCCESS ||
+            decoded.ptd.PTDSizes.DataPacketTotalBytes < sizeof(std::uint16_t))
+        {
+            co_yield frame_result(frame_errc::ptd_size);
+            co_return;
+        }
+
+        ptd_packet.resize(decoded.ptd.PTDSizes.DataPacketTotalBytes);
+        if (co_await source.read(ptd_packet.data(), ptd_packet.size()) < ptd_packet.size())
+        {
+            co_yield frame_result(frame_errc::truncated);
+            co_return;
+        }
+
+        co_await exec.schedule();
+
+        if (options.check_checksum && fee_CheckPTDChecksum(ptd_packet.data(), decoded.ptd.PTDSizes) != FEE_EXIT_SUCCESS)
+        {
+            co_yield frame_result(frame_errc::ptd_checksum);
+            continue;
+        }
+
+        std::size_t plane_words = (image_sizes.ImageMatrixBytes + 1) / sizeof(std::uint16_t);
+        decoded.planes.resize(FEE_NUM_CCD * plane_words);
+        for (std::size_t ccd = 0; ccd < FEE_NUM_CCD; ccd++)
+        {
+            decoded.ptd.ImageMatrix[ccd] = decoded.planes.data() + ccd * plane_words;
+        }
+
+        int status;
+        if (options.ptd_decoder != nullptr)
+        {
+            status = options.ptd_decoder(ptd_packet.data(), decoded.tm, &decoded.ptd);
+        }
+        else if constexpr (std::is_void_v<Geometry>)
+        {
+            status = decode_ptd(ptd_packet.data(), decoded.tm, &decoded.ptd);
+        }
+        else
+        {
+            status = decode_ptd<Geometry>(ptd_packet.data(), decoded.tm, &decoded.ptd);
+        }
+        if (status != FEE_EXIT_SUCCESS)
+        {
+            co_yield frame_result(frame_errc::ptd_decode);
+            continue;
+        }
+
+        co_yield frame_result(std::move(decoded));
+    }
+}
+
+} // namespace fee
+
+#endif
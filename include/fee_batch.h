@@ -0,0 +1,153 @@
+/**
+ * @file fee_batch.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Parallel batch decode of fee electronics packets. Arrays of packet descriptors (fee_pipeline.h) are split in
+ *  chunks that run on a work-stealing thread pool, either the built-in one or a caller-supplied executor. Results
+ *  are stored in the descriptors, so they keep the input order.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_BATCH_H
+#define FEE_BATCH_H
+
+#include <fee.h>
+#include <fee_pipeline.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup BatchConstants
+ * @{
+ */
+
+/*Default number of descriptors of a task*/
+#define FEE_BATCH_DEFAULT_CHUNK 16
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup BatchDataTypes
+ * @{
+ */
+
+/*Work-stealing thread pool. The thread that runs a job is one of its workers*/
+typedef struct fee_thread_pool fee_thread_pool_t;
+
+/*Task of a job. It is called once for every index from 0 to NumTasks - 1, from any worker*/
+typedef void (*fee_task_fn)(void *TaskData, size_t TaskIndex);
+
+/**
+ * Caller-supplied executor. It must call Task for every index from 0 to NumTasks - 1 and return when all the calls
+ * have finished. It returns FEE_EXIT_SUCCESS or FEE_EXIT_ERROR.
+ */
+typedef int (*fee_executor_fn)(void *ExecutorData, size_t NumTasks, fee_task_fn Task, void *TaskData);
+
+typedef struct
+{
+    fee_thread_pool_t *Pool;       /*Built-in pool. NULL selects the default pool (fee_thread_pool_default)*/
+    fee_executor_fn Executor;      /*Caller-supplied executor. If it is not NULL, Pool is not used*/
+    void *ExecutorData;            /*Data passed to Executor*/
+    fee_buffer_pool_t *ImagePool;  /*Pool of the image planes of the PTD descriptors whose PTD.ImageMatrix[0] is NULL.
+                                     Every buffer holds the planes of every CCD. It is only accessed by the calling thread*/
+    size_t ChunkSize;              /*Descriptors of a task. 0 selects FEE_BATCH_DEFAULT_CHUNK*/
+    int CheckChecksum;             /*Verify the checksum of every packet before decoding it*/
+
+} fee_batch_config_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Batch Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that creates a work-stealing thread pool. Every worker owns a range of the task indexes of a job
+ *  and steals half of the range of another worker when its own range is empty.
+ *
+ * @param NumWorkers [Input] Number of workers, including the thread that runs a job. 0 selects the number of online CPUs.
+ * @param Pool [Output] Created pool.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_thread_pool_create(size_t NumWorkers, fee_thread_pool_t **Pool);
+
+/**
+ * @brief Function that stops the threads of a pool and releases it. No job may be running.
+ *
+ * @param Pool [Input] Pool to be released. It may be NULL.
+ */
+void fee_thread_pool_destroy(fee_thread_pool_t *Pool);
+
+/**
+ * @brief Function that returns the pool used when a configuration has neither a pool nor an executor. It is created
+ *  on the first call with one worker per online CPU and lives until the process exits.
+ *
+ * @return fee_thread_pool_t* - Default pool. NULL if it cannot be created.
+ */
+fee_thread_pool_t *fee_thread_pool_default(void);
+
+/**
+ * @brief Function that returns the number of workers of a pool.
+ *
+ * @param Pool [Input] Pool.
+ * @return size_t - Number of workers.
+ */
+size_t fee_thread_pool_size(const fee_thread_pool_t *Pool);
+
+/**
+ * @brief Function that runs a job on a pool and waits for it. The calling thread works on the job too. Jobs of
+ *  different threads on the same pool run one after the other. A task can not run a job (e.g. a batch decode) on the
+ *  pool it belongs to, as it would wait for its own job; tasks that run jobs on other pools must not form a cycle.
+ *
+ * @param Pool [Input] Pool.
+ * @param NumTasks [Input] Number of tasks of the job. At most UINT32_MAX.
+ * @param Task [Input] Task function.
+ * @param TaskData [Input] Data passed to Task.
+ * @return int - The function returns FEE_EXIT_ERROR if any argument is not valid or it is called from a task of a job
+ *  of the same pool. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_thread_pool_run(fee_thread_pool_t *Pool, size_t NumTasks, fee_task_fn Task, void *TaskData);
+
+/**
+ * @brief Function that decodes an array of PTD descriptors in parallel. Every descriptor needs Packet, PacketBytes
+ *  and TM, and its planes in PTD.ImageMatrix or a free buffer in Config->ImagePool (recorded in ImageBufferIndex,
+ *  to be released by the caller). Desc->Status is FEE_EXIT_ERROR if the packet is shorter than its geometry, the
+ *  checksum is wrong, no image buffer is available or fee_PTD_Read fails. Descriptors whose Status is already
+ *  FEE_EXIT_ERROR are skipped.
+ *
+ * @param Descs [Input/Output] Descriptors of type FEE_PACKET_PTD.
+ * @param NumDescs [Input] Number of descriptors.
+ * @param Config [Input] Configuration. NULL selects the default pool without image pool or checksum verification.
+ * @return int - The function returns FEE_EXIT_ERROR if any descriptor fails or the job cannot be run. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_PTD_ReadBatch(fee_packet_desc_t *Descs, size_t NumDescs, const fee_batch_config_t *Config);
+
+/**
+ * @brief Function that decodes an array of TM descriptors in parallel into Desc->TM. Desc->Status is FEE_EXIT_ERROR
+ *  if the packet is shorter than TM_PACKET_BYTES, the checksum is wrong or fee_TM_Read fails. Descriptors whose
+ *  Status is already FEE_EXIT_ERROR are skipped.
+ *
+ * @param Descs [Input/Output] Descriptors of type FEE_PACKET_TM.
+ * @param NumDescs [Input] Number of descriptors.
+ * @param Config [Input] Configuration. NULL selects the default pool without checksum verification.
+ * @return int - The function returns FEE_EXIT_ERROR if any descriptor fails or the job cannot be run. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_TM_ReadBatch(fee_packet_desc_t *Descs, size_t NumDescs, const fee_batch_config_t *Config);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,301 @@
+/**
+ * @file fee_capture.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Capture files of fee electronics packets ("_Analysis.txt" ASCII layout: "Timestamp - Bytes" for TC and TM
+ *  lines, "Timestamp - Size Bytes" for PTD lines). Captures are mapped in memory and iterated packet by packet, and
+ *  a persistent timestamp index (timestamp to byte offset every Stride packets, with the packet type and PTD size)
+ *  is built once per file and reused, so that seeking a time in a large capture is a binary search. Whole captures
+ *  are parsed and decoded in parallel by splitting them in newline-aligned byte ranges.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_CAPTURE_H
+#define FEE_CAPTURE_H
+
+#include <stdint.h>
+#include <fee.h>
+#include <fee_pipeline.h>
+#include <fee_batch.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup CaptureConstants
+ * @{
+ */
+
+/*Default number of packets between index entries*/
+#define FEE_CAPTURE_DEFAULT_STRIDE 64
+
+/*Extension appended to the capture file name to get the default index file name*/
+#define FEE_CAPTURE_INDEX_EXTENSION ".idx"
+
+/*Version of the index file layout. Index files of other versions are rebuilt*/
+#define FEE_CAPTURE_INDEX_VERSION 1
+
+/*Default size of the byte ranges parsed by a task of fee_capture_read_parallel*/
+#define FEE_CAPTURE_DEFAULT_RANGE_BYTES (1024 * 1024)
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup CaptureDataTypes
+ * @{
+ */
+
+/*Type of a capture line, told by its number of fields*/
+typedef enum
+{
+    FEE_CAPTURE_TC = 0,     /*TC_PACKET_BYTES bytes*/
+    FEE_CAPTURE_TM = 1,     /*TM_PACKET_BYTES bytes*/
+    FEE_CAPTURE_PTD = 2,    /*Size followed by Size bytes*/
+    FEE_CAPTURE_UNKNOWN = 3 /*Line that cannot be parsed*/
+
+} fee_capture_type_t;
+
+/*Capture file mapped in memory*/
+typedef struct fee_capture fee_capture_t;
+
+/*Packet of a capture*/
+typedef struct
+{
+    uint64_t Timestamp;      /*Timestamp of the line (ms)*/
+    fee_capture_type_t Type; /*Type of the line*/
+    uint64_t Offset;         /*Byte offset of the line in the capture*/
+    uint64_t PacketIndex;    /*Index of the line in the capture. Empty lines are not counted*/
+    const uint8_t *Bytes;    /*Packet bytes. They belong to the iterator and change with the next packet*/
+    size_t NumBytes;         /*Number of bytes of the packet*/
+    uint32_t PTDBytes;       /*PTD: size of the packet. TM: DataPacketTotalBytes of the PTD it describes (0 if it is not
+                               valid, fee_Calculate_PTD_Sizes). Otherwise 0*/
+} fee_capture_packet_t;
+
+/*Iterator over the lines of a capture. It is a plain structure so that it lives on the stack*/
+typedef struct
+{
+    const fee_capture_t *Capture;
+    uint64_t Offset;       /*Offset of the next line*/
+    uint64_t EndOffset;    /*The iteration ends at this offset*/
+    uint64_t FirstTime;    /*Packets before this timestamp are skipped*/
+    uint64_t LastTime;     /*Packets after this timestamp are skipped*/
+    int Sorted;            /*Timestamps are in order: the iteration ends at the first packet after LastTime*/
+    uint64_t PacketIndex;  /*Index of the next packet*/
+    uint8_t *Buffer;       /*Bytes of the current packet*/
+    size_t BufferBytes;    /*Capacity of Buffer*/
+
+} fee_capture_iter_t;
+
+/*Entry of an index. Entry i describes the packet i * Stride*/
+typedef struct
+{
+    uint64_t Timestamp;
+    uint64_t Offset;
+    uint64_t PacketIndex;
+    uint32_t PTDBytes;
+    uint32_t Type;
+
+} fee_capture_index_entry_t;
+
+/*Timestamp index of a capture, mapped from its index file*/
+typedef struct fee_capture_index fee_capture_index_t;
+
+/*Decoded packet of fee_capture_read_parallel*/
+typedef struct
+{
+    uint64_t Timestamp;      /*Timestamp of the line (ms)*/
+    uint32_t CaptureIndex;   /*Capture of the line, as an index of the Captures array*/
+    uint64_t Offset;         /*Byte offset of the line in its capture*/
+    fee_packet_desc_t Desc;  /*Packet, decoded TM or PTD and Status. The TM of a PTD is the last TM before it*/
+
+} fee_capture_record_t;
+
+/*Result of fee_capture_read_parallel. It must be released with fee_capture_records_free*/
+typedef struct
+{
+    fee_capture_record_t *Records; /*Records in timestamp order. Equal timestamps keep the order of the captures and lines*/
+    size_t NumRecords;
+    size_t NumErrors;              /*Records whose Desc.Status is FEE_EXIT_ERROR*/
+    size_t NumSkipped;             /*TC lines and lines that cannot be parsed*/
+    void *Storage;                 /*Packet bytes of the records*/
+
+} fee_capture_records_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Capture Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that maps a capture file in memory.
+ *
+ * @param Path [Input] Path of the capture.
+ * @param Capture [Output] Opened capture.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_capture_open(const char *Path, fee_capture_t **Capture);
+
+/**
+ * @brief Function that unmaps a capture.
+ *
+ * @param Capture [Input] Capture to be closed. It may be NULL.
+ */
+void fee_capture_close(fee_capture_t *Capture);
+
+/**
+ * @brief Function that returns the mapped bytes of a capture.
+ *
+ * @param Capture [Input] Capture.
+ * @param NumBytes [Output] Size of the capture in bytes.
+ * @return const char* - Contents of the capture.
+ */
+const char *fee_capture_data(const fee_capture_t *Capture, uint64_t *NumBytes);
+
+/**
+ * @brief Function that parses a capture line. It is the tokenizer used by the iterators.
+ *
+ * @param Line [Input] Line, without its end of line.
+ * @param Length [Input] Characters of the line.
+ * @param Packet [Output] Timestamp, Type, NumBytes and PTDBytes of the line.
+ * @param Bytes [Output] Packet bytes. (Length + 1) / 2 bytes are always enough.
+ * @param Capacity [Input] Size of Bytes. Longer packets are reported as FEE_CAPTURE_UNKNOWN.
+ * @return int - The function returns FEE_EXIT_ERROR if the line cannot be parsed (Type is FEE_CAPTURE_UNKNOWN). Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_capture_parse_line(const char *Line, size_t Length, fee_capture_packet_t *Packet, uint8_t *Bytes, size_t Capacity);
+
+/**
+ * @brief Function that starts an iteration over the lines between two offsets. Packet indexes are counted from Offset.
+ *
+ * @param Capture [Input] Capture.
+ * @param Offset [Input] Offset of the first line. It must be the beginning of a line.
+ * @param EndOffset [Input] Offset where the iteration ends. UINT64_MAX selects the end of the capture.
+ * @param Iter [Output] Iterator. It must be released with fee_capture_iter_free.
+ */
+void fee_capture_iter_init(const fee_capture_t *Capture, uint64_t Offset, uint64_t EndOffset, fee_capture_iter_t *Iter);
+
+/**
+ * @brief Function that returns the next line of an iteration. Lines that cannot be parsed are returned as
+ *  FEE_CAPTURE_UNKNOWN; empty lines are skipped.
+ *
+ * @param Iter [Input] Iterator.
+ * @param Packet [Output] Next packet.
+ * @return int - The function returns FEE_EXIT_ERROR at the end of the iteration. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_capture_next(fee_capture_iter_t *Iter, fee_capture_packet_t *Packet);
+
+/**
+ * @brief Function that releases the buffer of an iterator.
+ *
+ * @param Iter [Input] Iterator.
+ */
+void fee_capture_iter_free(fee_capture_iter_t *Iter);
+
+/**
+ * @brief Function that opens the index of a capture. If the index file is missing, has another version or was built
+ *  for another size or modification time of the capture, it is built and written first.
+ *
+ * @param Capture [Input] Capture.
+ * @param IndexPath [Input] Path of the index file. NULL appends FEE_CAPTURE_INDEX_EXTENSION to the capture path.
+ * @param Stride [Input] Packets between entries of a new index. 0 selects FEE_CAPTURE_DEFAULT_STRIDE. An existing
+ *  valid index is reused with its own stride.
+ * @param Index [Output] Opened index.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_capture_index_open(const fee_capture_t *Capture, const char *IndexPath, uint32_t Stride, fee_capture_index_t **Index);
+
+/**
+ * @brief Function that writes the index of a capture, replacing the index file.
+ *
+ * @param Capture [Input] Capture.
+ * @param IndexPath [Input] Path of the index file. NULL appends FEE_CAPTURE_INDEX_EXTENSION to the capture path.
+ * @param Stride [Input] Packets between entries. 0 selects FEE_CAPTURE_DEFAULT_STRIDE.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_capture_index_build(const fee_capture_t *Capture, const char *IndexPath, uint32_t Stride);
+
+/**
+ * @brief Function that unmaps an index.
+ *
+ * @param Index [Input] Index to be closed. It may be NULL.
+ */
+void fee_capture_index_close(fee_capture_index_t *Index);
+
+/**
+ * @brief Function that returns the entries of an index.
+ *
+ * @param Index [Input] Index.
+ * @param NumEntries [Output] Number of entries.
+ * @param Stride [Output] Packets between entries. It may be NULL.
+ * @param NumPackets [Output] Lines of the capture. It may be NULL.
+ * @return const fee_capture_index_entry_t* - Entries, in file order.
+ */
+const fee_capture_index_entry_t *fee_capture_index_entries(const fee_capture_index_t *Index, uint64_t *NumEntries,
+                                                           uint32_t *Stride, uint64_t *NumPackets);
+
+/**
+ * @brief Function that finds where to start reading to reach the first packet at or after a timestamp: the offset
+ *  of the last entry before it, so that at most Stride packets are scanned. If the timestamps of the capture are not
+ *  in order, the offset is the beginning of the capture.
+ *
+ * @param Index [Input] Index.
+ * @param Timestamp [Input] Timestamp (ms).
+ * @param Offset [Output] Offset of a line at or before the first packet at or after Timestamp.
+ * @param PacketIndex [Output] Index of the packet of Offset. It may be NULL.
+ */
+void fee_capture_index_seek(const fee_capture_index_t *Index, uint64_t Timestamp, uint64_t *Offset, uint64_t *PacketIndex);
+
+/**
+ * @brief Function that starts an iteration over the packets with a timestamp between First and Last, both included.
+ *
+ * @param Index [Input] Index of the capture.
+ * @param Capture [Input] Capture.
+ * @param First [Input] First timestamp (ms).
+ * @param Last [Input] Last timestamp (ms).
+ * @param Iter [Output] Iterator. It must be released with fee_capture_iter_free.
+ */
+void fee_capture_index_range(const fee_capture_index_t *Index, const fee_capture_t *Capture, uint64_t First, uint64_t Last,
+                             fee_capture_iter_t *Iter);
+
+/**
+ * @brief Function that parses and decodes whole captures in parallel. Every capture is split in byte ranges aligned
+ *  to line boundaries; every range is parsed, and its TM packets decoded with fee_TM_Read, by a task of the pool.
+ *  The records of every range are merged in timestamp order, every PTD takes the TM of the last TM record before it
+ *  (the TM capture must be listed before the PTD capture, as both lines have the same timestamp), and the PTD
+ *  packets are decoded with fee_PTD_Read by another parallel job. Decode errors are reported in the records.
+ *
+ * @param Captures [Input] Captures, e.g. the TM and PTD captures of a session, or of a whole day.
+ * @param NumCaptures [Input] Number of captures.
+ * @param RangeBytes [Input] Size of the byte ranges. 0 selects FEE_CAPTURE_DEFAULT_RANGE_BYTES.
+ * @param Config [Input] Pool or executor, ChunkSize of the PTD decode tasks and checksum verification. ImagePool is
+ *  not used: the planes of every PTD record are reserved for it. NULL selects the default pool without checksum
+ *  verification.
+ * @param Records [Output] Decoded records.
+ * @return int - The function returns FEE_EXIT_ERROR if there is no memory or the jobs cannot be run. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_capture_read_parallel(fee_capture_t *const *Captures, size_t NumCaptures, uint64_t RangeBytes,
+                              const fee_batch_config_t *Config, fee_capture_records_t *Records);
+
+/**
+ * @brief Function that releases the records of fee_capture_read_parallel, their packets and their PTD planes.
+ *
+ * @param Records [Input] Records.
+ */
+void fee_capture_records_free(fee_capture_records_t *Records);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file fee_dispatch.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Runtime CPU-feature dispatch of the optimized kernels of the fee library. The instruction set tier of the
+ *  host (scalar, SSE4.2, AVX2 or AVX-512) is detected once and every kernel uses its best variant up to that tier,
+ *  so the same shared library runs on older and newer hosts. The environment variable FEE_CPU_TIER ("scalar",
+ *  "sse4.2", "avx2" or "avx512") lowers the tier for benchmarking.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_DISPATCH_H
+#define FEE_DISPATCH_H
+
+#include <stdio.h>
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup DispatchConstants
+ * @{
+ */
+
+/*Environment variable that limits the selected tier*/
+#define FEE_CPU_TIER_ENV "FEE_CPU_TIER"
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup DispatchDataTypes
+ * @{
+ */
+
+/*Instruction set tiers, from the lowest to the highest*/
+typedef enum
+{
+    FEE_CPU_TIER_SCALAR = 0, /*Portable C*/
+    FEE_CPU_TIER_SSE42 = 1,  /*SSE4.2 (SSSE3 shuffles)*/
+    FEE_CPU_TIER_AVX2 = 2,   /*AVX2*/
+    FEE_CPU_TIER_AVX512 = 3, /*AVX-512 F and BW*/
+    FEE_CPU_NUM_TIERS = 4
+
+} fee_cpu_tier_t;
+
+/*Dispatched kernels*/
+typedef enum
+{
+    FEE_KERNEL_CHECKSUM8 = 0,  /*8 bits xor checksum of the TC packets*/
+    FEE_KERNEL_CHECKSUM16 = 1, /*16 bits xor checksum of the TM and PTD packets*/
+    FEE_KERNEL_PTD_UNPACK = 2, /*Byte swap and deinterleave of the pixels of a PTD row (fee_PTD_Read)*/
+    FEE_KERNEL_PTD_PACK = 3,   /*Interleave and byte swap of the pixels of a PTD row (fee_PTD_Write)*/
+    FEE_KERNEL_LIMITS = 4,     /*Limit levels of converted telemetry values (fee_limits)*/
+    FEE_NUM_KERNELS = 5
+
+} fee_kernel_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Dispatch Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that returns the highest tier supported by the host.
+ *
+ * @return fee_cpu_tier_t - Detected tier.
+ */
+fee_cpu_tier_t fee_dispatch_detected_tier(void);
+
+/**
+ * @brief Function that returns the tier the kernels are selected for: the detected tier, lowered by FEE_CPU_TIER
+ *  or fee_dispatch_set_tier.
+ *
+ * @return fee_cpu_tier_t - Selected tier.
+ */
+fee_cpu_tier_t fee_dispatch_selected_tier(void);
+
+/**
+ * @brief Function that returns the tier of the variant selected for a kernel. It may be lower than the selected
+ *  tier if the kernel has no variant for it.
+ *
+ * @param Kernel [Input] Kernel.
+ * @return fee_cpu_tier_t - Tier of the variant. FEE_CPU_TIER_SCALAR if Kernel is not valid.
+ */
+fee_cpu_tier_t fee_dispatch_kernel_tier(fee_kernel_t Kernel);
+
+/**
+ * @brief Function that selects the kernels again for a tier. Tiers above the detected one are lowered to it.
+ *  It must not be called while other threads use the library.
+ *
+ * @param Tier [Input] Highest tier to be used.
+ * @return int - The function returns FEE_EXIT_ERROR if Tier is not valid. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_dispatch_set_tier(fee_cpu_tier_t Tier);
+
+/**
+ * @brief Function that returns the name of a tier, as accepted by FEE_CPU_TIER.
+ *
+ * @param Tier [Input] Tier.
+ * @return const char* - Name of the tier. NULL if Tier is not valid.
+ */
+const char *fee_dispatch_tier_name(fee_cpu_tier_t Tier);
+
+/**
+ * @brief Function that returns the name of a kernel.
+ *
+ * @param Kernel [Input] Kernel.
+ * @return const char* - Name of the kernel. NULL if Kernel is not valid.
+ */
+const char *fee_dispatch_kernel_name(fee_kernel_t Kernel);
+
+/**
+ * @brief Function that writes the detected and selected tiers and the tier of every kernel.
+ *
+ * @param fp [Input] Output file.
+ * @return int - The function returns FEE_EXIT_ERROR if the file cannot be written. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_dispatch_report(FILE *fp);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * @file fee_errindex.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Bitmap index of the TC_ERROR and VAU_ERROR masks of TM packets. Every bit of fee_TC_Error_t and
+ *  fee_VAU_Error_t has a compressed bitmap (roaring-style: containers of 2^16 sequence numbers stored as sorted arrays
+ *  while sparse and as plain bitmaps once dense) over the sequence numbers of the indexed packets. Packets are added
+ *  during ingest, and AND/OR queries restricted to a time range are answered without decoding any packet again.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_ERRINDEX_H
+#define FEE_ERRINDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup ErrIndexConstants
+ * @{
+ */
+
+/*Number of bitmaps: one per bit of TC_ERROR and one per bit of VAU_ERROR*/
+#define FEE_ERRINDEX_NUM_BITMAPS 32
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup ErrIndexDataTypes
+ * @{
+ */
+
+/*Index of error bits*/
+typedef struct fee_errindex fee_errindex_t;
+
+/**
+ * Query over the index. A packet matches if it has every bit of the All masks and, when any Any mask is not 0, at
+ * least one bit of the Any masks. At least one mask must not be 0.
+ */
+typedef struct
+{
+    uint16_t TCAll;          /*fee_TC_Error_t bits that must all be set*/
+    uint16_t VAUAll;         /*fee_VAU_Error_t bits that must all be set*/
+    uint16_t TCAny;          /*fee_TC_Error_t bits of which at least one must be set (with VAUAny)*/
+    uint16_t VAUAny;         /*fee_VAU_Error_t bits of which at least one must be set (with TCAny)*/
+    uint64_t FirstTimestamp; /*Earliest timestamp of the matches (ms)*/
+    uint64_t LastTimestamp;  /*Latest timestamp of the matches (ms). UINT64_MAX for no limit*/
+    int Latest;              /*Non-zero to return the latest matches first*/
+
+} fee_errindex_query_t;
+
+typedef struct
+{
+    uint64_t NumPackets;                            /*Indexed packets*/
+    uint64_t BitCounts[FEE_ERRINDEX_NUM_BITMAPS];   /*Packets with each bit set: TC_ERROR bits 0..15, then VAU_ERROR bits 0..15*/
+    size_t MemoryBytes;                             /*Memory used by the bitmaps and the timestamps*/
+
+} fee_errindex_info_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup ErrIndex Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that creates an empty index.
+ *
+ * @param Index [Output] Created index.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_errindex_create(fee_errindex_t **Index);
+
+/**
+ * @brief Function that frees an index.
+ *
+ * @param Index [Input] Index. It may be NULL.
+ */
+void fee_errindex_destroy(fee_errindex_t *Index);
+
+/**
+ * @brief Function that adds a packet to an index. Packets take consecutive sequence numbers from 0. Time restrictions
+ *  expect packets in timestamp order: a packet earlier than the previous one is indexed at the timestamp of the previous one.
+ *
+ * @param Index [Input] Index.
+ * @param Timestamp [Input] Timestamp of the packet (ms).
+ * @param TCError [Input] TC_ERROR mask of the packet (fee_TC_Error_t bits).
+ * @param VAUError [Input] VAU_ERROR mask of the packet (fee_VAU_Error_t bits).
+ * @param Sequence [Output] Sequence number of the packet. It may be NULL.
+ * @return int - The function returns FEE_EXIT_ERROR if memory cannot be allocated or the index has UINT32_MAX packets. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_errindex_add(fee_errindex_t *Index, uint64_t Timestamp, uint16_t TCError, uint16_t VAUError, uint32_t *Sequence);
+
+/**
+ * @brief Function that adds a decoded TM packet to an index (fee_errindex_add of its TC_ERROR and VAU_ERROR).
+ *
+ * @param Index [Input] Index.
+ * @param Timestamp [Input] Timestamp of the packet (ms).
+ * @param TM [Input] Decoded packet.
+ * @param Sequence [Output] Sequence number of the packet. It may be NULL.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_errindex_add_tm(fee_errindex_t *Index, uint64_t Timestamp, const fee_TM_t *TM, uint32_t *Sequence);
+
+/**
+ * @brief Function that runs a query over an index.
+ *
+ * @param Index [Input] Index.
+ * @param Query [Input] Query.
+ * @param Sequences [Output] Sequence numbers of the first Capacity matches, in ascending order (descending if Query->Latest). It may be NULL if Capacity is 0.
+ * @param Capacity [Input] Number of sequence numbers that fit in Sequences.
+ * @param NumMatches [Output] Number of matching packets, including the ones that did not fit in Sequences.
+ * @return int - The function returns FEE_EXIT_ERROR if the query has no bits. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_errindex_query(const fee_errindex_t *Index, const fee_errindex_query_t *Query, uint32_t *Sequences,
+                       size_t Capacity, size_t *NumMatches);
+
+/**
+ * @brief Function that returns the timestamp of an indexed packet.
+ *
+ * @param Index [Input] Index.
+ * @param Sequence [Input] Sequence number of the packet.
+ * @param Timestamp [Output] Timestamp of the packet (ms).
+ * @return int - The function returns FEE_EXIT_ERROR if the packet is not indexed. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_errindex_timestamp(const fee_errindex_t *Index, uint32_t Sequence, uint64_t *Timestamp);
+
+/**
+ * @brief Function that returns the size and the bit counts of an index.
+ *
+ * @param Index [Input] Index.
+ * @param Info [Output] Index information.
+ */
+void fee_errindex_info(const fee_errindex_t *Index, fee_errindex_info_t *Info);
+
+/**@}*/
+
+#endif
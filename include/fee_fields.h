@@ -0,0 +1,189 @@
+/**
+ * @file fee_fields.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Header-only accessors that read a single field of a raw TC or TM packet at its fixed offset, without
+ *  deserializing the whole packet with fee_TC_Read/fee_TM_Read. fee_TC_get_<FIELD> and fee_TM_get_<FIELD> are
+ *  generated for every field of fee_TC_t and fee_TM_t (Returned_TC fields included) and return the raw value, the
+ *  same that the read functions store in the structure. The field lists can be used to generate other code.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_FIELDS_H
+#define FEE_FIELDS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup FieldsConstants
+ * @{
+ */
+
+/**
+ * Field lists. X(Name, Bits) is expanded for every field, in packet order. Name is the field of fee_TC_t/fee_TM_t
+ * and the suffix of its TC_OFFSET_/TM_OFFSET_ constant, and Bits its width in the packet (8, 16 or 32).
+ */
+
+/*Configuration fields: the TC packet and the echo of the TM packet (Returned_TC)*/
+#define FEE_TC_FIELDS(X)          \
+    X(TC_COUNTER, 16)             \
+    X(OPMODE, 16)                 \
+    X(EXPO_TIME, 32)              \
+    X(DUOUTDRAINTVLTG, 8)         \
+    X(DURESETVLTG, 8)             \
+    X(DUDUMPVLTG, 8)              \
+    X(DUOUTGATEVLTG, 8)           \
+    X(DUIMGCKHVLTG, 8)            \
+    X(DUSTGCKHVLTG, 8)            \
+    X(DUREGCKHVLTG, 8)            \
+    X(DUDUMPCKHVLTG, 8)           \
+    X(DURESETCKHVLTG, 8)          \
+    X(NBSMEAR, 16)                \
+    X(WOISTART, 16)               \
+    X(WOISIZE, 16)                \
+    X(SPATIALBINNINGMODE, 16)     \
+    X(FTPTIME, 8)                 \
+    X(IMGSTGCKRFTIME, 8)          \
+    X(IMGSTGCKOVTIME, 8)          \
+    X(IMGSTGCKPWTIME, 8)          \
+    X(REGLINADVTIME, 8)           \
+    X(LINADVREGTIME, 8)           \
+    X(RCKPTIME, 8)                \
+    X(REGCKOVTIME, 8)             \
+    X(R1REGCKONTIME, 8)           \
+    X(R3REGCKONTIME, 8)           \
+    X(R2CKRISEDELTIME, 8)         \
+    X(RESETCKONTIME, 8)           \
+    X(RESETCKFALLDELTIME, 8)      \
+    X(ADC1TIME, 8)                \
+    X(ADC2TIME, 8)                \
+    X(ADC1RDDLY, 8)               \
+    X(ADC2RDDLY, 8)               \
+    X(DULAMBDA, 16)               \
+    X(FREQBINNINGBAND_1, 16)      \
+    X(FREQBINNINGBAND_2, 16)      \
+    X(FREQBINNINGBAND_3, 16)      \
+    X(FREQBINNINGBAND_4, 16)      \
+    X(FREQBINNINGBAND_5, 16)      \
+    X(PIXEL_MIN, 16)              \
+    X(PIXEL_MAX, 16)              \
+    X(SYNTPATTERN, 16)            \
+    X(CDSPARAMS, 16)              \
+    X(HCNBSAMPLE, 16)             \
+    X(NBTAIL, 16)                 \
+    X(ACQSTARTDELAY, 16)
+
+/*Measurement fields of the TM packet*/
+#define FEE_TM_MEAS_FIELDS(X) \
+    X(CCDTEMP_MEAS1, 16)      \
+    X(CCDTEMP_MEAS2, 16)      \
+    X(VAUTEMP_MEAS, 16)       \
+    X(FPPETEMP_MEAS, 16)      \
+    X(VODE_MEAS, 16)          \
+    X(VODF_MEAS, 16)          \
+    X(VODG_MEAS, 16)          \
+    X(VODH_MEAS, 16)          \
+    X(VRD_MEAS, 16)           \
+    X(VDD_MEAS, 16)           \
+    X(VOG_MEAS, 16)           \
+    X(IPHIH_MEAS, 16)         \
+    X(SPHIH_MEAS, 16)         \
+    X(RPHIH_MEAS, 16)         \
+    X(PHIRH_MEAS, 16)         \
+    X(VDGH_MEAS, 16)          \
+    X(VANAP_MEAS, 16)         \
+    X(VANAN_MEAS, 16)         \
+    X(VDET_MEAS, 16)          \
+    X(VDRV_MEAS, 16)          \
+    X(VDIG_MEAS, 16)          \
+    X(IDIG_MEAS, 16)          \
+    X(TC_ERROR, 16)           \
+    X(VAU_ERROR, 16)
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Fields Funcitons
+ * @{
+ */
+
+/*Big-endian loads. The packet does not need to be aligned*/
+static inline uint8_t fee_load_be8(const uint8_t *Bytes)
+{
+    return Bytes[0];
+}
+
+static inline uint16_t fee_load_be16(const uint8_t *Bytes)
+{
+    return (uint16_t)(((uint16_t)Bytes[0] << 8) | Bytes[1]);
+}
+
+static inline uint32_t fee_load_be32(const uint8_t *Bytes)
+{
+    return ((uint32_t)Bytes[0] << 24) | ((uint32_t)Bytes[1] << 16) | ((uint32_t)Bytes[2] << 8) | Bytes[3];
+}
+
+#define FEE_DEFINE_TC_GETTER(Name, Bits)                                \
+    static inline uint##Bits##_t fee_TC_get_##Name(const uint8_t *pkt) \
+    {                                                                   \
+        return fee_load_be##Bits(pkt + TC_OFFSET_##Name);               \
+    }
+
+#define FEE_DEFINE_TM_GETTER(Name, Bits)                                \
+    static inline uint##Bits##_t fee_TM_get_##Name(const uint8_t *pkt) \
+    {                                                                   \
+        return fee_load_be##Bits(pkt + TM_OFFSET_##Name);               \
+    }
+
+/*fee_TC_get_<FIELD>(const uint8_t *pkt) for every field of a TC packet*/
+FEE_TC_FIELDS(FEE_DEFINE_TC_GETTER)
+
+/*fee_TM_get_<FIELD>(const uint8_t *pkt) for every field of a TM packet: TM_COUNTER, Returned_TC and measurements*/
+FEE_DEFINE_TM_GETTER(TM_COUNTER, 32)
+FEE_TC_FIELDS(FEE_DEFINE_TM_GETTER)
+FEE_TM_MEAS_FIELDS(FEE_DEFINE_TM_GETTER)
+
+#undef FEE_DEFINE_TC_GETTER
+#undef FEE_DEFINE_TM_GETTER
+
+/**
+ * @brief Function that returns the checksum stored in a TC packet, to compare it with fee_CheckTeleCommandChecksum.
+ *
+ * @param pkt [Input] TC packet.
+ * @return uint8_t - Stored checksum.
+ */
+static inline uint8_t fee_TC_get_CHECKSUM(const uint8_t *pkt)
+{
+    return pkt[TC_OFFSET_CHECKSUM];
+}
+
+/**
+ * @brief Function that returns the checksum stored in a TM packet. As XORChecksum16 computes it, it is in host order.
+ *
+ * @param pkt [Input] TM packet.
+ * @return uint16_t - Stored checksum.
+ */
+static inline uint16_t fee_TM_get_CHECKSUM(const uint8_t *pkt)
+{
+    uint16_t Checksum;
+
+    memcpy(&Checksum, pkt + TM_OFFSET_CHECKSUM, sizeof(Checksum));
+    return Checksum;
+}
+
+/**@}*/
+
+#endif
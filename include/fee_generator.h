@@ -0,0 +1,179 @@
+/**
+ * @file fee_generator.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Synthetic TC/TM/PTD packet generator. Consistent TM + PTD pairs are produced for any geometry allowed by the
+ *  TC limits (up to WOISIZE 536, NBTAIL 1023 and five 450-pixel bands with binning 1) and several pixel patterns, so
+ *  that throughput, memory and scaling can be measured without real captures.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_GENERATOR_H
+#define FEE_GENERATOR_H
+
+#include <stdio.h>
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup GeneratorConstants
+ * @{
+ */
+
+/*Number of FREQBINNINGBAND parameters of a TC*/
+#define FEE_GEN_NUM_BANDS 5
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup GeneratorDataTypes
+ * @{
+ */
+
+typedef enum
+{
+    FEE_GEN_PATTERN_RAMP = 0,        /*Pixel value increases along the image, wrapping at 65535*/
+    FEE_GEN_PATTERN_NOISE = 1,       /*Uniform pseudo-random pixels (xorshift32, reproducible with Seed)*/
+    FEE_GEN_PATTERN_SYNTHETIC_1 = 2, /*Column ramp. The TC is generated with SYNTPATTERN = SYNTHETIC_PATTERN_1*/
+    FEE_GEN_PATTERN_SYNTHETIC_2 = 3, /*Row ramp. The TC is generated with SYNTPATTERN = SYNTHETIC_PATTERN_2*/
+    FEE_GEN_PATTERN_CONSTANT = 4     /*Every pixel is PatternValue*/
+
+} fee_gen_pattern_t;
+
+/**
+ * Configuration of the generated frames.
+ */
+typedef struct
+{
+    uint16_t WOISIZE;                            /*Rows of the window of interest*/
+    uint16_t NBTAIL;                             /*Over-scan rows*/
+    spatialbinning_t SPATIALBINNINGMODE;         /*Spatial binning mode*/
+    uint16_t BinningSize[FEE_GEN_NUM_BANDS];     /*Binning of every band (1-8)*/
+    uint16_t BandSize[FEE_GEN_NUM_BANDS];        /*Pixels of every band. 0 disables the band. Multiple of BinningSize*/
+    fee_gen_pattern_t Pattern;                   /*Pixel pattern*/
+    uint16_t PatternValue;                       /*Step of FEE_GEN_PATTERN_RAMP or value of FEE_GEN_PATTERN_CONSTANT*/
+    uint32_t Seed;                               /*Seed of FEE_GEN_PATTERN_NOISE. Every frame uses Seed + FrameIndex*/
+    uint32_t FirstCounter;                       /*TC_COUNTER, TM_COUNTER and PIXEL_DATA_COUNTER of the frame 0*/
+
+} fee_gen_config_t;
+
+/**
+ * Generated frame. It must be zero-initialized before its first use and released with fee_gen_frame_free.
+ * The buffers are reused (and grown when needed) by successive calls.
+ */
+typedef struct
+{
+    fee_TC_Packet_t TC_Packet;   /*Serialized TC (TM.Returned_TC)*/
+    fee_TM_t TM;                 /*TM of the frame*/
+    fee_TM_Packet_t TM_Packet;   /*Serialized TM*/
+    fee_PTD_t PTD;               /*Generated image, voltage references and sizes*/
+    uint8_t *PTD_Packet;         /*Serialized PTD of PTD.PTDSizes.DataPacketTotalBytes bytes*/
+    size_t ImageCapacityBytes;   /*Reserved bytes of every PTD.ImageMatrix plane*/
+    size_t PacketCapacityBytes;  /*Reserved bytes of PTD_Packet*/
+
+} fee_gen_frame_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Generator Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that fills a configuration with the geometry of the 2022-03-14 CHANNEL_2 captures
+ *  (WOISIZE 282, one band of 225 pixels, no over-scan rows) and a ramp pattern.
+ *
+ * @param Config [Output] Configuration.
+ */
+void fee_gen_config_default(fee_gen_config_t *Config);
+
+/**
+ * @brief Function that fills a configuration with the largest frame allowed by the TC limits
+ *  (WOISIZE 536, NBTAIL 1023, five 450-pixel bands with binning 1, no spatial binning) and a noise pattern.
+ *
+ * @param Config [Output] Configuration.
+ */
+void fee_gen_config_maximum(fee_gen_config_t *Config);
+
+/**
+ * @brief Function that generates the operational TM of a frame. The echoed TC passes fee_TC_BoundsCheck.
+ *
+ * @param Config [Input] Configuration.
+ * @param FrameIndex [Input] Index of the frame. Counters are Config->FirstCounter + FrameIndex.
+ * @param TM_Data_Struct [Output] Generated TM.
+ * @return int - The function returns FEE_EXIT_ERROR if the configuration violates the TC limits. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_gen_TM(const fee_gen_config_t *Config, uint32_t FrameIndex, fee_TM_t *TM_Data_Struct);
+
+/**
+ * @brief Function that fills the image planes of a PTD with the configured pattern.
+ *  PTD_Data->PTDImageMatrixTotalSizes must be calculated and the planes reserved.
+ *  Dark columns of the smear rows are set to 0, as fee_PTD_Read does.
+ *
+ * @param Config [Input] Configuration.
+ * @param FrameIndex [Input] Index of the frame.
+ * @param PTD_Data [Input/Output] PTD whose ImageMatrix is filled.
+ */
+void fee_gen_image(const fee_gen_config_t *Config, uint32_t FrameIndex, fee_PTD_t *PTD_Data);
+
+/**
+ * @brief Function that generates a complete frame: TM (fee_gen_TM), TC and TM packets and PTD packet.
+ *
+ * @param Config [Input] Configuration.
+ * @param FrameIndex [Input] Index of the frame.
+ * @param Frame [Input/Output] Frame. Its buffers are grown if needed.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_gen_frame(const fee_gen_config_t *Config, uint32_t FrameIndex, fee_gen_frame_t *Frame);
+
+/**
+ * @brief Function that generates the PTD of a given TM (e.g. read from a capture). The geometry of Config is ignored;
+ *  only the pattern fields are used. The TC and TM packets are serialized from TM_Data_Struct.
+ *
+ * @param Config [Input] Configuration.
+ * @param TM_Data_Struct [Input] Operational TM without errors.
+ * @param FrameIndex [Input] Index of the frame. PIXEL_DATA_COUNTER is Config->FirstCounter + FrameIndex.
+ * @param Frame [Input/Output] Frame. Its buffers are grown if needed.
+ * @return int - The function returns FEE_EXIT_ERROR if the TM does not have PTD information or any error occurs.
+ *  Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_gen_frame_from_TM(const fee_gen_config_t *Config, fee_TM_t TM_Data_Struct, uint32_t FrameIndex, fee_gen_frame_t *Frame);
+
+/**
+ * @brief Function that releases the buffers of a frame.
+ *
+ * @param Frame [Input] Frame. It may be reused after the call.
+ */
+void fee_gen_frame_free(fee_gen_frame_t *Frame);
+
+/**
+ * @brief Function that writes a packet as a line of an ASCII "_Analysis.txt" capture.
+ *  TC and TM lines are "Timestamp - b0 b1 ...". PTD lines are "Timestamp - NumBytes b0 b1 ...".
+ *
+ * @param fp [Input] Output file.
+ * @param Timestamp [Input] Timestamp of the line (ms).
+ * @param Packet [Input] Packet.
+ * @param PacketBytes [Input] Bytes of the packet.
+ * @param IsPTD [Input] Not 0 for PTD packets.
+ * @return int - The function returns FEE_EXIT_ERROR if the file cannot be written. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_gen_fprint_packet(FILE *fp, uint64_t Timestamp, const uint8_t *Packet, size_t PacketBytes, int IsPTD);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file fee_inline.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Header-only definitions of the small hot functions of the codec, so that per-packet loops can inline and
+ *  vectorize them across the library boundary. The fee_inline_* functions are always available. When FEE_INLINE is
+ *  defined before fee.h is included (the FEE_INLINE CMake option defines it for every program linked with the
+ *  library), calls to the exported functions of the same name are replaced by them; their addresses are still the
+ *  exported functions, and the ABI of the library does not change. The exported functions use these definitions,
+ *  so both give the same results. Checksum checks through the inline functions are not counted by fee_stats.h.
+ *  The field decoders of fee_fields.h are included.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_INLINE_H
+#define FEE_INLINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <fee.h>
+#include <fee_fields.h>
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Inline Funcitons
+ * @{
+ */
+
+/*Inline fee_getFreqBinningBand_parameters*/
+static inline void fee_inline_getFreqBinningBand_parameters(uint16_t freqbinningband, uint16_t *binninsize,
+                                                            uint16_t *bandsize)
+{
+    /*freqbinningband = binningsize [13:15]  spare [9:12] bandsize[0:8] where 0 is the LSB*/
+    /*The binninsize value has an offset of 1*/
+    *binninsize = (uint16_t)(((freqbinningband >> 13) & 0x0007) + 1);
+    *bandsize = freqbinningband & 0x01FF;
+}
+
+/*Inline fee_getCDSParam_parameters*/
+static inline void fee_inline_getCDSParam_parameters(uint16_t cdsparam, uint16_t *cds_mode, uint16_t *digital_offset)
+{
+    /*cdsparam = cds_param [14:15] spare [10,13] bandsize[0:9] where 0 is the LSB*/
+    *cds_mode = (cdsparam >> 14) & 0x0003;
+    *digital_offset = cdsparam & 0x03FF;
+}
+
+/*Inline fee_fill_cdsparam_parameter*/
+static inline uint16_t fee_inline_fill_cdsparam_parameter(cds_params_t cds_mode, int digital_offset)
+{
+    /*cdsparam = cds_mode [14:15] spare [10,13] bandsize[0:9] where 0 is the LSB*/
+    return (uint16_t)((((uint16_t)cds_mode & 0x0003) << 14) | ((uint16_t)digital_offset & 0x03FF));
+}
+
+/*Inline fee_fill_freqbinningband_parameter*/
+static inline uint16_t fee_inline_fill_freqbinningband_parameter(int binningsize, int bandsize)
+{
+    /*Binningsize parameter length is three bits and has an offset of -1*/
+    uint16_t binninsize_s = (uint16_t)(((uint16_t)binningsize & 0x0007) - 1);
+
+    /*freqbinninbband = binningsize [13:15] spare [9,12] bandsize[0:8] being 0 the LSB*/
+    return (uint16_t)((uint32_t)binninsize_s << 13 | ((uint16_t)bandsize & 0x01FF));
+}
+
+/*Inline fee_PTDImageIndx*/
+static inline size_t fee_inline_PTDImageIndx(size_t RowIndex, size_t ColIndex, size_t NumColumns)
+{
+    return RowIndex * NumColumns + ColIndex;
+}
+
+/*Inline fee_checksum16_patch*/
+static inline uint16_t fee_inline_checksum16_patch(uint16_t checksum, size_t offset, const uint8_t *old_data,
+                                                   const uint8_t *new_data, size_t length)
+{
+    uint8_t delta[2] = {0, 0};
+    uint16_t delta_int;
+    size_t i;
+
+    /*Even and odd bytes of the packet only affect the first and the second byte of the stored checksum*/
+    for (i = 0; i < length; i++)
+    {
+        delta[(offset + i) % 2] ^= old_data[i] ^ new_data[i];
+    }
+    memcpy(&delta_int, delta, sizeof(delta_int));
+
+    return checksum ^ delta_int;
+}
+
+/*Inline fee_checksum8_patch*/
+static inline uint8_t fee_inline_checksum8_patch(uint8_t checksum, const uint8_t *old_data, const uint8_t *new_data,
+                                                 size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        checksum ^= old_data[i] ^ new_data[i];
+    }
+
+    return checksum;
+}
+
+/**
+ * @brief Function that calculates the checksum of a TC packet, as it is stored in the packet.
+ *
+ * @param TC_Packet [Input] TC packet.
+ * @return uint8_t - Xor of the bytes before the checksum.
+ */
+static inline uint8_t fee_inline_TC_checksum(const uint8_t *TC_Packet)
+{
+    uint8_t Checksum = 0;
+    size_t i;
+
+    for (i = 0; i < TC_OFFSET_CHECKSUM; i++)
+    {
+        Checksum ^= TC_Packet[i];
+    }
+
+    return Checksum;
+}
+
+/**
+ * @brief Function that calculates the checksum of a TM packet, as it is stored in the packet.
+ *
+ * @param TM_Packet [Input] TM packet.
+ * @return uint16_t - Xor of the 16 bits words, in host order, before the checksum.
+ */
+static inline uint16_t fee_inline_TM_checksum(const uint8_t *TM_Packet)
+{
+    uint16_t Checksum = 0, Word;
+    size_t i;
+
+    for (i = 0; i < TM_OFFSET_CHECKSUM; i += 2)
+    {
+        memcpy(&Word, TM_Packet + i, sizeof(Word));
+        Checksum ^= Word;
+    }
+
+    return Checksum;
+}
+
+/*Inline fee_CheckTeleCommandChecksum*/
+static inline int fee_inline_CheckTeleCommandChecksum(const uint8_t *TC_Packet)
+{
+    return fee_inline_TC_checksum(TC_Packet) == fee_TC_get_CHECKSUM(TC_Packet) ? FEE_EXIT_SUCCESS : FEE_EXIT_ERROR;
+}
+
+/*Inline fee_CheckTelemetryChecksum*/
+static inline int fee_inline_CheckTelemetryChecksum(const uint8_t *TM_Packet)
+{
+    return fee_inline_TM_checksum(TM_Packet) == fee_TM_get_CHECKSUM(TM_Packet) ? FEE_EXIT_SUCCESS : FEE_EXIT_ERROR;
+}
+
+/**@}*/
+
+/*Calls to the exported functions are replaced by the inline ones*/
+#ifdef FEE_INLINE
+#define fee_getFreqBinningBand_parameters(freqbinningband, binninsize_s, bandsize_s) \
+    fee_inline_getFreqBinningBand_parameters(freqbinningband, binninsize_s, bandsize_s)
+#define fee_getCDSParam_parameters(cdsparam, cds_mode, digital_offset) \
+    fee_inline_getCDSParam_parameters(cdsparam, cds_mode, digital_offset)
+#define fee_fill_cdsparam_parameter(cds_mode, digital_offset) \
+    fee_inline_fill_cdsparam_parameter(cds_mode, digital_offset)
+#define fee_fill_freqbinningband_parameter(binningsize, bandsize) \
+    fee_inline_fill_freqbinningband_parameter(binningsize, bandsize)
+#define fee_PTDImageIndx(RowIndex, ColIndex, NumColumns) fee_inline_PTDImageIndx(RowIndex, ColIndex, NumColumns)
+#define fee_checksum16_patch(checksum, offset, old_data, new_data, length) \
+    fee_inline_checksum16_patch(checksum, offset, old_data, new_data, length)
+#define fee_checksum8_patch(checksum, old_data, new_data, length) \
+    fee_inline_checksum8_patch(checksum, old_data, new_data, length)
+#define fee_CheckTeleCommandChecksum(TC_Packet) fee_inline_CheckTeleCommandChecksum(TC_Packet)
+#define fee_CheckTelemetryChecksum(TM_Packet) fee_inline_CheckTelemetryChecksum(TM_Packet)
+#endif
+
+#endif
@@ -0,0 +1,215 @@
+/**
+ * @file fee_limits.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Limit monitoring of converted telemetry. Every channel of a limit table checks a field of fee_TM_Float_t
+ *  (or of any vector of values) against its warning and alarm limits, and changes between OK, WARN and ALARM with
+ *  hysteresis. The limits of every channel are compared at once with the dispatched SIMD kernel (fee_dispatch.h),
+ *  and only the channels whose state changes produce a transition.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_LIMITS_H
+#define FEE_LIMITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <fee.h>
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup LimitsDataTypes
+ * @{
+ */
+
+/*Fields of fee_TM_Float_t, in their order*/
+typedef enum
+{
+    FEE_TM_FLOAT_CCDTEMP_MEAS1 = 0,
+    FEE_TM_FLOAT_CCDTEMP_MEAS2 = 1,
+    FEE_TM_FLOAT_VAUTEMP_MEAS = 2,
+    FEE_TM_FLOAT_FPPETEMP_MEAS = 3,
+    FEE_TM_FLOAT_VODE_MEAS = 4,
+    FEE_TM_FLOAT_VODF_MEAS = 5,
+    FEE_TM_FLOAT_VODG_MEAS = 6,
+    FEE_TM_FLOAT_VODH_MEAS = 7,
+    FEE_TM_FLOAT_VRD_MEAS = 8,
+    FEE_TM_FLOAT_VDD_MEAS = 9,
+    FEE_TM_FLOAT_VOG_MEAS = 10,
+    FEE_TM_FLOAT_IPHIH_MEAS = 11,
+    FEE_TM_FLOAT_SPHIH_MEAS = 12,
+    FEE_TM_FLOAT_RPHIH_MEAS = 13,
+    FEE_TM_FLOAT_PHIRH_MEAS = 14,
+    FEE_TM_FLOAT_VDGH_MEAS = 15,
+    FEE_TM_FLOAT_VANAP_MEAS = 16,
+    FEE_TM_FLOAT_VDET_MEAS = 17,
+    FEE_TM_FLOAT_VANAN_MEAS = 18,
+    FEE_TM_FLOAT_VDRV_MEAS = 19,
+    FEE_TM_FLOAT_VDIG_MEAS = 20,
+    FEE_TM_FLOAT_IDIG_MEAS = 21,
+    FEE_TM_FLOAT_NUM_FIELDS = 22
+
+} fee_TM_FloatField_t;
+
+typedef enum
+{
+    FEE_LIMIT_OK = 0,    /*Inside the warning limits*/
+    FEE_LIMIT_WARN = 1,  /*Outside the warning limits, inside the alarm limits*/
+    FEE_LIMIT_ALARM = 2  /*Outside the alarm limits, or NaN*/
+
+} fee_limit_state_t;
+
+/**
+ * Limits of a channel. They must be ordered (AlarmLow <= WarnLow <= WarnHigh <= AlarmHigh); infinite limits disable
+ * a side. A channel returns to a lower state once the value is Hysteresis inside the limits it had crossed.
+ */
+typedef struct
+{
+    uint32_t Field;   /*Index of the checked value. A fee_TM_FloatField_t for fee_limits_eval_tm*/
+    float WarnLow;
+    float WarnHigh;
+    float AlarmLow;
+    float AlarmHigh;
+    float Hysteresis; /*From 0 to half the width of the warning limits*/
+
+} fee_limit_t;
+
+typedef struct
+{
+    uint32_t Channel;        /*Row of the limit table*/
+    uint32_t Field;          /*Field of the channel*/
+    size_t Packet;           /*Packet of the batch. 0 for a single packet*/
+    fee_limit_state_t From;
+    fee_limit_state_t To;
+    float Value;             /*Value that caused the transition*/
+
+} fee_limit_transition_t;
+
+/*Limit table and channel states. It must not be used by several threads at once*/
+typedef struct fee_limits fee_limits_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Limits Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that creates a limit monitor from a table. Every channel starts at FEE_LIMIT_OK.
+ *
+ * @param Table [Input] Limits of every channel.
+ * @param NumChannels [Input] Number of channels. At least one.
+ * @param Limits [Output] Created monitor.
+ * @return int - The function returns FEE_EXIT_ERROR if any limit is not valid or memory cannot be allocated. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_limits_create(const fee_limit_t *Table, size_t NumChannels, fee_limits_t **Limits);
+
+/**
+ * @brief Function that creates a limit monitor from a text table. Every line holds a channel: the field (a
+ *  fee_limits_field_name or an index), WarnLow, WarnHigh, AlarmLow, AlarmHigh and, optionally, Hysteresis.
+ *  Limits may be "inf" or "-inf". Blank lines and lines starting with '#' are ignored.
+ *
+ * @param Path [Input] Path of the table.
+ * @param Limits [Output] Created monitor.
+ * @return int - The function returns FEE_EXIT_ERROR if the file cannot be read or any line is not valid. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_limits_load(const char *Path, fee_limits_t **Limits);
+
+/**
+ * @brief Function that frees a limit monitor.
+ *
+ * @param Limits [Input] Monitor. It may be NULL.
+ */
+void fee_limits_destroy(fee_limits_t *Limits);
+
+/**
+ * @brief Function that checks a vector of values and updates the state of every channel.
+ *
+ * @param Limits [Input] Monitor.
+ * @param Values [Input] Values, indexed by the Field of the channels.
+ * @param NumValues [Input] Number of values. It must be higher than the Field of every channel.
+ * @param Transitions [Output] The first Capacity transitions, by channel. It may be NULL if Capacity is 0.
+ * @param Capacity [Input] Number of transitions that fit in Transitions.
+ * @param NumTransitions [Output] Number of transitions, including the ones that did not fit in Transitions.
+ * @return int - The function returns FEE_EXIT_ERROR if NumValues is too low. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_limits_eval(fee_limits_t *Limits, const float *Values, size_t NumValues, fee_limit_transition_t *Transitions,
+                    size_t Capacity, size_t *NumTransitions);
+
+/**
+ * @brief Function that checks the converted parameters of a TM packet (fee_convert_TM_parameters).
+ *
+ * @param Limits [Input] Monitor. The Field of its channels are fee_TM_FloatField_t.
+ * @param TM [Input] Converted parameters.
+ * @param Transitions [Output] The first Capacity transitions, by channel. It may be NULL if Capacity is 0.
+ * @param Capacity [Input] Number of transitions that fit in Transitions.
+ * @param NumTransitions [Output] Number of transitions, including the ones that did not fit in Transitions.
+ * @return int - The function returns FEE_EXIT_ERROR if a channel is not a fee_TM_FloatField_t. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_limits_eval_tm(fee_limits_t *Limits, const fee_TM_Float_t *TM, fee_limit_transition_t *Transitions,
+                       size_t Capacity, size_t *NumTransitions);
+
+/**
+ * @brief Function that checks a batch of packets in SoA form: the values of a field for every packet are contiguous.
+ *  The states are the same as checking every packet in order with fee_limits_eval.
+ *
+ * @param Limits [Input] Monitor.
+ * @param Columns [Input] Values. The value of the field f for the packet p is Columns[f * Stride + p].
+ * @param NumFields [Input] Number of columns. It must be higher than the Field of every channel.
+ * @param Stride [Input] Distance between columns. At least NumPackets.
+ * @param NumPackets [Input] Packets of the batch.
+ * @param Transitions [Output] The first Capacity transitions, by channel and then by packet. It may be NULL if Capacity is 0.
+ * @param Capacity [Input] Number of transitions that fit in Transitions.
+ * @param NumTransitions [Output] Number of transitions, including the ones that did not fit in Transitions.
+ * @return int - The function returns FEE_EXIT_ERROR if NumFields or Stride are too low. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_limits_eval_batch(fee_limits_t *Limits, const float *Columns, size_t NumFields, size_t Stride,
+                          size_t NumPackets, fee_limit_transition_t *Transitions, size_t Capacity,
+                          size_t *NumTransitions);
+
+/**
+ * @brief Function that returns the state of a channel.
+ *
+ * @param Limits [Input] Monitor.
+ * @param Channel [Input] Row of the limit table.
+ * @return fee_limit_state_t - State of the channel. FEE_LIMIT_OK if Channel is not valid.
+ */
+fee_limit_state_t fee_limits_state(const fee_limits_t *Limits, size_t Channel);
+
+/**
+ * @brief Function that returns every channel to FEE_LIMIT_OK.
+ *
+ * @param Limits [Input] Monitor.
+ */
+void fee_limits_reset(fee_limits_t *Limits);
+
+/**
+ * @brief Function that returns the number of channels of a monitor.
+ *
+ * @param Limits [Input] Monitor.
+ * @return size_t - Number of channels.
+ */
+size_t fee_limits_num_channels(const fee_limits_t *Limits);
+
+/**
+ * @brief Function that returns the name of a field of fee_TM_Float_t, without the "_f" suffix.
+ *
+ * @param Field [Input] Field.
+ * @return const char* - Name of the field. NULL if Field is not valid.
+ */
+const char *fee_limits_field_name(fee_TM_FloatField_t Field);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,258 @@
+/**
+ * @file fee_pipeline.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Lock-free acquisition -> decode -> consume pipeline for fee electronics packets.
+ *  Packets are handed over between threads as descriptors that reference pooled buffers (zero-copy),
+ *  through cache-line padded single-producer/single-consumer rings.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_PIPELINE_H
+#define FEE_PIPELINE_H
+
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup PipelineConstants
+ * @{
+ */
+
+/*Size in bytes of a cache line. Ring indexes written by different threads are placed in different cache lines*/
+#define FEE_CACHE_LINE_BYTES 64
+
+/*Default number of descriptors processed by a stage in every wakeup*/
+#define FEE_PIPELINE_DEFAULT_BATCH 32
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup PipelineDataTypes
+ * @{
+ */
+
+typedef enum
+{
+    FEE_PACKET_TM = 0,
+    FEE_PACKET_PTD = 1
+
+} fee_packet_type_t;
+
+/**
+ * Packet descriptor. Descriptors are copied through the rings; the packet bytes and the image planes are not.
+ */
+typedef struct
+{
+    fee_packet_type_t Type;  /*Type of the referenced packet*/
+    uint8_t *Packet;         /*Raw packet. Usually a buffer of a fee_buffer_pool_t*/
+    size_t PacketBytes;      /*Number of valid bytes of Packet*/
+    size_t BufferIndex;      /*Index of Packet in its buffer pool*/
+    fee_TM_t TM;             /*FEE_PACKET_TM: decoded TM. FEE_PACKET_PTD: TM information needed to decode the PTD packet*/
+    fee_PTD_t PTD;           /*FEE_PACKET_PTD: decoded PTD. PTD.ImageMatrix must point to (pooled) memory before decoding*/
+    size_t ImageBufferIndex; /*FEE_PACKET_PTD: index of the planes in their buffer pool, if fee_PTD_ReadBatch took them from one*/
+    int Status;              /*FEE_EXIT_SUCCESS, or FEE_EXIT_ERROR once a stage has failed*/
+    void *UserData;          /*Caller information carried with the packet*/
+
+} fee_packet_desc_t;
+
+/*Single-producer/single-consumer ring of packet descriptors*/
+typedef struct fee_spsc_ring fee_spsc_ring_t;
+
+/*Pool of fixed size buffers. Buffers are acquired by one thread and released by one thread*/
+typedef struct fee_buffer_pool fee_buffer_pool_t;
+
+/*Pipeline of stages running on dedicated threads*/
+typedef struct fee_pipeline fee_pipeline_t;
+
+/**
+ * Function run by a stage for every descriptor. It returns FEE_EXIT_SUCCESS or FEE_EXIT_ERROR, which is stored in Desc->Status.
+ * Descriptors whose Status is already FEE_EXIT_ERROR are passed through without calling the stage.
+ */
+typedef int (*fee_pipeline_stage_fn)(fee_packet_desc_t *Desc, void *StageData);
+
+typedef struct
+{
+    fee_pipeline_stage_fn Process; /*Function of the stage*/
+    void *StageData;               /*Data passed to Process*/
+
+} fee_pipeline_stage_t;
+
+typedef struct
+{
+    const fee_pipeline_stage_t *Stages; /*Stages, in processing order. Every stage runs on its own thread*/
+    size_t NumStages;                   /*Number of stages. At least one*/
+    size_t RingCapacity;                /*Capacity of the rings between stages. Rounded up to a power of two*/
+    size_t BatchSize;                   /*Maximum descriptors processed per wakeup. 0 selects FEE_PIPELINE_DEFAULT_BATCH*/
+
+} fee_pipeline_config_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Pipeline Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that creates a single-producer/single-consumer ring of descriptors.
+ *
+ * @param Capacity [Input] Minimum number of descriptors of the ring. It is rounded up to a power of two.
+ * @param Ring [Output] Created ring.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_spsc_ring_create(size_t Capacity, fee_spsc_ring_t **Ring);
+
+/**
+ * @brief Function that releases a ring.
+ *
+ * @param Ring [Input] Ring to be released. It may be NULL.
+ */
+void fee_spsc_ring_destroy(fee_spsc_ring_t *Ring);
+
+/**
+ * @brief Function that pushes descriptors into the ring. It must only be called by the producer thread.
+ *
+ * @param Ring [Input] Ring.
+ * @param Descs [Input] Descriptors to be pushed.
+ * @param NumDescs [Input] Number of descriptors of Descs.
+ * @return size_t - Number of descriptors pushed. It is lower than NumDescs if the ring is full.
+ */
+size_t fee_spsc_ring_push(fee_spsc_ring_t *Ring, const fee_packet_desc_t *Descs, size_t NumDescs);
+
+/**
+ * @brief Function that pops descriptors from the ring. It must only be called by the consumer thread.
+ *
+ * @param Ring [Input] Ring.
+ * @param Descs [Output] Popped descriptors.
+ * @param MaxDescs [Input] Maximum number of descriptors to be popped.
+ * @return size_t - Number of descriptors popped. 0 if the ring is empty.
+ */
+size_t fee_spsc_ring_pop(fee_spsc_ring_t *Ring, fee_packet_desc_t *Descs, size_t MaxDescs);
+
+/**
+ * @brief Function that creates a pool of cache-line aligned buffers.
+ *
+ * @param NumBuffers [Input] Number of buffers of the pool.
+ * @param BufferBytes [Input] Size in bytes of every buffer.
+ * @param Pool [Output] Created pool.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_buffer_pool_create(size_t NumBuffers, size_t BufferBytes, fee_buffer_pool_t **Pool);
+
+/**
+ * @brief Function that releases a pool and all its buffers.
+ *
+ * @param Pool [Input] Pool to be released. It may be NULL.
+ */
+void fee_buffer_pool_destroy(fee_buffer_pool_t *Pool);
+
+/**
+ * @brief Function that takes a free buffer from the pool.
+ *
+ * @param Pool [Input] Pool.
+ * @param Buffer [Output] Acquired buffer.
+ * @param BufferIndex [Output] Index of the buffer, needed to release it.
+ * @return int - The function returns FEE_EXIT_ERROR if there are no free buffers. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_buffer_pool_acquire(fee_buffer_pool_t *Pool, uint8_t **Buffer, size_t *BufferIndex);
+
+/**
+ * @brief Function that gives a buffer back to the pool.
+ *
+ * @param Pool [Input] Pool.
+ * @param BufferIndex [Input] Index of the buffer returned by fee_buffer_pool_acquire.
+ * @return int - The function returns FEE_EXIT_ERROR if the index is not valid or the buffer is not acquired (e.g. it
+ *  has already been released). Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_buffer_pool_release(fee_buffer_pool_t *Pool, size_t BufferIndex);
+
+/**
+ * @brief Function that returns the buffer with a given index.
+ *
+ * @param Pool [Input] Pool.
+ * @param BufferIndex [Input] Index of the buffer.
+ * @return uint8_t* - Buffer. NULL if the index is not valid.
+ */
+uint8_t *fee_buffer_pool_buffer(fee_buffer_pool_t *Pool, size_t BufferIndex);
+
+/**
+ * @brief Function that returns the size in bytes of the buffers of a pool.
+ *
+ * @param Pool [Input] Pool.
+ * @return size_t - Size in bytes of every buffer.
+ */
+size_t fee_buffer_pool_buffer_bytes(const fee_buffer_pool_t *Pool);
+
+/**
+ * @brief Function that creates a pipeline and starts one thread per stage.
+ *
+ * @param Config [Input] Configuration of the pipeline.
+ * @param Pipeline [Output] Created pipeline.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_pipeline_create(const fee_pipeline_config_t *Config, fee_pipeline_t **Pipeline);
+
+/**
+ * @brief Function that stops the stage threads and releases the pipeline. Descriptors not received yet are discarded.
+ *
+ * @param Pipeline [Input] Pipeline to be released. It may be NULL.
+ */
+void fee_pipeline_destroy(fee_pipeline_t *Pipeline);
+
+/**
+ * @brief Function that submits descriptors to the first stage. It must only be called by one (producer) thread. It does not block.
+ *
+ * @param Pipeline [Input] Pipeline.
+ * @param Descs [Input] Descriptors to be processed.
+ * @param NumDescs [Input] Number of descriptors of Descs.
+ * @return size_t - Number of descriptors submitted. It is lower than NumDescs if the first ring is full.
+ */
+size_t fee_pipeline_submit(fee_pipeline_t *Pipeline, const fee_packet_desc_t *Descs, size_t NumDescs);
+
+/**
+ * @brief Function that receives descriptors processed by every stage, in submission order.
+ *  It must only be called by one (consumer) thread. It does not block.
+ *
+ * @param Pipeline [Input] Pipeline.
+ * @param Descs [Output] Processed descriptors.
+ * @param MaxDescs [Input] Maximum number of descriptors to be received.
+ * @return size_t - Number of descriptors received. 0 if none is ready.
+ */
+size_t fee_pipeline_receive(fee_pipeline_t *Pipeline, fee_packet_desc_t *Descs, size_t MaxDescs);
+
+/**
+ * @brief Stage function that verifies the checksum of the packet (fee_CheckTelemetryChecksum or fee_CheckPTDChecksum).
+ *
+ * @param Desc [Input/Output] Descriptor of the packet.
+ * @param StageData [Input] Not used.
+ * @return int - The function returns FEE_EXIT_ERROR if the packet is too short or the checksum is wrong. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_pipeline_stage_checksum(fee_packet_desc_t *Desc, void *StageData);
+
+/**
+ * @brief Stage function that decodes the packet into Desc->TM (fee_TM_Read) or Desc->PTD (fee_PTD_Read).
+ *
+ * @param Desc [Input/Output] Descriptor of the packet.
+ * @param StageData [Input] Not used.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_pipeline_stage_decode(fee_packet_desc_t *Desc, void *StageData);
+
+/**@}*/
+
+#endif
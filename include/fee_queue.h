@@ -0,0 +1,171 @@
+/**
+ * @file fee_queue.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Bounded queue of decoded frames with back-pressure. Frames are packet descriptors (fee_pipeline.h) of decoded
+ *  PTDs. When the queue is full, the producer is blocked or frames are dropped or decimated by a policy, and every
+ *  outcome is counted, so that quick-look consumers degrade gracefully while the archival path uses a blocking queue
+ *  and keeps every frame.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_QUEUE_H
+#define FEE_QUEUE_H
+
+#include <stdint.h>
+#include <fee.h>
+#include <fee_pipeline.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup QueueConstants
+ * @{
+ */
+
+/*Default factor of FEE_QUEUE_DECIMATE: one of every 4 frames is kept under pressure*/
+#define FEE_QUEUE_DEFAULT_DECIMATION 4
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup QueueDataTypes
+ * @{
+ */
+
+/*Behaviour of a push under pressure*/
+typedef enum
+{
+    FEE_QUEUE_BLOCK = 0,       /*The producer waits until there is room. No frame is lost*/
+    FEE_QUEUE_DROP_OLDEST = 1, /*The oldest queued frame is dropped to make room*/
+    FEE_QUEUE_DROP_NEWEST = 2, /*The pushed frame is dropped*/
+    FEE_QUEUE_DECIMATE = 3     /*From DecimationThreshold queued frames, only one of every DecimationFactor pushed
+                                 frames is kept. If the queue is full, the pushed frame is dropped*/
+} fee_queue_policy_t;
+
+/*Bounded frame queue. Any number of threads may push and pop*/
+typedef struct fee_frame_queue fee_frame_queue_t;
+
+/*Function called for every dropped frame and for the frames left at fee_frame_queue_destroy, to give back its buffers*/
+typedef void (*fee_frame_release_fn)(void *ReleaseData, fee_packet_desc_t *Frame);
+
+typedef struct
+{
+    size_t Capacity;              /*Maximum number of queued frames. At least one*/
+    fee_queue_policy_t Policy;    /*Behaviour of a push under pressure*/
+    uint32_t DecimationFactor;    /*FEE_QUEUE_DECIMATE: one of every DecimationFactor frames is kept. 0 selects FEE_QUEUE_DEFAULT_DECIMATION*/
+    size_t DecimationThreshold;   /*FEE_QUEUE_DECIMATE: queued frames from which frames are decimated. 0 selects half the capacity*/
+    fee_frame_release_fn Release; /*Release function of the dropped frames. It may be NULL*/
+    void *ReleaseData;            /*Data passed to Release*/
+
+} fee_frame_queue_config_t;
+
+/*Counters of a queue since its creation*/
+typedef struct
+{
+    uint64_t Pushed;             /*Frames passed to fee_frame_queue_push*/
+    uint64_t Accepted;           /*Frames queued*/
+    uint64_t Popped;             /*Frames taken by the consumers*/
+    uint64_t DroppedOldest;      /*Queued frames dropped by FEE_QUEUE_DROP_OLDEST*/
+    uint64_t DroppedNewest;      /*Pushed frames dropped because the queue was full (FEE_QUEUE_DROP_NEWEST and FEE_QUEUE_DECIMATE)*/
+    uint64_t Decimated;          /*Pushed frames dropped by the decimation of FEE_QUEUE_DECIMATE*/
+    uint64_t BlockedPushes;      /*Pushes that waited for room (FEE_QUEUE_BLOCK)*/
+    uint64_t BlockedNanoseconds; /*Total time waited by the blocked pushes*/
+    size_t Depth;                /*Currently queued frames*/
+    size_t HighWatermark;        /*Maximum number of queued frames*/
+
+} fee_frame_queue_counters_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Queue Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that creates a frame queue.
+ *
+ * @param Config [Input] Configuration of the queue.
+ * @param Queue [Output] Created queue.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_frame_queue_create(const fee_frame_queue_config_t *Config, fee_frame_queue_t **Queue);
+
+/**
+ * @brief Function that releases a queue. The frames still queued are passed to the release function. No thread may
+ *  be using the queue.
+ *
+ * @param Queue [Input] Queue to be released. It may be NULL.
+ */
+void fee_frame_queue_destroy(fee_frame_queue_t *Queue);
+
+/**
+ * @brief Function that pushes a frame. The queue owns the frame from then on: if it is dropped, now or later, it is
+ *  passed to the release function.
+ *
+ * @param Queue [Input] Queue.
+ * @param Frame [Input] Frame to be pushed.
+ * @param Accepted [Output] 1 if the frame has been queued, 0 if it has been dropped. It may be NULL.
+ * @return int - The function returns FEE_EXIT_ERROR if the queue is closed, and the caller keeps the frame. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_frame_queue_push(fee_frame_queue_t *Queue, const fee_packet_desc_t *Frame, int *Accepted);
+
+/**
+ * @brief Function that pops the oldest frame, waiting until there is one.
+ *
+ * @param Queue [Input] Queue.
+ * @param Frame [Output] Popped frame. The caller owns it.
+ * @return int - The function returns FEE_EXIT_ERROR if the queue is closed and empty. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_frame_queue_pop(fee_frame_queue_t *Queue, fee_packet_desc_t *Frame);
+
+/**
+ * @brief Function that pops the oldest frame without waiting.
+ *
+ * @param Queue [Input] Queue.
+ * @param Frame [Output] Popped frame. The caller owns it.
+ * @return int - The function returns FEE_EXIT_ERROR if the queue is empty. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_frame_queue_try_pop(fee_frame_queue_t *Queue, fee_packet_desc_t *Frame);
+
+/**
+ * @brief Function that closes a queue. Blocked and later pushes fail, and the consumers pop the remaining frames
+ *  before fee_frame_queue_pop fails.
+ *
+ * @param Queue [Input] Queue.
+ */
+void fee_frame_queue_close(fee_frame_queue_t *Queue);
+
+/**
+ * @brief Function that reads the counters of a queue.
+ *
+ * @param Queue [Input] Queue.
+ * @param Counters [Output] Counters.
+ */
+void fee_frame_queue_counters(fee_frame_queue_t *Queue, fee_frame_queue_counters_t *Counters);
+
+/**
+ * @brief Function that returns the name of a policy.
+ *
+ * @param Policy [Input] Policy.
+ * @return const char* - Name of the policy. NULL if Policy is not valid.
+ */
+const char *fee_frame_queue_policy_name(fee_queue_policy_t Policy);
+
+/**@}*/
+
+#endif
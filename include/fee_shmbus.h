@@ -0,0 +1,209 @@
+/**
+ * @file fee_shmbus.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Shared-memory frame bus. A single writer publishes decoded frames (TM, fee_PTD_t header and ImageMatrix
+ *  planes) once into a ring in shared memory (shm_open or memfd), and up to FEE_SHMBUS_MAX_READERS processes
+ *  attach with independent cursors and read the planes in place. Every slot records the readers that still
+ *  reference it and is reused when all of them have released it, so N consumers cost one decode and no copies.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_SHMBUS_H
+#define FEE_SHMBUS_H
+
+#include <stdint.h>
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup ShmBusConstants
+ * @{
+ */
+
+/*Maximum number of readers attached at the same time*/
+#define FEE_SHMBUS_MAX_READERS 64
+
+/*Version of the shared-memory layout. Readers reject buses of other versions*/
+#define FEE_SHMBUS_VERSION 1
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup ShmBusDataTypes
+ * @{
+ */
+
+/*Writer side of a bus. It owns the shared memory*/
+typedef struct fee_shmbus fee_shmbus_t;
+
+/*Reader side of a bus*/
+typedef struct fee_shmbus_reader fee_shmbus_reader_t;
+
+typedef struct
+{
+    uint32_t NumSlots;  /*Frames of the ring. At least one*/
+    size_t PlaneBytes;  /*Maximum ImageMatrixBytes of a published frame (bytes of every CCD plane)*/
+
+} fee_shmbus_config_t;
+
+typedef struct
+{
+    uint64_t Published;      /*Published frames. It is also the sequence of the next frame*/
+    uint64_t Busy;           /*Reserves rejected because the next slot was still referenced by a reader*/
+    uint32_t ActiveReaders;  /*Attached readers*/
+    uint64_t MaxLag;         /*Published frames not yet released by the slowest reader*/
+
+} fee_shmbus_counters_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup ShmBus Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that creates a bus and its shared memory.
+ *
+ * @param Name [Input] POSIX shared memory name ("/name"), which must not exist. NULL creates an anonymous memfd, to be
+ *  shared by fork or fd passing (fee_shmbus_fd).
+ * @param Config [Input] Configuration of the bus.
+ * @param Bus [Output] Created bus.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_create(const char *Name, const fee_shmbus_config_t *Config, fee_shmbus_t **Bus);
+
+/**
+ * @brief Function that releases a bus. A named shared memory is unlinked; attached readers keep their mapping.
+ *
+ * @param Bus [Input] Bus to be released. It may be NULL.
+ */
+void fee_shmbus_destroy(fee_shmbus_t *Bus);
+
+/**
+ * @brief Function that returns the file descriptor of the shared memory of a bus.
+ *
+ * @param Bus [Input] Bus.
+ * @return int - File descriptor.
+ */
+int fee_shmbus_fd(const fee_shmbus_t *Bus);
+
+/**
+ * @brief Function that reserves the next slot and points PTD->ImageMatrix to its planes, so that fee_PTD_Read
+ *  decodes straight into shared memory. The frame becomes visible at fee_shmbus_commit.
+ *
+ * @param Bus [Input] Bus.
+ * @param TM [Input] TM information of the frame. Its geometry must fit in the planes of the bus.
+ * @param PTD [Output] ImageMatrix set to the planes of the slot.
+ * @return int - The function returns FEE_EXIT_ERROR if the geometry does not fit or the slot is still referenced (the
+ *  caller may retry or drop the frame). Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_reserve(fee_shmbus_t *Bus, const fee_TM_t *TM, fee_PTD_t *PTD);
+
+/**
+ * @brief Function that publishes the reserved slot to the attached readers.
+ *
+ * @param Bus [Input] Bus.
+ * @param PTD [Input] Decoded PTD. Its header is copied; its planes must be the ones set by fee_shmbus_reserve.
+ * @return int - The function returns FEE_EXIT_ERROR if no slot is reserved. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_commit(fee_shmbus_t *Bus, const fee_PTD_t *PTD);
+
+/**
+ * @brief Function that publishes a frame decoded elsewhere, copying its planes (fee_shmbus_reserve and fee_shmbus_commit).
+ *
+ * @param Bus [Input] Bus.
+ * @param TM [Input] TM information of the frame.
+ * @param PTD [Input] Decoded PTD.
+ * @return int - The function returns FEE_EXIT_ERROR if the frame cannot be reserved. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_publish(fee_shmbus_t *Bus, const fee_TM_t *TM, const fee_PTD_t *PTD);
+
+/**
+ * @brief Function that detaches a reader that cannot do it itself (e.g. a crashed process) and releases its slots.
+ *
+ * @param Bus [Input] Bus.
+ * @param ReaderId [Input] Identifier of the reader (fee_shmbus_reader_id).
+ * @return int - The function returns FEE_EXIT_ERROR if ReaderId is not valid. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_evict(fee_shmbus_t *Bus, uint32_t ReaderId);
+
+/**
+ * @brief Function that reads the counters of a bus.
+ *
+ * @param Bus [Input] Bus.
+ * @param Counters [Output] Counters.
+ */
+void fee_shmbus_counters(const fee_shmbus_t *Bus, fee_shmbus_counters_t *Counters);
+
+/**
+ * @brief Function that attaches a reader to a named bus. The reader receives the frames published from then on.
+ *
+ * @param Name [Input] POSIX shared memory name of the bus.
+ * @param Reader [Output] Attached reader.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs or the bus has no free reader. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_attach(const char *Name, fee_shmbus_reader_t **Reader);
+
+/**
+ * @brief Function that attaches a reader to the bus of a file descriptor (fee_shmbus_fd). The descriptor is duplicated.
+ *
+ * @param Fd [Input] File descriptor of the shared memory.
+ * @param Reader [Output] Attached reader.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs or the bus has no free reader. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_attach_fd(int Fd, fee_shmbus_reader_t **Reader);
+
+/**
+ * @brief Function that detaches a reader, releasing the slots it still references.
+ *
+ * @param Reader [Input] Reader. It may be NULL.
+ */
+void fee_shmbus_detach(fee_shmbus_reader_t *Reader);
+
+/**
+ * @brief Function that returns the identifier of a reader in its bus.
+ *
+ * @param Reader [Input] Reader.
+ * @return uint32_t - Identifier, lower than FEE_SHMBUS_MAX_READERS.
+ */
+uint32_t fee_shmbus_reader_id(const fee_shmbus_reader_t *Reader);
+
+/**
+ * @brief Function that reads the next frame without waiting. The planes are not copied: PTD->ImageMatrix points to
+ *  shared memory until fee_shmbus_release.
+ *
+ * @param Reader [Input] Reader.
+ * @param TM [Output] TM information of the frame. It may be NULL.
+ * @param PTD [Output] PTD header and planes of the frame.
+ * @param Sequence [Output] Sequence of the frame. Frames published while the reader was attaching may be skipped. It may be NULL.
+ * @return int - The function returns FEE_EXIT_ERROR if there is no new frame. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_read(fee_shmbus_reader_t *Reader, fee_TM_t *TM, fee_PTD_t *PTD, uint64_t *Sequence);
+
+/**
+ * @brief Function that releases the frame returned by fee_shmbus_read, so that its slot can be reused.
+ *
+ * @param Reader [Input] Reader.
+ * @return int - The function returns FEE_EXIT_ERROR if no frame is being read. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_shmbus_release(fee_shmbus_reader_t *Reader);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file fee_stats.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Hot-path statistics of the fee library: calls, processed bytes, failures by reason and log-linear latency
+ *  histograms of the serialization, size calculation and checksum functions. Counters are kept per thread and
+ *  aggregated on snapshot. The library must be built with the FEE_ENABLE_STATS option to collect them; otherwise the
+ *  instrumentation is not compiled and snapshots are empty.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_STATS_H
+#define FEE_STATS_H
+
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup StatsConstants
+ * @{
+ */
+
+/*Every power of two of the latency histograms is divided in 2^FEE_STATS_SUB_BUCKET_BITS linear buckets*/
+#define FEE_STATS_SUB_BUCKET_BITS 3
+#define FEE_STATS_SUB_BUCKETS (1 << FEE_STATS_SUB_BUCKET_BITS)
+/*Number of buckets of a latency histogram. Latencies up to 2^64 - 1 ns*/
+#define FEE_STATS_NUM_BUCKETS ((64 - FEE_STATS_SUB_BUCKET_BITS + 1) * FEE_STATS_SUB_BUCKETS)
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup StatsDataTypes
+ * @{
+ */
+
+/*Instrumented functions*/
+typedef enum
+{
+    FEE_STATS_TC_WRITE = 0,             /*fee_TC_Write*/
+    FEE_STATS_TM_READ = 1,              /*fee_TM_Read*/
+    FEE_STATS_PTD_READ = 2,             /*fee_PTD_Read*/
+    FEE_STATS_PTD_WRITE = 3,            /*fee_PTD_Write*/
+    FEE_STATS_CALCULATE_PTD_SIZES = 4,  /*fee_Calculate_PTD_Sizes*/
+    FEE_STATS_CHECK_TC_CHECKSUM = 5,    /*fee_CheckTeleCommandChecksum*/
+    FEE_STATS_CHECK_TM_CHECKSUM = 6,    /*fee_CheckTelemetryChecksum*/
+    FEE_STATS_CHECK_PTD_CHECKSUM = 7,   /*fee_CheckPTDChecksum*/
+    FEE_STATS_NUM_OPS = 8
+
+} fee_stats_op_t;
+
+/*Failure reasons*/
+typedef enum
+{
+    FEE_STATS_FAIL_CHECKSUM = 0, /*Read checksum differs from the calculated one*/
+    FEE_STATS_FAIL_GEOMETRY = 1, /*PTD sizes cannot be calculated from the TM (bandsize not multiple of binningsize)*/
+    FEE_STATS_FAIL_LENGTH = 2,   /*Packet length does not match the serialized parameters*/
+    FEE_STATS_NUM_FAILS = 3
+
+} fee_stats_fail_t;
+
+/*Statistics of an instrumented function*/
+typedef struct
+{
+    uint64_t Calls;                               /*Number of calls, including failed ones*/
+    uint64_t Bytes;                               /*Packet bytes processed by successful calls*/
+    uint64_t Failures[FEE_STATS_NUM_FAILS];       /*Failed calls by reason*/
+    uint64_t TotalNs;                             /*Sum of the latencies*/
+    uint64_t MaxNs;                               /*Maximum latency*/
+    uint64_t Histogram[FEE_STATS_NUM_BUCKETS];    /*Number of calls per latency bucket (fee_stats_bucket_bounds)*/
+
+} fee_stats_op_snapshot_t;
+
+/*Statistics of every instrumented function, aggregated over every thread*/
+typedef struct
+{
+    int Enabled;                                  /*0 if the library was built without FEE_ENABLE_STATS*/
+    fee_stats_op_snapshot_t Ops[FEE_STATS_NUM_OPS];
+
+} fee_stats_snapshot_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Stats Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that aggregates the statistics of every thread, including the ones that have already finished.
+ *  Counters of other threads are read while they are updated, so a snapshot is approximately consistent.
+ *
+ * @param Snapshot [Output] Aggregated statistics. Zeroed if the library was built without FEE_ENABLE_STATS.
+ * @return int - The function returns FEE_EXIT_ERROR if Snapshot is NULL. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_stats_snapshot(fee_stats_snapshot_t *Snapshot);
+
+/**
+ * @brief Function that resets the statistics of every thread. Every thread clears its counters before its next update.
+ */
+void fee_stats_reset(void);
+
+/**
+ * @brief Function that returns the latency range of a histogram bucket.
+ *
+ * @param Bucket [Input] Bucket index (lower than FEE_STATS_NUM_BUCKETS).
+ * @param LowerNs [Output] Lowest latency of the bucket.
+ * @param UpperNs [Output] Highest latency of the bucket.
+ * @return int - The function returns FEE_EXIT_ERROR if the bucket is not valid. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_stats_bucket_bounds(size_t Bucket, uint64_t *LowerNs, uint64_t *UpperNs);
+
+/**
+ * @brief Function that estimates a latency percentile from a histogram. The upper bound of the bucket is returned.
+ *
+ * @param Op [Input] Statistics of a function.
+ * @param Fraction [Input] Percentile between 0 and 1 (e.g. 0.99).
+ * @param LatencyNs [Output] Estimated latency.
+ * @return int - The function returns FEE_EXIT_ERROR if there are no calls or Fraction is not valid. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_stats_percentile(const fee_stats_op_snapshot_t *Op, double Fraction, uint64_t *LatencyNs);
+
+/**
+ * @brief Function that returns the name of an instrumented function.
+ *
+ * @param Op [Input] Instrumented function.
+ * @return const char* - Name of the function. NULL if Op is not valid.
+ */
+const char *fee_stats_op_name(fee_stats_op_t Op);
+
+/**@}*/
+
+#endif
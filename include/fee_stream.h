@@ -0,0 +1,206 @@
+/**
+ * @file fee_stream.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Stream continuity tracker of fee electronics packets. TM_COUNTER, TC_COUNTER and PIXEL_DATA_COUNTER are
+ *  followed in O(1) per packet, with wraparound, to report gaps, duplicates and reorderings and the loss rate of
+ *  every stream without post-processing the captures.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_STREAM_H
+#define FEE_STREAM_H
+
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup StreamConstants
+ * @{
+ */
+
+/*Number of counters before the highest one whose reception is remembered (reorder window)*/
+#define FEE_STREAM_WINDOW 64
+
+/*Jump of a counter, forward or backward, from which the stream is considered restarted*/
+#define FEE_STREAM_DEFAULT_RESYNC_GAP 1024
+
+/*Width in bits of the counters*/
+#define FEE_STREAM_TC_COUNTER_BITS 16
+#define FEE_STREAM_TM_COUNTER_BITS 32
+#define FEE_STREAM_PIXEL_DATA_COUNTER_BITS 32
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup StreamDataTypes
+ * @{
+ */
+
+/*Classification of a received counter*/
+typedef enum
+{
+    FEE_STREAM_IN_ORDER = 0,  /*Next expected counter (or the first one)*/
+    FEE_STREAM_GAP = 1,       /*Ahead of the expected counter. The skipped counters are counted as lost*/
+    FEE_STREAM_DUPLICATE = 2, /*Counter already received*/
+    FEE_STREAM_REORDERED = 3, /*Missing counter received late, inside the reorder window. It is not lost anymore*/
+    FEE_STREAM_LATE = 4,      /*Older than the reorder window. It cannot be told from a duplicate*/
+    FEE_STREAM_RESYNC = 5,    /*Jump larger than the resync gap. Tracking restarts at the counter*/
+    FEE_STREAM_REPEAT = 6     /*Same counter as the previous packet in a stream that allows repeats*/
+
+} fee_stream_event_t;
+
+/**
+ * Continuity state and running totals of a counter.
+ */
+typedef struct
+{
+    /*Configuration*/
+    uint32_t Mask;       /*2^bits - 1*/
+    uint32_t ResyncGap;  /*Jump from which the stream is restarted*/
+    int AllowRepeats;    /*Not 0 if consecutive packets may carry the same counter (TC_COUNTER echoed in TM)*/
+
+    /*State*/
+    int Started;         /*Not 0 once a counter has been received*/
+    uint32_t Highest;    /*Highest received counter (modulo 2^bits)*/
+    uint64_t Window;     /*Bit i is set if Highest - i has been received*/
+
+    /*Running totals*/
+    uint64_t Received;   /*Received packets*/
+    uint64_t Expected;   /*Counters spanned by the stream, from its first counter to Highest (resyncs included)*/
+    uint64_t Lost;       /*Counters not received*/
+    uint64_t Gaps;       /*Number of FEE_STREAM_GAP events*/
+    uint64_t Duplicates; /*Number of FEE_STREAM_DUPLICATE events*/
+    uint64_t Reordered;  /*Number of FEE_STREAM_REORDERED events*/
+    uint64_t Late;       /*Number of FEE_STREAM_LATE events*/
+    uint64_t Resyncs;    /*Number of FEE_STREAM_RESYNC events*/
+    uint64_t Repeats;    /*Number of FEE_STREAM_REPEAT events*/
+
+} fee_stream_counter_t;
+
+/**
+ * Trackers of a channel.
+ */
+typedef struct
+{
+    fee_stream_counter_t TM;      /*TM_COUNTER of the TM packets*/
+    fee_stream_counter_t TC_Echo; /*TC_COUNTER echoed in the TM packets. Repeats are allowed*/
+    fee_stream_counter_t TC;      /*TC_COUNTER of the TC packets*/
+    fee_stream_counter_t PTD;     /*PIXEL_DATA_COUNTER of the PTD packets*/
+
+} fee_stream_tracker_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup Stream Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that initializes the tracker of a counter.
+ *
+ * @param Counter [Output] Tracker.
+ * @param Bits [Input] Width of the counter (1-32).
+ * @param ResyncGap [Input] Jump from which the stream is restarted. 0 selects half of the counter range.
+ * @param AllowRepeats [Input] Not 0 if consecutive packets may carry the same counter.
+ * @return int - The function returns FEE_EXIT_ERROR if Bits or ResyncGap are not valid. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_stream_counter_init(fee_stream_counter_t *Counter, unsigned int Bits, uint32_t ResyncGap, int AllowRepeats);
+
+/**
+ * @brief Function that updates the tracker of a counter with a received value.
+ *
+ * @param Counter [Input/Output] Tracker.
+ * @param Value [Input] Received counter. Only the configured bits are used.
+ * @param Missing [Output] FEE_STREAM_GAP: number of skipped counters. 0 otherwise. It may be NULL.
+ * @return fee_stream_event_t - Classification of the counter.
+ */
+fee_stream_event_t fee_stream_counter_update(fee_stream_counter_t *Counter, uint32_t Value, uint32_t *Missing);
+
+/**
+ * @brief Function that returns the fraction of counters not received.
+ *
+ * @param Counter [Input] Tracker.
+ * @return double - Lost / Expected. 0 if nothing has been received.
+ */
+double fee_stream_counter_loss_rate(const fee_stream_counter_t *Counter);
+
+/**
+ * @brief Function that initializes the trackers of a channel with FEE_STREAM_DEFAULT_RESYNC_GAP.
+ *
+ * @param Tracker [Output] Trackers.
+ */
+void fee_stream_tracker_init(fee_stream_tracker_t *Tracker);
+
+/**
+ * @brief Function that updates the TM and TC echo trackers with a decoded TM.
+ *
+ * @param Tracker [Input/Output] Trackers.
+ * @param TM_Data_Struct [Input] Decoded TM.
+ * @return fee_stream_event_t - Classification of TM_COUNTER.
+ */
+fee_stream_event_t fee_stream_update_TM(fee_stream_tracker_t *Tracker, const fee_TM_t *TM_Data_Struct);
+
+/**
+ * @brief Function that updates the TC tracker with a decoded TC.
+ *
+ * @param Tracker [Input/Output] Trackers.
+ * @param TC_Data_Struct [Input] Decoded TC.
+ * @return fee_stream_event_t - Classification of TC_COUNTER.
+ */
+fee_stream_event_t fee_stream_update_TC(fee_stream_tracker_t *Tracker, const fee_TC_t *TC_Data_Struct);
+
+/**
+ * @brief Function that updates the PTD tracker with a decoded PTD.
+ *
+ * @param Tracker [Input/Output] Trackers.
+ * @param PTD_Data [Input] Decoded PTD.
+ * @return fee_stream_event_t - Classification of PIXEL_DATA_COUNTER.
+ */
+fee_stream_event_t fee_stream_update_PTD(fee_stream_tracker_t *Tracker, const fee_PTD_t *PTD_Data);
+
+/**
+ * @brief Function that updates the TM and TC echo trackers reading the counters of a raw TM packet, without decoding it.
+ *
+ * @param Tracker [Input/Output] Trackers.
+ * @param TM_Packet [Input] Raw TM packet.
+ * @return fee_stream_event_t - Classification of TM_COUNTER.
+ */
+fee_stream_event_t fee_stream_peek_TM(fee_stream_tracker_t *Tracker, const uint8_t *TM_Packet);
+
+/**
+ * @brief Function that updates the TC tracker reading the counter of a raw TC packet, without decoding it.
+ *
+ * @param Tracker [Input/Output] Trackers.
+ * @param TC_Packet [Input] Raw TC packet.
+ * @return fee_stream_event_t - Classification of TC_COUNTER.
+ */
+fee_stream_event_t fee_stream_peek_TC(fee_stream_tracker_t *Tracker, const uint8_t *TC_Packet);
+
+/**
+ * @brief Function that updates the PTD tracker reading the counter of a raw PTD packet, without decoding it.
+ *
+ * @param Tracker [Input/Output] Trackers.
+ * @param PTD_Packet [Input] Raw PTD packet (at least the first 4 bytes).
+ * @return fee_stream_event_t - Classification of PIXEL_DATA_COUNTER.
+ */
+fee_stream_event_t fee_stream_peek_PTD(fee_stream_tracker_t *Tracker, const uint8_t *PTD_Packet);
+
+/**@}*/
+
+#endif
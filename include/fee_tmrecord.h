@@ -0,0 +1,164 @@
+/**
+ * @file fee_tmrecord.h
+ * @author David Rodríguez Muñoz (david.rodriguez@iac.es)
+ * @brief Packed in-memory record of a TM packet. The configuration echo (Returned_TC) of a packet hardly ever
+ *  changes, so it is interned in a configuration table and the record only keeps its id, the TM_COUNTER and the 24
+ *  measurement words: 56 bytes without padding, against the 140 bytes of the packet and the larger fee_TM_t.
+ *  Records convert back to fee_TM_t and to the exact packet bytes.
+ * @version 0
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_TMRECORD_H
+#define FEE_TMRECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <fee.h>
+
+/*************************/
+/*       Consts          */
+/*************************/
+
+/**
+ * \defgroup TMRecordConstants
+ * @{
+ */
+
+/*Measurement words of a record: from CCDTEMP_MEAS1 to VAU_ERROR, in packet order*/
+#define FEE_TM_RECORD_NUM_WORDS ((TM_OFFSET_ACQSTARTDELAY - TM_OFFSET_CCDTEMP_MEAS1) / 2)
+
+/*Index in fee_tm_record_t.Words of the measurement word at a TM_OFFSET_* offset*/
+#define FEE_TM_RECORD_WORD(Offset) (((Offset) - TM_OFFSET_CCDTEMP_MEAS1) / 2)
+
+/*Bytes of the configuration echo of a TM packet, spare bytes included*/
+#define FEE_TM_CONFIG_ECHO_BYTES (TM_OFFSET_CCDTEMP_MEAS1 - TM_OFFSET_TC_COUNTER + TM_OFFSET_CHECKSUM - TM_OFFSET_ACQSTARTDELAY)
+
+/**@}*/
+
+/* --------------------- */
+/* ---- Data types ---- */
+/* --------------------- */
+
+/**
+ * \defgroup TMRecordDataTypes
+ * @{
+ */
+
+/*Packed TM packet*/
+typedef struct
+{
+    uint32_t TM_COUNTER;
+    uint32_t ConfigId;                        /*Id of the configuration echo in its fee_tm_config_table_t*/
+    uint16_t Words[FEE_TM_RECORD_NUM_WORDS];  /*Measurement words, in host order. Indexed with FEE_TM_RECORD_WORD*/
+
+} fee_tm_record_t;
+
+/**
+ * Interned configuration echoes. Ids are consecutive from 0 in order of appearance. Adding records modifies the table,
+ * so it must not be shared by several threads while records are added; converting records back only reads it.
+ */
+typedef struct fee_tm_config_table fee_tm_config_table_t;
+
+/**@}*/
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+/**
+ * \defgroup TMRecord Funcitons
+ * @{
+ */
+
+/**
+ * @brief Function that creates an empty configuration table.
+ *
+ * @param Table [Output] Created table.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_config_table_create(fee_tm_config_table_t **Table);
+
+/**
+ * @brief Function that frees a configuration table.
+ *
+ * @param Table [Input] Table. It may be NULL.
+ */
+void fee_tm_config_table_destroy(fee_tm_config_table_t *Table);
+
+/**
+ * @brief Function that returns the number of configurations of a table.
+ *
+ * @param Table [Input] Table.
+ * @return size_t - Number of interned configurations.
+ */
+size_t fee_tm_config_table_size(const fee_tm_config_table_t *Table);
+
+/**
+ * @brief Function that returns a decoded configuration.
+ *
+ * @param Table [Input] Table.
+ * @param ConfigId [Input] Id of the configuration.
+ * @param TC [Output] Configuration, as fee_TM_Read decodes it in Returned_TC.
+ * @return int - The function returns FEE_EXIT_ERROR if ConfigId is not in the table. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_config_get(const fee_tm_config_table_t *Table, uint32_t ConfigId, fee_TC_t *TC);
+
+/**
+ * @brief Function that packs a TM packet. Its configuration echo is added to the table if it is new.
+ *
+ * @param Table [Input] Table.
+ * @param Packet [Input] TM packet. The checksum is not checked.
+ * @param Record [Output] Packed packet.
+ * @return int - The function returns FEE_EXIT_ERROR if the configuration cannot be added. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_record_from_packet(fee_tm_config_table_t *Table, const fee_TM_Packet_t Packet, fee_tm_record_t *Record);
+
+/**
+ * @brief Function that packs several TM packets (fee_tm_record_from_packet).
+ *
+ * @param Table [Input] Table.
+ * @param Packets [Input] TM packets.
+ * @param NumPackets [Input] Number of packets.
+ * @param Records [Output] Packed packets.
+ * @return int - The function returns FEE_EXIT_ERROR if a configuration cannot be added. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_record_from_packets(fee_tm_config_table_t *Table, const fee_TM_Packet_t *Packets, size_t NumPackets,
+                               fee_tm_record_t *Records);
+
+/**
+ * @brief Function that packs a decoded TM packet. Its configuration is serialized as fee_TM_Write does.
+ *
+ * @param Table [Input] Table.
+ * @param TM [Input] Decoded packet.
+ * @param Record [Output] Packed packet.
+ * @return int - The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_record_from_tm(fee_tm_config_table_t *Table, const fee_TM_t *TM, fee_tm_record_t *Record);
+
+/**
+ * @brief Function that unpacks a record into a decoded TM packet, the same that fee_TM_Read gives for its packet.
+ *
+ * @param Table [Input] Table of the record.
+ * @param Record [Input] Packed packet.
+ * @param TM [Output] Decoded packet.
+ * @return int - The function returns FEE_EXIT_ERROR if the configuration of the record is not in the table. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_record_to_tm(const fee_tm_config_table_t *Table, const fee_tm_record_t *Record, fee_TM_t *TM);
+
+/**
+ * @brief Function that unpacks a record into the bytes of its TM packet, with a valid checksum.
+ *
+ * @param Table [Input] Table of the record.
+ * @param Record [Input] Packed packet.
+ * @param Packet [Output] TM packet.
+ * @return int - The function returns FEE_EXIT_ERROR if the configuration of the record is not in the table. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int fee_tm_record_to_packet(const fee_tm_config_table_t *Table, const fee_tm_record_t *Record, fee_TM_Packet_t Packet);
+
+/**@}*/
+
+#endif
@@ -0,0 +1,733 @@
+/**
+ * @file pyfee.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief CPython extension module of the fee library. Decoded images and TM columns are returned as buffer-protocol
+ *  objects over memory owned by the module and recycled through a pool, so numpy.asarray() and memoryview() use
+ *  them without copies. The GIL is released while packets are decoded.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fee.h>
+
+/*Size classes of the buffer pool: 2^POOL_MIN_SHIFT ... 2^(POOL_MIN_SHIFT + POOL_NUM_CLASSES - 1) bytes*/
+#define POOL_MIN_SHIFT 12
+#define POOL_NUM_CLASSES 16
+/*Free buffers kept per size class*/
+#define POOL_MAX_CACHED 8
+#define POOL_ALIGNMENT 64
+
+/*Status column values of read_tm_batch*/
+#define PYFEE_STATUS_OK 0
+#define PYFEE_STATUS_CHECKSUM 1
+#define PYFEE_STATUS_DECODE 2
+
+/* --------------------- */
+/* ---- Buffer pool ---- */
+/* --------------------- */
+
+/*The pool is only used with the GIL held*/
+static void *PoolFree[POOL_NUM_CLASSES][POOL_MAX_CACHED];
+static int PoolCount[POOL_NUM_CLASSES];
+
+/*Size class of a request. -1 if it is larger than the largest class*/
+static int PoolClass(size_t Bytes)
+{
+    int Class = 0;
+
+    while (Class < POOL_NUM_CLASSES && ((size_t)1 << (POOL_MIN_SHIFT + Class)) < Bytes)
+    {
+        Class++;
+    }
+
+    return Class < POOL_NUM_CLASSES ? Class : -1;
+}
+
+static void *PoolAcquire(size_t Bytes, size_t *Capacity)
+{
+    int Class = PoolClass(Bytes);
+    void *Data = NULL;
+
+    if (Class >= 0)
+    {
+        *Capacity = (size_t)1 << (POOL_MIN_SHIFT + Class);
+        if (PoolCount[Class] > 0)
+        {
+            return PoolFree[Class][--PoolCount[Class]];
+        }
+    }
+    else
+    {
+        *Capacity = Bytes;
+    }
+
+    if (posix_memalign(&Data, POOL_ALIGNMENT, *Capacity) != 0)
+    {
+        return NULL;
+    }
+
+    return Data;
+}
+
+static void PoolRelease(void *Data, size_t Capacity)
+{
+    int Class = PoolClass(Capacity);
+
+    if (Data == NULL)
+    {
+        return;
+    }
+
+    if (Class >= 0 && ((size_t)1 << (POOL_MIN_SHIFT + Class)) == Capacity && PoolCount[Class] < POOL_MAX_CACHED)
+    {
+        PoolFree[Class][PoolCount[Class]++] = Data;
+        return;
+    }
+
+    free(Data);
+}
+
+/* --------------------- */
+/* ---- Buffer type ---- */
+/* --------------------- */
+
+/*C-contiguous array of 1 or 2 dimensions over a pooled block*/
+typedef struct
+{
+    PyObject_HEAD
+    void *Data;
+    size_t Capacity;
+    int NDim;
+    Py_ssize_t Shape[2];
+    Py_ssize_t Strides[2];
+    Py_ssize_t ItemSize;
+    char Format[2];
+
+} PyFeeBuffer;
+
+static PyTypeObject PyFeeBufferType;
+static PyObject *PyFeeError;
+
+/*Reserve is the minimum size of the block, in case the writer needs more than the array*/
+static PyFeeBuffer *BufferNew(int NDim, Py_ssize_t Rows, Py_ssize_t Columns, Py_ssize_t ItemSize, size_t Reserve)
+{
+    PyFeeBuffer *Buffer;
+    size_t Bytes = (size_t)Rows * (size_t)(NDim == 2 ? Columns : 1) * (size_t)ItemSize;
+
+    if (Bytes < Reserve)
+    {
+        Bytes = Reserve;
+    }
+
+    Buffer = PyObject_New(PyFeeBuffer, &PyFeeBufferType);
+    if (Buffer == NULL)
+    {
+        return NULL;
+    }
+
+    /*Zero-sized buffers still get a valid pointer*/
+    Buffer->Data = PoolAcquire(Bytes > 0 ? Bytes : 1, &Buffer->Capacity);
+    if (Buffer->Data == NULL)
+    {
+        Buffer->Capacity = 0;
+        Py_DECREF(Buffer);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    Buffer->NDim = NDim;
+    Buffer->ItemSize = ItemSize;
+    Buffer->Shape[0] = Rows;
+    Buffer->Shape[1] = NDim == 2 ? Columns : 1;
+    Buffer->Strides[1] = ItemSize;
+    Buffer->Strides[0] = NDim == 2 ? Columns * ItemSize : ItemSize;
+    Buffer->Format[0] = ItemSize == 1 ? 'B' : (ItemSize == 2 ? 'H' : 'I');
+    Buffer->Format[1] = '\0';
+
+    return Buffer;
+}
+
+static void BufferDealloc(PyFeeBuffer *Buffer)
+{
+    PoolRelease(Buffer->Data, Buffer->Capacity);
+    Py_TYPE(Buffer)->tp_free((PyObject *)Buffer);
+}
+
+static int BufferGetBuffer(PyFeeBuffer *Buffer, Py_buffer *View, int Flags)
+{
+    View->buf = Buffer->Data;
+    View->obj = (PyObject *)Buffer;
+    Py_INCREF(Buffer);
+    View->len = Buffer->Shape[0] * (Buffer->NDim == 2 ? Buffer->Shape[1] : 1) * Buffer->ItemSize;
+    View->readonly = 0;
+    View->itemsize = Buffer->ItemSize;
+    View->format = (Flags & PyBUF_FORMAT) ? Buffer->Format : NULL;
+    View->ndim = Buffer->NDim;
+    View->shape = (Flags & PyBUF_ND) ? Buffer->Shape : NULL;
+    View->strides = (Flags & PyBUF_STRIDES) == PyBUF_STRIDES ? Buffer->Strides : NULL;
+    View->suboffsets = NULL;
+    View->internal = NULL;
+
+    return 0;
+}
+
+static PyObject *BufferGetShape(PyFeeBuffer *Buffer, void *Closure)
+{
+    (void)Closure;
+
+    if (Buffer->NDim == 2)
+    {
+        return Py_BuildValue("(nn)", Buffer->Shape[0], Buffer->Shape[1]);
+    }
+
+    return Py_BuildValue("(n)", Buffer->Shape[0]);
+}
+
+static PyObject *BufferGetFormat(PyFeeBuffer *Buffer, void *Closure)
+{
+    (void)Closure;
+
+    return PyUnicode_FromString(Buffer->Format);
+}
+
+static PyObject *BufferGetNbytes(PyFeeBuffer *Buffer, void *Closure)
+{
+    (void)Closure;
+
+    return PyLong_FromSsize_t(Buffer->Shape[0] * (Buffer->NDim == 2 ? Buffer->Shape[1] : 1) * Buffer->ItemSize);
+}
+
+static Py_ssize_t BufferLength(PyFeeBuffer *Buffer)
+{
+    return Buffer->Shape[0];
+}
+
+static PyBufferProcs BufferProcs = {
+    (getbufferproc)BufferGetBuffer,
+    NULL,
+};
+
+static PySequenceMethods BufferSequence = {
+    .sq_length = (lenfunc)BufferLength,
+};
+
+static PyGetSetDef BufferGetSet[] = {
+    {"shape", (getter)BufferGetShape, NULL, "Shape of the array", NULL},
+    {"format", (getter)BufferGetFormat, NULL, "struct module format of the items", NULL},
+    {"nbytes", (getter)BufferGetNbytes, NULL, "Size in bytes of the array", NULL},
+    {NULL, NULL, NULL, NULL, NULL},
+};
+
+static PyTypeObject PyFeeBufferType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "pyfee.Buffer",
+    .tp_doc = "Array over pooled library memory. Use numpy.asarray() or memoryview() to access it without copies.",
+    .tp_basicsize = sizeof(PyFeeBuffer),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)BufferDealloc,
+    .tp_as_buffer = &BufferProcs,
+    .tp_as_sequence = &BufferSequence,
+    .tp_getset = BufferGetSet,
+};
+
+/* --------------------- */
+/* ---- TM fields ------ */
+/* --------------------- */
+
+typedef struct
+{
+    const char *Name;
+    size_t Offset;
+    size_t Bytes;
+
+} TM_Field_t;
+
+#define TM_FIELD(field) {#field, offsetof(fee_TM_t, field), sizeof(((fee_TM_t *)0)->field)}
+#define TM_TC_FIELD(field) {#field, offsetof(fee_TM_t, Returned_TC.field), sizeof(((fee_TM_t *)0)->Returned_TC.field)}
+
+/*Columns of read_tm and read_tm_batch, in packet order*/
+static const TM_Field_t TM_Fields[] = {
+    TM_FIELD(TM_COUNTER),
+    TM_TC_FIELD(TC_COUNTER),
+    TM_TC_FIELD(OPMODE),
+    TM_TC_FIELD(EXPO_TIME),
+    TM_TC_FIELD(DUOUTDRAINTVLTG),
+    TM_TC_FIELD(DURESETVLTG),
+    TM_TC_FIELD(DUDUMPVLTG),
+    TM_TC_FIELD(DUOUTGATEVLTG),
+    TM_TC_FIELD(DUIMGCKHVLTG),
+    TM_TC_FIELD(DUSTGCKHVLTG),
+    TM_TC_FIELD(DUREGCKHVLTG),
+    TM_TC_FIELD(DUDUMPCKHVLTG),
+    TM_TC_FIELD(DURESETCKHVLTG),
+    TM_TC_FIELD(NBSMEAR),
+    TM_TC_FIELD(WOISTART),
+    TM_TC_FIELD(WOISIZE),
+    TM_TC_FIELD(SPATIALBINNINGMODE),
+    TM_TC_FIELD(FTPTIME),
+    TM_TC_FIELD(IMGSTGCKRFTIME),
+    TM_TC_FIELD(IMGSTGCKOVTIME),
+    TM_TC_FIELD(IMGSTGCKPWTIME),
+    TM_TC_FIELD(REGLINADVTIME),
+    TM_TC_FIELD(LINADVREGTIME),
+    TM_TC_FIELD(RCKPTIME),
+    TM_TC_FIELD(REGCKOVTIME),
+    TM_TC_FIELD(R1REGCKONTIME),
+    TM_TC_FIELD(R3REGCKONTIME),
+    TM_TC_FIELD(R2CKRISEDELTIME),
+    TM_TC_FIELD(RESETCKONTIME),
+    TM_TC_FIELD(RESETCKFALLDELTIME),
+    TM_TC_FIELD(ADC1TIME),
+    TM_TC_FIELD(ADC2TIME),
+    TM_TC_FIELD(ADC1RDDLY),
+    TM_TC_FIELD(ADC2RDDLY),
+    TM_TC_FIELD(DULAMBDA),
+    TM_TC_FIELD(FREQBINNINGBAND_1),
+    TM_TC_FIELD(FREQBINNINGBAND_2),
+    TM_TC_FIELD(FREQBINNINGBAND_3),
+    TM_TC_FIELD(FREQBINNINGBAND_4),
+    TM_TC_FIELD(FREQBINNINGBAND_5),
+    TM_TC_FIELD(PIXEL_MIN),
+    TM_TC_FIELD(PIXEL_MAX),
+    TM_TC_FIELD(SYNTPATTERN),
+    TM_TC_FIELD(CDSPARAMS),
+    TM_TC_FIELD(HCNBSAMPLE),
+    TM_TC_FIELD(NBTAIL),
+    TM_TC_FIELD(ACQSTARTDELAY),
+    TM_FIELD(CCDTEMP_MEAS1),
+    TM_FIELD(CCDTEMP_MEAS2),
+    TM_FIELD(VAUTEMP_MEAS),
+    TM_FIELD(FPPETEMP_MEAS),
+    TM_FIELD(VODE_MEAS),
+    TM_FIELD(VODF_MEAS),
+    TM_FIELD(VODG_MEAS),
+    TM_FIELD(VODH_MEAS),
+    TM_FIELD(VRD_MEAS),
+    TM_FIELD(VDD_MEAS),
+    TM_FIELD(VOG_MEAS),
+    TM_FIELD(IPHIH_MEAS),
+    TM_FIELD(SPHIH_MEAS),
+    TM_FIELD(RPHIH_MEAS),
+    TM_FIELD(PHIRH_MEAS),
+    TM_FIELD(VDGH_MEAS),
+    TM_FIELD(VANAP_MEAS),
+    TM_FIELD(VANAN_MEAS),
+    TM_FIELD(VDET_MEAS),
+    TM_FIELD(VDRV_MEAS),
+    TM_FIELD(VDIG_MEAS),
+    TM_FIELD(IDIG_MEAS),
+    TM_FIELD(TC_ERROR),
+    TM_FIELD(VAU_ERROR),
+};
+
+#define NUM_TM_FIELDS (sizeof(TM_Fields) / sizeof(TM_Fields[0]))
+
+static uint32_t TM_FieldValue(const fee_TM_t *TM_Data_Struct, const TM_Field_t *Field)
+{
+    const uint8_t *Source = (const uint8_t *)TM_Data_Struct + Field->Offset;
+    uint8_t Value8;
+    uint16_t Value16;
+    uint32_t Value32;
+
+    switch (Field->Bytes)
+    {
+    case 1:
+        memcpy(&Value8, Source, 1);
+        return Value8;
+    case 2:
+        memcpy(&Value16, Source, 2);
+        return Value16;
+    default:
+        memcpy(&Value32, Source, 4);
+        return Value32;
+    }
+}
+
+/*Get a contiguous read-only view of a bytes-like argument with a minimum size*/
+static int GetPacket(PyObject *Object, Py_buffer *View, Py_ssize_t MinBytes, const char *Name)
+{
+    if (PyObject_GetBuffer(Object, View, PyBUF_C_CONTIGUOUS) != 0)
+    {
+        return -1;
+    }
+
+    if (View->len < MinBytes)
+    {
+        PyErr_Format(PyExc_ValueError, "%s must have at least %zd bytes, got %zd", Name, MinBytes, View->len);
+        PyBuffer_Release(View);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*Decode a TM packet (GIL released by the caller or not)*/
+static int DecodeTM(uint8_t *Packet, int CheckChecksum, fee_TM_t *TM_Data_Struct)
+{
+    if (CheckChecksum && fee_CheckTelemetryChecksum(Packet) != FEE_EXIT_SUCCESS)
+    {
+        return PYFEE_STATUS_CHECKSUM;
+    }
+
+    if (fee_TM_Read(Packet, TM_Data_Struct) != FEE_EXIT_SUCCESS)
+    {
+        return PYFEE_STATUS_DECODE;
+    }
+
+    return PYFEE_STATUS_OK;
+}
+
+static void RaiseStatus(int Status, const char *Packet)
+{
+    PyErr_Format(PyFeeError, Status == PYFEE_STATUS_CHECKSUM ? "Wrong %s checksum" : "Error decoding the %s packet", Packet);
+}
+
+/* --------------------- */
+/* ---- Functions ------ */
+/* --------------------- */
+
+static PyObject *PyFee_read_tm(PyObject *Self, PyObject *Args, PyObject *Kwargs)
+{
+    static char *Keywords[] = {"packet", "check_checksum", NULL};
+    PyObject *PacketObject, *Result, *Value;
+    Py_buffer View;
+    fee_TM_t TM_Data_Struct;
+    int CheckChecksum = 1, Status;
+    size_t i;
+
+    (void)Self;
+
+    if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "O|p", Keywords, &PacketObject, &CheckChecksum) ||
+        GetPacket(PacketObject, &View, TM_PACKET_BYTES, "packet") != 0)
+    {
+        return NULL;
+    }
+
+    Status = DecodeTM(View.buf, CheckChecksum, &TM_Data_Struct);
+    PyBuffer_Release(&View);
+
+    if (Status != PYFEE_STATUS_OK)
+    {
+        RaiseStatus(Status, "TM");
+        return NULL;
+    }
+
+    Result = PyDict_New();
+    if (Result == NULL)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < NUM_TM_FIELDS; i++)
+    {
+        Value = PyLong_FromUnsignedLong(TM_FieldValue(&TM_Data_Struct, &TM_Fields[i]));
+        if (Value == NULL || PyDict_SetItemString(Result, TM_Fields[i].Name, Value) != 0)
+        {
+            Py_XDECREF(Value);
+            Py_DECREF(Result);
+            return NULL;
+        }
+        Py_DECREF(Value);
+    }
+
+    return Result;
+}
+
+static PyObject *PyFee_read_tm_batch(PyObject *Self, PyObject *Args, PyObject *Kwargs)
+{
+    static char *Keywords[] = {"packets", "check_checksum", NULL};
+    PyObject *PacketsObject, *Result = NULL;
+    PyFeeBuffer *Columns[NUM_TM_FIELDS] = {NULL};
+    PyFeeBuffer *StatusColumn = NULL;
+    Py_buffer View;
+    Py_ssize_t NumPackets, PacketIt;
+    fee_TM_t TM_Data_Struct;
+    uint8_t *Status;
+    int CheckChecksum = 1;
+    size_t i;
+    uint32_t Value;
+
+    (void)Self;
+
+    if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "O|p", Keywords, &PacketsObject, &CheckChecksum) ||
+        GetPacket(PacketsObject, &View, 0, "packets") != 0)
+    {
+        return NULL;
+    }
+
+    if (View.len % TM_PACKET_BYTES != 0)
+    {
+        PyErr_Format(PyExc_ValueError, "packets length must be a multiple of %d", TM_PACKET_BYTES);
+        PyBuffer_Release(&View);
+        return NULL;
+    }
+    NumPackets = View.len / TM_PACKET_BYTES;
+
+    /*Columns are reserved with the GIL held*/
+    StatusColumn = BufferNew(1, NumPackets, 1, 1, 0);
+    if (StatusColumn == NULL)
+    {
+        goto Exit;
+    }
+    for (i = 0; i < NUM_TM_FIELDS; i++)
+    {
+        Columns[i] = BufferNew(1, NumPackets, 1, (Py_ssize_t)TM_Fields[i].Bytes, 0);
+        if (Columns[i] == NULL)
+        {
+            goto Exit;
+        }
+    }
+
+    Status = StatusColumn->Data;
+
+    Py_BEGIN_ALLOW_THREADS
+
+    for (PacketIt = 0; PacketIt < NumPackets; PacketIt++)
+    {
+        Status[PacketIt] = (uint8_t)DecodeTM((uint8_t *)View.buf + PacketIt * TM_PACKET_BYTES, CheckChecksum, &TM_Data_Struct);
+        if (Status[PacketIt] != PYFEE_STATUS_OK)
+        {
+            memset(&TM_Data_Struct, 0, sizeof(TM_Data_Struct));
+        }
+
+        /*Scatter the fields into the columns*/
+        for (i = 0; i < NUM_TM_FIELDS; i++)
+        {
+            Value = TM_FieldValue(&TM_Data_Struct, &TM_Fields[i]);
+            switch (TM_Fields[i].Bytes)
+            {
+            case 1:
+                ((uint8_t *)Columns[i]->Data)[PacketIt] = (uint8_t)Value;
+                break;
+            case 2:
+                ((uint16_t *)Columns[i]->Data)[PacketIt] = (uint16_t)Value;
+                break;
+            default:
+                ((uint32_t *)Columns[i]->Data)[PacketIt] = Value;
+                break;
+            }
+        }
+    }
+
+    Py_END_ALLOW_THREADS
+
+    Result = PyDict_New();
+    if (Result == NULL)
+    {
+        goto Exit;
+    }
+    for (i = 0; i < NUM_TM_FIELDS; i++)
+    {
+        if (PyDict_SetItemString(Result, TM_Fields[i].Name, (PyObject *)Columns[i]) != 0)
+        {
+            Py_CLEAR(Result);
+            goto Exit;
+        }
+    }
+    if (PyDict_SetItemString(Result, "status", (PyObject *)StatusColumn) != 0)
+    {
+        Py_CLEAR(Result);
+    }
+
+Exit:
+    for (i = 0; i < NUM_TM_FIELDS; i++)
+    {
+        Py_XDECREF(Columns[i]);
+    }
+    Py_XDECREF(StatusColumn);
+    PyBuffer_Release(&View);
+
+    return Result;
+}
+
+static PyObject *PyFee_ptd_sizes(PyObject *Self, PyObject *Args)
+{
+    PyObject *TM_Object;
+    Py_buffer View;
+    fee_TM_t TM_Data_Struct;
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageSizes;
+    int Status;
+
+    (void)Self;
+
+    if (!PyArg_ParseTuple(Args, "O", &TM_Object) || GetPacket(TM_Object, &View, TM_PACKET_BYTES, "tm") != 0)
+    {
+        return NULL;
+    }
+
+    Status = DecodeTM(View.buf, 0, &TM_Data_Struct);
+    PyBuffer_Release(&View);
+
+    if (Status != PYFEE_STATUS_OK || fee_Calculate_PTD_Sizes(TM_Data_Struct, &PTDSizes, &ImageSizes) != FEE_EXIT_SUCCESS)
+    {
+        PyErr_SetString(PyFeeError, "PTD sizes cannot be calculated from the TM");
+        return NULL;
+    }
+
+    return Py_BuildValue("{s:n,s:n,s:n,s:n,s:n}",
+                         "packet_bytes", (Py_ssize_t)PTDSizes.DataPacketTotalBytes,
+                         "data_rows", (Py_ssize_t)PTDSizes.NumDataRows,
+                         "overscan_rows", (Py_ssize_t)PTDSizes.NumOverScanRows,
+                         "image_rows", (Py_ssize_t)ImageSizes.ImageTotalRows,
+                         "image_columns", (Py_ssize_t)ImageSizes.ImageTotalColumns);
+}
+
+static PyObject *PyFee_read_ptd(PyObject *Self, PyObject *Args, PyObject *Kwargs)
+{
+    static char *Keywords[] = {"packet", "tm", "check_checksum", NULL};
+    PyObject *PacketObject, *TM_Object, *Result = NULL;
+    PyFeeBuffer *Planes[FEE_NUM_CCD] = {NULL};
+    Py_buffer PacketView, TM_View;
+    fee_TM_t TM_Data_Struct;
+    fee_PTD_t PTD_Data;
+    fee_ImageMatrixTotalSizes_t ImageSizes;
+    int CheckChecksum = 1, Status, CCD;
+
+    (void)Self;
+
+    if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "OO|p", Keywords, &PacketObject, &TM_Object, &CheckChecksum) ||
+        GetPacket(TM_Object, &TM_View, TM_PACKET_BYTES, "tm") != 0)
+    {
+        return NULL;
+    }
+
+    Status = DecodeTM(TM_View.buf, 0, &TM_Data_Struct);
+    PyBuffer_Release(&TM_View);
+
+    memset(&PTD_Data, 0, sizeof(PTD_Data));
+    if (Status != PYFEE_STATUS_OK ||
+        fee_Calculate_PTD_Sizes(TM_Data_Struct, &PTD_Data.PTDSizes, &ImageSizes) != FEE_EXIT_SUCCESS ||
+        PTD_Data.PTDSizes.DataPacketTotalBytes == 0)
+    {
+        PyErr_SetString(PyFeeError, "The TM does not describe a PTD packet");
+        return NULL;
+    }
+
+    PTD_Data.PTDImageMatrixTotalSizes = ImageSizes;
+
+    if (GetPacket(PacketObject, &PacketView, (Py_ssize_t)PTD_Data.PTDSizes.DataPacketTotalBytes, "packet") != 0)
+    {
+        return NULL;
+    }
+
+    /*Planes are taken from the pool with the GIL held*/
+    for (CCD = 0; CCD < FEE_NUM_CCD; CCD++)
+    {
+        Planes[CCD] = BufferNew(2, (Py_ssize_t)ImageSizes.ImageTotalRows, (Py_ssize_t)ImageSizes.ImageTotalColumns, 2,
+                                ImageSizes.ImageMatrixBytes);
+        if (Planes[CCD] == NULL)
+        {
+            goto Exit;
+        }
+        PTD_Data.ImageMatrix[CCD] = Planes[CCD]->Data;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+
+    if (CheckChecksum && fee_CheckPTDChecksum(PacketView.buf, PTD_Data.PTDSizes) != FEE_EXIT_SUCCESS)
+    {
+        Status = PYFEE_STATUS_CHECKSUM;
+    }
+    else if (fee_PTD_Read(PacketView.buf, TM_Data_Struct, &PTD_Data) != FEE_EXIT_SUCCESS)
+    {
+        Status = PYFEE_STATUS_DECODE;
+    }
+    else
+    {
+        Status = PYFEE_STATUS_OK;
+    }
+
+    Py_END_ALLOW_THREADS
+
+    if (Status != PYFEE_STATUS_OK)
+    {
+        RaiseStatus(Status, "PTD");
+        goto Exit;
+    }
+
+    Result = Py_BuildValue("{s:k,s:(HHHH),s:(OO)}",
+                           "pixel_data_counter", (unsigned long)PTD_Data.PIXEL_DATA_COUNTER,
+                           "voltages_references", PTD_Data.VOLTAGES_REFERENCES[0], PTD_Data.VOLTAGES_REFERENCES[1],
+                           PTD_Data.VOLTAGES_REFERENCES[2], PTD_Data.VOLTAGES_REFERENCES[3],
+                           "planes", (PyObject *)Planes[0], (PyObject *)Planes[1]);
+
+Exit:
+    for (CCD = 0; CCD < FEE_NUM_CCD; CCD++)
+    {
+        Py_XDECREF(Planes[CCD]);
+    }
+    PyBuffer_Release(&PacketView);
+
+    return Result;
+}
+
+static PyMethodDef PyFeeMethods[] = {
+    {"read_tm", (PyCFunction)(void (*)(void))PyFee_read_tm, METH_VARARGS | METH_KEYWORDS,
+     "read_tm(packet, check_checksum=True) -> dict\n\nDecode a TM packet into a dictionary of fields."},
+    {"read_tm_batch", (PyCFunction)(void (*)(void))PyFee_read_tm_batch, METH_VARARGS | METH_KEYWORDS,
+     "read_tm_batch(packets, check_checksum=True) -> dict\n\n"
+     "Decode concatenated TM packets into columns (Buffer objects, one item per packet) and a 'status' column\n"
+     "(0 ok, 1 wrong checksum, 2 decode error). Fields of failed packets are 0. The GIL is released while decoding."},
+    {"read_ptd", (PyCFunction)(void (*)(void))PyFee_read_ptd, METH_VARARGS | METH_KEYWORDS,
+     "read_ptd(packet, tm, check_checksum=True) -> dict\n\n"
+     "Decode a PTD packet with the geometry of its raw TM packet. The image planes are (rows, columns) uint16\n"
+     "Buffer objects over pooled memory. The GIL is released while decoding."},
+    {"ptd_sizes", PyFee_ptd_sizes, METH_VARARGS,
+     "ptd_sizes(tm) -> dict\n\nSizes of the PTD packet and image described by a raw TM packet."},
+    {NULL, NULL, 0, NULL},
+};
+
+static struct PyModuleDef PyFeeModule = {
+    PyModuleDef_HEAD_INIT,
+    "pyfee",
+    "Zero-copy bindings of the fee electronics packets library.",
+    -1,
+    PyFeeMethods,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+};
+
+PyMODINIT_FUNC PyInit_pyfee(void)
+{
+    PyObject *Module;
+
+    if (PyType_Ready(&PyFeeBufferType) < 0)
+    {
+        return NULL;
+    }
+
+    Module = PyModule_Create(&PyFeeModule);
+    if (Module == NULL)
+    {
+        return NULL;
+    }
+
+    PyFeeError = PyErr_NewException("pyfee.error", PyExc_ValueError, NULL);
+    Py_INCREF(&PyFeeBufferType);
+    if (PyFeeError == NULL ||
+        PyModule_AddObject(Module, "error", PyFeeError) != 0 ||
+        PyModule_AddObject(Module, "Buffer", (PyObject *)&PyFeeBufferType) != 0 ||
+        PyModule_AddIntConstant(Module, "TM_PACKET_BYTES", TM_PACKET_BYTES) != 0 ||
+        PyModule_AddIntConstant(Module, "TC_PACKET_BYTES", TC_PACKET_BYTES) != 0 ||
+        PyModule_AddIntConstant(Module, "STATUS_OK", PYFEE_STATUS_OK) != 0 ||
+        PyModule_AddIntConstant(Module, "STATUS_CHECKSUM", PYFEE_STATUS_CHECKSUM) != 0 ||
+        PyModule_AddIntConstant(Module, "STATUS_DECODE", PYFEE_STATUS_DECODE) != 0)
+    {
+        Py_DECREF(Module);
+        return NULL;
+    }
+
+    return Module;
+}
@@ -13,7 +13,10 @@
 #include <arpa/inet.h>
 #include <string.h>
 #include <fee.h>
+#include <fee_inline.h>
 #include "../common/fee_common.h"
+#include "../common/fee_stats_internal.h"
+#include "fee_PTDKernels.h"
 
 #define NUM_DARK_INFO_PER_ROW 2 /*Number of dark-info parameters in each row data of the data packet*/
 #define NUM_CHANNELS_READFPGA 2 /*UP and Bottom channels. One per each CCD*/
@@ -24,11 +27,11 @@
 #define BYTES_PTD_PARAMETERS 2           /*Length in bytes of each data packet parameter. Only PIXEL_DATA_COUNTER is 4 bytes*/
 
 size_t fee_PTDImageIndx(size_t RowIndex, size_t ColIndex, size_t NumColumns)
-{   
-    return RowIndex * NumColumns + ColIndex;
+{
+    return fee_inline_PTDImageIndx(RowIndex, ColIndex, NumColumns);
 }
 
-int fee_Calculate_PTD_Sizes(fee_TM_t TmInformation, fee_PTDSizes_t *PTDSizes, fee_ImageMatrixTotalSizes_t *ImageMatrixSizes)
+static int CalculatePTDSizes(fee_TM_t TmInformation, fee_PTDSizes_t *PTDSizes, fee_ImageMatrixTotalSizes_t *ImageMatrixSizes)
 {
 
     /*	o is the index of rows defined in Table 3.6 1 and ranges from 1 to WOISIZE/(SBM+1),
@@ -133,7 +136,19 @@ int fee_Calculate_PTD_Sizes(fee_TM_t TmInformation, fee_PTDSizes_t *PTDSizes, fe
     return FEE_EXIT_SUCCESS;
 }
 
-int fee_PTD_Read(uint8_t *PixelDataPacket, fee_TM_t TmInformation, fee_PTD_t *PTD_Data)
+int fee_Calculate_PTD_Sizes(fee_TM_t TmInformation, fee_PTDSizes_t *PTDSizes, fee_ImageMatrixTotalSizes_t *ImageMatrixSizes)
+{
+    int Status;
+    FEE_STATS_START(Timer);
+
+    Status = CalculatePTDSizes(TmInformation, PTDSizes, ImageMatrixSizes);
+
+    FEE_STATS_STOP(FEE_STATS_CALCULATE_PTD_SIZES, Timer, Status, 0, FEE_STATS_FAIL_GEOMETRY);
+
+    return Status;
+}
+
+static int DeserializePTD(uint8_t *PixelDataPacket, fee_TM_t TmInformation, fee_PTD_t *PTD_Data)
 {
 
     fee_PTDSizes_t *PTDSizes;
@@ -146,14 +161,23 @@ int fee_PTD_Read(uint8_t *PixelDataPacket, fee_TM_t TmInformation, fee_PTD_t *PT
     size_t TotalColumns = 0;
 
     DeserializationInfo_t PTD_DeserializationInfo;
+    const PTDKernel_t *Kernel;
 
     PTDSizes = &PTD_Data->PTDSizes;
 
-    if (fee_Calculate_PTD_Sizes(TmInformation, PTDSizes, &PTD_Data->PTDImageMatrixTotalSizes) != FEE_EXIT_SUCCESS)
+    if (CalculatePTDSizes(TmInformation, PTDSizes, &PTD_Data->PTDImageMatrixTotalSizes) != FEE_EXIT_SUCCESS)
     {
         return FEE_EXIT_ERROR;
     }
 
+    /*Geometries with a specialized kernel*/
+    Kernel = FindPTDKernel(PTDSizes);
+    if (Kernel != NULL)
+    {
+        Kernel->Read(PixelDataPacket, PTD_Data);
+        return FEE_EXIT_SUCCESS;
+    }
+
     TotalColumns = PTD_Data->PTDImageMatrixTotalSizes.ImageTotalColumns;
 
     /*Initialize PTD Desiarilazation Information*/
@@ -301,8 +325,36 @@ int fee_PTD_Read(uint8_t *PixelDataPacket, fee_TM_t TmInformation, fee_PTD_t *PT
     return FEE_EXIT_SUCCESS;
 }
 
+#ifdef FEE_ENABLE_STATS
+/*Failure reason of the PTD serialization functions. Only used by the statistics*/
+static fee_stats_fail_t PTDFailureReason(fee_TM_t TmInformation)
+{
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+
+    if (CalculatePTDSizes(TmInformation, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_STATS_FAIL_GEOMETRY;
+    }
+
+    return FEE_STATS_FAIL_LENGTH;
+}
+#endif
+
+int fee_PTD_Read(uint8_t *PixelDataPacket, fee_TM_t TmInformation, fee_PTD_t *PTD_Data)
+{
+    int Status;
+    FEE_STATS_START(Timer);
+
+    Status = DeserializePTD(PixelDataPacket, TmInformation, PTD_Data);
+
+    FEE_STATS_STOP(FEE_STATS_PTD_READ, Timer, Status, PTD_Data->PTDSizes.DataPacketTotalBytes, PTDFailureReason(TmInformation));
+
+    return Status;
+}
+
 /*TBD Cambiar las descripciones*/
-int fee_PTD_Write(fee_TM_t TmInformation, fee_PTD_t PTD_Data, uint8_t *PixelDataPacket)
+static int SerializePTD(fee_TM_t TmInformation, fee_PTD_t PTD_Data, uint8_t *PixelDataPacket, size_t *PacketBytes)
 {
 
     fee_PTDSizes_t *PTDSizes;
@@ -314,13 +366,25 @@ int fee_PTD_Write(fee_TM_t TmInformation, fee_PTD_t PTD_Data, uint8_t *PixelData
 
     size_t TotalColumns = 0;
     size_t byte_counter = 0;
+    const PTDKernel_t *Kernel;
 
     PTDSizes = &PTD_Data.PTDSizes;
 
-    if (fee_Calculate_PTD_Sizes(TmInformation, PTDSizes, &PTD_Data.PTDImageMatrixTotalSizes) != FEE_EXIT_SUCCESS)
+    if (CalculatePTDSizes(TmInformation, PTDSizes, &PTD_Data.PTDImageMatrixTotalSizes) != FEE_EXIT_SUCCESS)
     {
         return FEE_EXIT_ERROR;
     }
+    *PacketBytes = PTDSizes->DataPacketTotalBytes;
+
+    /*Geometries with a specialized kernel*/
+    Kernel = FindPTDKernel(PTDSizes);
+    if (Kernel != NULL)
+    {
+        Kernel->Write(&PTD_Data, PixelDataPacket);
+        CalculatedChecksum = XORChecksum16(PixelDataPacket, PTDSizes->DataPacketTotalBytes - PTD_CHECKSUM_BYTES);
+        memcpy(PixelDataPacket + PTDSizes->DataPacketTotalBytes - PTD_CHECKSUM_BYTES, &CalculatedChecksum, PTD_CHECKSUM_BYTES);
+        return FEE_EXIT_SUCCESS;
+    }
 
     TotalColumns = PTD_Data.PTDImageMatrixTotalSizes.ImageTotalColumns;;
 
@@ -460,9 +524,22 @@ int fee_PTD_Write(fee_TM_t TmInformation, fee_PTD_t PTD_Data, uint8_t *PixelData
     return FEE_EXIT_SUCCESS;
 }
 
+int fee_PTD_Write(fee_TM_t TmInformation, fee_PTD_t PTD_Data, uint8_t *PixelDataPacket)
+{
+    int Status;
+    size_t PacketBytes = 0;
+    FEE_STATS_START(Timer);
+
+    Status = SerializePTD(TmInformation, PTD_Data, PixelDataPacket, &PacketBytes);
+
+    FEE_STATS_STOP(FEE_STATS_PTD_WRITE, Timer, Status, PacketBytes, PTDFailureReason(TmInformation));
+
+    return Status;
+}
 
 
-int fee_CheckPTDChecksum(fee_TM_Packet_t PTD_Packet, fee_PTDSizes_t PTDSizes){
+
+static int CheckPTDChecksum(fee_TM_Packet_t PTD_Packet, fee_PTDSizes_t PTDSizes){
 
     uint16_t ReadedChecksum = 0;
     uint16_t CalculatedChecksum = 0;
@@ -481,3 +558,43 @@ int fee_CheckPTDChecksum(fee_TM_Packet_t PTD_Packet, fee_PTDSizes_t PTDSizes){
 
     return FEE_EXIT_SUCCESS;
 }
+
+int fee_CheckPTDChecksum(fee_TM_Packet_t PTD_Packet, fee_PTDSizes_t PTDSizes)
+{
+    int Status;
+    FEE_STATS_START(Timer);
+
+    Status = CheckPTDChecksum(PTD_Packet, PTDSizes);
+
+    FEE_STATS_STOP(FEE_STATS_CHECK_PTD_CHECKSUM, Timer, Status, PTDSizes.DataPacketTotalBytes, FEE_STATS_FAIL_CHECKSUM);
+
+    return Status;
+}
+
+const char *fee_PTD_KernelName(fee_TM_t TmInformation)
+{
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+    const PTDKernel_t *Kernel;
+
+    if (CalculatePTDSizes(TmInformation, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_PTD_GENERIC_KERNEL_NAME;
+    }
+
+    Kernel = FindPTDKernel(&PTDSizes);
+
+    return Kernel != NULL ? Kernel->Name : FEE_PTD_GENERIC_KERNEL_NAME;
+}
+
+int fee_PTD_SetParameter(uint8_t *PixelDataPacket, fee_PTDSizes_t PTDSizes, size_t offset, int parameter_length_bytes, uint32_t value)
+{
+    /*Protection against empty packets*/
+    if (PTDSizes.DataPacketTotalBytes < PTD_CHECKSUM_BYTES)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return PatchParameter_Checksum16(PixelDataPacket, PTDSizes.DataPacketTotalBytes - PTD_CHECKSUM_BYTES,
+                                     offset, parameter_length_bytes, value);
+}
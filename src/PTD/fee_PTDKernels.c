@@ -0,0 +1,325 @@
+/**
+ * @file fee_PTDKernels.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief PTD serialization kernels specialized for the row lengths of the production geometries. The packet layout
+ *  only depends on the number of pixels of a row (the split of the pixels among the FREQBINNINGBAND_n and the
+ *  spatial binning only change the number of rows), so every kernel bakes it in as a constant and the compiler can
+ *  unroll and vectorize the deinterleaving of the CCD. Any other geometry uses the generic loop of fee_PTD.c.
+ *  When the CPU-feature dispatch selects a vector tier, every geometry uses the dispatched pixel kernels instead.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "fee_PTDKernels.h"
+#include "../common/fee_dispatch_internal.h"
+
+#define NUM_DARK_INFO_PER_ROW 2 /*Number of dark-info parameters in each row data of the data packet*/
+#define NUM_VOLTAGE_REF_INFO 4  /*Number of voltage reference parameters in Pixel data packet*/
+
+#if defined(__GNUC__)
+#define FEE_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define FEE_ALWAYS_INLINE inline
+#endif
+
+static pthread_once_t KernelsOnce = PTHREAD_ONCE_INIT;
+static int KernelsEnabled = 1;
+
+static void ReadKernelsEnv(void)
+{
+    const char *Value = getenv(FEE_PTD_KERNELS_ENV);
+
+    KernelsEnabled = Value == NULL || strcmp(Value, FEE_PTD_GENERIC_KERNEL_NAME) != 0;
+}
+
+static FEE_ALWAYS_INLINE uint16_t Load16(const uint8_t *Packet)
+{
+    return (uint16_t)((Packet[0] << 8) | Packet[1]);
+}
+
+static FEE_ALWAYS_INLINE void Store16(uint8_t *Packet, uint16_t Value)
+{
+    Packet[0] = (uint8_t)(Value >> 8);
+    Packet[1] = (uint8_t)Value;
+}
+
+/*Rows of the image of every CCD*/
+static FEE_ALWAYS_INLINE void RowPointers(const fee_PTD_t *PTD_Data, size_t RowIndex, size_t TotalColumns,
+                                          uint16_t *Rows[FEE_NUM_CCD])
+{
+    size_t CCDIt;
+
+    for (CCDIt = 0; CCDIt < FEE_NUM_CCD; CCDIt++)
+    {
+        Rows[CCDIt] = PTD_Data->ImageMatrix[CCDIt] + RowIndex * TotalColumns;
+    }
+}
+
+/*Dark info of every CCD at the beginning of a data or over-scan row*/
+static FEE_ALWAYS_INLINE const uint8_t *ReadDark(const uint8_t *Packet, uint16_t *Rows[FEE_NUM_CCD])
+{
+    size_t CCDIt, DarkIt;
+
+    for (CCDIt = 0; CCDIt < FEE_NUM_CCD; CCDIt++)
+    {
+        for (DarkIt = 0; DarkIt < NUM_DARK_INFO_PER_ROW; DarkIt++, Packet += 2)
+        {
+            Rows[CCDIt][DarkIt] = Load16(Packet);
+        }
+    }
+
+    return Packet;
+}
+
+/*Pixels of a row, interleaved by CCD. Unpack is the dispatched kernel, or NULL for the inline loop*/
+static FEE_ALWAYS_INLINE const uint8_t *ReadPixels(const uint8_t *Packet, uint16_t *Rows[FEE_NUM_CCD], size_t RowPixels,
+                                                   PTDUnpackKernel_t Unpack)
+{
+    size_t PixelIt, CCDIt;
+
+#if FEE_NUM_CCD == 2
+    if (Unpack != NULL)
+    {
+        Unpack(Packet, Rows[0] + NUM_DARK_INFO_PER_ROW, Rows[1] + NUM_DARK_INFO_PER_ROW, RowPixels);
+        return Packet + RowPixels * FEE_NUM_CCD * 2;
+    }
+#else
+    (void)Unpack;
+#endif
+
+    for (PixelIt = 0; PixelIt < RowPixels; PixelIt++)
+    {
+        for (CCDIt = 0; CCDIt < FEE_NUM_CCD; CCDIt++, Packet += 2)
+        {
+            Rows[CCDIt][NUM_DARK_INFO_PER_ROW + PixelIt] = Load16(Packet);
+        }
+    }
+
+    return Packet;
+}
+
+static FEE_ALWAYS_INLINE uint8_t *WriteDark(uint8_t *Packet, uint16_t *Rows[FEE_NUM_CCD])
+{
+    size_t CCDIt, DarkIt;
+
+    for (CCDIt = 0; CCDIt < FEE_NUM_CCD; CCDIt++)
+    {
+        for (DarkIt = 0; DarkIt < NUM_DARK_INFO_PER_ROW; DarkIt++, Packet += 2)
+        {
+            Store16(Packet, Rows[CCDIt][DarkIt]);
+        }
+    }
+
+    return Packet;
+}
+
+static FEE_ALWAYS_INLINE uint8_t *WritePixels(uint8_t *Packet, uint16_t *Rows[FEE_NUM_CCD], size_t RowPixels,
+                                              PTDPackKernel_t Pack)
+{
+    size_t PixelIt, CCDIt;
+
+#if FEE_NUM_CCD == 2
+    if (Pack != NULL)
+    {
+        Pack(Rows[0] + NUM_DARK_INFO_PER_ROW, Rows[1] + NUM_DARK_INFO_PER_ROW, Packet, RowPixels);
+        return Packet + RowPixels * FEE_NUM_CCD * 2;
+    }
+#else
+    (void)Pack;
+#endif
+
+    for (PixelIt = 0; PixelIt < RowPixels; PixelIt++)
+    {
+        for (CCDIt = 0; CCDIt < FEE_NUM_CCD; CCDIt++, Packet += 2)
+        {
+            Store16(Packet, Rows[CCDIt][NUM_DARK_INFO_PER_ROW + PixelIt]);
+        }
+    }
+
+    return Packet;
+}
+
+/*Body of the read kernels. RowPixels is a constant in the row kernels, which pass a NULL Unpack*/
+static FEE_ALWAYS_INLINE void ReadPTDRows(const uint8_t *Packet, fee_PTD_t *PTD_Data, size_t RowPixels,
+                                          PTDUnpackKernel_t Unpack)
+{
+    const size_t TotalColumns = NUM_DARK_INFO_PER_ROW + RowPixels;
+    uint16_t *Rows[FEE_NUM_CCD];
+    size_t RowIndex = 0, RowIt, CCDIt, DarkIt;
+
+    PTD_Data->PIXEL_DATA_COUNTER = ((uint32_t)Packet[0] << 24) | ((uint32_t)Packet[1] << 16) |
+                                   ((uint32_t)Packet[2] << 8) | (uint32_t)Packet[3];
+    Packet += 4;
+
+    for (RowIt = 0; RowIt < PTD_Data->PTDSizes.NumDataRows; RowIt++, RowIndex++)
+    {
+        RowPointers(PTD_Data, RowIndex, TotalColumns, Rows);
+        Packet = ReadDark(Packet, Rows);
+        Packet = ReadPixels(Packet, Rows, RowPixels, Unpack);
+    }
+
+    /*Smear rows have no dark info*/
+    for (RowIt = 0; RowIt < FEE_NUM_SMEAR_ROWS; RowIt++, RowIndex++)
+    {
+        RowPointers(PTD_Data, RowIndex, TotalColumns, Rows);
+        for (CCDIt = 0; CCDIt < FEE_NUM_CCD; CCDIt++)
+        {
+            for (DarkIt = 0; DarkIt < NUM_DARK_INFO_PER_ROW; DarkIt++)
+            {
+                Rows[CCDIt][DarkIt] = 0;
+            }
+        }
+        Packet = ReadPixels(Packet, Rows, RowPixels, Unpack);
+    }
+
+    for (RowIt = 0; RowIt < PTD_Data->PTDSizes.NumOverScanRows; RowIt++, RowIndex++)
+    {
+        RowPointers(PTD_Data, RowIndex, TotalColumns, Rows);
+        Packet = ReadDark(Packet, Rows);
+        Packet = ReadPixels(Packet, Rows, RowPixels, Unpack);
+    }
+
+    for (RowIt = 0; RowIt < NUM_VOLTAGE_REF_INFO; RowIt++, Packet += 2)
+    {
+        PTD_Data->VOLTAGES_REFERENCES[RowIt] = Load16(Packet);
+    }
+}
+
+/*Body of the write kernels. RowPixels is a constant in the row kernels, which pass a NULL Pack*/
+static FEE_ALWAYS_INLINE void WritePTDRows(const fee_PTD_t *PTD_Data, uint8_t *Packet, size_t RowPixels,
+                                           PTDPackKernel_t Pack)
+{
+    const size_t TotalColumns = NUM_DARK_INFO_PER_ROW + RowPixels;
+    uint16_t *Rows[FEE_NUM_CCD];
+    size_t RowIndex = 0, RowIt;
+
+    Packet[0] = (uint8_t)(PTD_Data->PIXEL_DATA_COUNTER >> 24);
+    Packet[1] = (uint8_t)(PTD_Data->PIXEL_DATA_COUNTER >> 16);
+    Packet[2] = (uint8_t)(PTD_Data->PIXEL_DATA_COUNTER >> 8);
+    Packet[3] = (uint8_t)PTD_Data->PIXEL_DATA_COUNTER;
+    Packet += 4;
+
+    for (RowIt = 0; RowIt < PTD_Data->PTDSizes.NumDataRows; RowIt++, RowIndex++)
+    {
+        RowPointers(PTD_Data, RowIndex, TotalColumns, Rows);
+        Packet = WriteDark(Packet, Rows);
+        Packet = WritePixels(Packet, Rows, RowPixels, Pack);
+    }
+
+    for (RowIt = 0; RowIt < FEE_NUM_SMEAR_ROWS; RowIt++, RowIndex++)
+    {
+        RowPointers(PTD_Data, RowIndex, TotalColumns, Rows);
+        Packet = WritePixels(Packet, Rows, RowPixels, Pack);
+    }
+
+    for (RowIt = 0; RowIt < PTD_Data->PTDSizes.NumOverScanRows; RowIt++, RowIndex++)
+    {
+        RowPointers(PTD_Data, RowIndex, TotalColumns, Rows);
+        Packet = WriteDark(Packet, Rows);
+        Packet = WritePixels(Packet, Rows, RowPixels, Pack);
+    }
+
+    for (RowIt = 0; RowIt < NUM_VOLTAGE_REF_INFO; RowIt++, Packet += 2)
+    {
+        Store16(Packet, PTD_Data->VOLTAGES_REFERENCES[RowIt]);
+    }
+}
+
+/*Instantiate the kernels of a row length*/
+#define DEFINE_PTD_KERNEL(RowPixels)                                                            \
+    static void ReadPTD_##RowPixels(const uint8_t *PixelDataPacket, fee_PTD_t *PTD_Data)       \
+    {                                                                                           \
+        ReadPTDRows(PixelDataPacket, PTD_Data, RowPixels, NULL);                                \
+    }                                                                                           \
+    static void WritePTD_##RowPixels(const fee_PTD_t *PTD_Data, uint8_t *PixelDataPacket)      \
+    {                                                                                           \
+        WritePTDRows(PTD_Data, PixelDataPacket, RowPixels, NULL);                               \
+    }
+
+#define PTD_KERNEL_ENTRY(RowPixels) {"row" #RowPixels, RowPixels, ReadPTD_##RowPixels, WritePTD_##RowPixels}
+
+DEFINE_PTD_KERNEL(225)  /*One 225-pixel band with binning 1 (2022-03-14 CHANNEL_2 captures)*/
+DEFINE_PTD_KERNEL(450)  /*One full band with binning 1*/
+DEFINE_PTD_KERNEL(2250) /*Five full bands with binning 1*/
+
+static const PTDKernel_t PTDKernels[] = {
+    PTD_KERNEL_ENTRY(225),
+    PTD_KERNEL_ENTRY(450),
+    PTD_KERNEL_ENTRY(2250),
+};
+
+#define NUM_PTD_KERNELS (sizeof(PTDKernels) / sizeof(PTDKernels[0]))
+
+/*Row length of a geometry*/
+static inline size_t GetRowPixels(const fee_PTDSizes_t *PTDSizes)
+{
+    return (PTDSizes->NumDataParametersPerRow_EveryCDD - PTDSizes->NumDarkInfoPerRow_EveryCCD) / FEE_NUM_CCD;
+}
+
+/*Kernels of any row length that deinterleave the pixels with the variants selected by the CPU-feature dispatch*/
+static void ReadPTD_Vector(const uint8_t *PixelDataPacket, fee_PTD_t *PTD_Data)
+{
+    ReadPTDRows(PixelDataPacket, PTD_Data, GetRowPixels(&PTD_Data->PTDSizes), GetKernelTable()->PTDUnpack);
+}
+
+static void WritePTD_Vector(const fee_PTD_t *PTD_Data, uint8_t *PixelDataPacket)
+{
+    WritePTDRows(PTD_Data, PixelDataPacket, GetRowPixels(&PTD_Data->PTDSizes), GetKernelTable()->PTDPack);
+}
+
+/*One entry by tier, so that the name reports the selected variant. The scalar tier uses the row kernels*/
+static const PTDKernel_t VectorKernels[FEE_CPU_NUM_TIERS] = {
+    {NULL, 0, NULL, NULL},
+    {"vector-sse4.2", 0, ReadPTD_Vector, WritePTD_Vector},
+    {"vector-avx2", 0, ReadPTD_Vector, WritePTD_Vector},
+    {"vector-avx512", 0, ReadPTD_Vector, WritePTD_Vector},
+};
+
+const PTDKernel_t *FindPTDKernel(const fee_PTDSizes_t *PTDSizes)
+{
+    size_t RowPixels, KernelIt;
+
+    pthread_once(&KernelsOnce, ReadKernelsEnv);
+
+    /*Packets without image information are handled by the generic loop*/
+    if (!KernelsEnabled || PTDSizes->DataPacketTotalBytes == 0 ||
+        PTDSizes->NumDataParametersPerRow_EveryCDD < PTDSizes->NumDarkInfoPerRow_EveryCCD)
+    {
+        return NULL;
+    }
+
+#if FEE_NUM_CCD == 2
+    /*Read and write use the same tier, as both kernels have variants for every tier*/
+    fee_cpu_tier_t Tier = GetKernelTable()->Tiers[FEE_KERNEL_PTD_UNPACK];
+    if (Tier != FEE_CPU_TIER_SCALAR)
+    {
+        return &VectorKernels[Tier];
+    }
+#endif
+
+    RowPixels = GetRowPixels(PTDSizes);
+
+    for (KernelIt = 0; KernelIt < NUM_PTD_KERNELS; KernelIt++)
+    {
+        if (PTDKernels[KernelIt].RowPixels == RowPixels)
+        {
+            return &PTDKernels[KernelIt];
+        }
+    }
+
+    return NULL;
+}
+
+void fee_PTD_EnableKernels(int Enable)
+{
+    /*The environment must not override the value later*/
+    pthread_once(&KernelsOnce, ReadKernelsEnv);
+
+    KernelsEnabled = Enable != 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file fee_PTDKernels.h
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Registry of PTD serialization kernels specialized for the row lengths of the production geometries.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_PTD_KERNELS_H
+#define FEE_PTD_KERNELS_H
+
+#include "fee.h"
+
+/*Environment variable that disables the specialized kernels when it is set to "generic"*/
+#define FEE_PTD_KERNELS_ENV "FEE_PTD_KERNELS"
+
+/*Name reported when no kernel matches*/
+#define FEE_PTD_GENERIC_KERNEL_NAME "generic"
+
+/*Deserialize a PTD packet whose sizes have been calculated in PTD_Data*/
+typedef void (*PTDReadKernel_t)(const uint8_t *PixelDataPacket, fee_PTD_t *PTD_Data);
+
+/*Serialize a PTD packet whose sizes have been calculated in PTD_Data. The checksum is not written*/
+typedef void (*PTDWriteKernel_t)(const fee_PTD_t *PTD_Data, uint8_t *PixelDataPacket);
+
+typedef struct
+{
+    const char *Name;       /*Name reported by fee_PTD_KernelName*/
+    size_t RowPixels;       /*Pixels of a row of each CCD (ImageTotalColumns without the dark columns)*/
+    PTDReadKernel_t Read;
+    PTDWriteKernel_t Write;
+
+} PTDKernel_t;
+
+/**
+ * @brief Function that selects the specialized kernel of a PTD geometry.
+ *
+ * @param PTDSizes [Input] Sizes calculated by fee_Calculate_PTD_Sizes.
+ * @return const PTDKernel_t* - Kernel of the geometry. NULL if the generic loop must be used.
+ */
+const PTDKernel_t *FindPTDKernel(const fee_PTDSizes_t *PTDSizes);
+
+#endif
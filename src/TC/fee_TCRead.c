@@ -12,7 +12,9 @@
 #include <stdio.h>
 #include <arpa/inet.h>
 #include <fee.h>
+#include <fee_inline.h>
 #include "../common/fee_common.h"
+#include "../common/fee_stats_internal.h"
 
 
 int fee_TC_Read(fee_TC_Packet_t TC_Packet, fee_TC_t *TC_Data_Struct)
@@ -243,25 +245,15 @@ int fee_TC_Read(fee_TC_Packet_t TC_Packet, fee_TC_t *TC_Data_Struct)
 
 void fee_getFreqBinningBand_parameters(uint16_t freqbinningband, uint16_t *binninsize, uint16_t *bandsize)
 {
-
-    /*freqbinningband = binningsize [0:2]  spare [3,6] bandsize[7:15] where 0 is the MSB*/
-    /*freqbinningband = binningsize [13:15]  spare [9:12] bandsize[0:8] where 0 is the LSB*/
-
-    /*The binninsize value has an offset of 1*/
-    *binninsize = ((freqbinningband >> 13) & 0x0007) + 1;
-    *bandsize = (freqbinningband)&0x01FF;
+    fee_inline_getFreqBinningBand_parameters(freqbinningband, binninsize, bandsize);
 }
 
 void fee_getCDSParam_parameters(uint16_t cdsparam, uint16_t *cds_mode, uint16_t *digital_offset)
 {
-
-    /*cdsparam = cds_param [0:1] spare [2,5] bandsize[6:15] where 0 is the MSB*/
-    /*cdsparam = cds_param [14:15] spare [10,13] bandsize[0:9] where 0 is the LSB*/
-    *cds_mode = (cdsparam >> 14) & 0x0003;
-    *digital_offset = cdsparam & 0x03FF;
+    fee_inline_getCDSParam_parameters(cdsparam, cds_mode, digital_offset);
 }
 
-int fee_CheckTeleCommandChecksum(fee_TC_Packet_t TC_Packet){
+static int CheckTCChecksum(fee_TC_Packet_t TC_Packet){
 
     uint8_t ReadedChecksum = 0;
     uint8_t CalculatedChecksum = 0;
@@ -279,4 +271,16 @@ int fee_CheckTeleCommandChecksum(fee_TC_Packet_t TC_Packet){
     }
 
     return FEE_EXIT_SUCCESS;
+}
+
+int fee_CheckTeleCommandChecksum(fee_TC_Packet_t TC_Packet)
+{
+    int Status;
+    FEE_STATS_START(Timer);
+
+    Status = CheckTCChecksum(TC_Packet);
+
+    FEE_STATS_STOP(FEE_STATS_CHECK_TC_CHECKSUM, Timer, Status, TC_PACKET_BYTES, FEE_STATS_FAIL_CHECKSUM);
+
+    return Status;
 }
\ No newline at end of file
@@ -11,448 +11,323 @@
 
 #include <stdio.h>
 #include <fee.h>
+#include <fee_fields.h>
+#include <fee_inline.h>
 #include "../common/fee_common.h"
+#include "../common/fee_stats_internal.h"
 #include <string.h>
+#include <stddef.h>
 #include <arpa/inet.h>
 
-/**
- * \defgroup Local TM Funcitons
- * @{
- */
-
-
-/**
- * @brief 
- * 
- * @param freqbinninbband 
- * @param binningsize_max 
- * @param binningsize_min 
- * @param bandsize_max 
- * @param bandsize_min 
- * @return int 
- */
-int check_feqbinningband_parameter(uint16_t freqbinninbband,
-                                   int binningsize_max,
-                                   int binningsize_min,
-                                   int bandsize_max,
-                                   int bandsize_min);
-/**
- * @brief 
- * 
- * @param cdsparam 
- * @param cds_mode_max 
- * @param cds_mode_min 
- * @param digital_offset_max 
- * @param digital_offset_min 
- * @return int 
- */
-int check_cdsparam_parameter(uint16_t cdsparam,
-                             int cds_mode_max,
-                             int cds_mode_min,
-                             int digital_offset_max,
-                             int digital_offset_min);
-
-/**@}*/
+/*Field, stored at its TC offset*/
+#define PUT_TC_FIELD(Name, Bits) \
+    PutField##Bits(TC_Packet, TC_OFFSET_##Name, (uint##Bits##_t)TC_Data_Struct.Name, &Sum);
 
-int fee_TC_Write(fee_TC_t TC_Data_Struct, fee_TC_Packet_t TC_Packet)
+static int SerializeTC(fee_TC_t TC_Data_Struct, fee_TC_Packet_t TC_Packet)
 {
 
-    size_t byte_counter = 0;
-    uint16_t op_mode = 0;
-    uint16_t spatialbinning_mode = 0;
-    uint16_t cdsparams = 0;
-    uint16_t synpattern = 0;
-    uint8_t checksum_tc_message = 0;
-
-    /*Initialize variable to 0*/
-    memset(TC_Packet, 0, sizeof(fee_TC_Packet_t));
-    /*Convert enum variables to uint16_t*/
-    op_mode = (uint16_t)TC_Data_Struct.OPMODE;
-    spatialbinning_mode = (uint16_t)TC_Data_Struct.SPATIALBINNINGMODE;
-    cdsparams = (uint16_t)TC_Data_Struct.CDSPARAMS;
-    synpattern = (uint16_t)TC_Data_Struct.SYNTPATTERN;
-
-    if (SerializeParameter(&TC_Data_Struct.TC_COUNTER, sizeof(TC_Data_Struct.TC_COUNTER), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&op_mode, sizeof(op_mode), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.EXPO_TIME, sizeof(TC_Data_Struct.EXPO_TIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        Serialize_Spare_Parameter(sizeof(uint8_t), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DUOUTDRAINTVLTG, sizeof(TC_Data_Struct.DUOUTDRAINTVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DURESETVLTG, sizeof(TC_Data_Struct.DURESETVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DUDUMPVLTG, sizeof(TC_Data_Struct.DUDUMPVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DUOUTGATEVLTG, sizeof(TC_Data_Struct.DUOUTGATEVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DUIMGCKHVLTG, sizeof(TC_Data_Struct.DUIMGCKHVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DUSTGCKHVLTG, sizeof(TC_Data_Struct.DUSTGCKHVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DUREGCKHVLTG, sizeof(TC_Data_Struct.DUREGCKHVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DUDUMPCKHVLTG, sizeof(TC_Data_Struct.DUDUMPCKHVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DURESETCKHVLTG, sizeof(TC_Data_Struct.DURESETCKHVLTG), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.NBSMEAR, sizeof(TC_Data_Struct.NBSMEAR), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.WOISTART, sizeof(TC_Data_Struct.WOISTART), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.WOISIZE, sizeof(TC_Data_Struct.WOISIZE), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&spatialbinning_mode, sizeof(spatialbinning_mode), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.FTPTIME, sizeof(TC_Data_Struct.FTPTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.IMGSTGCKRFTIME, sizeof(TC_Data_Struct.IMGSTGCKRFTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.IMGSTGCKOVTIME, sizeof(TC_Data_Struct.IMGSTGCKOVTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.IMGSTGCKPWTIME, sizeof(TC_Data_Struct.IMGSTGCKPWTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.REGLINADVTIME, sizeof(TC_Data_Struct.REGLINADVTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.LINADVREGTIME, sizeof(TC_Data_Struct.LINADVREGTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.RCKPTIME, sizeof(TC_Data_Struct.RCKPTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.REGCKOVTIME, sizeof(TC_Data_Struct.REGCKOVTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.R1REGCKONTIME, sizeof(TC_Data_Struct.R1REGCKONTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.R3REGCKONTIME, sizeof(TC_Data_Struct.R3REGCKONTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        Serialize_Spare_Parameter(sizeof(uint8_t), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.R2CKRISEDELTIME, sizeof(TC_Data_Struct.R2CKRISEDELTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.RESETCKONTIME, sizeof(TC_Data_Struct.RESETCKONTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.RESETCKFALLDELTIME, sizeof(TC_Data_Struct.RESETCKFALLDELTIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.ADC1TIME, sizeof(TC_Data_Struct.ADC1TIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.ADC2TIME, sizeof(TC_Data_Struct.ADC2TIME), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.ADC1RDDLY, sizeof(TC_Data_Struct.ADC1RDDLY), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.ADC2RDDLY, sizeof(TC_Data_Struct.ADC2RDDLY), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.DULAMBDA, sizeof(TC_Data_Struct.DULAMBDA), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.FREQBINNINGBAND_1, sizeof(TC_Data_Struct.FREQBINNINGBAND_1), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.FREQBINNINGBAND_2, sizeof(TC_Data_Struct.FREQBINNINGBAND_2), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.FREQBINNINGBAND_3, sizeof(TC_Data_Struct.FREQBINNINGBAND_3), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.FREQBINNINGBAND_4, sizeof(TC_Data_Struct.FREQBINNINGBAND_4), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.FREQBINNINGBAND_5, sizeof(TC_Data_Struct.FREQBINNINGBAND_5), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.PIXEL_MIN, sizeof(TC_Data_Struct.PIXEL_MIN), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.PIXEL_MAX, sizeof(TC_Data_Struct.PIXEL_MAX), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&synpattern, sizeof(synpattern), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&cdsparams, sizeof(cdsparams), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.HCNBSAMPLE, sizeof(TC_Data_Struct.HCNBSAMPLE), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.NBTAIL, sizeof(TC_Data_Struct.NBTAIL), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        SerializeParameter(&TC_Data_Struct.ACQSTARTDELAY, sizeof(TC_Data_Struct.ACQSTARTDELAY), &byte_counter, TC_Packet, TC_PACKET_BYTES) ||
-        Serialize_Spare_Parameter(sizeof(uint8_t) * NUM_SPARE_BYTES_END_TELECOMMAND, &byte_counter, TC_Packet, TC_PACKET_BYTES))
-    {
-        return FEE_EXIT_ERROR;
-    }
+    uint16_t Sum = 0;
 
-    /*Calculate checksum of the TCMessage and insert it*/
-    checksum_tc_message = XORChecksum8(TC_Packet, TC_PACKET_BYTES - TC_CHECKSUM_BYTES);
-    if (SerializeParameter(&checksum_tc_message, sizeof(checksum_tc_message), &byte_counter, TC_Packet, TC_PACKET_BYTES))
-    {
-        return FEE_EXIT_ERROR;
-    }
+    /*Every field is stored at its offset (enum fields as 16 bits words) and the checksum is folded at the same time*/
+    FEE_TC_FIELDS(PUT_TC_FIELD)
 
-    /*Check that lengths match*/
-    if (byte_counter != TC_PACKET_BYTES)
-    {
-        return FEE_EXIT_ERROR;
-    }
+    /*Spare bytes: after EXPO_TIME, after R3REGCKONTIME and after ACQSTARTDELAY*/
+    PutSpare(TC_Packet, TC_OFFSET_DUOUTDRAINTVLTG - 1, 1);
+    PutSpare(TC_Packet, TC_OFFSET_R2CKRISEDELTIME - 1, 1);
+    PutSpare(TC_Packet, TC_OFFSET_CHECKSUM - NUM_SPARE_BYTES_END_TELECOMMAND, NUM_SPARE_BYTES_END_TELECOMMAND);
+
+    /*Checksum of the TCMessage*/
+    TC_Packet[TC_OFFSET_CHECKSUM] = Checksum8(Sum);
 
     return FEE_EXIT_SUCCESS;
 }
 
-int fee_TC_BoundsCheck(fee_TC_t TC_Data_Struct)
+int fee_TC_Write(fee_TC_t TC_Data_Struct, fee_TC_Packet_t TC_Packet)
 {
+    int Status;
+    FEE_STATS_START(Timer);
 
-    if (TC_Data_Struct.TC_COUNTER < TC_COUNTER_MIN || TC_Data_Struct.TC_COUNTER > TC_COUNTER_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.OPMODE < TC_OPMODE_MIN || TC_Data_Struct.OPMODE > TC_OPMODE_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.EXPO_TIME < TC_EXPO_TIME_MIN || TC_Data_Struct.EXPO_TIME > TC_EXPO_TIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DUOUTDRAINTVLTG < TC_DUOUTDRAINTVLTG_MIN || TC_Data_Struct.DUOUTDRAINTVLTG > TC_DUOUTDRAINTVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DURESETVLTG < TC_DURESETVLTG_MIN || TC_Data_Struct.DURESETVLTG > TC_DURESETVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DUDUMPVLTG < TC_DUDUMPVLTG_MIN || TC_Data_Struct.DUDUMPVLTG > TC_DUDUMPVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DUOUTGATEVLTG < TC_DUOUTGATEVLTG_MIN || TC_Data_Struct.DUOUTGATEVLTG > TC_DUOUTGATEVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DUIMGCKHVLTG < TC_DUIMGCKHVLTG_MIN || TC_Data_Struct.DUIMGCKHVLTG > TC_DUIMGCKHVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DUSTGCKHVLTG < TC_DUSTGCKHVLTG_MIN || TC_Data_Struct.DUSTGCKHVLTG > TC_DUSTGCKHVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DUREGCKHVLTG < TC_DUREGCKHVLTG_MIN || TC_Data_Struct.DUREGCKHVLTG > TC_DUREGCKHVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DUDUMPCKHVLTG < TC_DUDUMPCKHVLTG_MIN || TC_Data_Struct.DUDUMPCKHVLTG > TC_DUDUMPCKHVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.DURESETCKHVLTG < TC_DURESETCKHVLTG_MIN || TC_Data_Struct.DURESETCKHVLTG > TC_DURESETCKHVLTG_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.NBSMEAR < TC_NBSMEAR_MIN || TC_Data_Struct.NBSMEAR > TC_NBSMEAR_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.WOISTART < TC_WOISTART_MIN || TC_Data_Struct.WOISTART > TC_WOISTART_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+    Status = SerializeTC(TC_Data_Struct, TC_Packet);
 
-    if (TC_Data_Struct.WOISIZE < TC_WOISIZE_MIN || TC_Data_Struct.WOISIZE > TC_WOISIZE_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.SPATIALBINNINGMODE < TC_SPATIALBINNINGMODE_MIN || TC_Data_Struct.SPATIALBINNINGMODE > TC_SPATIALBINNINGMODE_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.FTPTIME < TC_FTPTIME_MIN || TC_Data_Struct.FTPTIME > TC_FTPTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.IMGSTGCKRFTIME < TC_IMGSTGCKRFTIME_MIN || TC_Data_Struct.IMGSTGCKRFTIME > TC_IMGSTGCKRFTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.IMGSTGCKOVTIME < TC_IMGSTGCKOVTIME_MIN || TC_Data_Struct.IMGSTGCKOVTIME > TC_IMGSTGCKOVTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.IMGSTGCKPWTIME < TC_IMGSTGCKPWTIME_MIN || TC_Data_Struct.IMGSTGCKPWTIME > TC_IMGSTGCKPWTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.REGLINADVTIME < TC_REGLINADVTIME_MIN || TC_Data_Struct.REGLINADVTIME > TC_REGLINADVTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+    FEE_STATS_STOP(FEE_STATS_TC_WRITE, Timer, Status, TC_PACKET_BYTES, FEE_STATS_FAIL_LENGTH);
 
-    if (TC_Data_Struct.LINADVREGTIME < TC_LINADVREGTIME_MIN || TC_Data_Struct.LINADVREGTIME > TC_LINADVREGTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.RCKPTIME < TC_RCKPTIME_MIN || TC_Data_Struct.RCKPTIME > TC_RCKPTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.REGCKOVTIME < TC_REGCKOVTIME_MIN || TC_Data_Struct.REGCKOVTIME > TC_REGCKOVTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.R1REGCKONTIME < TC_R1REGCKONTIME_MIN || TC_Data_Struct.R1REGCKONTIME > TC_R1REGCKONTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.R3REGCKONTIME < TC_R3REGCKONTIME_MIN || TC_Data_Struct.R3REGCKONTIME > TC_R3REGCKONTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.R2CKRISEDELTIME < TC_R2CKRISEDELTIME_MIN || TC_Data_Struct.R2CKRISEDELTIME > TC_R2CKRISEDELTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.RESETCKONTIME < TC_RESETCKONTIME_MIN || TC_Data_Struct.RESETCKONTIME > TC_RESETCKONTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    if (TC_Data_Struct.RESETCKFALLDELTIME < TC_RESETCKFALLDELTIME_MIN || TC_Data_Struct.RESETCKFALLDELTIME > TC_RESETCKFALLDELTIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+    return Status;
+}
 
-    if (TC_Data_Struct.ADC1TIME < TC_ADC1TIME_MIN || TC_Data_Struct.ADC1TIME > TC_ADC1TIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+/*Number of TC structures whose fields are compared at once by fee_TC_BoundsCheck_Batch*/
+#define TC_BOUNDS_BATCH_LANES 16
 
-    if (TC_Data_Struct.ADC2TIME < TC_ADC2TIME_MIN || TC_Data_Struct.ADC2TIME > TC_ADC2TIME_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+/*Limits of a TC field (or sub-field). The checked value is ((field >> Shift) & Mask) + Offset*/
+typedef struct
+{
+    size_t StructOffset; /*Offset of the field in fee_TC_t*/
+    size_t StructBytes;  /*Size of the field in fee_TC_t*/
+    uint32_t Shift;
+    uint32_t Mask;
+    int64_t Offset;
+    int64_t Min;
+    int64_t Max;
+
+} TC_FieldLimits_t;
+
+#define TC_LIMIT_SUBFIELD(field, shift, mask, offset, min, max) \
+    {offsetof(fee_TC_t, field), sizeof(((fee_TC_t *)0)->field), (shift), (mask), (offset), (min), (max)}
+#define TC_LIMIT(field, min, max) TC_LIMIT_SUBFIELD(field, 0, 0xFFFFFFFF, 0, min, max)
+
+/*Limits table. It is indexed by fee_TC_Field_t*/
+static const TC_FieldLimits_t TC_FieldLimits[TC_FIELD_NUM] = {
+    TC_LIMIT(TC_COUNTER, TC_COUNTER_MIN, TC_COUNTER_MAX),
+    TC_LIMIT(OPMODE, TC_OPMODE_MIN, TC_OPMODE_MAX),
+    TC_LIMIT(EXPO_TIME, TC_EXPO_TIME_MIN, TC_EXPO_TIME_MAX),
+    TC_LIMIT(DUOUTDRAINTVLTG, TC_DUOUTDRAINTVLTG_MIN, TC_DUOUTDRAINTVLTG_MAX),
+    TC_LIMIT(DURESETVLTG, TC_DURESETVLTG_MIN, TC_DURESETVLTG_MAX),
+    TC_LIMIT(DUDUMPVLTG, TC_DUDUMPVLTG_MIN, TC_DUDUMPVLTG_MAX),
+    TC_LIMIT(DUOUTGATEVLTG, TC_DUOUTGATEVLTG_MIN, TC_DUOUTGATEVLTG_MAX),
+    TC_LIMIT(DUIMGCKHVLTG, TC_DUIMGCKHVLTG_MIN, TC_DUIMGCKHVLTG_MAX),
+    TC_LIMIT(DUSTGCKHVLTG, TC_DUSTGCKHVLTG_MIN, TC_DUSTGCKHVLTG_MAX),
+    TC_LIMIT(DUREGCKHVLTG, TC_DUREGCKHVLTG_MIN, TC_DUREGCKHVLTG_MAX),
+    TC_LIMIT(DUDUMPCKHVLTG, TC_DUDUMPCKHVLTG_MIN, TC_DUDUMPCKHVLTG_MAX),
+    TC_LIMIT(DURESETCKHVLTG, TC_DURESETCKHVLTG_MIN, TC_DURESETCKHVLTG_MAX),
+    TC_LIMIT(NBSMEAR, TC_NBSMEAR_MIN, TC_NBSMEAR_MAX),
+    TC_LIMIT(WOISTART, TC_WOISTART_MIN, TC_WOISTART_MAX),
+    TC_LIMIT(WOISIZE, TC_WOISIZE_MIN, TC_WOISIZE_MAX),
+    TC_LIMIT(SPATIALBINNINGMODE, TC_SPATIALBINNINGMODE_MIN, TC_SPATIALBINNINGMODE_MAX),
+    TC_LIMIT(FTPTIME, TC_FTPTIME_MIN, TC_FTPTIME_MAX),
+    TC_LIMIT(IMGSTGCKRFTIME, TC_IMGSTGCKRFTIME_MIN, TC_IMGSTGCKRFTIME_MAX),
+    TC_LIMIT(IMGSTGCKOVTIME, TC_IMGSTGCKOVTIME_MIN, TC_IMGSTGCKOVTIME_MAX),
+    TC_LIMIT(IMGSTGCKPWTIME, TC_IMGSTGCKPWTIME_MIN, TC_IMGSTGCKPWTIME_MAX),
+    TC_LIMIT(REGLINADVTIME, TC_REGLINADVTIME_MIN, TC_REGLINADVTIME_MAX),
+    TC_LIMIT(LINADVREGTIME, TC_LINADVREGTIME_MIN, TC_LINADVREGTIME_MAX),
+    TC_LIMIT(RCKPTIME, TC_RCKPTIME_MIN, TC_RCKPTIME_MAX),
+    TC_LIMIT(REGCKOVTIME, TC_REGCKOVTIME_MIN, TC_REGCKOVTIME_MAX),
+    TC_LIMIT(R1REGCKONTIME, TC_R1REGCKONTIME_MIN, TC_R1REGCKONTIME_MAX),
+    TC_LIMIT(R3REGCKONTIME, TC_R3REGCKONTIME_MIN, TC_R3REGCKONTIME_MAX),
+    TC_LIMIT(R2CKRISEDELTIME, TC_R2CKRISEDELTIME_MIN, TC_R2CKRISEDELTIME_MAX),
+    TC_LIMIT(RESETCKONTIME, TC_RESETCKONTIME_MIN, TC_RESETCKONTIME_MAX),
+    TC_LIMIT(RESETCKFALLDELTIME, TC_RESETCKFALLDELTIME_MIN, TC_RESETCKFALLDELTIME_MAX),
+    TC_LIMIT(ADC1TIME, TC_ADC1TIME_MIN, TC_ADC1TIME_MAX),
+    TC_LIMIT(ADC2TIME, TC_ADC2TIME_MIN, TC_ADC2TIME_MAX),
+    TC_LIMIT(ADC1RDDLY, TC_ADC1RDDLY_MIN, TC_ADC1RDDLY_MAX),
+    TC_LIMIT(ADC2RDDLY, TC_ADC2RDDLY_MIN, TC_ADC2RDDLY_MAX),
+    TC_LIMIT(DULAMBDA, TC_DULAMBDA_MIN, TC_DULAMBDA_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_1, 13, 0x0007, 1, TC_FREQBINNINGBAND_1_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_1_BINNINGSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_1, 0, 0x01FF, 0, TC_FREQBINNINGBAND_1_BANDSIZE_MIN, TC_FREQBINNINGBAND_1_BANDSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_2, 13, 0x0007, 1, TC_FREQBINNINGBAND_2_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_2_BINNINGSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_2, 0, 0x01FF, 0, TC_FREQBINNINGBAND_2_BANDSIZE_MIN, TC_FREQBINNINGBAND_2_BANDSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_3, 13, 0x0007, 1, TC_FREQBINNINGBAND_3_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_3_BINNINGSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_3, 0, 0x01FF, 0, TC_FREQBINNINGBAND_3_BANDSIZE_MIN, TC_FREQBINNINGBAND_3_BANDSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_4, 13, 0x0007, 1, TC_FREQBINNINGBAND_4_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_4_BINNINGSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_4, 0, 0x01FF, 0, TC_FREQBINNINGBAND_4_BANDSIZE_MIN, TC_FREQBINNINGBAND_4_BANDSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_5, 13, 0x0007, 1, TC_FREQBINNINGBAND_5_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_5_BINNINGSIZE_MAX),
+    TC_LIMIT_SUBFIELD(FREQBINNINGBAND_5, 0, 0x01FF, 0, TC_FREQBINNINGBAND_5_BANDSIZE_MIN, TC_FREQBINNINGBAND_5_BANDSIZE_MAX),
+    TC_LIMIT(PIXEL_MIN, TC_PIXEL_MIN_MIN, TC_PIXEL_MIN_MAX),
+    TC_LIMIT(PIXEL_MAX, TC_PIXEL_MAX_MIN, TC_PIXEL_MAX_MAX),
+    /*SYNTPATTERN is not a range. It is checked against the valid patterns*/
+    TC_LIMIT(SYNTPATTERN, NO_SYNTHETIC_PATTERN, SYNTHETIC_PATTERN_2),
+    TC_LIMIT_SUBFIELD(CDSPARAMS, 14, 0x0003, 0, TC_CDSPARAMS_MODE_MIN, TC_CDSPARAMS_MODE_MAX),
+    TC_LIMIT_SUBFIELD(CDSPARAMS, 0, 0x03FF, 0, TC_CDSPARAMS_DIGITAL_OFFSET_MIN, TC_CDSPARAMS_DIGITAL_OFFSET_MAX),
+    TC_LIMIT(HCNBSAMPLE, TC_HCNBSAMPLE_MIN, TC_HCNBSAMPLE_MAX),
+    TC_LIMIT(NBTAIL, TC_NBTAIL_MIN, TC_NBTAIL_MAX),
+    TC_LIMIT(ACQSTARTDELAY, TC_ACQSTARTDELAY_MIN, TC_ACQSTARTDELAY_MAX)
+};
+
+static const char *const TC_FieldNames[TC_FIELD_NUM] = {
+    "TC_COUNTER",
+    "OPMODE",
+    "EXPO_TIME",
+    "DUOUTDRAINTVLTG",
+    "DURESETVLTG",
+    "DUDUMPVLTG",
+    "DUOUTGATEVLTG",
+    "DUIMGCKHVLTG",
+    "DUSTGCKHVLTG",
+    "DUREGCKHVLTG",
+    "DUDUMPCKHVLTG",
+    "DURESETCKHVLTG",
+    "NBSMEAR",
+    "WOISTART",
+    "WOISIZE",
+    "SPATIALBINNINGMODE",
+    "FTPTIME",
+    "IMGSTGCKRFTIME",
+    "IMGSTGCKOVTIME",
+    "IMGSTGCKPWTIME",
+    "REGLINADVTIME",
+    "LINADVREGTIME",
+    "RCKPTIME",
+    "REGCKOVTIME",
+    "R1REGCKONTIME",
+    "R3REGCKONTIME",
+    "R2CKRISEDELTIME",
+    "RESETCKONTIME",
+    "RESETCKFALLDELTIME",
+    "ADC1TIME",
+    "ADC2TIME",
+    "ADC1RDDLY",
+    "ADC2RDDLY",
+    "DULAMBDA",
+    "FREQBINNINGBAND_1_BINNINGSIZE",
+    "FREQBINNINGBAND_1_BANDSIZE",
+    "FREQBINNINGBAND_2_BINNINGSIZE",
+    "FREQBINNINGBAND_2_BANDSIZE",
+    "FREQBINNINGBAND_3_BINNINGSIZE",
+    "FREQBINNINGBAND_3_BANDSIZE",
+    "FREQBINNINGBAND_4_BINNINGSIZE",
+    "FREQBINNINGBAND_4_BANDSIZE",
+    "FREQBINNINGBAND_5_BINNINGSIZE",
+    "FREQBINNINGBAND_5_BANDSIZE",
+    "PIXEL_MIN",
+    "PIXEL_MAX",
+    "SYNTPATTERN",
+    "CDSPARAMS_MODE",
+    "CDSPARAMS_DIGITAL_OFFSET",
+    "HCNBSAMPLE",
+    "NBTAIL",
+    "ACQSTARTDELAY"
+};
 
-    if (TC_Data_Struct.ADC1RDDLY < TC_ADC1RDDLY_MIN || TC_Data_Struct.ADC1RDDLY > TC_ADC1RDDLY_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+/**
+ * @brief Function that gets the checked value of a field (or sub-field) of the TC information structure.
+ *
+ * @param TC_Data_Struct [Input] TC Data information structure.
+ * @param Limits [Input] Limits of the field.
+ * @return int64_t The checked value.
+ */
+static inline int64_t TC_FieldValue(const fee_TC_t *TC_Data_Struct, const TC_FieldLimits_t *Limits)
+{
+    const uint8_t *Field = (const uint8_t *)TC_Data_Struct + Limits->StructOffset;
+    uint8_t value8 = 0;
+    uint16_t value16 = 0;
+    uint32_t value32 = 0;
 
-    if (TC_Data_Struct.ADC2RDDLY < TC_ADC2RDDLY_MIN || TC_Data_Struct.ADC2RDDLY > TC_ADC2RDDLY_MAX)
+    if (Limits->StructBytes == sizeof(uint8_t))
     {
-        return FEE_EXIT_ERROR;
+        value8 = *Field;
+        value32 = value8;
     }
-
-    if (TC_Data_Struct.DULAMBDA < TC_DULAMBDA_MIN || TC_Data_Struct.DULAMBDA > TC_DULAMBDA_MAX)
+    else if (Limits->StructBytes == sizeof(uint16_t))
     {
-        return FEE_EXIT_ERROR;
+        memcpy(&value16, Field, sizeof(value16));
+        value32 = value16;
     }
-
-    if (TC_Data_Struct.PIXEL_MIN < TC_PIXEL_MIN_MIN || TC_Data_Struct.PIXEL_MIN > TC_PIXEL_MIN_MAX)
+    else
     {
-        return FEE_EXIT_ERROR;
+        memcpy(&value32, Field, sizeof(value32));
     }
 
-    if (TC_Data_Struct.PIXEL_MAX < TC_PIXEL_MAX_MIN || TC_Data_Struct.PIXEL_MAX > TC_PIXEL_MAX_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+    return (int64_t)((value32 >> Limits->Shift) & Limits->Mask) + Limits->Offset;
+}
 
-    if (TC_Data_Struct.HCNBSAMPLE < TC_HCNBSAMPLE_MIN || TC_Data_Struct.HCNBSAMPLE > TC_HCNBSAMPLE_MAX)
+/**
+ * @brief Function that returns 1 if the checked value of a field is out of its limits. Otherwise 0 is returned.
+ */
+static inline uint64_t TC_FieldViolation(fee_TC_Field_t Field, int64_t value)
+{
+    if (Field == TC_FIELD_SYNTPATTERN)
     {
-        return FEE_EXIT_ERROR;
+        return (uint64_t)((value != NO_SYNTHETIC_PATTERN) & (value != SYNTHETIC_PATTERN_1) & (value != SYNTHETIC_PATTERN_2));
     }
 
-    if (TC_Data_Struct.NBTAIL < TC_NBTAIL_MIN || TC_Data_Struct.NBTAIL > TC_NBTAIL_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+    return (uint64_t)((value < TC_FieldLimits[Field].Min) | (value > TC_FieldLimits[Field].Max));
+}
 
-    if (TC_Data_Struct.ACQSTARTDELAY < TC_ACQSTARTDELAY_MIN || TC_Data_Struct.ACQSTARTDELAY > TC_ACQSTARTDELAY_MAX)
-    {
-        return FEE_EXIT_ERROR;
-    }
+int fee_TC_BoundsCheck_Mask(fee_TC_t TC_Data_Struct, uint64_t *ViolationMask)
+{
+    uint64_t mask = 0;
+    int Field;
 
-    if (check_cdsparam_parameter(TC_Data_Struct.CDSPARAMS, TC_CDSPARAMS_MODE_MAX, TC_CDSPARAMS_MODE_MIN,
-                                 TC_CDSPARAMS_DIGITAL_OFFSET_MAX, TC_CDSPARAMS_DIGITAL_OFFSET_MIN))
+    for (Field = 0; Field < TC_FIELD_NUM; Field++)
     {
-        return FEE_EXIT_ERROR;
+        mask |= TC_FieldViolation(Field, TC_FieldValue(&TC_Data_Struct, &TC_FieldLimits[Field])) << Field;
     }
 
-    if (check_feqbinningband_parameter(TC_Data_Struct.FREQBINNINGBAND_1, TC_FREQBINNINGBAND_1_BINNINGSIZE_MAX,
-                                       TC_FREQBINNINGBAND_1_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_1_BANDSIZE_MAX, TC_FREQBINNINGBAND_1_BANDSIZE_MIN))
-    {
-        return FEE_EXIT_ERROR;
-    }
+    *ViolationMask = mask;
 
-    if (check_feqbinningband_parameter(TC_Data_Struct.FREQBINNINGBAND_2, TC_FREQBINNINGBAND_2_BINNINGSIZE_MAX,
-                                       TC_FREQBINNINGBAND_2_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_2_BANDSIZE_MAX, TC_FREQBINNINGBAND_2_BANDSIZE_MIN))
-    {
-        return FEE_EXIT_ERROR;
-    }
+    return mask ? FEE_EXIT_ERROR : FEE_EXIT_SUCCESS;
+}
 
-    if (check_feqbinningband_parameter(TC_Data_Struct.FREQBINNINGBAND_3, TC_FREQBINNINGBAND_3_BINNINGSIZE_MAX,
-                                       TC_FREQBINNINGBAND_3_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_3_BANDSIZE_MAX, TC_FREQBINNINGBAND_3_BANDSIZE_MIN))
-    {
-        return FEE_EXIT_ERROR;
-    }
+int fee_TC_BoundsCheck_Batch(const fee_TC_t *TC_Data_Array, size_t NumTC, uint64_t *ViolationMasks)
+{
+    int64_t values[TC_BOUNDS_BATCH_LANES];
+    uint64_t masks[TC_BOUNDS_BATCH_LANES];
+    uint64_t any_violation = 0;
+    size_t Base, Lanes, Lane;
+    int Field;
+
+    for (Base = 0; Base < NumTC; Base += TC_BOUNDS_BATCH_LANES)
+    {
+        Lanes = NumTC - Base < TC_BOUNDS_BATCH_LANES ? NumTC - Base : TC_BOUNDS_BATCH_LANES;
+
+        memset(masks, 0, sizeof(masks));
+        memset(values, 0, sizeof(values));
+
+        for (Field = 0; Field < TC_FIELD_NUM; Field++)
+        {
+            const int64_t Min = TC_FieldLimits[Field].Min;
+            const int64_t Max = TC_FieldLimits[Field].Max;
+
+            /*Gather the field of every lane*/
+            for (Lane = 0; Lane < Lanes; Lane++)
+            {
+                values[Lane] = TC_FieldValue(&TC_Data_Array[Base + Lane], &TC_FieldLimits[Field]);
+            }
+
+            /*Compare every lane at once. Constant trip count so the compiler emits vector compares*/
+            if (Field == TC_FIELD_SYNTPATTERN)
+            {
+                for (Lane = 0; Lane < TC_BOUNDS_BATCH_LANES; Lane++)
+                {
+                    masks[Lane] |= (uint64_t)((values[Lane] != NO_SYNTHETIC_PATTERN) & (values[Lane] != SYNTHETIC_PATTERN_1) &
+                                              (values[Lane] != SYNTHETIC_PATTERN_2)) << Field;
+                }
+            }
+            else
+            {
+                for (Lane = 0; Lane < TC_BOUNDS_BATCH_LANES; Lane++)
+                {
+                    masks[Lane] |= (uint64_t)((values[Lane] < Min) | (values[Lane] > Max)) << Field;
+                }
+            }
+        }
+
+        for (Lane = 0; Lane < Lanes; Lane++)
+        {
+            ViolationMasks[Base + Lane] = masks[Lane];
+            any_violation |= masks[Lane];
+        }
+    }
+
+    return any_violation ? FEE_EXIT_ERROR : FEE_EXIT_SUCCESS;
+}
 
-    if (check_feqbinningband_parameter(TC_Data_Struct.FREQBINNINGBAND_4, TC_FREQBINNINGBAND_4_BINNINGSIZE_MAX,
-                                       TC_FREQBINNINGBAND_4_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_4_BANDSIZE_MAX, TC_FREQBINNINGBAND_4_BANDSIZE_MIN))
+const char *fee_TC_FieldName(fee_TC_Field_t Field)
+{
+    if ((int)Field < 0 || Field >= TC_FIELD_NUM)
     {
-        return FEE_EXIT_ERROR;
+        return NULL;
     }
 
-    if (check_feqbinningband_parameter(TC_Data_Struct.FREQBINNINGBAND_5, TC_FREQBINNINGBAND_5_BINNINGSIZE_MAX,
-                                       TC_FREQBINNINGBAND_5_BINNINGSIZE_MIN, TC_FREQBINNINGBAND_5_BANDSIZE_MAX, TC_FREQBINNINGBAND_5_BANDSIZE_MIN))
-    {
-        return FEE_EXIT_ERROR;
-    }
+    return TC_FieldNames[Field];
+}
 
-    if (TC_Data_Struct.SYNTPATTERN != NO_SYNTHETIC_PATTERN && TC_Data_Struct.SYNTPATTERN != SYNTHETIC_PATTERN_1 && TC_Data_Struct.SYNTPATTERN != SYNTHETIC_PATTERN_2)
-    {
-        return FEE_EXIT_ERROR;
-    }
+int fee_TC_BoundsCheck(fee_TC_t TC_Data_Struct)
+{
+    uint64_t ViolationMask = 0;
 
-    return FEE_EXIT_SUCCESS;
+    return fee_TC_BoundsCheck_Mask(TC_Data_Struct, &ViolationMask);
 }
 
 uint16_t fee_fill_cdsparam_parameter(cds_params_t cds_mode, int digital_offset)
 {
-    uint16_t cds_mode_s;
-    uint16_t digigtal_offset_s;
-
-    /*cds_mode parameter length is 2 bits*/
-    cds_mode_s = (uint16_t)cds_mode & 0x0003;
-    /*digital_offset parameter length is nine bits*/
-    digigtal_offset_s = (uint16_t)digital_offset & 0x03FF;
-    /*cdsparam = cds_mode [0:1] spare [2,5] bandsize[6:15] where 0 is the MSB*/
-    /*cdsparam = cds_mode [14:15] spare [10,13] bandsize[0:9] where 0 is the LSB*/
-    return cds_mode_s << 14 | digigtal_offset_s;
+    return fee_inline_fill_cdsparam_parameter(cds_mode, digital_offset);
 }
 
 uint16_t fee_fill_freqbinningband_parameter(int binningsize, int bandsize)
 {
-    uint16_t binninsize_s;
-    uint16_t bandsize_s;
-
-    /*Binningsize parameter length is three bits and has an offset of -1*/
-    binninsize_s = ((uint16_t)binningsize & 0x0007) - 1;
-    /*Bandsize parameter length is nine bits*/
-    bandsize_s = ((uint16_t)bandsize) & 0x01FF;
-    /*freqbinninbband = binningsize [0:2] spare [3,6] bandsize[7:15] being 0 the MSB*/
-    /*freqbinninbband = binningsize [13:15] spare [9,12] bandsize[0:0] being 0 the LSB*/
-    return (binninsize_s << 13) | bandsize_s;
-}
-
-int check_cdsparam_parameter(uint16_t cdsparam,
-                             int cds_mode_max,
-                             int cds_mode_min,
-                             int digital_offset_max,
-                             int digital_offset_min)
-{
-    uint16_t cds_mode_s = 0;
-    uint16_t digigtal_offset_s = 0;
-
-    fee_getCDSParam_parameters(cdsparam, &cds_mode_s, &digigtal_offset_s);
-
-    /* Check that parameters are not out of bound*/
-    if (cds_mode_s < cds_mode_min ||
-        cds_mode_s > cds_mode_max ||
-        digigtal_offset_s < digital_offset_min ||
-        digigtal_offset_s > digital_offset_max)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    return FEE_EXIT_SUCCESS;
+    return fee_inline_fill_freqbinningband_parameter(binningsize, bandsize);
 }
 
-int check_feqbinningband_parameter(uint16_t freqbinningband,
-                                   int binningsize_max,
-                                   int binningsize_min,
-                                   int bandsize_max,
-                                   int bandsize_min)
+int fee_TC_SetParameter(fee_TC_Packet_t TC_Packet, size_t offset, int parameter_length_bytes, uint32_t value)
 {
-    uint16_t binninsize_s;
-    uint16_t bandsize_s;
-
-    fee_getFreqBinningBand_parameters(freqbinningband, &binninsize_s, &bandsize_s);
-
-    /* Check that parameters are not out of bound*/
-    if (binninsize_s < binningsize_min ||
-        binninsize_s > binningsize_max ||
-        bandsize_s < bandsize_min ||
-        bandsize_s > bandsize_max)
-    {
-        return FEE_EXIT_ERROR;
-    }
-
-    return FEE_EXIT_SUCCESS;
+    return PatchParameter_Checksum8(TC_Packet, TC_OFFSET_CHECKSUM, offset, parameter_length_bytes, value);
 }
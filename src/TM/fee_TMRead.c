@@ -11,6 +11,7 @@
  */
 #include <fee.h>
 #include "../common/fee_common.h"
+#include "../common/fee_stats_internal.h"
 #include <string.h>
 #include <arpa/inet.h>
 #include <math.h>
@@ -129,7 +130,7 @@ int fee_convert_TM_parameters(fee_TM_t TM_Data_Struct_Index, fee_TM_Float_t *TM_
     return FEE_EXIT_SUCCESS;
 }
 
-int fee_TM_Read(fee_TM_Packet_t TM_Packet, fee_TM_t *TM_Data_Struct)
+int DeserializeTM(fee_TM_Packet_t TM_Packet, fee_TM_t *TM_Data_Struct)
 {
 
     DeserializationInfo_t TM_serialization;
@@ -454,7 +455,19 @@ int fee_TM_Read(fee_TM_Packet_t TM_Packet, fee_TM_t *TM_Data_Struct)
     return FEE_EXIT_SUCCESS;
 }
 
-int fee_CheckTelemetryChecksum(fee_TM_Packet_t TM_Packet){
+int fee_TM_Read(fee_TM_Packet_t TM_Packet, fee_TM_t *TM_Data_Struct)
+{
+    int Status;
+    FEE_STATS_START(Timer);
+
+    Status = DeserializeTM(TM_Packet, TM_Data_Struct);
+
+    FEE_STATS_STOP(FEE_STATS_TM_READ, Timer, Status, TM_PACKET_BYTES, FEE_STATS_FAIL_LENGTH);
+
+    return Status;
+}
+
+static int CheckTMChecksum(fee_TM_Packet_t TM_Packet){
 
     uint16_t ReadedChecksum = 0;
     uint16_t CalculatedChecksum = 0;
@@ -472,4 +485,16 @@ int fee_CheckTelemetryChecksum(fee_TM_Packet_t TM_Packet){
     }
 
     return FEE_EXIT_SUCCESS;
+}
+
+int fee_CheckTelemetryChecksum(fee_TM_Packet_t TM_Packet)
+{
+    int Status;
+    FEE_STATS_START(Timer);
+
+    Status = CheckTMChecksum(TM_Packet);
+
+    FEE_STATS_STOP(FEE_STATS_CHECK_TM_CHECKSUM, Timer, Status, TM_PACKET_BYTES, FEE_STATS_FAIL_CHECKSUM);
+
+    return Status;
 }
\ No newline at end of file
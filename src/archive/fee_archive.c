@@ -0,0 +1,860 @@
+/**
+ * @file fee_archive.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library compressed TM archive functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fee.h>
+#include <fee_archive.h>
+#include "../common/fee_common.h"
+
+/*"FEETMARC" in ASCII*/
+#define ARCHIVE_MAGIC 0x435241544D454546ULL
+/*"TMBK" in ASCII*/
+#define ARCHIVE_BLOCK_MAGIC 0x4B424D54U
+
+/*Packet layout. The TC echo is every word from the TC counter to the TM checksum except the measurements*/
+#define ECHO_FIRST_BYTES TM_OFFSET_TC_COUNTER
+#define MEAS_FIRST_BYTE TM_OFFSET_CCDTEMP_MEAS1
+#define MEAS_END_BYTE TM_OFFSET_ACQSTARTDELAY
+#define NUM_MEAS_WORDS ((MEAS_END_BYTE - MEAS_FIRST_BYTE) / 2)
+#define NUM_ECHO_WORDS ((MEAS_FIRST_BYTE - ECHO_FIRST_BYTES + TM_OFFSET_CHECKSUM - MEAS_END_BYTE) / 2)
+
+/*Worst encoded bits of a packet: timestamp and counter (4 + 64 each), a run of one echo with every word changed
+  (1 + NUM_ECHO_WORDS + 16 * NUM_ECHO_WORDS), the measurement deltas and a raw checksum (1 + 16)*/
+#define PACKET_MAX_BITS (2 * 68 + 1 + 17 * NUM_ECHO_WORDS + 16 * NUM_MEAS_WORDS + 17)
+/*Bits of a block besides its packets: first timestamp and counter, first value and width of every measurement column*/
+#define BLOCK_FIXED_BITS (64 + 32 + 21 * NUM_MEAS_WORDS)
+
+typedef struct
+{
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t BlockPackets;
+
+} ArchiveHeader_t;
+
+typedef struct
+{
+    uint32_t Magic;
+    uint32_t NumPackets;
+    uint64_t FirstTimestamp;
+    uint64_t LastTimestamp;
+    uint64_t BlockBytes;
+
+} ArchiveBlockHeader_t;
+
+/*Bits are written from the least significant bit of every byte*/
+typedef struct
+{
+    uint8_t *Out;
+    size_t Capacity;
+    size_t Bytes;
+    uint64_t Acc;
+    unsigned NumBits;
+    int Overflow;
+
+} BitWriter_t;
+
+typedef struct
+{
+    const uint8_t *In;
+    size_t Bytes;
+    size_t Pos;
+    uint64_t Acc;
+    unsigned NumBits;
+    int Underflow;
+
+} BitReader_t;
+
+struct fee_tm_archive_writer
+{
+    FILE *fp;
+    uint32_t BlockPackets;
+    uint32_t NumPackets;
+    uint64_t *Timestamps;
+    fee_TM_Packet_t *Packets;
+    uint8_t *Block;
+    size_t BlockCapacity;
+    int Status;
+};
+
+struct fee_tm_archive_reader
+{
+    const uint8_t *Data;
+    size_t NumBytes;
+    uint32_t BlockPackets;
+    size_t NextBlock;       /*Offset of the next block to be decoded*/
+    uint64_t *Timestamps;   /*Decoded block*/
+    fee_TM_Packet_t *Packets;
+    uint32_t NumPackets;
+    uint32_t NextPacket;
+};
+
+static void PutBits(BitWriter_t *Writer, uint64_t Value, unsigned NumBits)
+{
+    /*At most 32 bits at a time, so that the accumulator never holds more than 39*/
+    if (NumBits > 32)
+    {
+        PutBits(Writer, Value & 0xFFFFFFFFU, 32);
+        PutBits(Writer, Value >> 32, NumBits - 32);
+        return;
+    }
+
+    if (NumBits < 64)
+    {
+        Value &= (1ULL << NumBits) - 1;
+    }
+    Writer->Acc |= Value << Writer->NumBits;
+    Writer->NumBits += NumBits;
+
+    while (Writer->NumBits >= 8)
+    {
+        if (Writer->Bytes < Writer->Capacity)
+        {
+            Writer->Out[Writer->Bytes] = (uint8_t)Writer->Acc;
+        }
+        else
+        {
+            Writer->Overflow = 1;
+        }
+        Writer->Bytes++;
+        Writer->Acc >>= 8;
+        Writer->NumBits -= 8;
+    }
+}
+
+static void FlushBits(BitWriter_t *Writer)
+{
+    if (Writer->NumBits > 0)
+    {
+        PutBits(Writer, 0, 8 - Writer->NumBits);
+    }
+}
+
+static uint64_t GetBits(BitReader_t *Reader, unsigned NumBits)
+{
+    uint64_t Value;
+
+    if (NumBits > 32)
+    {
+        Value = GetBits(Reader, 32);
+        return Value | (GetBits(Reader, NumBits - 32) << 32);
+    }
+
+    while (Reader->NumBits < NumBits)
+    {
+        if (Reader->Pos >= Reader->Bytes)
+        {
+            Reader->Underflow = 1;
+            return 0;
+        }
+        Reader->Acc |= (uint64_t)Reader->In[Reader->Pos++] << Reader->NumBits;
+        Reader->NumBits += 8;
+    }
+
+    Value = Reader->Acc & ((1ULL << NumBits) - 1);
+    Reader->Acc >>= NumBits;
+    Reader->NumBits -= NumBits;
+
+    return Value;
+}
+
+static uint64_t ZigZag64(uint64_t Value)
+{
+    return (Value << 1) ^ (0 - (Value >> 63));
+}
+
+static uint64_t UnZigZag64(uint64_t Value)
+{
+    return (Value >> 1) ^ (0 - (Value & 1));
+}
+
+static uint32_t ZigZag32(uint32_t Value)
+{
+    return (Value << 1) ^ (0U - (Value >> 31));
+}
+
+static uint32_t UnZigZag32(uint32_t Value)
+{
+    return (Value >> 1) ^ (0U - (Value & 1));
+}
+
+static uint16_t ZigZag16(uint16_t Value)
+{
+    return (uint16_t)((Value << 1) ^ (0U - (Value >> 15)));
+}
+
+static uint16_t UnZigZag16(uint16_t Value)
+{
+    return (uint16_t)((Value >> 1) ^ (0U - (Value & 1)));
+}
+
+/*Zig-zag delta-of-delta: '0' if it is 0, then '10', '110' and '1110' with 7, 9 and 12 bits, and '1111' with 64 bits*/
+static void PutDoD(BitWriter_t *Writer, uint64_t ZigZag)
+{
+    if (ZigZag == 0)
+    {
+        PutBits(Writer, 0, 1);
+    }
+    else if (ZigZag < (1U << 7))
+    {
+        PutBits(Writer, 0x1, 2);
+        PutBits(Writer, ZigZag, 7);
+    }
+    else if (ZigZag < (1U << 9))
+    {
+        PutBits(Writer, 0x3, 3);
+        PutBits(Writer, ZigZag, 9);
+    }
+    else if (ZigZag < (1U << 12))
+    {
+        PutBits(Writer, 0x7, 4);
+        PutBits(Writer, ZigZag, 12);
+    }
+    else
+    {
+        PutBits(Writer, 0xF, 4);
+        PutBits(Writer, ZigZag, 64);
+    }
+}
+
+static uint64_t GetDoD(BitReader_t *Reader)
+{
+    static const unsigned Widths[] = {7, 9, 12, 64};
+    unsigned Prefix = 0;
+
+    while (Prefix < 4 && GetBits(Reader, 1) == 1)
+    {
+        Prefix++;
+    }
+    if (Prefix == 0)
+    {
+        return 0;
+    }
+
+    return GetBits(Reader, Widths[Prefix - 1]);
+}
+
+/*Elias gamma code of a run length (at least 1)*/
+static void PutGamma(BitWriter_t *Writer, uint32_t Value)
+{
+    unsigned NumBits = 0;
+
+    while ((Value >> NumBits) > 1)
+    {
+        NumBits++;
+    }
+    PutBits(Writer, 1ULL << NumBits, NumBits + 1);
+    PutBits(Writer, Value, NumBits);
+}
+
+static uint32_t GetGamma(BitReader_t *Reader)
+{
+    unsigned NumBits = 0;
+
+    while (NumBits < 32 && GetBits(Reader, 1) == 0 && !Reader->Underflow)
+    {
+        NumBits++;
+    }
+    if (NumBits >= 32)
+    {
+        Reader->Underflow = 1;
+        return 0;
+    }
+
+    return (uint32_t)((1ULL << NumBits) | GetBits(Reader, NumBits));
+}
+
+static uint16_t ReadWord(const uint8_t *Packet, size_t Offset)
+{
+    return (uint16_t)((Packet[Offset] << 8) | Packet[Offset + 1]);
+}
+
+static void WriteWord(uint8_t *Packet, size_t Offset, uint16_t Word)
+{
+    Packet[Offset] = (uint8_t)(Word >> 8);
+    Packet[Offset + 1] = (uint8_t)Word;
+}
+
+/*Byte offset of every word of the TC echo*/
+static size_t EchoOffset(size_t Word)
+{
+    size_t Offset = ECHO_FIRST_BYTES + 2 * Word;
+
+    return Offset < MEAS_FIRST_BYTE ? Offset : Offset + (MEAS_END_BYTE - MEAS_FIRST_BYTE);
+}
+
+static int SameEcho(const uint8_t *A, const uint8_t *B)
+{
+    return memcmp(A + ECHO_FIRST_BYTES, B + ECHO_FIRST_BYTES, MEAS_FIRST_BYTE - ECHO_FIRST_BYTES) == 0 &&
+           memcmp(A + MEAS_END_BYTE, B + MEAS_END_BYTE, TM_OFFSET_CHECKSUM - MEAS_END_BYTE) == 0;
+}
+
+static uint32_t ReadCounter(const uint8_t *Packet)
+{
+    return ((uint32_t)Packet[0] << 24) | ((uint32_t)Packet[1] << 16) | ((uint32_t)Packet[2] << 8) | Packet[3];
+}
+
+static void StoreChecksum(uint8_t *Packet)
+{
+    uint16_t Checksum = XORChecksum16(Packet, TM_PACKET_BYTES - TM_CHECKSUM_BYTES);
+
+    memcpy(Packet + TM_OFFSET_CHECKSUM, &Checksum, TM_CHECKSUM_BYTES);
+}
+
+size_t fee_tm_archive_block_bound(size_t NumPackets)
+{
+    return sizeof(ArchiveBlockHeader_t) + (NumPackets * PACKET_MAX_BITS + BLOCK_FIXED_BITS + 7) / 8;
+}
+
+int fee_tm_archive_encode_block(const uint64_t *Timestamps, const fee_TM_Packet_t *Packets, size_t NumPackets,
+                                uint8_t *Block, size_t Capacity, size_t *BlockBytes)
+{
+    ArchiveBlockHeader_t Header;
+    BitWriter_t Writer;
+    uint64_t Delta = 0, PrevDelta = 0;
+    uint32_t Delta32, PrevDelta32 = 0;
+    uint16_t Word, Prev, Column[NUM_MEAS_WORDS];
+    unsigned Width;
+    uint64_t Mask;
+    fee_TM_Packet_t Check;
+    const uint8_t *Echo = NULL;
+    size_t i, j, Run;
+
+    if (NumPackets == 0 || NumPackets > UINT32_MAX || Capacity < sizeof(ArchiveBlockHeader_t))
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(&Writer, 0, sizeof(Writer));
+    Writer.Out = Block + sizeof(ArchiveBlockHeader_t);
+    Writer.Capacity = Capacity - sizeof(ArchiveBlockHeader_t);
+
+    Header.Magic = ARCHIVE_BLOCK_MAGIC;
+    Header.NumPackets = (uint32_t)NumPackets;
+    Header.FirstTimestamp = Timestamps[0];
+    Header.LastTimestamp = Timestamps[0];
+
+    /*Timestamps. The header has the lowest and highest ones, which may not be the first and last ones*/
+    PutBits(&Writer, Timestamps[0], 64);
+    for (i = 1; i < NumPackets; i++)
+    {
+        Delta = Timestamps[i] - Timestamps[i - 1];
+        PutDoD(&Writer, ZigZag64(Delta - PrevDelta));
+        PrevDelta = Delta;
+
+        Header.FirstTimestamp = Timestamps[i] < Header.FirstTimestamp ? Timestamps[i] : Header.FirstTimestamp;
+        Header.LastTimestamp = Timestamps[i] > Header.LastTimestamp ? Timestamps[i] : Header.LastTimestamp;
+    }
+
+    /*TM_COUNTER*/
+    PutBits(&Writer, ReadCounter(Packets[0]), 32);
+    for (i = 1; i < NumPackets; i++)
+    {
+        Delta32 = ReadCounter(Packets[i]) - ReadCounter(Packets[i - 1]);
+        PutDoD(&Writer, ZigZag32(Delta32 - PrevDelta32));
+        PrevDelta32 = Delta32;
+    }
+
+    /*TC echo runs: length, mask of the words changed from the previous run and their XOR*/
+    for (i = 0; i < NumPackets; i += Run)
+    {
+        for (Run = 1; i + Run < NumPackets && SameEcho(Packets[i], Packets[i + Run]); Run++)
+        {
+        }
+        PutGamma(&Writer, (uint32_t)Run);
+
+        Mask = 0;
+        for (j = 0; j < NUM_ECHO_WORDS; j++)
+        {
+            Prev = Echo != NULL ? ReadWord(Echo, EchoOffset(j)) : 0;
+            Mask |= (uint64_t)(ReadWord(Packets[i], EchoOffset(j)) != Prev) << j;
+        }
+        PutBits(&Writer, Mask, NUM_ECHO_WORDS);
+        for (j = 0; j < NUM_ECHO_WORDS; j++)
+        {
+            if (Mask & (1ULL << j))
+            {
+                Prev = Echo != NULL ? ReadWord(Echo, EchoOffset(j)) : 0;
+                PutBits(&Writer, (uint16_t)(ReadWord(Packets[i], EchoOffset(j)) ^ Prev), 16);
+            }
+        }
+        Echo = Packets[i];
+    }
+
+    /*Measurement columns: first value, width and the zig-zag deltas bit-packed*/
+    for (j = 0; j < NUM_MEAS_WORDS; j++)
+    {
+        Column[j] = 0;
+        for (i = 1; i < NumPackets; i++)
+        {
+            Column[j] |= ZigZag16((uint16_t)(ReadWord(Packets[i], MEAS_FIRST_BYTE + 2 * j) -
+                                             ReadWord(Packets[i - 1], MEAS_FIRST_BYTE + 2 * j)));
+        }
+        for (Width = 0; Width < 16 && (Column[j] >> Width) != 0; Width++)
+        {
+        }
+
+        PutBits(&Writer, ReadWord(Packets[0], MEAS_FIRST_BYTE + 2 * j), 16);
+        PutBits(&Writer, Width, 5);
+        for (i = 1; i < NumPackets && Width > 0; i++)
+        {
+            Word = (uint16_t)(ReadWord(Packets[i], MEAS_FIRST_BYTE + 2 * j) - ReadWord(Packets[i - 1], MEAS_FIRST_BYTE + 2 * j));
+            PutBits(&Writer, ZigZag16(Word), Width);
+        }
+    }
+
+    /*Checksums. A valid one is rebuilt from the packet*/
+    for (i = 0; i < NumPackets; i++)
+    {
+        memcpy(Check, Packets[i], TM_PACKET_BYTES);
+        StoreChecksum(Check);
+        if (memcmp(Check + TM_OFFSET_CHECKSUM, Packets[i] + TM_OFFSET_CHECKSUM, TM_CHECKSUM_BYTES) == 0)
+        {
+            PutBits(&Writer, 0, 1);
+        }
+        else
+        {
+            PutBits(&Writer, 1, 1);
+            PutBits(&Writer, Packets[i][TM_OFFSET_CHECKSUM], 8);
+            PutBits(&Writer, Packets[i][TM_OFFSET_CHECKSUM + 1], 8);
+        }
+    }
+
+    FlushBits(&Writer);
+    if (Writer.Overflow)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Header.BlockBytes = sizeof(ArchiveBlockHeader_t) + Writer.Bytes;
+    memcpy(Block, &Header, sizeof(Header));
+    *BlockBytes = (size_t)Header.BlockBytes;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_archive_block_info(const uint8_t *Block, size_t Bytes, fee_tm_archive_block_info_t *Info)
+{
+    ArchiveBlockHeader_t Header;
+
+    if (Bytes < sizeof(Header))
+    {
+        return FEE_EXIT_ERROR;
+    }
+    memcpy(&Header, Block, sizeof(Header));
+
+    if (Header.Magic != ARCHIVE_BLOCK_MAGIC || Header.NumPackets == 0 || Header.BlockBytes < sizeof(Header) ||
+        Header.BlockBytes > Bytes || Header.FirstTimestamp > Header.LastTimestamp)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Info->NumPackets = Header.NumPackets;
+    Info->FirstTimestamp = Header.FirstTimestamp;
+    Info->LastTimestamp = Header.LastTimestamp;
+    Info->BlockBytes = (size_t)Header.BlockBytes;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_archive_decode_block(const uint8_t *Block, size_t Bytes, uint64_t *Timestamps, fee_TM_Packet_t *Packets,
+                                size_t Capacity)
+{
+    fee_tm_archive_block_info_t Info;
+    BitReader_t Reader;
+    uint64_t Delta = 0;
+    uint32_t Counter, Delta32 = 0;
+    uint16_t Word, Prev;
+    unsigned Width;
+    uint64_t Mask;
+    const uint8_t *Echo = NULL;
+    size_t NumPackets, i, j, k, Run;
+
+    if (fee_tm_archive_block_info(Block, Bytes, &Info) != FEE_EXIT_SUCCESS || Info.NumPackets > Capacity)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    NumPackets = Info.NumPackets;
+
+    memset(&Reader, 0, sizeof(Reader));
+    Reader.In = Block + sizeof(ArchiveBlockHeader_t);
+    Reader.Bytes = Info.BlockBytes - sizeof(ArchiveBlockHeader_t);
+
+    Timestamps[0] = GetBits(&Reader, 64);
+    for (i = 1; i < NumPackets; i++)
+    {
+        Delta += UnZigZag64(GetDoD(&Reader));
+        Timestamps[i] = Timestamps[i - 1] + Delta;
+    }
+
+    Counter = (uint32_t)GetBits(&Reader, 32);
+    for (i = 0; i < NumPackets; i++)
+    {
+        if (i > 0)
+        {
+            Delta32 += UnZigZag32((uint32_t)GetDoD(&Reader));
+            Counter += Delta32;
+        }
+        Packets[i][0] = (uint8_t)(Counter >> 24);
+        Packets[i][1] = (uint8_t)(Counter >> 16);
+        Packets[i][2] = (uint8_t)(Counter >> 8);
+        Packets[i][3] = (uint8_t)Counter;
+    }
+
+    for (i = 0; i < NumPackets && !Reader.Underflow; i += Run)
+    {
+        Run = GetGamma(&Reader);
+        if (Run == 0 || Run > NumPackets - i)
+        {
+            return FEE_EXIT_ERROR;
+        }
+
+        Mask = GetBits(&Reader, NUM_ECHO_WORDS);
+        for (j = 0; j < NUM_ECHO_WORDS; j++)
+        {
+            Prev = Echo != NULL ? ReadWord(Echo, EchoOffset(j)) : 0;
+            Word = (Mask & (1ULL << j)) ? (uint16_t)(Prev ^ GetBits(&Reader, 16)) : Prev;
+            WriteWord(Packets[i], EchoOffset(j), Word);
+        }
+        for (k = 1; k < Run; k++)
+        {
+            memcpy(Packets[i + k] + ECHO_FIRST_BYTES, Packets[i] + ECHO_FIRST_BYTES, MEAS_FIRST_BYTE - ECHO_FIRST_BYTES);
+            memcpy(Packets[i + k] + MEAS_END_BYTE, Packets[i] + MEAS_END_BYTE, TM_OFFSET_CHECKSUM - MEAS_END_BYTE);
+        }
+        Echo = Packets[i];
+    }
+
+    for (j = 0; j < NUM_MEAS_WORDS; j++)
+    {
+        Word = (uint16_t)GetBits(&Reader, 16);
+        Width = (unsigned)GetBits(&Reader, 5);
+        if (Width > 16)
+        {
+            return FEE_EXIT_ERROR;
+        }
+
+        WriteWord(Packets[0], MEAS_FIRST_BYTE + 2 * j, Word);
+        for (i = 1; i < NumPackets; i++)
+        {
+            if (Width > 0)
+            {
+                Word = (uint16_t)(Word + UnZigZag16((uint16_t)GetBits(&Reader, Width)));
+            }
+            WriteWord(Packets[i], MEAS_FIRST_BYTE + 2 * j, Word);
+        }
+    }
+
+    for (i = 0; i < NumPackets; i++)
+    {
+        if (GetBits(&Reader, 1) == 0)
+        {
+            StoreChecksum(Packets[i]);
+        }
+        else
+        {
+            Packets[i][TM_OFFSET_CHECKSUM] = (uint8_t)GetBits(&Reader, 8);
+            Packets[i][TM_OFFSET_CHECKSUM + 1] = (uint8_t)GetBits(&Reader, 8);
+        }
+    }
+
+    return Reader.Underflow ? FEE_EXIT_ERROR : FEE_EXIT_SUCCESS;
+}
+
+static int WriteBlock(fee_tm_archive_writer_t *Writer)
+{
+    size_t BlockBytes;
+
+    if (Writer->NumPackets == 0)
+    {
+        return FEE_EXIT_SUCCESS;
+    }
+
+    if (fee_tm_archive_encode_block(Writer->Timestamps, (const fee_TM_Packet_t *)Writer->Packets, Writer->NumPackets,
+                                    Writer->Block, Writer->BlockCapacity, &BlockBytes) != FEE_EXIT_SUCCESS ||
+        fwrite(Writer->Block, 1, BlockBytes, Writer->fp) != BlockBytes)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Writer->NumPackets = 0;
+    return FEE_EXIT_SUCCESS;
+}
+
+static void FreeWriter(fee_tm_archive_writer_t *Writer)
+{
+    free(Writer->Timestamps);
+    free(Writer->Packets);
+    free(Writer->Block);
+    free(Writer);
+}
+
+int fee_tm_archive_writer_open(const char *Path, uint32_t BlockPackets, fee_tm_archive_writer_t **Writer)
+{
+    fee_tm_archive_writer_t *Opened;
+    ArchiveHeader_t Header;
+
+    *Writer = NULL;
+    if (BlockPackets == 0)
+    {
+        BlockPackets = FEE_TM_ARCHIVE_DEFAULT_BLOCK_PACKETS;
+    }
+
+    Opened = (fee_tm_archive_writer_t *)calloc(1, sizeof(fee_tm_archive_writer_t));
+    if (Opened == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    Opened->BlockPackets = BlockPackets;
+    Opened->BlockCapacity = fee_tm_archive_block_bound(BlockPackets);
+    Opened->Timestamps = (uint64_t *)malloc(BlockPackets * sizeof(uint64_t));
+    Opened->Packets = (fee_TM_Packet_t *)malloc(BlockPackets * sizeof(fee_TM_Packet_t));
+    Opened->Block = (uint8_t *)malloc(Opened->BlockCapacity);
+    if (Opened->Timestamps == NULL || Opened->Packets == NULL || Opened->Block == NULL)
+    {
+        FreeWriter(Opened);
+        return FEE_EXIT_ERROR;
+    }
+
+    Opened->fp = fopen(Path, "wb");
+    if (Opened->fp == NULL)
+    {
+        FreeWriter(Opened);
+        return FEE_EXIT_ERROR;
+    }
+
+    Header.Magic = ARCHIVE_MAGIC;
+    Header.Version = FEE_TM_ARCHIVE_VERSION;
+    Header.BlockPackets = BlockPackets;
+    if (fwrite(&Header, sizeof(Header), 1, Opened->fp) != 1)
+    {
+        fclose(Opened->fp);
+        FreeWriter(Opened);
+        return FEE_EXIT_ERROR;
+    }
+
+    Opened->Status = FEE_EXIT_SUCCESS;
+    *Writer = Opened;
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_archive_append(fee_tm_archive_writer_t *Writer, uint64_t Timestamp, const fee_TM_Packet_t Packet)
+{
+    if (Writer->Status != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Writer->Timestamps[Writer->NumPackets] = Timestamp;
+    memcpy(Writer->Packets[Writer->NumPackets], Packet, TM_PACKET_BYTES);
+    if (++Writer->NumPackets == Writer->BlockPackets)
+    {
+        Writer->Status = WriteBlock(Writer);
+    }
+
+    return Writer->Status;
+}
+
+int fee_tm_archive_writer_close(fee_tm_archive_writer_t *Writer)
+{
+    int Status;
+
+    if (Writer == NULL)
+    {
+        return FEE_EXIT_SUCCESS;
+    }
+
+    Status = Writer->Status;
+    if (Status == FEE_EXIT_SUCCESS)
+    {
+        Status = WriteBlock(Writer);
+    }
+    if (fclose(Writer->fp) != 0)
+    {
+        Status = FEE_EXIT_ERROR;
+    }
+
+    FreeWriter(Writer);
+    return Status;
+}
+
+int fee_tm_archive_reader_open(const char *Path, fee_tm_archive_reader_t **Reader)
+{
+    fee_tm_archive_reader_t *Opened;
+    ArchiveHeader_t Header;
+    struct stat Stat;
+    void *Map;
+    int Fd;
+
+    *Reader = NULL;
+
+    Fd = open(Path, O_RDONLY | O_CLOEXEC);
+    if (Fd < 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    if (fstat(Fd, &Stat) != 0 || (uint64_t)Stat.st_size < sizeof(ArchiveHeader_t) || (uint64_t)Stat.st_size > SIZE_MAX)
+    {
+        close(Fd);
+        return FEE_EXIT_ERROR;
+    }
+    Map = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+    close(Fd);
+    if (Map == MAP_FAILED)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memcpy(&Header, Map, sizeof(Header));
+    Opened = (fee_tm_archive_reader_t *)calloc(1, sizeof(fee_tm_archive_reader_t));
+    if (Header.Magic != ARCHIVE_MAGIC || Header.Version != FEE_TM_ARCHIVE_VERSION || Header.BlockPackets == 0 ||
+        Opened == NULL)
+    {
+        free(Opened);
+        munmap(Map, (size_t)Stat.st_size);
+        return FEE_EXIT_ERROR;
+    }
+
+    Opened->Data = (const uint8_t *)Map;
+    Opened->NumBytes = (size_t)Stat.st_size;
+    Opened->BlockPackets = Header.BlockPackets;
+    Opened->NextBlock = sizeof(ArchiveHeader_t);
+    Opened->Timestamps = (uint64_t *)malloc(Header.BlockPackets * sizeof(uint64_t));
+    Opened->Packets = (fee_TM_Packet_t *)malloc(Header.BlockPackets * sizeof(fee_TM_Packet_t));
+    if (Opened->Timestamps == NULL || Opened->Packets == NULL)
+    {
+        fee_tm_archive_reader_close(Opened);
+        return FEE_EXIT_ERROR;
+    }
+
+    *Reader = Opened;
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_tm_archive_reader_close(fee_tm_archive_reader_t *Reader)
+{
+    if (Reader == NULL)
+    {
+        return;
+    }
+
+    munmap((void *)Reader->Data, Reader->NumBytes);
+    free(Reader->Timestamps);
+    free(Reader->Packets);
+    free(Reader);
+}
+
+/*Decodes the block at NextBlock*/
+static int DecodeNextBlock(fee_tm_archive_reader_t *Reader)
+{
+    fee_tm_archive_block_info_t Info;
+    const uint8_t *Block = Reader->Data + Reader->NextBlock;
+    size_t Bytes = Reader->NumBytes - Reader->NextBlock;
+
+    Reader->NumPackets = 0;
+    Reader->NextPacket = 0;
+
+    if (fee_tm_archive_block_info(Block, Bytes, &Info) != FEE_EXIT_SUCCESS ||
+        fee_tm_archive_decode_block(Block, Bytes, Reader->Timestamps, Reader->Packets, Reader->BlockPackets) != FEE_EXIT_SUCCESS)
+    {
+        /*A corrupted block ends the archive*/
+        Reader->NextBlock = Reader->NumBytes;
+        return FEE_EXIT_ERROR;
+    }
+
+    Reader->NextBlock += Info.BlockBytes;
+    Reader->NumPackets = Info.NumPackets;
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_archive_next(fee_tm_archive_reader_t *Reader, uint64_t *Timestamp, fee_TM_Packet_t Packet)
+{
+    while (Reader->NextPacket == Reader->NumPackets)
+    {
+        if (Reader->NextBlock >= Reader->NumBytes || DecodeNextBlock(Reader) != FEE_EXIT_SUCCESS)
+        {
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    *Timestamp = Reader->Timestamps[Reader->NextPacket];
+    memcpy(Packet, Reader->Packets[Reader->NextPacket], TM_PACKET_BYTES);
+    Reader->NextPacket++;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_archive_seek(fee_tm_archive_reader_t *Reader, uint64_t Timestamp)
+{
+    fee_tm_archive_block_info_t Info;
+
+    Reader->NextBlock = sizeof(ArchiveHeader_t);
+    Reader->NumPackets = 0;
+    Reader->NextPacket = 0;
+
+    while (Reader->NextBlock < Reader->NumBytes)
+    {
+        if (fee_tm_archive_block_info(Reader->Data + Reader->NextBlock, Reader->NumBytes - Reader->NextBlock, &Info) !=
+            FEE_EXIT_SUCCESS)
+        {
+            Reader->NextBlock = Reader->NumBytes;
+            return FEE_EXIT_ERROR;
+        }
+        if (Info.LastTimestamp >= Timestamp)
+        {
+            break;
+        }
+        Reader->NextBlock += Info.BlockBytes;
+    }
+
+    if (Reader->NextBlock >= Reader->NumBytes)
+    {
+        return FEE_EXIT_SUCCESS;
+    }
+    if (DecodeNextBlock(Reader) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    while (Reader->NextPacket < Reader->NumPackets && Reader->Timestamps[Reader->NextPacket] < Timestamp)
+    {
+        Reader->NextPacket++;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_archive_info(const fee_tm_archive_reader_t *Reader, fee_tm_archive_info_t *Info)
+{
+    fee_tm_archive_block_info_t BlockInfo;
+    size_t Offset = sizeof(ArchiveHeader_t);
+
+    memset(Info, 0, sizeof(fee_tm_archive_info_t));
+    Info->ArchiveBytes = Reader->NumBytes;
+
+    while (Offset < Reader->NumBytes)
+    {
+        if (fee_tm_archive_block_info(Reader->Data + Offset, Reader->NumBytes - Offset, &BlockInfo) != FEE_EXIT_SUCCESS)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Info->NumPackets += BlockInfo.NumPackets;
+        Info->NumBlocks++;
+        Offset += BlockInfo.BlockBytes;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
@@ -0,0 +1,499 @@
+/**
+ * @file fee_batch.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library parallel batch decode functions and work-stealing thread pool.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fee.h>
+#include <fee_batch.h>
+#include "../common/fee_common.h"
+
+/*Ranges of task indexes are packed in 64 bits, so that the owner and the thieves update them with a single CAS*/
+#define RANGE_BEGIN(Range) ((uint32_t)(Range))
+#define RANGE_END(Range) ((uint32_t)((Range) >> 32))
+#define MAKE_RANGE(Begin, End) (((uint64_t)(End) << 32) | (uint64_t)(Begin))
+
+/*Tasks of a worker. The owner takes them from the beginning and the thieves half of them from the end*/
+typedef struct
+{
+    _Alignas(FEE_CACHE_LINE_BYTES) _Atomic uint64_t Range;
+
+} WorkerQueue_t;
+
+/*Information of a worker thread*/
+typedef struct
+{
+    fee_thread_pool_t *Pool;
+    size_t Index;
+    pthread_t Thread;
+
+} PoolWorker_t;
+
+/*Pool whose job the current thread works on, as a worker or as the thread that runs it. It detects re-entry*/
+static _Thread_local const fee_thread_pool_t *ThreadPoolOfThread = NULL;
+
+struct fee_thread_pool
+{
+    size_t NumWorkers;       /*Worker 0 is the thread that runs the job*/
+    WorkerQueue_t *Queues;
+    PoolWorker_t *Workers;
+    size_t NumThreads;       /*Started threads (workers 1 to NumWorkers - 1)*/
+
+    pthread_mutex_t RunLock; /*Serializes the jobs*/
+    pthread_mutex_t Lock;    /*Protects the fields below*/
+    pthread_cond_t Start;
+    pthread_cond_t Done;
+    uint64_t Generation;     /*Incremented for every job*/
+    size_t Running;          /*Threads still working on the current job*/
+    int Stop;
+    fee_task_fn Task;
+    void *TaskData;
+};
+
+/*Job of a batch decode*/
+typedef struct
+{
+    fee_packet_desc_t *Descs;
+    size_t NumDescs;
+    size_t ChunkSize;
+    int CheckChecksum;
+
+} BatchJob_t;
+
+static pthread_once_t DefaultPoolOnce = PTHREAD_ONCE_INIT;
+static fee_thread_pool_t *DefaultPool = NULL;
+
+/**
+ * @brief Function that takes the first task of the queue of a worker.
+ *
+ * @return int - 1 if a task has been taken, 0 if the queue is empty.
+ */
+static int PopTask(WorkerQueue_t *Queue, uint32_t *TaskIndex)
+{
+    uint64_t Range = atomic_load_explicit(&Queue->Range, memory_order_acquire);
+
+    while (RANGE_BEGIN(Range) < RANGE_END(Range))
+    {
+        if (atomic_compare_exchange_weak_explicit(&Queue->Range, &Range, MAKE_RANGE(RANGE_BEGIN(Range) + 1, RANGE_END(Range)),
+                                                  memory_order_acq_rel, memory_order_acquire))
+        {
+            *TaskIndex = RANGE_BEGIN(Range);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Function that moves the upper half of the tasks of another worker to the (empty) queue of a worker.
+ *  Only the owner stores into its own queue; the other workers only update it with CAS.
+ *
+ * @return int - 1 if any task has been stolen, 0 if every other queue is empty.
+ */
+static int StealTasks(fee_thread_pool_t *Pool, size_t Thief)
+{
+    size_t VictimIt, Victim;
+    uint64_t Range;
+    uint32_t Begin, End, Middle;
+
+    for (VictimIt = 1; VictimIt < Pool->NumWorkers; VictimIt++)
+    {
+        Victim = (Thief + VictimIt) % Pool->NumWorkers;
+        Range = atomic_load_explicit(&Pool->Queues[Victim].Range, memory_order_acquire);
+
+        while (RANGE_BEGIN(Range) < RANGE_END(Range))
+        {
+            Begin = RANGE_BEGIN(Range);
+            End = RANGE_END(Range);
+            Middle = Begin + (End - Begin) / 2;
+
+            if (atomic_compare_exchange_weak_explicit(&Pool->Queues[Victim].Range, &Range, MAKE_RANGE(Begin, Middle),
+                                                      memory_order_acq_rel, memory_order_acquire))
+            {
+                atomic_store_explicit(&Pool->Queues[Thief].Range, MAKE_RANGE(Middle, End), memory_order_release);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*Run tasks until every queue is empty. Stolen tasks in flight belong to the thief, which runs them*/
+static void WorkLoop(fee_thread_pool_t *Pool, size_t Worker)
+{
+    uint32_t TaskIndex;
+
+    do
+    {
+        while (PopTask(&Pool->Queues[Worker], &TaskIndex))
+        {
+            Pool->Task(Pool->TaskData, TaskIndex);
+        }
+    } while (StealTasks(Pool, Worker));
+}
+
+static void *PoolWorkerThread(void *Arg)
+{
+    PoolWorker_t *Worker = Arg;
+    fee_thread_pool_t *Pool = Worker->Pool;
+    uint64_t Seen = 0;
+
+    ThreadPoolOfThread = Pool;
+
+    pthread_mutex_lock(&Pool->Lock);
+    for (;;)
+    {
+        while (Pool->Generation == Seen && !Pool->Stop)
+        {
+            pthread_cond_wait(&Pool->Start, &Pool->Lock);
+        }
+        if (Pool->Stop)
+        {
+            break;
+        }
+        Seen = Pool->Generation;
+        pthread_mutex_unlock(&Pool->Lock);
+
+        WorkLoop(Pool, Worker->Index);
+
+        pthread_mutex_lock(&Pool->Lock);
+        if (--Pool->Running == 0)
+        {
+            pthread_cond_signal(&Pool->Done);
+        }
+    }
+    pthread_mutex_unlock(&Pool->Lock);
+
+    return NULL;
+}
+
+int fee_thread_pool_create(size_t NumWorkers, fee_thread_pool_t **Pool)
+{
+    fee_thread_pool_t *NewPool;
+    long OnlineCPUs;
+    size_t i;
+
+    if (Pool == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    if (NumWorkers == 0)
+    {
+        OnlineCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+        NumWorkers = OnlineCPUs > 0 ? (size_t)OnlineCPUs : 1;
+    }
+
+    NewPool = calloc(1, sizeof(fee_thread_pool_t));
+    if (NewPool == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    NewPool->NumWorkers = NumWorkers;
+    NewPool->Workers = calloc(NumWorkers, sizeof(PoolWorker_t));
+    if (posix_memalign((void **)&NewPool->Queues, FEE_CACHE_LINE_BYTES, NumWorkers * sizeof(WorkerQueue_t)) != 0)
+    {
+        NewPool->Queues = NULL;
+    }
+    if (NewPool->Workers == NULL || NewPool->Queues == NULL)
+    {
+        free(NewPool->Workers);
+        free(NewPool->Queues);
+        free(NewPool);
+        return FEE_EXIT_ERROR;
+    }
+
+    for (i = 0; i < NumWorkers; i++)
+    {
+        atomic_init(&NewPool->Queues[i].Range, 0);
+    }
+
+    pthread_mutex_init(&NewPool->RunLock, NULL);
+    pthread_mutex_init(&NewPool->Lock, NULL);
+    pthread_cond_init(&NewPool->Start, NULL);
+    pthread_cond_init(&NewPool->Done, NULL);
+
+    for (i = 1; i < NumWorkers; i++)
+    {
+        NewPool->Workers[i].Pool = NewPool;
+        NewPool->Workers[i].Index = i;
+        if (pthread_create(&NewPool->Workers[i].Thread, NULL, PoolWorkerThread, &NewPool->Workers[i]) != 0)
+        {
+            fee_thread_pool_destroy(NewPool);
+            return FEE_EXIT_ERROR;
+        }
+        NewPool->NumThreads++;
+    }
+
+    *Pool = NewPool;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_thread_pool_destroy(fee_thread_pool_t *Pool)
+{
+    size_t i;
+
+    if (Pool == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&Pool->Lock);
+    Pool->Stop = 1;
+    pthread_cond_broadcast(&Pool->Start);
+    pthread_mutex_unlock(&Pool->Lock);
+
+    for (i = 1; i <= Pool->NumThreads; i++)
+    {
+        pthread_join(Pool->Workers[i].Thread, NULL);
+    }
+
+    pthread_cond_destroy(&Pool->Start);
+    pthread_cond_destroy(&Pool->Done);
+    pthread_mutex_destroy(&Pool->Lock);
+    pthread_mutex_destroy(&Pool->RunLock);
+    free(Pool->Workers);
+    free(Pool->Queues);
+    free(Pool);
+}
+
+static void CreateDefaultPool(void)
+{
+    if (fee_thread_pool_create(0, &DefaultPool) != FEE_EXIT_SUCCESS)
+    {
+        DefaultPool = NULL;
+    }
+}
+
+fee_thread_pool_t *fee_thread_pool_default(void)
+{
+    pthread_once(&DefaultPoolOnce, CreateDefaultPool);
+
+    return DefaultPool;
+}
+
+size_t fee_thread_pool_size(const fee_thread_pool_t *Pool)
+{
+    return Pool->NumWorkers;
+}
+
+int fee_thread_pool_run(fee_thread_pool_t *Pool, size_t NumTasks, fee_task_fn Task, void *TaskData)
+{
+    const fee_thread_pool_t *OuterPool = ThreadPoolOfThread;
+    size_t i;
+
+    if (Pool == NULL || Task == NULL || NumTasks > UINT32_MAX)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*A task of a job of the pool would wait forever for the job it belongs to*/
+    if (OuterPool == Pool)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    if (NumTasks == 0)
+    {
+        return FEE_EXIT_SUCCESS;
+    }
+
+    pthread_mutex_lock(&Pool->RunLock);
+    ThreadPoolOfThread = Pool;
+
+    /*Contiguous ranges of the same size*/
+    for (i = 0; i < Pool->NumWorkers; i++)
+    {
+        atomic_store_explicit(&Pool->Queues[i].Range,
+                              MAKE_RANGE(NumTasks * i / Pool->NumWorkers, NumTasks * (i + 1) / Pool->NumWorkers),
+                              memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&Pool->Lock);
+    Pool->Task = Task;
+    Pool->TaskData = TaskData;
+    Pool->Running = Pool->NumThreads;
+    Pool->Generation++;
+    pthread_cond_broadcast(&Pool->Start);
+    pthread_mutex_unlock(&Pool->Lock);
+
+    WorkLoop(Pool, 0);
+
+    /*Every thread must leave the job before its data goes out of scope*/
+    pthread_mutex_lock(&Pool->Lock);
+    while (Pool->Running > 0)
+    {
+        pthread_cond_wait(&Pool->Done, &Pool->Lock);
+    }
+    pthread_mutex_unlock(&Pool->Lock);
+
+    ThreadPoolOfThread = OuterPool;
+    pthread_mutex_unlock(&Pool->RunLock);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/*Decode of a PTD descriptor. The length is checked first, as fee_PTD_Read does not know it*/
+static int DecodePTDDesc(fee_packet_desc_t *Desc, int CheckChecksum)
+{
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+
+    if (Desc->Type != FEE_PACKET_PTD || Desc->PTD.ImageMatrix[0] == NULL ||
+        fee_Calculate_PTD_Sizes(Desc->TM, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS ||
+        PTDSizes.DataPacketTotalBytes < PTD_CHECKSUM_BYTES || Desc->PacketBytes < PTDSizes.DataPacketTotalBytes)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    if (CheckChecksum && fee_CheckPTDChecksum(Desc->Packet, PTDSizes) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return fee_PTD_Read(Desc->Packet, Desc->TM, &Desc->PTD);
+}
+
+static int DecodeTMDesc(fee_packet_desc_t *Desc, int CheckChecksum)
+{
+    if (Desc->Type != FEE_PACKET_TM || Desc->PacketBytes < TM_PACKET_BYTES)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    if (CheckChecksum && fee_CheckTelemetryChecksum(Desc->Packet) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return fee_TM_Read(Desc->Packet, &Desc->TM);
+}
+
+static void PTDBatchTask(void *TaskData, size_t TaskIndex)
+{
+    BatchJob_t *Job = TaskData;
+    size_t First = TaskIndex * Job->ChunkSize;
+    size_t Last = First + Job->ChunkSize < Job->NumDescs ? First + Job->ChunkSize : Job->NumDescs;
+    size_t i;
+
+    for (i = First; i < Last; i++)
+    {
+        if (Job->Descs[i].Status == FEE_EXIT_SUCCESS)
+        {
+            Job->Descs[i].Status = DecodePTDDesc(&Job->Descs[i], Job->CheckChecksum);
+        }
+    }
+}
+
+static void TMBatchTask(void *TaskData, size_t TaskIndex)
+{
+    BatchJob_t *Job = TaskData;
+    size_t First = TaskIndex * Job->ChunkSize;
+    size_t Last = First + Job->ChunkSize < Job->NumDescs ? First + Job->ChunkSize : Job->NumDescs;
+    size_t i;
+
+    for (i = First; i < Last; i++)
+    {
+        if (Job->Descs[i].Status == FEE_EXIT_SUCCESS)
+        {
+            Job->Descs[i].Status = DecodeTMDesc(&Job->Descs[i], Job->CheckChecksum);
+        }
+    }
+}
+
+/*Planes of the descriptors without them. Buffers are acquired on the calling thread, as the pool requires*/
+static void AcquireImages(fee_packet_desc_t *Descs, size_t NumDescs, fee_buffer_pool_t *ImagePool)
+{
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+    uint8_t *Buffer;
+    size_t i;
+    int k;
+
+    for (i = 0; i < NumDescs; i++)
+    {
+        if (Descs[i].Status != FEE_EXIT_SUCCESS || Descs[i].PTD.ImageMatrix[0] != NULL || ImagePool == NULL)
+        {
+            continue;
+        }
+
+        if (fee_Calculate_PTD_Sizes(Descs[i].TM, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS ||
+            FEE_NUM_CCD * ImageMatrixSizes.ImageMatrixBytes > fee_buffer_pool_buffer_bytes(ImagePool) ||
+            fee_buffer_pool_acquire(ImagePool, &Buffer, &Descs[i].ImageBufferIndex) != FEE_EXIT_SUCCESS)
+        {
+            Descs[i].Status = FEE_EXIT_ERROR;
+            continue;
+        }
+
+        for (k = 0; k < FEE_NUM_CCD; k++)
+        {
+            Descs[i].PTD.ImageMatrix[k] = (uint16_t *)(Buffer + k * ImageMatrixSizes.ImageMatrixBytes);
+        }
+    }
+}
+
+static int RunBatch(fee_packet_desc_t *Descs, size_t NumDescs, const fee_batch_config_t *Config, fee_task_fn Task)
+{
+    BatchJob_t Job;
+    fee_thread_pool_t *Pool;
+    size_t NumTasks, i;
+    int Status;
+
+    if (Descs == NULL && NumDescs > 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Job.Descs = Descs;
+    Job.NumDescs = NumDescs;
+    Job.ChunkSize = Config != NULL && Config->ChunkSize > 0 ? Config->ChunkSize : FEE_BATCH_DEFAULT_CHUNK;
+    Job.CheckChecksum = Config != NULL && Config->CheckChecksum;
+    NumTasks = (NumDescs + Job.ChunkSize - 1) / Job.ChunkSize;
+
+    if (Config != NULL && Config->Executor != NULL)
+    {
+        Status = Config->Executor(Config->ExecutorData, NumTasks, Task, &Job);
+    }
+    else
+    {
+        Pool = Config != NULL && Config->Pool != NULL ? Config->Pool : fee_thread_pool_default();
+        Status = fee_thread_pool_run(Pool, NumTasks, Task, &Job);
+    }
+
+    for (i = 0; i < NumDescs && Status == FEE_EXIT_SUCCESS; i++)
+    {
+        Status = Descs[i].Status;
+    }
+
+    return Status;
+}
+
+int fee_PTD_ReadBatch(fee_packet_desc_t *Descs, size_t NumDescs, const fee_batch_config_t *Config)
+{
+    if (Descs != NULL)
+    {
+        AcquireImages(Descs, NumDescs, Config != NULL ? Config->ImagePool : NULL);
+    }
+
+    return RunBatch(Descs, NumDescs, Config, PTDBatchTask);
+}
+
+int fee_TM_ReadBatch(fee_packet_desc_t *Descs, size_t NumDescs, const fee_batch_config_t *Config)
+{
+    return RunBatch(Descs, NumDescs, Config, TMBatchTask);
+}
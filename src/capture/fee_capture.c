@@ -0,0 +1,702 @@
+/**
+ * @file fee_capture.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library capture file and timestamp index functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fee.h>
+#include <fee_capture.h>
+
+/*"FEECAPIX" in ASCII*/
+#define CAPTURE_INDEX_MAGIC 0x5849504143454546ULL
+
+/*Values above this are not bytes nor PTD sizes*/
+#define CAPTURE_MAX_VALUE UINT32_MAX
+
+/*Entries reserved at the beginning of an index build*/
+#define CAPTURE_INITIAL_ENTRIES 1024
+
+/*Header of an index file. The entries follow it*/
+typedef struct
+{
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t Stride;
+    uint64_t NumEntries;
+    uint64_t NumPackets;     /*Lines of the capture*/
+    uint64_t CaptureBytes;   /*Size of the indexed capture*/
+    uint64_t CaptureMtimeNs; /*Modification time of the indexed capture*/
+    uint32_t Sorted;         /*Timestamps of the capture are in order*/
+    uint32_t Reserved;
+    uint64_t Reserved2;
+
+} CaptureIndexHeader_t;
+
+struct fee_capture
+{
+    char *Path;
+    const char *Data; /*NULL for an empty capture*/
+    uint64_t NumBytes;
+    uint64_t MtimeNs;
+};
+
+struct fee_capture_index
+{
+    CaptureIndexHeader_t Header;
+    const fee_capture_index_entry_t *Entries;
+    void *Map;                          /*Mapped index file. NULL if the entries were built in memory*/
+    size_t MapBytes;
+    fee_capture_index_entry_t *Owned;   /*Entries built in memory when the index file could not be written*/
+};
+
+static int IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/*Parses the decimal number at Line[*Pos], skipping the blanks before it*/
+static int ParseNumber(const char *Line, size_t Length, size_t *Pos, uint64_t *Value)
+{
+    size_t i = *Pos;
+    uint64_t Number = 0;
+    size_t Digits = 0;
+
+    while (i < Length && IsBlank(Line[i]))
+    {
+        i++;
+    }
+
+    while (i < Length && Line[i] >= '0' && Line[i] <= '9')
+    {
+        /*Timestamps have 13 digits. Longer numbers cannot be parsed without overflow*/
+        if (++Digits > 19)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Number = Number * 10 + (uint64_t)(Line[i] - '0');
+        i++;
+    }
+
+    if (Digits == 0 || (i < Length && !IsBlank(Line[i])))
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    *Pos = i;
+    *Value = Number;
+    return FEE_EXIT_SUCCESS;
+}
+
+static uint32_t DescribedPTDBytes(const uint8_t *TM_Packet)
+{
+    fee_TM_t TM;
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+
+    if (fee_TM_Read((uint8_t *)TM_Packet, &TM) != FEE_EXIT_SUCCESS ||
+        fee_Calculate_PTD_Sizes(TM, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS ||
+        PTDSizes.DataPacketTotalBytes > CAPTURE_MAX_VALUE)
+    {
+        return 0;
+    }
+
+    return (uint32_t)PTDSizes.DataPacketTotalBytes;
+}
+
+int fee_capture_parse_line(const char *Line, size_t Length, fee_capture_packet_t *Packet, uint8_t *Bytes, size_t Capacity)
+{
+    size_t Pos = 0, NumValues = 0;
+    uint64_t Value, First = 0;
+
+    Packet->Type = FEE_CAPTURE_UNKNOWN;
+    Packet->Timestamp = 0;
+    Packet->NumBytes = 0;
+    Packet->PTDBytes = 0;
+
+    if (ParseNumber(Line, Length, &Pos, &Packet->Timestamp) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    while (Pos < Length && IsBlank(Line[Pos]))
+    {
+        Pos++;
+    }
+    if (Pos >= Length || Line[Pos] != '-')
+    {
+        return FEE_EXIT_ERROR;
+    }
+    Pos++;
+
+    /*The first value is a byte of a TC or TM, or the size of a PTD. The rest are stored from Bytes[0] and moved once
+      the type is known*/
+    while (1)
+    {
+        while (Pos < Length && IsBlank(Line[Pos]))
+        {
+            Pos++;
+        }
+        if (Pos >= Length)
+        {
+            break;
+        }
+        if (ParseNumber(Line, Length, &Pos, &Value) != FEE_EXIT_SUCCESS || Value > CAPTURE_MAX_VALUE)
+        {
+            return FEE_EXIT_ERROR;
+        }
+
+        if (NumValues == 0)
+        {
+            First = Value;
+        }
+        else if (Value > UINT8_MAX || NumValues > Capacity)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        else
+        {
+            Bytes[NumValues - 1] = (uint8_t)Value;
+        }
+        NumValues++;
+    }
+
+    if (NumValues == 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*A size that is not a byte can only be a PTD. Otherwise the number of values tells the type*/
+    if (First == NumValues - 1 && (First > UINT8_MAX || (NumValues != TM_PACKET_BYTES && NumValues != TC_PACKET_BYTES)))
+    {
+        Packet->Type = FEE_CAPTURE_PTD;
+        Packet->NumBytes = NumValues - 1;
+        Packet->PTDBytes = (uint32_t)First;
+        return FEE_EXIT_SUCCESS;
+    }
+
+    if (First > UINT8_MAX || (NumValues != TM_PACKET_BYTES && NumValues != TC_PACKET_BYTES) || NumValues > Capacity)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memmove(Bytes + 1, Bytes, NumValues - 1);
+    Bytes[0] = (uint8_t)First;
+    Packet->NumBytes = NumValues;
+
+    if (NumValues == TM_PACKET_BYTES)
+    {
+        Packet->Type = FEE_CAPTURE_TM;
+        Packet->PTDBytes = DescribedPTDBytes(Bytes);
+    }
+    else
+    {
+        Packet->Type = FEE_CAPTURE_TC;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_capture_open(const char *Path, fee_capture_t **Capture)
+{
+    fee_capture_t *Opened;
+    struct stat Stat;
+    size_t PathBytes;
+    void *Map = NULL;
+    int Fd;
+
+    *Capture = NULL;
+
+    Fd = open(Path, O_RDONLY | O_CLOEXEC);
+    if (Fd < 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    if (fstat(Fd, &Stat) != 0 || (uint64_t)Stat.st_size > SIZE_MAX)
+    {
+        close(Fd);
+        return FEE_EXIT_ERROR;
+    }
+
+    if (Stat.st_size > 0)
+    {
+        Map = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+        if (Map == MAP_FAILED)
+        {
+            close(Fd);
+            return FEE_EXIT_ERROR;
+        }
+        /*Captures are read front to back*/
+        posix_madvise(Map, (size_t)Stat.st_size, POSIX_MADV_SEQUENTIAL);
+    }
+    /*The mapping holds its own reference to the file*/
+    close(Fd);
+
+    PathBytes = strlen(Path) + 1;
+    Opened = (fee_capture_t *)calloc(1, sizeof(fee_capture_t));
+    if (Opened != NULL)
+    {
+        Opened->Path = (char *)malloc(PathBytes);
+    }
+    if (Opened == NULL || Opened->Path == NULL)
+    {
+        free(Opened);
+        if (Map != NULL)
+        {
+            munmap(Map, (size_t)Stat.st_size);
+        }
+        return FEE_EXIT_ERROR;
+    }
+
+    memcpy(Opened->Path, Path, PathBytes);
+    Opened->Data = (const char *)Map;
+    Opened->NumBytes = (uint64_t)Stat.st_size;
+    Opened->MtimeNs = (uint64_t)Stat.st_mtim.tv_sec * 1000000000ULL + (uint64_t)Stat.st_mtim.tv_nsec;
+
+    *Capture = Opened;
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_capture_close(fee_capture_t *Capture)
+{
+    if (Capture == NULL)
+    {
+        return;
+    }
+
+    if (Capture->Data != NULL)
+    {
+        munmap((void *)Capture->Data, (size_t)Capture->NumBytes);
+    }
+    free(Capture->Path);
+    free(Capture);
+}
+
+const char *fee_capture_data(const fee_capture_t *Capture, uint64_t *NumBytes)
+{
+    *NumBytes = Capture->NumBytes;
+    return Capture->Data;
+}
+
+void fee_capture_iter_init(const fee_capture_t *Capture, uint64_t Offset, uint64_t EndOffset, fee_capture_iter_t *Iter)
+{
+    memset(Iter, 0, sizeof(fee_capture_iter_t));
+    Iter->Capture = Capture;
+    Iter->EndOffset = EndOffset < Capture->NumBytes ? EndOffset : Capture->NumBytes;
+    Iter->Offset = Offset < Iter->EndOffset ? Offset : Iter->EndOffset;
+    Iter->FirstTime = 0;
+    Iter->LastTime = UINT64_MAX;
+}
+
+int fee_capture_next(fee_capture_iter_t *Iter, fee_capture_packet_t *Packet)
+{
+    const char *Data = Iter->Capture->Data;
+    const char *Line, *End;
+    size_t Length, Required;
+    uint8_t *Buffer;
+
+    while (Iter->Offset < Iter->EndOffset)
+    {
+        Line = Data + Iter->Offset;
+        End = (const char *)memchr(Line, '\n', (size_t)(Iter->Capture->NumBytes - Iter->Offset));
+        Length = End != NULL ? (size_t)(End - Line) : (size_t)(Iter->Capture->NumBytes - Iter->Offset);
+
+        Packet->Offset = Iter->Offset;
+        Iter->Offset += Length + (End != NULL ? 1 : 0);
+
+        while (Length > 0 && IsBlank(Line[Length - 1]))
+        {
+            Length--;
+        }
+        if (Length == 0)
+        {
+            continue;
+        }
+
+        /*Every value takes at least one digit and one separator*/
+        Required = (Length + 1) / 2;
+        if (Required > Iter->BufferBytes)
+        {
+            Buffer = (uint8_t *)realloc(Iter->Buffer, Required);
+            if (Buffer == NULL)
+            {
+                Iter->Offset = Iter->EndOffset;
+                return FEE_EXIT_ERROR;
+            }
+            Iter->Buffer = Buffer;
+            Iter->BufferBytes = Required;
+        }
+
+        fee_capture_parse_line(Line, Length, Packet, Iter->Buffer, Iter->BufferBytes);
+        Packet->Bytes = Iter->Buffer;
+        Packet->PacketIndex = Iter->PacketIndex++;
+
+        if (Packet->Timestamp < Iter->FirstTime)
+        {
+            continue;
+        }
+        if (Packet->Timestamp > Iter->LastTime)
+        {
+            if (Iter->Sorted && Packet->Type != FEE_CAPTURE_UNKNOWN)
+            {
+                Iter->Offset = Iter->EndOffset;
+                return FEE_EXIT_ERROR;
+            }
+            continue;
+        }
+
+        return FEE_EXIT_SUCCESS;
+    }
+
+    return FEE_EXIT_ERROR;
+}
+
+void fee_capture_iter_free(fee_capture_iter_t *Iter)
+{
+    free(Iter->Buffer);
+    Iter->Buffer = NULL;
+    Iter->BufferBytes = 0;
+}
+
+static char *DefaultIndexPath(const fee_capture_t *Capture)
+{
+    size_t PathLength = strlen(Capture->Path);
+    char *IndexPath = (char *)malloc(PathLength + sizeof(FEE_CAPTURE_INDEX_EXTENSION));
+
+    if (IndexPath != NULL)
+    {
+        memcpy(IndexPath, Capture->Path, PathLength);
+        memcpy(IndexPath + PathLength, FEE_CAPTURE_INDEX_EXTENSION, sizeof(FEE_CAPTURE_INDEX_EXTENSION));
+    }
+
+    return IndexPath;
+}
+
+/*Scans the capture once and records every Stride-th parsed packet. Lines that cannot be parsed have no reliable
+  timestamp and are not recorded, but they are counted so that packet indexes match the iterators*/
+static int BuildEntries(const fee_capture_t *Capture, uint32_t Stride, CaptureIndexHeader_t *Header,
+                        fee_capture_index_entry_t **Entries)
+{
+    fee_capture_iter_t Iter;
+    fee_capture_packet_t Packet;
+    fee_capture_index_entry_t *Grown, *Built;
+    uint64_t Capacity = CAPTURE_INITIAL_ENTRIES, NumParsed = 0, LastTimestamp = 0;
+
+    memset(Header, 0, sizeof(CaptureIndexHeader_t));
+    Header->Magic = CAPTURE_INDEX_MAGIC;
+    Header->Version = FEE_CAPTURE_INDEX_VERSION;
+    Header->Stride = Stride;
+    Header->CaptureBytes = Capture->NumBytes;
+    Header->CaptureMtimeNs = Capture->MtimeNs;
+    Header->Sorted = 1;
+
+    Built = (fee_capture_index_entry_t *)malloc((size_t)Capacity * sizeof(fee_capture_index_entry_t));
+    if (Built == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+    while (fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+    {
+        Header->NumPackets++;
+        if (Packet.Type == FEE_CAPTURE_UNKNOWN)
+        {
+            continue;
+        }
+
+        if (Packet.Timestamp < LastTimestamp)
+        {
+            Header->Sorted = 0;
+        }
+        LastTimestamp = Packet.Timestamp;
+
+        if (NumParsed++ % Stride != 0)
+        {
+            continue;
+        }
+
+        if (Header->NumEntries == Capacity)
+        {
+            Capacity *= 2;
+            Grown = (fee_capture_index_entry_t *)realloc(Built, (size_t)Capacity * sizeof(fee_capture_index_entry_t));
+            if (Grown == NULL)
+            {
+                fee_capture_iter_free(&Iter);
+                free(Built);
+                return FEE_EXIT_ERROR;
+            }
+            Built = Grown;
+        }
+
+        Built[Header->NumEntries].Timestamp = Packet.Timestamp;
+        Built[Header->NumEntries].Offset = Packet.Offset;
+        Built[Header->NumEntries].PacketIndex = Packet.PacketIndex;
+        Built[Header->NumEntries].PTDBytes = Packet.PTDBytes;
+        Built[Header->NumEntries].Type = (uint32_t)Packet.Type;
+        Header->NumEntries++;
+    }
+    fee_capture_iter_free(&Iter);
+
+    *Entries = Built;
+    return FEE_EXIT_SUCCESS;
+}
+
+/*Writes the index to a temporary file and renames it, so that tools opening the index at the same time never read
+  a partial file*/
+static int WriteIndex(const char *IndexPath, const CaptureIndexHeader_t *Header, const fee_capture_index_entry_t *Entries)
+{
+    size_t PathLength = strlen(IndexPath);
+    size_t EntriesBytes = (size_t)Header->NumEntries * sizeof(fee_capture_index_entry_t);
+    char *TempPath;
+    FILE *fp;
+    int Status = FEE_EXIT_SUCCESS;
+
+    TempPath = (char *)malloc(PathLength + 32);
+    if (TempPath == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    snprintf(TempPath, PathLength + 32, "%s.%ld.tmp", IndexPath, (long)getpid());
+
+    fp = fopen(TempPath, "wb");
+    if (fp == NULL)
+    {
+        free(TempPath);
+        return FEE_EXIT_ERROR;
+    }
+
+    if (fwrite(Header, sizeof(CaptureIndexHeader_t), 1, fp) != 1 ||
+        (EntriesBytes > 0 && fwrite(Entries, EntriesBytes, 1, fp) != 1))
+    {
+        Status = FEE_EXIT_ERROR;
+    }
+    if (fclose(fp) != 0)
+    {
+        Status = FEE_EXIT_ERROR;
+    }
+
+    if (Status == FEE_EXIT_SUCCESS && rename(TempPath, IndexPath) != 0)
+    {
+        Status = FEE_EXIT_ERROR;
+    }
+    if (Status != FEE_EXIT_SUCCESS)
+    {
+        unlink(TempPath);
+    }
+
+    free(TempPath);
+    return Status;
+}
+
+int fee_capture_index_build(const fee_capture_t *Capture, const char *IndexPath, uint32_t Stride)
+{
+    CaptureIndexHeader_t Header;
+    fee_capture_index_entry_t *Entries;
+    char *DefaultPath = NULL;
+    int Status;
+
+    if (IndexPath == NULL)
+    {
+        DefaultPath = DefaultIndexPath(Capture);
+        if (DefaultPath == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        IndexPath = DefaultPath;
+    }
+
+    Status = BuildEntries(Capture, Stride > 0 ? Stride : FEE_CAPTURE_DEFAULT_STRIDE, &Header, &Entries);
+    if (Status == FEE_EXIT_SUCCESS)
+    {
+        Status = WriteIndex(IndexPath, &Header, Entries);
+        free(Entries);
+    }
+
+    free(DefaultPath);
+    return Status;
+}
+
+/*Maps an index file if it was built for the current size and modification time of the capture*/
+static int MapIndex(const fee_capture_t *Capture, const char *IndexPath, fee_capture_index_t *Index)
+{
+    const CaptureIndexHeader_t *Header;
+    struct stat Stat;
+    void *Map;
+    int Fd;
+
+    Fd = open(IndexPath, O_RDONLY | O_CLOEXEC);
+    if (Fd < 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    if (fstat(Fd, &Stat) != 0 || (uint64_t)Stat.st_size < sizeof(CaptureIndexHeader_t) || (uint64_t)Stat.st_size > SIZE_MAX)
+    {
+        close(Fd);
+        return FEE_EXIT_ERROR;
+    }
+
+    Map = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_SHARED, Fd, 0);
+    close(Fd);
+    if (Map == MAP_FAILED)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Header = (const CaptureIndexHeader_t *)Map;
+    if (Header->Magic != CAPTURE_INDEX_MAGIC || Header->Version != FEE_CAPTURE_INDEX_VERSION || Header->Stride == 0 ||
+        Header->CaptureBytes != Capture->NumBytes || Header->CaptureMtimeNs != Capture->MtimeNs ||
+        Header->NumEntries > ((uint64_t)Stat.st_size - sizeof(CaptureIndexHeader_t)) / sizeof(fee_capture_index_entry_t) ||
+        (uint64_t)Stat.st_size != sizeof(CaptureIndexHeader_t) + Header->NumEntries * sizeof(fee_capture_index_entry_t))
+    {
+        munmap(Map, (size_t)Stat.st_size);
+        return FEE_EXIT_ERROR;
+    }
+
+    memcpy(&Index->Header, Header, sizeof(CaptureIndexHeader_t));
+    Index->Entries = (const fee_capture_index_entry_t *)(Header + 1);
+    Index->Map = Map;
+    Index->MapBytes = (size_t)Stat.st_size;
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_capture_index_open(const fee_capture_t *Capture, const char *IndexPath, uint32_t Stride, fee_capture_index_t **Index)
+{
+    fee_capture_index_t *Opened;
+    char *DefaultPath = NULL;
+
+    *Index = NULL;
+
+    if (IndexPath == NULL)
+    {
+        DefaultPath = DefaultIndexPath(Capture);
+        if (DefaultPath == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        IndexPath = DefaultPath;
+    }
+
+    Opened = (fee_capture_index_t *)calloc(1, sizeof(fee_capture_index_t));
+    if (Opened == NULL)
+    {
+        free(DefaultPath);
+        return FEE_EXIT_ERROR;
+    }
+
+    if (MapIndex(Capture, IndexPath, Opened) != FEE_EXIT_SUCCESS)
+    {
+        /*Missing or stale index. It is rebuilt; if it cannot be written (e.g. a read-only directory) the entries
+          are used from memory and the next open builds them again*/
+        if (BuildEntries(Capture, Stride > 0 ? Stride : FEE_CAPTURE_DEFAULT_STRIDE, &Opened->Header, &Opened->Owned) !=
+            FEE_EXIT_SUCCESS)
+        {
+            free(Opened);
+            free(DefaultPath);
+            return FEE_EXIT_ERROR;
+        }
+        Opened->Entries = Opened->Owned;
+        WriteIndex(IndexPath, &Opened->Header, Opened->Owned);
+    }
+
+    free(DefaultPath);
+    *Index = Opened;
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_capture_index_close(fee_capture_index_t *Index)
+{
+    if (Index == NULL)
+    {
+        return;
+    }
+
+    if (Index->Map != NULL)
+    {
+        munmap(Index->Map, Index->MapBytes);
+    }
+    free(Index->Owned);
+    free(Index);
+}
+
+const fee_capture_index_entry_t *fee_capture_index_entries(const fee_capture_index_t *Index, uint64_t *NumEntries,
+                                                           uint32_t *Stride, uint64_t *NumPackets)
+{
+    *NumEntries = Index->Header.NumEntries;
+    if (Stride != NULL)
+    {
+        *Stride = Index->Header.Stride;
+    }
+    if (NumPackets != NULL)
+    {
+        *NumPackets = Index->Header.NumPackets;
+    }
+
+    return Index->Entries;
+}
+
+void fee_capture_index_seek(const fee_capture_index_t *Index, uint64_t Timestamp, uint64_t *Offset, uint64_t *PacketIndex)
+{
+    uint64_t Low = 0, High = Index->Header.NumEntries, Middle;
+
+    *Offset = 0;
+    if (PacketIndex != NULL)
+    {
+        *PacketIndex = 0;
+    }
+
+    if (!Index->Header.Sorted)
+    {
+        return;
+    }
+
+    /*Number of entries before Timestamp. The entry before them is the last one earlier than Timestamp, so no packet
+      at Timestamp (even repeated timestamps) is behind it*/
+    while (Low < High)
+    {
+        Middle = Low + (High - Low) / 2;
+        if (Index->Entries[Middle].Timestamp < Timestamp)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    if (Low > 0)
+    {
+        *Offset = Index->Entries[Low - 1].Offset;
+        if (PacketIndex != NULL)
+        {
+            *PacketIndex = Index->Entries[Low - 1].PacketIndex;
+        }
+    }
+}
+
+void fee_capture_index_range(const fee_capture_index_t *Index, const fee_capture_t *Capture, uint64_t First, uint64_t Last,
+                             fee_capture_iter_t *Iter)
+{
+    uint64_t Offset, PacketIndex;
+
+    fee_capture_index_seek(Index, First, &Offset, &PacketIndex);
+    fee_capture_iter_init(Capture, Offset, UINT64_MAX, Iter);
+    Iter->PacketIndex = PacketIndex;
+    Iter->FirstTime = First;
+    Iter->LastTime = Last;
+    Iter->Sorted = (int)Index->Header.Sorted;
+}
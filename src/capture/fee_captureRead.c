@@ -0,0 +1,513 @@
+/**
+ * @file fee_captureRead.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library parallel capture parse and decode functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fee.h>
+#include <fee_capture.h>
+#include "../common/fee_common.h"
+
+/*Records and packet bytes reserved at the beginning of a range*/
+#define RANGE_INITIAL_RECORDS 256
+#define RANGE_INITIAL_ARENA_BYTES (64 * 1024)
+
+/*Byte range of a capture, parsed by a single task*/
+typedef struct
+{
+    const fee_capture_t *Capture;
+    uint32_t CaptureIndex;
+    uint64_t Begin;
+    uint64_t End;
+    fee_capture_record_t *Records; /*Desc.BufferIndex holds the offset of the packet in Arena until the merge*/
+    size_t NumRecords;
+    size_t Capacity;
+    uint8_t *Arena;                /*Packet bytes of the records of the range*/
+    size_t ArenaBytes;
+    size_t ArenaCapacity;
+    size_t NumSkipped;
+    int Status;
+
+} CaptureRange_t;
+
+typedef struct
+{
+    CaptureRange_t *Ranges;
+    int CheckChecksum;
+
+} ParseJob_t;
+
+typedef struct
+{
+    fee_capture_record_t **PTDs;
+    size_t NumPTDs;
+    size_t ChunkSize;
+    int CheckChecksum;
+
+} DecodeJob_t;
+
+/*Packet bytes of a result. They are the arenas of its ranges*/
+typedef struct
+{
+    uint8_t **Arenas;
+    size_t NumArenas;
+
+} CaptureStorage_t;
+
+/*First line that begins at or after Offset*/
+static uint64_t AlignToLine(const char *Data, uint64_t NumBytes, uint64_t Offset)
+{
+    const char *End;
+
+    if (Offset == 0 || Offset >= NumBytes)
+    {
+        return Offset < NumBytes ? Offset : NumBytes;
+    }
+    if (Data[Offset - 1] == '\n')
+    {
+        return Offset;
+    }
+
+    End = (const char *)memchr(Data + Offset, '\n', (size_t)(NumBytes - Offset));
+    return End != NULL ? (uint64_t)(End - Data) + 1 : NumBytes;
+}
+
+static int AppendRecord(CaptureRange_t *Range, const fee_capture_packet_t *Packet, fee_packet_type_t Type)
+{
+    fee_capture_record_t *Records, *Record;
+    uint8_t *Arena;
+    size_t Capacity;
+
+    if (Range->NumRecords == Range->Capacity)
+    {
+        Capacity = Range->Capacity > 0 ? 2 * Range->Capacity : RANGE_INITIAL_RECORDS;
+        Records = (fee_capture_record_t *)realloc(Range->Records, Capacity * sizeof(fee_capture_record_t));
+        if (Records == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Range->Records = Records;
+        Range->Capacity = Capacity;
+    }
+
+    if (Range->ArenaBytes + Packet->NumBytes > Range->ArenaCapacity)
+    {
+        Capacity = Range->ArenaCapacity > 0 ? 2 * Range->ArenaCapacity : RANGE_INITIAL_ARENA_BYTES;
+        while (Capacity < Range->ArenaBytes + Packet->NumBytes)
+        {
+            Capacity *= 2;
+        }
+        Arena = (uint8_t *)realloc(Range->Arena, Capacity);
+        if (Arena == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Range->Arena = Arena;
+        Range->ArenaCapacity = Capacity;
+    }
+
+    Record = &Range->Records[Range->NumRecords++];
+    memset(Record, 0, sizeof(fee_capture_record_t));
+    Record->Timestamp = Packet->Timestamp;
+    Record->CaptureIndex = Range->CaptureIndex;
+    Record->Offset = Packet->Offset;
+    Record->Desc.Type = Type;
+    Record->Desc.PacketBytes = Packet->NumBytes;
+    Record->Desc.BufferIndex = Range->ArenaBytes;
+    Record->Desc.Status = FEE_EXIT_SUCCESS;
+
+    memcpy(Range->Arena + Range->ArenaBytes, Packet->Bytes, Packet->NumBytes);
+    Range->ArenaBytes += Packet->NumBytes;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/*Parses a range. TM packets are decoded here; PTD packets need the TM before them, which may be in another range*/
+static void ParseRangeTask(void *TaskData, size_t TaskIndex)
+{
+    ParseJob_t *Job = TaskData;
+    CaptureRange_t *Range = &Job->Ranges[TaskIndex];
+    fee_capture_iter_t Iter;
+    fee_capture_packet_t Packet;
+    fee_capture_record_t *Record;
+
+    fee_capture_iter_init(Range->Capture, Range->Begin, Range->End, &Iter);
+    while (Range->Status == FEE_EXIT_SUCCESS && fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+    {
+        if (Packet.Type != FEE_CAPTURE_TM && Packet.Type != FEE_CAPTURE_PTD)
+        {
+            Range->NumSkipped++;
+            continue;
+        }
+
+        if (AppendRecord(Range, &Packet, Packet.Type == FEE_CAPTURE_TM ? FEE_PACKET_TM : FEE_PACKET_PTD) != FEE_EXIT_SUCCESS)
+        {
+            Range->Status = FEE_EXIT_ERROR;
+            break;
+        }
+
+        Record = &Range->Records[Range->NumRecords - 1];
+        if (Packet.Type == FEE_CAPTURE_TM)
+        {
+            if (Job->CheckChecksum && fee_CheckTelemetryChecksum((uint8_t *)Packet.Bytes) != FEE_EXIT_SUCCESS)
+            {
+                Record->Desc.Status = FEE_EXIT_ERROR;
+            }
+            else
+            {
+                Record->Desc.Status = fee_TM_Read((uint8_t *)Packet.Bytes, &Record->Desc.TM);
+            }
+        }
+    }
+    fee_capture_iter_free(&Iter);
+}
+
+/*Decode of a PTD record into planes reserved for it. The length is checked first, as fee_PTD_Read does not know it*/
+static int DecodePTDRecord(fee_capture_record_t *Record, int CheckChecksum)
+{
+    fee_packet_desc_t *Desc = &Record->Desc;
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+    uint8_t *Planes;
+    int k;
+
+    if (fee_Calculate_PTD_Sizes(Desc->TM, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS ||
+        PTDSizes.DataPacketTotalBytes < PTD_CHECKSUM_BYTES || Desc->PacketBytes < PTDSizes.DataPacketTotalBytes)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    if (CheckChecksum && fee_CheckPTDChecksum(Desc->Packet, PTDSizes) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Planes = (uint8_t *)malloc(FEE_NUM_CCD * ImageMatrixSizes.ImageMatrixBytes + 1);
+    if (Planes == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    for (k = 0; k < FEE_NUM_CCD; k++)
+    {
+        Desc->PTD.ImageMatrix[k] = (uint16_t *)(Planes + k * ImageMatrixSizes.ImageMatrixBytes);
+    }
+
+    return fee_PTD_Read(Desc->Packet, Desc->TM, &Desc->PTD);
+}
+
+static void DecodePTDTask(void *TaskData, size_t TaskIndex)
+{
+    DecodeJob_t *Job = TaskData;
+    size_t First = TaskIndex * Job->ChunkSize;
+    size_t Last = First + Job->ChunkSize < Job->NumPTDs ? First + Job->ChunkSize : Job->NumPTDs;
+    size_t i;
+
+    for (i = First; i < Last; i++)
+    {
+        if (Job->PTDs[i]->Desc.Status == FEE_EXIT_SUCCESS)
+        {
+            Job->PTDs[i]->Desc.Status = DecodePTDRecord(Job->PTDs[i], Job->CheckChecksum);
+        }
+    }
+}
+
+static int RunJob(const fee_batch_config_t *Config, size_t NumTasks, fee_task_fn Task, void *TaskData)
+{
+    fee_thread_pool_t *Pool;
+
+    if (Config != NULL && Config->Executor != NULL)
+    {
+        return Config->Executor(Config->ExecutorData, NumTasks, Task, TaskData);
+    }
+
+    Pool = Config != NULL && Config->Pool != NULL ? Config->Pool : fee_thread_pool_default();
+    if (Pool == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return fee_thread_pool_run(Pool, NumTasks, Task, TaskData);
+}
+
+/*Stable bottom-up merge sort of the record order by timestamp. Runs already in order are copied without merging.
+  The passes alternate between Order and Temp; the returned one holds the sorted order*/
+static size_t *SortByTimestamp(const fee_capture_record_t *Records, size_t *Order, size_t *Temp, size_t NumRecords)
+{
+    size_t Width, Begin, Middle, End, i, j, k;
+    size_t *Swap;
+
+    for (Width = 1; Width < NumRecords; Width *= 2)
+    {
+        for (Begin = 0; Begin < NumRecords; Begin += 2 * Width)
+        {
+            Middle = Begin + Width < NumRecords ? Begin + Width : NumRecords;
+            End = Begin + 2 * Width < NumRecords ? Begin + 2 * Width : NumRecords;
+
+            if (Middle == End || Records[Order[Middle - 1]].Timestamp <= Records[Order[Middle]].Timestamp)
+            {
+                memcpy(Temp + Begin, Order + Begin, (End - Begin) * sizeof(size_t));
+                continue;
+            }
+
+            for (i = Begin, j = Middle, k = Begin; k < End; k++)
+            {
+                if (j >= End || (i < Middle && Records[Order[i]].Timestamp <= Records[Order[j]].Timestamp))
+                {
+                    Temp[k] = Order[i++];
+                }
+                else
+                {
+                    Temp[k] = Order[j++];
+                }
+            }
+        }
+
+        Swap = Order;
+        Order = Temp;
+        Temp = Swap;
+    }
+
+    return Order;
+}
+
+static void FreeRanges(CaptureRange_t *Ranges, size_t NumRanges)
+{
+    size_t i;
+
+    for (i = 0; i < NumRanges; i++)
+    {
+        free(Ranges[i].Records);
+        free(Ranges[i].Arena);
+    }
+    free(Ranges);
+}
+
+/*Concatenates the records of the ranges (in capture and line order) and moves the arenas to the result storage*/
+static int MergeRanges(CaptureRange_t *Ranges, size_t NumRanges, fee_capture_records_t *Records)
+{
+    CaptureStorage_t *Storage;
+    fee_capture_record_t *All, *Sorted;
+    size_t *Order, *SortedOrder;
+    size_t NumRecords = 0, i, j;
+    int InOrder = 1;
+
+    for (i = 0; i < NumRanges; i++)
+    {
+        NumRecords += Ranges[i].NumRecords;
+        Records->NumSkipped += Ranges[i].NumSkipped;
+    }
+
+    Storage = (CaptureStorage_t *)calloc(1, sizeof(CaptureStorage_t));
+    All = (fee_capture_record_t *)malloc((NumRecords + 1) * sizeof(fee_capture_record_t));
+    if (Storage != NULL)
+    {
+        Storage->Arenas = (uint8_t **)calloc(NumRanges + 1, sizeof(uint8_t *));
+    }
+    if (Storage == NULL || Storage->Arenas == NULL || All == NULL)
+    {
+        free(All);
+        if (Storage != NULL)
+        {
+            free(Storage->Arenas);
+        }
+        free(Storage);
+        return FEE_EXIT_ERROR;
+    }
+
+    for (i = 0, NumRecords = 0; i < NumRanges; i++)
+    {
+        for (j = 0; j < Ranges[i].NumRecords; j++)
+        {
+            All[NumRecords] = Ranges[i].Records[j];
+            All[NumRecords].Desc.Packet = Ranges[i].Arena + All[NumRecords].Desc.BufferIndex;
+            All[NumRecords].Desc.BufferIndex = 0;
+            if (NumRecords > 0 && All[NumRecords - 1].Timestamp > All[NumRecords].Timestamp)
+            {
+                InOrder = 0;
+            }
+            NumRecords++;
+        }
+        Storage->Arenas[Storage->NumArenas++] = Ranges[i].Arena;
+        Ranges[i].Arena = NULL;
+    }
+
+    Records->Records = All;
+    Records->NumRecords = NumRecords;
+    Records->Storage = Storage;
+
+    if (InOrder)
+    {
+        return FEE_EXIT_SUCCESS;
+    }
+
+    /*Captures of several sources, or of a clock that went backwards. The order is sorted, then applied*/
+    Order = (size_t *)malloc(2 * NumRecords * sizeof(size_t));
+    Sorted = (fee_capture_record_t *)malloc(NumRecords * sizeof(fee_capture_record_t));
+    if (Order == NULL || Sorted == NULL)
+    {
+        free(Order);
+        free(Sorted);
+        return FEE_EXIT_ERROR;
+    }
+    for (i = 0; i < NumRecords; i++)
+    {
+        Order[i] = i;
+    }
+    SortedOrder = SortByTimestamp(All, Order, Order + NumRecords, NumRecords);
+
+    for (i = 0; i < NumRecords; i++)
+    {
+        Sorted[i] = All[SortedOrder[i]];
+    }
+    free(Order);
+    free(All);
+    Records->Records = Sorted;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_capture_read_parallel(fee_capture_t *const *Captures, size_t NumCaptures, uint64_t RangeBytes,
+                              const fee_batch_config_t *Config, fee_capture_records_t *Records)
+{
+    CaptureRange_t *Ranges;
+    ParseJob_t ParseJob;
+    DecodeJob_t DecodeJob;
+    const fee_capture_record_t *LastTM = NULL;
+    const char *Data;
+    uint64_t NumBytes, Begin;
+    size_t NumRanges = 0, i, k;
+    int Status;
+
+    memset(Records, 0, sizeof(fee_capture_records_t));
+
+    if ((Captures == NULL && NumCaptures > 0) || NumCaptures > UINT32_MAX)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    if (RangeBytes == 0)
+    {
+        RangeBytes = FEE_CAPTURE_DEFAULT_RANGE_BYTES;
+    }
+
+    for (i = 0; i < NumCaptures; i++)
+    {
+        fee_capture_data(Captures[i], &NumBytes);
+        NumRanges += (size_t)(NumBytes / RangeBytes + (NumBytes % RangeBytes != 0));
+    }
+
+    Ranges = (CaptureRange_t *)calloc(NumRanges + 1, sizeof(CaptureRange_t));
+    if (Ranges == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Every range begins at the first line at or after its nominal offset, so every line belongs to one range*/
+    for (i = 0, NumRanges = 0; i < NumCaptures; i++)
+    {
+        Data = fee_capture_data(Captures[i], &NumBytes);
+        for (Begin = 0; Begin < NumBytes; Begin += RangeBytes)
+        {
+            Ranges[NumRanges].Capture = Captures[i];
+            Ranges[NumRanges].CaptureIndex = (uint32_t)i;
+            Ranges[NumRanges].Begin = AlignToLine(Data, NumBytes, Begin);
+            Ranges[NumRanges].End = AlignToLine(Data, NumBytes, Begin + RangeBytes < NumBytes ? Begin + RangeBytes : NumBytes);
+            Ranges[NumRanges].Status = FEE_EXIT_SUCCESS;
+            NumRanges++;
+        }
+    }
+
+    ParseJob.Ranges = Ranges;
+    ParseJob.CheckChecksum = Config != NULL && Config->CheckChecksum;
+    Status = RunJob(Config, NumRanges, ParseRangeTask, &ParseJob);
+    for (i = 0; i < NumRanges && Status == FEE_EXIT_SUCCESS; i++)
+    {
+        Status = Ranges[i].Status;
+    }
+    if (Status == FEE_EXIT_SUCCESS)
+    {
+        Status = MergeRanges(Ranges, NumRanges, Records);
+    }
+    FreeRanges(Ranges, NumRanges);
+    if (Status != FEE_EXIT_SUCCESS)
+    {
+        fee_capture_records_free(Records);
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Every PTD is described by the last TM before it*/
+    DecodeJob.PTDs = (fee_capture_record_t **)malloc((Records->NumRecords + 1) * sizeof(fee_capture_record_t *));
+    if (DecodeJob.PTDs == NULL)
+    {
+        fee_capture_records_free(Records);
+        return FEE_EXIT_ERROR;
+    }
+    DecodeJob.NumPTDs = 0;
+    for (i = 0; i < Records->NumRecords; i++)
+    {
+        if (Records->Records[i].Desc.Type == FEE_PACKET_TM)
+        {
+            LastTM = &Records->Records[i];
+            continue;
+        }
+
+        if (LastTM == NULL || LastTM->Desc.Status != FEE_EXIT_SUCCESS)
+        {
+            Records->Records[i].Desc.Status = FEE_EXIT_ERROR;
+            continue;
+        }
+        Records->Records[i].Desc.TM = LastTM->Desc.TM;
+        DecodeJob.PTDs[DecodeJob.NumPTDs++] = &Records->Records[i];
+    }
+
+    DecodeJob.ChunkSize = Config != NULL && Config->ChunkSize > 0 ? Config->ChunkSize : 1;
+    DecodeJob.CheckChecksum = Config != NULL && Config->CheckChecksum;
+    Status = RunJob(Config, (DecodeJob.NumPTDs + DecodeJob.ChunkSize - 1) / DecodeJob.ChunkSize, DecodePTDTask, &DecodeJob);
+    free(DecodeJob.PTDs);
+    if (Status != FEE_EXIT_SUCCESS)
+    {
+        fee_capture_records_free(Records);
+        return FEE_EXIT_ERROR;
+    }
+
+    for (k = 0; k < Records->NumRecords; k++)
+    {
+        Records->NumErrors += Records->Records[k].Desc.Status != FEE_EXIT_SUCCESS;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_capture_records_free(fee_capture_records_t *Records)
+{
+    CaptureStorage_t *Storage = (CaptureStorage_t *)Records->Storage;
+    size_t i;
+
+    for (i = 0; i < Records->NumRecords; i++)
+    {
+        if (Records->Records[i].Desc.Type == FEE_PACKET_PTD)
+        {
+            free(Records->Records[i].Desc.PTD.ImageMatrix[0]);
+        }
+    }
+
+    if (Storage != NULL)
+    {
+        for (i = 0; i < Storage->NumArenas; i++)
+        {
+            free(Storage->Arenas[i]);
+        }
+        free(Storage->Arenas);
+        free(Storage);
+    }
+
+    free(Records->Records);
+    memset(Records, 0, sizeof(fee_capture_records_t));
+}
@@ -11,39 +11,21 @@
 
 #include <fee.h>
 #include "fee_common.h"
+#include <fee_inline.h>
+#include "fee_dispatch_internal.h"
 #include "stdio.h"
 #include <arpa/inet.h>
 #include <string.h>
 
 uint8_t XORChecksum8(uint8_t *data, size_t dataLength)
 {
-    uint8_t value = 0;
-    size_t i = 0;
-
-    for (i = 0; i < dataLength; i++)
-    {
-        value ^= (uint8_t)data[i];
-    }
-    return value;
+    return GetKernelTable()->Checksum8(data, dataLength);
 }
 
 uint16_t XORChecksum16(uint8_t *data, size_t dataLength)
 {
-    uint16_t value = 0;
-    uint16_t value_int = 0;
-
-    for (size_t i = 0; i < dataLength / 2; i++)
-    {   
-        memcpy(&value_int, &data[2 * i], 2);
-        value ^= value_int;
-    }
-
-    if (dataLength % 2)
-    {
-        value ^= data[dataLength - 1];
-    }
-
-    return value;
+    /*Words are read in host order and a trailing odd byte is xored in the low byte*/
+    return GetKernelTable()->Checksum16(data, dataLength);
 }
 
 int BandSize_MultitpleOf_BinningSize(uint16_t freqbinningband)
@@ -120,7 +102,7 @@ int Serialize_Spare_Parameter(int data_length_bytes, size_t *byte_counter, uint8
 
     if (max_length_Message >= data_length_bytes + *byte_counter)
     {
-        memset(TC_Message + *byte_counter, 0, sizeof(TC_Message[0]));
+        memset(TC_Message + *byte_counter, 0, data_length_bytes);
         *byte_counter = *byte_counter + data_length_bytes;
     }
     else
@@ -198,3 +180,92 @@ int SerializeParameter_NoEndianessConversion(void *data, int data_length_bytes,
 
     return FEE_EXIT_SUCCESS;
 }
+
+uint16_t fee_checksum16_patch(uint16_t checksum, size_t offset, const uint8_t *old_data, const uint8_t *new_data, size_t length)
+{
+    return fee_inline_checksum16_patch(checksum, offset, old_data, new_data, length);
+}
+
+uint8_t fee_checksum8_patch(uint8_t checksum, const uint8_t *old_data, const uint8_t *new_data, size_t length)
+{
+    return fee_inline_checksum8_patch(checksum, old_data, new_data, length);
+}
+
+/**
+ * @brief Function which checks that a parameter can be patched and serializes its new value.
+ *
+ * @param ChecksumOffset [Input] Byte offset of the checksum in the packet.
+ * @param offset [Input] Byte offset of the parameter to be patched.
+ * @param parameter_length_bytes [Input] Length in bytes of the parameter (1, 2 or 4).
+ * @param value [Input] New value of the parameter.
+ * @param NewBytes [Output] Serialized value. At least 4 bytes long.
+ * @return int The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+static int PrepareParameterPatch(size_t ChecksumOffset, size_t offset, int parameter_length_bytes, uint32_t value, uint8_t *NewBytes)
+{
+    size_t byte_counter = 0;
+    uint8_t value8 = (uint8_t)value;
+    uint16_t value16 = (uint16_t)value;
+    void *data = &value;
+
+    /*The parameter can not overlap the checksum*/
+    if (parameter_length_bytes <= 0 || offset + (size_t)parameter_length_bytes > ChecksumOffset)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Check that the value fits in the parameter*/
+    if (parameter_length_bytes == 1)
+    {
+        if (value > UINT8_MAX)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        data = &value8;
+    }
+    else if (parameter_length_bytes == 2)
+    {
+        if (value > UINT16_MAX)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        data = &value16;
+    }
+
+    return SerializeParameter(data, parameter_length_bytes, &byte_counter, NewBytes, sizeof(uint32_t));
+}
+
+int PatchParameter_Checksum16(uint8_t *Message, size_t ChecksumOffset, size_t offset, int parameter_length_bytes, uint32_t value)
+{
+    uint8_t NewBytes[sizeof(uint32_t)] = {0};
+    uint16_t Checksum = 0;
+
+    if (PrepareParameterPatch(ChecksumOffset, offset, parameter_length_bytes, value, NewBytes) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*The checksum is stored without endianess conversion*/
+    memcpy(&Checksum, Message + ChecksumOffset, sizeof(Checksum));
+    Checksum = fee_checksum16_patch(Checksum, offset, Message + offset, NewBytes, parameter_length_bytes);
+
+    memcpy(Message + offset, NewBytes, parameter_length_bytes);
+    memcpy(Message + ChecksumOffset, &Checksum, sizeof(Checksum));
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int PatchParameter_Checksum8(uint8_t *Message, size_t ChecksumOffset, size_t offset, int parameter_length_bytes, uint32_t value)
+{
+    uint8_t NewBytes[sizeof(uint32_t)] = {0};
+
+    if (PrepareParameterPatch(ChecksumOffset, offset, parameter_length_bytes, value, NewBytes) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Message[ChecksumOffset] = fee_checksum8_patch(Message[ChecksumOffset], Message + offset, NewBytes, parameter_length_bytes);
+    memcpy(Message + offset, NewBytes, parameter_length_bytes);
+
+    return FEE_EXIT_SUCCESS;
+}
@@ -12,6 +12,7 @@
 #ifndef FEE_COMMON_H
 #define FEE_COMMON_H
 
+#include <string.h>
 #include "fee.h"
 
 /*Number of speare bits at the end of TC message*/
@@ -84,6 +85,58 @@ int SerializeParameter_NoEndianessConversion(void *data, int data_length_bytes,
  */
 int Serialize_Spare_Parameter(int data_length_bytes, size_t *byte_counter, uint8_t *MessageVect, size_t max_length_Message);
 
+/*
+Straight-line serialization of fixed-layout packets. Every field is stored with network endianess at its offset and
+xored into Sum, the xor of the packet as 16 bits big-endian words. Once every byte before the checksum is written
+(spare bytes with PutSpare, which do not change Sum), StoreChecksum16/Checksum8 give the XORChecksum16/XORChecksum8
+of the packet without another pass over it.
+*/
+static inline void PutField8(uint8_t *Message, size_t offset, uint8_t value, uint16_t *Sum)
+{
+    Message[offset] = value;
+    *Sum ^= (offset & 1) ? value : (uint16_t)(value << 8);
+}
+
+static inline void PutField16(uint8_t *Message, size_t offset, uint16_t value, uint16_t *Sum)
+{
+    Message[offset] = (uint8_t)(value >> 8);
+    Message[offset + 1] = (uint8_t)value;
+    *Sum ^= (offset & 1) ? (uint16_t)((value << 8) | (value >> 8)) : value;
+}
+
+static inline void PutField32(uint8_t *Message, size_t offset, uint32_t value, uint16_t *Sum)
+{
+    PutField16(Message, offset, (uint16_t)(value >> 16), Sum);
+    PutField16(Message, offset + 2, (uint16_t)value, Sum);
+}
+
+static inline void PutSpare(uint8_t *Message, size_t offset, size_t length)
+{
+    memset(Message + offset, 0, length);
+}
+
+/*The stored bytes are the xor of the even and of the odd bytes, as XORChecksum16 gives them in any host endianess*/
+static inline void StoreChecksum16(uint8_t *Message, size_t ChecksumOffset, uint16_t Sum)
+{
+    Message[ChecksumOffset] = (uint8_t)(Sum >> 8);
+    Message[ChecksumOffset + 1] = (uint8_t)Sum;
+}
+
+static inline uint8_t Checksum8(uint16_t Sum)
+{
+    return (uint8_t)((Sum >> 8) ^ Sum);
+}
+
+/**
+ * @brief Function which deserializes a TM packet, as fee_TM_Read, without recording statistics. It is used to decode
+ *  packets built by the library itself.
+ *
+ * @param TM_Packet [Input] TM packet.
+ * @param TM_Data_Struct [Output] Deserialized TM.
+ * @return int The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int DeserializeTM(fee_TM_Packet_t TM_Packet, fee_TM_t *TM_Data_Struct);
+
 /**
  * @brief Function that checks if Bandsize parameter is multiple of BinningSize
  *
@@ -111,4 +164,30 @@ uint8_t XORChecksum8(uint8_t *data, size_t dataLength);
  */
 uint16_t XORChecksum16(uint8_t *data, size_t dataLength);
 
+/**
+ * @brief Function which overwrites a parameter of a serialized packet protected by a 16 bits xor checksum (TM and PTD)
+ *  and updates the checksum stored in the packet without recalculating it.
+ *
+ * @param Message [Input/Output] Serialized packet.
+ * @param ChecksumOffset [Input] Byte offset of the checksum in the packet. The patched parameter must be placed before it.
+ * @param offset [Input] Byte offset of the parameter to be patched.
+ * @param parameter_length_bytes [Input] Length in bytes of the parameter (1, 2 or 4).
+ * @param value [Input] New value of the parameter. It is serialized with network endianess.
+ * @return int The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int PatchParameter_Checksum16(uint8_t *Message, size_t ChecksumOffset, size_t offset, int parameter_length_bytes, uint32_t value);
+
+/**
+ * @brief Function which overwrites a parameter of a serialized packet protected by an 8 bits xor checksum (TC)
+ *  and updates the checksum stored in the packet without recalculating it.
+ *
+ * @param Message [Input/Output] Serialized packet.
+ * @param ChecksumOffset [Input] Byte offset of the checksum in the packet. The patched parameter must be placed before it.
+ * @param offset [Input] Byte offset of the parameter to be patched.
+ * @param parameter_length_bytes [Input] Length in bytes of the parameter (1, 2 or 4).
+ * @param value [Input] New value of the parameter. It is serialized with network endianess.
+ * @return int The function returns FEE_EXIT_ERROR if any error occurs. Otherwise, FEE_EXIT_SUCCESS will be returned.
+ */
+int PatchParameter_Checksum8(uint8_t *Message, size_t ChecksumOffset, size_t offset, int parameter_length_bytes, uint32_t value);
+
 #endif
\ No newline at end of file
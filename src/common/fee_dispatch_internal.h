@@ -0,0 +1,89 @@
+/**
+ * @file fee_dispatch_internal.h
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Kernel table of the runtime CPU-feature dispatch and the variants of every kernel.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_DISPATCH_INTERNAL_H
+#define FEE_DISPATCH_INTERNAL_H
+
+#include "fee_dispatch.h"
+
+/*x86 variants are only built with compilers that support the target attribute*/
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define FEE_DISPATCH_X86
+#endif
+
+/*Kernel signatures*/
+typedef uint8_t (*Checksum8Kernel_t)(const uint8_t *Data, size_t Length);
+typedef uint16_t (*Checksum16Kernel_t)(const uint8_t *Data, size_t Length);
+/*Pixels big-endian pairs (CCD 0, CCD 1) of a PTD row to the two image planes*/
+typedef void (*PTDUnpackKernel_t)(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels);
+/*Two image planes to big-endian pairs (CCD 0, CCD 1) of a PTD row*/
+typedef void (*PTDPackKernel_t)(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels);
+
+/*Bounds of the limit levels kernel: the limits, then the limits shrunk by the hysteresis*/
+#define LIMIT_NUM_BOUNDS 8
+/*Levels of Count values against the limits (Loose) and the shrunk limits (Strict): 0 inside the warning limits,
+  1 inside the alarm limits and 2 outside them or NaN. Bounds[b] has a bound per value, or one for every value if Broadcast*/
+typedef void (*LimitLevelsKernel_t)(const float *Values, size_t Count, const float *const *Bounds, int Broadcast,
+                                    uint8_t *Loose, uint8_t *Strict);
+
+/*Selected variants*/
+typedef struct
+{
+    Checksum8Kernel_t Checksum8;
+    Checksum16Kernel_t Checksum16;
+    PTDUnpackKernel_t PTDUnpack;
+    PTDPackKernel_t PTDPack;
+    LimitLevelsKernel_t LimitLevels;
+    fee_cpu_tier_t Tiers[FEE_NUM_KERNELS]; /*Tier of every selected variant*/
+
+} KernelTable_t;
+
+/**
+ * @brief Function that returns the kernel table. It is initialized on the first call.
+ *
+ * @return const KernelTable_t* - Kernel table.
+ */
+const KernelTable_t *GetKernelTable(void);
+
+/*Scalar variants*/
+uint8_t ScalarChecksum8(const uint8_t *Data, size_t Length);
+uint16_t ScalarChecksum16(const uint8_t *Data, size_t Length);
+void ScalarPTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels);
+void ScalarPTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels);
+void ScalarLimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast, uint8_t *Loose,
+                       uint8_t *Strict);
+
+#ifdef FEE_DISPATCH_X86
+/*SSE4.2 variants*/
+uint8_t SSE42Checksum8(const uint8_t *Data, size_t Length);
+uint16_t SSE42Checksum16(const uint8_t *Data, size_t Length);
+void SSE42PTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels);
+void SSE42PTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels);
+void SSE42LimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast, uint8_t *Loose,
+                       uint8_t *Strict);
+
+/*AVX2 variants*/
+uint8_t AVX2Checksum8(const uint8_t *Data, size_t Length);
+uint16_t AVX2Checksum16(const uint8_t *Data, size_t Length);
+void AVX2PTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels);
+void AVX2PTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels);
+void AVX2LimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast, uint8_t *Loose,
+                      uint8_t *Strict);
+
+/*AVX-512 variants*/
+uint16_t AVX512Checksum16(const uint8_t *Data, size_t Length);
+void AVX512PTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels);
+void AVX512PTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels);
+void AVX512LimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast, uint8_t *Loose,
+                        uint8_t *Strict);
+#endif
+
+#endif
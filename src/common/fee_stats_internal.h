@@ -0,0 +1,51 @@
+/**
+ * @file fee_stats_internal.h
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Instrumentation macros of the fee library statistics. Without FEE_ENABLE_STATS they expand to nothing.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#ifndef FEE_STATS_INTERNAL_H
+#define FEE_STATS_INTERNAL_H
+
+#include "fee_stats.h"
+
+#ifdef FEE_ENABLE_STATS
+
+uint64_t StatsNow(void);
+void StatsRecord(fee_stats_op_t Op, uint64_t LatencyNs, int Status, uint64_t Bytes, fee_stats_fail_t Reason);
+
+/*Declare a timer and start it. It must be used where declarations are allowed*/
+#define FEE_STATS_START(Timer) uint64_t Timer = StatsNow()
+
+/*Record a call. The timer is stopped before Bytes (only evaluated if the call succeeded) and Reason (only if it
+failed) are evaluated, so that they are not part of the latency*/
+#define FEE_STATS_STOP(Op, Timer, Status, Bytes, Reason)                                               \
+    do                                                                                                 \
+    {                                                                                                  \
+        uint64_t StatsLatencyNs = StatsNow() - (Timer);                                                \
+        if ((Status) == FEE_EXIT_SUCCESS)                                                              \
+        {                                                                                              \
+            StatsRecord((Op), StatsLatencyNs, FEE_EXIT_SUCCESS, (uint64_t)(Bytes), FEE_STATS_NUM_FAILS); \
+        }                                                                                              \
+        else                                                                                           \
+        {                                                                                              \
+            StatsRecord((Op), StatsLatencyNs, FEE_EXIT_ERROR, 0, (Reason));                            \
+        }                                                                                              \
+    } while (0)
+
+#else
+
+#define FEE_STATS_START(Timer)
+#define FEE_STATS_STOP(Op, Timer, Status, Bytes, Reason) \
+    do                                                   \
+    {                                                    \
+    } while (0)
+
+#endif
+
+#endif
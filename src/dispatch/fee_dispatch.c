@@ -0,0 +1,201 @@
+/**
+ * @file fee_dispatch.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library runtime CPU-feature dispatch. The tier of the host is detected on the first use of a kernel
+ *  and every kernel takes the variant of the highest tier it has up to the selected one.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../common/fee_dispatch_internal.h"
+
+static const char *TierNames[FEE_CPU_NUM_TIERS] = {"scalar", "sse4.2", "avx2", "avx512"};
+static const char *KernelNames[FEE_NUM_KERNELS] = {"checksum8", "checksum16", "ptd_unpack", "ptd_pack", "limits"};
+
+/*Variants of every kernel by tier. NULL when a kernel has no variant for a tier*/
+#ifdef FEE_DISPATCH_X86
+static const Checksum8Kernel_t Checksum8Variants[FEE_CPU_NUM_TIERS] = {ScalarChecksum8, SSE42Checksum8,
+                                                                      AVX2Checksum8, NULL};
+static const Checksum16Kernel_t Checksum16Variants[FEE_CPU_NUM_TIERS] = {ScalarChecksum16, SSE42Checksum16,
+                                                                        AVX2Checksum16, AVX512Checksum16};
+static const PTDUnpackKernel_t PTDUnpackVariants[FEE_CPU_NUM_TIERS] = {ScalarPTDUnpack, SSE42PTDUnpack,
+                                                                      AVX2PTDUnpack, AVX512PTDUnpack};
+static const PTDPackKernel_t PTDPackVariants[FEE_CPU_NUM_TIERS] = {ScalarPTDPack, SSE42PTDPack,
+                                                                  AVX2PTDPack, AVX512PTDPack};
+static const LimitLevelsKernel_t LimitLevelsVariants[FEE_CPU_NUM_TIERS] = {ScalarLimitLevels, SSE42LimitLevels,
+                                                                          AVX2LimitLevels, AVX512LimitLevels};
+#else
+static const Checksum8Kernel_t Checksum8Variants[FEE_CPU_NUM_TIERS] = {ScalarChecksum8};
+static const Checksum16Kernel_t Checksum16Variants[FEE_CPU_NUM_TIERS] = {ScalarChecksum16};
+static const PTDUnpackKernel_t PTDUnpackVariants[FEE_CPU_NUM_TIERS] = {ScalarPTDUnpack};
+static const PTDPackKernel_t PTDPackVariants[FEE_CPU_NUM_TIERS] = {ScalarPTDPack};
+static const LimitLevelsKernel_t LimitLevelsVariants[FEE_CPU_NUM_TIERS] = {ScalarLimitLevels};
+#endif
+
+static pthread_once_t DispatchOnce = PTHREAD_ONCE_INIT;
+static fee_cpu_tier_t DetectedTier = FEE_CPU_TIER_SCALAR;
+static fee_cpu_tier_t SelectedTier = FEE_CPU_TIER_SCALAR;
+static KernelTable_t KernelTable;
+
+/*Take the variant of the highest tier up to Tier. Scalar variants always exist*/
+#define SELECT_VARIANT(Field, Kernel, Variants, Tier)      \
+    do                                                     \
+    {                                                      \
+        int TierIt_ = (int)(Tier);                         \
+        while (TierIt_ > 0 && Variants[TierIt_] == NULL)   \
+        {                                                  \
+            TierIt_--;                                     \
+        }                                                  \
+        KernelTable.Field = Variants[TierIt_];             \
+        KernelTable.Tiers[Kernel] = (fee_cpu_tier_t)TierIt_; \
+    } while (0)
+
+static fee_cpu_tier_t DetectTier(void)
+{
+#ifdef FEE_DISPATCH_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+    {
+        return FEE_CPU_TIER_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return FEE_CPU_TIER_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("ssse3"))
+    {
+        return FEE_CPU_TIER_SSE42;
+    }
+#endif
+
+    return FEE_CPU_TIER_SCALAR;
+}
+
+static void SelectKernels(fee_cpu_tier_t Tier)
+{
+    SelectedTier = Tier > DetectedTier ? DetectedTier : Tier;
+
+    SELECT_VARIANT(Checksum8, FEE_KERNEL_CHECKSUM8, Checksum8Variants, SelectedTier);
+    SELECT_VARIANT(Checksum16, FEE_KERNEL_CHECKSUM16, Checksum16Variants, SelectedTier);
+    SELECT_VARIANT(PTDUnpack, FEE_KERNEL_PTD_UNPACK, PTDUnpackVariants, SelectedTier);
+    SELECT_VARIANT(PTDPack, FEE_KERNEL_PTD_PACK, PTDPackVariants, SelectedTier);
+    SELECT_VARIANT(LimitLevels, FEE_KERNEL_LIMITS, LimitLevelsVariants, SelectedTier);
+}
+
+static void InitDispatch(void)
+{
+    const char *Value = getenv(FEE_CPU_TIER_ENV);
+    fee_cpu_tier_t Tier;
+
+    DetectedTier = DetectTier();
+    Tier = DetectedTier;
+
+    /*Unknown names are ignored*/
+    if (Value != NULL)
+    {
+        for (int TierIt = 0; TierIt < FEE_CPU_NUM_TIERS; TierIt++)
+        {
+            if (strcmp(Value, TierNames[TierIt]) == 0)
+            {
+                Tier = (fee_cpu_tier_t)TierIt;
+            }
+        }
+    }
+
+    SelectKernels(Tier);
+}
+
+const KernelTable_t *GetKernelTable(void)
+{
+    pthread_once(&DispatchOnce, InitDispatch);
+
+    return &KernelTable;
+}
+
+fee_cpu_tier_t fee_dispatch_detected_tier(void)
+{
+    pthread_once(&DispatchOnce, InitDispatch);
+
+    return DetectedTier;
+}
+
+fee_cpu_tier_t fee_dispatch_selected_tier(void)
+{
+    pthread_once(&DispatchOnce, InitDispatch);
+
+    return SelectedTier;
+}
+
+fee_cpu_tier_t fee_dispatch_kernel_tier(fee_kernel_t Kernel)
+{
+    pthread_once(&DispatchOnce, InitDispatch);
+
+    if ((int)Kernel < 0 || Kernel >= FEE_NUM_KERNELS)
+    {
+        return FEE_CPU_TIER_SCALAR;
+    }
+
+    return KernelTable.Tiers[Kernel];
+}
+
+int fee_dispatch_set_tier(fee_cpu_tier_t Tier)
+{
+    if ((int)Tier < 0 || Tier >= FEE_CPU_NUM_TIERS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    pthread_once(&DispatchOnce, InitDispatch);
+    SelectKernels(Tier);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+const char *fee_dispatch_tier_name(fee_cpu_tier_t Tier)
+{
+    if ((int)Tier < 0 || Tier >= FEE_CPU_NUM_TIERS)
+    {
+        return NULL;
+    }
+
+    return TierNames[Tier];
+}
+
+const char *fee_dispatch_kernel_name(fee_kernel_t Kernel)
+{
+    if ((int)Kernel < 0 || Kernel >= FEE_NUM_KERNELS)
+    {
+        return NULL;
+    }
+
+    return KernelNames[Kernel];
+}
+
+int fee_dispatch_report(FILE *fp)
+{
+    int KernelIt;
+
+    pthread_once(&DispatchOnce, InitDispatch);
+
+    if (fprintf(fp, "detected tier: %s\nselected tier: %s\n", TierNames[DetectedTier], TierNames[SelectedTier]) < 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (KernelIt = 0; KernelIt < FEE_NUM_KERNELS; KernelIt++)
+    {
+        if (fprintf(fp, "  %-12s %s\n", KernelNames[KernelIt], TierNames[KernelTable.Tiers[KernelIt]]) < 0)
+        {
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file fee_kernels_scalar.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Portable variants of the dispatched kernels. They are the reference of the other tiers.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <string.h>
+#include "../common/fee_dispatch_internal.h"
+
+uint8_t ScalarChecksum8(const uint8_t *Data, size_t Length)
+{
+    uint8_t Value = 0;
+    size_t i;
+
+    for (i = 0; i < Length; i++)
+    {
+        Value ^= Data[i];
+    }
+
+    return Value;
+}
+
+uint16_t ScalarChecksum16(const uint8_t *Data, size_t Length)
+{
+    uint16_t Value = 0, Word;
+    size_t i;
+
+    /*Words are read in host order*/
+    for (i = 0; i < Length / 2; i++)
+    {
+        memcpy(&Word, &Data[2 * i], 2);
+        Value ^= Word;
+    }
+
+    if (Length % 2)
+    {
+        Value ^= Data[Length - 1];
+    }
+
+    return Value;
+}
+
+void ScalarPTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels)
+{
+    size_t i;
+
+    for (i = 0; i < Pixels; i++, Packet += 4)
+    {
+        Plane0[i] = (uint16_t)((Packet[0] << 8) | Packet[1]);
+        Plane1[i] = (uint16_t)((Packet[2] << 8) | Packet[3]);
+    }
+}
+
+void ScalarPTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels)
+{
+    size_t i;
+
+    for (i = 0; i < Pixels; i++, Packet += 4)
+    {
+        Packet[0] = (uint8_t)(Plane0[i] >> 8);
+        Packet[1] = (uint8_t)Plane0[i];
+        Packet[2] = (uint8_t)(Plane1[i] >> 8);
+        Packet[3] = (uint8_t)Plane1[i];
+    }
+}
+
+/*Comparisons with NaN are false, so NaN values are outside every limit*/
+static uint8_t LimitLevel(float Value, float WarnLow, float WarnHigh, float AlarmLow, float AlarmHigh)
+{
+    return (uint8_t)(!(Value >= AlarmLow && Value <= AlarmHigh) + !(Value >= WarnLow && Value <= WarnHigh));
+}
+
+void ScalarLimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast, uint8_t *Loose,
+                       uint8_t *Strict)
+{
+    size_t i, b;
+
+    for (i = 0; i < Count; i++)
+    {
+        b = Broadcast ? 0 : i;
+        Loose[i] = LimitLevel(Values[i], Bounds[0][b], Bounds[1][b], Bounds[2][b], Bounds[3][b]);
+        Strict[i] = LimitLevel(Values[i], Bounds[4][b], Bounds[5][b], Bounds[6][b], Bounds[7][b]);
+    }
+}
@@ -0,0 +1,383 @@
+/**
+ * @file fee_kernels_x86.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief SSE4.2, AVX2 and AVX-512 variants of the dispatched kernels. Every function is compiled for its own target
+ *  with the target attribute, so the file is built without -m flags and the variants are only called on hosts that
+ *  support them. Tails shorter than a vector are processed by the scalar variants.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include "../common/fee_dispatch_internal.h"
+
+#ifdef FEE_DISPATCH_X86
+
+#include <immintrin.h>
+
+#define FEE_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define FEE_TARGET_AVX2 __attribute__((target("avx2")))
+#define FEE_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+
+/* --------------------- */
+/* ---- SSE4.2 --------- */
+/* --------------------- */
+
+/*Xor of the eight 16 bits words of a vector*/
+static inline FEE_TARGET_SSE42 uint16_t Fold16_128(__m128i Value)
+{
+    Value = _mm_xor_si128(Value, _mm_srli_si128(Value, 8));
+    Value = _mm_xor_si128(Value, _mm_srli_si128(Value, 4));
+    Value = _mm_xor_si128(Value, _mm_srli_si128(Value, 2));
+
+    return (uint16_t)_mm_extract_epi16(Value, 0);
+}
+
+static inline FEE_TARGET_SSE42 uint8_t Fold8_128(__m128i Value)
+{
+    uint16_t Word = Fold16_128(Value);
+
+    return (uint8_t)(Word ^ (Word >> 8));
+}
+
+/*Xor of the 16 bytes blocks of a buffer. The number of processed bytes is returned in Done*/
+static inline FEE_TARGET_SSE42 __m128i Xor128(const uint8_t *Data, size_t Length, size_t *Done)
+{
+    __m128i Acc = _mm_setzero_si128();
+    size_t i;
+
+    for (i = 0; i + 16 <= Length; i += 16)
+    {
+        Acc = _mm_xor_si128(Acc, _mm_loadu_si128((const __m128i *)(Data + i)));
+    }
+    *Done = i;
+
+    return Acc;
+}
+
+FEE_TARGET_SSE42 uint8_t SSE42Checksum8(const uint8_t *Data, size_t Length)
+{
+    size_t Done;
+    __m128i Acc = Xor128(Data, Length, &Done);
+
+    return Fold8_128(Acc) ^ ScalarChecksum8(Data + Done, Length - Done);
+}
+
+FEE_TARGET_SSE42 uint16_t SSE42Checksum16(const uint8_t *Data, size_t Length)
+{
+    size_t Done;
+    __m128i Acc = Xor128(Data, Length, &Done);
+
+    /*Done is even, so the tail words keep their alignment*/
+    return Fold16_128(Acc) ^ ScalarChecksum16(Data + Done, Length - Done);
+}
+
+FEE_TARGET_SSE42 void SSE42PTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels)
+{
+    /*Byte swap of every word, CCD 0 words in the low half and CCD 1 words in the high half*/
+    const __m128i Mask = _mm_setr_epi8(1, 0, 5, 4, 9, 8, 13, 12, 3, 2, 7, 6, 11, 10, 15, 14);
+    __m128i V0, V1;
+    size_t i;
+
+    for (i = 0; i + 8 <= Pixels; i += 8, Packet += 32)
+    {
+        V0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)Packet), Mask);
+        V1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(Packet + 16)), Mask);
+        _mm_storeu_si128((__m128i *)(Plane0 + i), _mm_unpacklo_epi64(V0, V1));
+        _mm_storeu_si128((__m128i *)(Plane1 + i), _mm_unpackhi_epi64(V0, V1));
+    }
+
+    ScalarPTDUnpack(Packet, Plane0 + i, Plane1 + i, Pixels - i);
+}
+
+FEE_TARGET_SSE42 void SSE42PTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels)
+{
+    const __m128i Swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    __m128i A, B;
+    size_t i;
+
+    for (i = 0; i + 8 <= Pixels; i += 8, Packet += 32)
+    {
+        A = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(Plane0 + i)), Swap);
+        B = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(Plane1 + i)), Swap);
+        _mm_storeu_si128((__m128i *)Packet, _mm_unpacklo_epi16(A, B));
+        _mm_storeu_si128((__m128i *)(Packet + 16), _mm_unpackhi_epi16(A, B));
+    }
+
+    ScalarPTDPack(Plane0 + i, Plane1 + i, Packet, Pixels - i);
+}
+
+/*Levels of the values from First with the scalar variant*/
+static inline void LimitLevelsTail(const float *Values, size_t First, size_t Count, const float *const *Bounds,
+                                   int Broadcast, uint8_t *Loose, uint8_t *Strict)
+{
+    const float *Tail[LIMIT_NUM_BOUNDS];
+    int b;
+
+    for (b = 0; b < LIMIT_NUM_BOUNDS; b++)
+    {
+        Tail[b] = Broadcast ? Bounds[b] : Bounds[b] + First;
+    }
+
+    ScalarLimitLevels(Values + First, Count - First, Tail, Broadcast, Loose + First, Strict + First);
+}
+
+static inline FEE_TARGET_SSE42 __m128 LoadBound128(const float *const *Bounds, int b, int Broadcast, size_t i)
+{
+    return Broadcast ? _mm_set1_ps(Bounds[b][0]) : _mm_loadu_ps(Bounds[b] + i);
+}
+
+/*2, minus 1 inside the alarm limits, minus 1 inside the warning limits. Ordered comparisons leave NaN outside*/
+static inline FEE_TARGET_SSE42 __m128i LimitLevel128(__m128 Value, const float *const *Bounds, int First, int Broadcast, size_t i)
+{
+    __m128 InWarn = _mm_and_ps(_mm_cmpge_ps(Value, LoadBound128(Bounds, First, Broadcast, i)),
+                               _mm_cmple_ps(Value, LoadBound128(Bounds, First + 1, Broadcast, i)));
+    __m128 InAlarm = _mm_and_ps(_mm_cmpge_ps(Value, LoadBound128(Bounds, First + 2, Broadcast, i)),
+                                _mm_cmple_ps(Value, LoadBound128(Bounds, First + 3, Broadcast, i)));
+
+    return _mm_add_epi32(_mm_set1_epi32(2), _mm_add_epi32(_mm_castps_si128(InWarn), _mm_castps_si128(InAlarm)));
+}
+
+FEE_TARGET_SSE42 void SSE42LimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast,
+                                       uint8_t *Loose, uint8_t *Strict)
+{
+    __m128 V0, V1;
+    __m128i Levels;
+    size_t i;
+
+    for (i = 0; i + 8 <= Count; i += 8)
+    {
+        V0 = _mm_loadu_ps(Values + i);
+        V1 = _mm_loadu_ps(Values + i + 4);
+        Levels = _mm_packs_epi32(LimitLevel128(V0, Bounds, 0, Broadcast, i), LimitLevel128(V1, Bounds, 0, Broadcast, i + 4));
+        _mm_storel_epi64((__m128i *)(Loose + i), _mm_packus_epi16(Levels, Levels));
+        Levels = _mm_packs_epi32(LimitLevel128(V0, Bounds, 4, Broadcast, i), LimitLevel128(V1, Bounds, 4, Broadcast, i + 4));
+        _mm_storel_epi64((__m128i *)(Strict + i), _mm_packus_epi16(Levels, Levels));
+    }
+
+    LimitLevelsTail(Values, i, Count, Bounds, Broadcast, Loose, Strict);
+}
+
+/* --------------------- */
+/* ---- AVX2 ----------- */
+/* --------------------- */
+
+static inline FEE_TARGET_AVX2 __m128i Fold256(__m256i Value)
+{
+    return _mm_xor_si128(_mm256_castsi256_si128(Value), _mm256_extracti128_si256(Value, 1));
+}
+
+static inline FEE_TARGET_AVX2 __m256i Xor256(const uint8_t *Data, size_t Length, size_t *Done)
+{
+    __m256i Acc = _mm256_setzero_si256();
+    size_t i;
+
+    for (i = 0; i + 32 <= Length; i += 32)
+    {
+        Acc = _mm256_xor_si256(Acc, _mm256_loadu_si256((const __m256i *)(Data + i)));
+    }
+    *Done = i;
+
+    return Acc;
+}
+
+FEE_TARGET_AVX2 uint8_t AVX2Checksum8(const uint8_t *Data, size_t Length)
+{
+    size_t Done;
+    __m256i Acc = Xor256(Data, Length, &Done);
+
+    return Fold8_128(Fold256(Acc)) ^ ScalarChecksum8(Data + Done, Length - Done);
+}
+
+FEE_TARGET_AVX2 uint16_t AVX2Checksum16(const uint8_t *Data, size_t Length)
+{
+    size_t Done;
+    __m256i Acc = Xor256(Data, Length, &Done);
+
+    return Fold16_128(Fold256(Acc)) ^ ScalarChecksum16(Data + Done, Length - Done);
+}
+
+FEE_TARGET_AVX2 void AVX2PTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels)
+{
+    const __m256i Mask = _mm256_setr_epi8(1, 0, 5, 4, 9, 8, 13, 12, 3, 2, 7, 6, 11, 10, 15, 14,
+                                          1, 0, 5, 4, 9, 8, 13, 12, 3, 2, 7, 6, 11, 10, 15, 14);
+    __m256i V0, V1;
+    size_t i;
+
+    for (i = 0; i + 16 <= Pixels; i += 16, Packet += 64)
+    {
+        /*Every lane holds 4 words of each CCD*/
+        V0 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)Packet), Mask);
+        V1 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(Packet + 32)), Mask);
+        /*Unpacking gives the 64 bits groups in the order 0, 2, 1, 3*/
+        _mm256_storeu_si256((__m256i *)(Plane0 + i), _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(V0, V1), 0xD8));
+        _mm256_storeu_si256((__m256i *)(Plane1 + i), _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(V0, V1), 0xD8));
+    }
+
+    ScalarPTDUnpack(Packet, Plane0 + i, Plane1 + i, Pixels - i);
+}
+
+FEE_TARGET_AVX2 void AVX2PTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels)
+{
+    const __m256i Swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    __m256i A, B, Low, High;
+    size_t i;
+
+    for (i = 0; i + 16 <= Pixels; i += 16, Packet += 64)
+    {
+        A = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(Plane0 + i)), Swap);
+        B = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(Plane1 + i)), Swap);
+        /*Pixels 0-3 and 8-11 in Low, 4-7 and 12-15 in High*/
+        Low = _mm256_unpacklo_epi16(A, B);
+        High = _mm256_unpackhi_epi16(A, B);
+        _mm256_storeu_si256((__m256i *)Packet, _mm256_permute2x128_si256(Low, High, 0x20));
+        _mm256_storeu_si256((__m256i *)(Packet + 32), _mm256_permute2x128_si256(Low, High, 0x31));
+    }
+
+    ScalarPTDPack(Plane0 + i, Plane1 + i, Packet, Pixels - i);
+}
+
+static inline FEE_TARGET_AVX2 __m256 LoadBound256(const float *const *Bounds, int b, int Broadcast, size_t i)
+{
+    return Broadcast ? _mm256_set1_ps(Bounds[b][0]) : _mm256_loadu_ps(Bounds[b] + i);
+}
+
+static inline FEE_TARGET_AVX2 __m128i LimitLevel256(__m256 Value, const float *const *Bounds, int First, int Broadcast, size_t i)
+{
+    __m256 InWarn = _mm256_and_ps(_mm256_cmp_ps(Value, LoadBound256(Bounds, First, Broadcast, i), _CMP_GE_OQ),
+                                  _mm256_cmp_ps(Value, LoadBound256(Bounds, First + 1, Broadcast, i), _CMP_LE_OQ));
+    __m256 InAlarm = _mm256_and_ps(_mm256_cmp_ps(Value, LoadBound256(Bounds, First + 2, Broadcast, i), _CMP_GE_OQ),
+                                   _mm256_cmp_ps(Value, LoadBound256(Bounds, First + 3, Broadcast, i), _CMP_LE_OQ));
+    __m256i Levels = _mm256_add_epi32(_mm256_set1_epi32(2),
+                                      _mm256_add_epi32(_mm256_castps_si256(InWarn), _mm256_castps_si256(InAlarm)));
+    __m128i Words = _mm_packs_epi32(_mm256_castsi256_si128(Levels), _mm256_extracti128_si256(Levels, 1));
+
+    return _mm_packus_epi16(Words, Words);
+}
+
+FEE_TARGET_AVX2 void AVX2LimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast,
+                                     uint8_t *Loose, uint8_t *Strict)
+{
+    __m256 V;
+    size_t i;
+
+    for (i = 0; i + 8 <= Count; i += 8)
+    {
+        V = _mm256_loadu_ps(Values + i);
+        _mm_storel_epi64((__m128i *)(Loose + i), LimitLevel256(V, Bounds, 0, Broadcast, i));
+        _mm_storel_epi64((__m128i *)(Strict + i), LimitLevel256(V, Bounds, 4, Broadcast, i));
+    }
+
+    LimitLevelsTail(Values, i, Count, Bounds, Broadcast, Loose, Strict);
+}
+
+/* --------------------- */
+/* ---- AVX-512 -------- */
+/* --------------------- */
+
+/*Word indexes of _mm512_permutex2var_epi16. Indexes from 32 select the second vector*/
+static const uint16_t UnpackEven[32] = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+                                        32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62};
+static const uint16_t UnpackOdd[32] = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31,
+                                       33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63};
+static const uint16_t PackLow[32] = {0, 32, 1, 33, 2, 34, 3, 35, 4, 36, 5, 37, 6, 38, 7, 39,
+                                     8, 40, 9, 41, 10, 42, 11, 43, 12, 44, 13, 45, 14, 46, 15, 47};
+static const uint16_t PackHigh[32] = {16, 48, 17, 49, 18, 50, 19, 51, 20, 52, 21, 53, 22, 54, 23, 55,
+                                      24, 56, 25, 57, 26, 58, 27, 59, 28, 60, 29, 61, 30, 62, 31, 63};
+
+static inline FEE_TARGET_AVX512 __m512i Swap512(__m512i Value)
+{
+    return _mm512_or_si512(_mm512_slli_epi16(Value, 8), _mm512_srli_epi16(Value, 8));
+}
+
+FEE_TARGET_AVX512 uint16_t AVX512Checksum16(const uint8_t *Data, size_t Length)
+{
+    __m512i Acc = _mm512_setzero_si512();
+    size_t i;
+
+    for (i = 0; i + 64 <= Length; i += 64)
+    {
+        Acc = _mm512_xor_si512(Acc, _mm512_loadu_si512((const void *)(Data + i)));
+    }
+
+    Acc = _mm512_castsi256_si512(_mm256_xor_si256(_mm512_castsi512_si256(Acc), _mm512_extracti64x4_epi64(Acc, 1)));
+
+    return Fold16_128(Fold256(_mm512_castsi512_si256(Acc))) ^ ScalarChecksum16(Data + i, Length - i);
+}
+
+FEE_TARGET_AVX512 void AVX512PTDUnpack(const uint8_t *Packet, uint16_t *Plane0, uint16_t *Plane1, size_t Pixels)
+{
+    const __m512i Even = _mm512_loadu_si512((const void *)UnpackEven);
+    const __m512i Odd = _mm512_loadu_si512((const void *)UnpackOdd);
+    __m512i V0, V1;
+    size_t i;
+
+    for (i = 0; i + 32 <= Pixels; i += 32, Packet += 128)
+    {
+        V0 = Swap512(_mm512_loadu_si512((const void *)Packet));
+        V1 = Swap512(_mm512_loadu_si512((const void *)(Packet + 64)));
+        _mm512_storeu_si512((void *)(Plane0 + i), _mm512_permutex2var_epi16(V0, Even, V1));
+        _mm512_storeu_si512((void *)(Plane1 + i), _mm512_permutex2var_epi16(V0, Odd, V1));
+    }
+
+    ScalarPTDUnpack(Packet, Plane0 + i, Plane1 + i, Pixels - i);
+}
+
+FEE_TARGET_AVX512 void AVX512PTDPack(const uint16_t *Plane0, const uint16_t *Plane1, uint8_t *Packet, size_t Pixels)
+{
+    const __m512i Low = _mm512_loadu_si512((const void *)PackLow);
+    const __m512i High = _mm512_loadu_si512((const void *)PackHigh);
+    __m512i A, B;
+    size_t i;
+
+    for (i = 0; i + 32 <= Pixels; i += 32, Packet += 128)
+    {
+        A = Swap512(_mm512_loadu_si512((const void *)(Plane0 + i)));
+        B = Swap512(_mm512_loadu_si512((const void *)(Plane1 + i)));
+        _mm512_storeu_si512((void *)Packet, _mm512_permutex2var_epi16(A, Low, B));
+        _mm512_storeu_si512((void *)(Packet + 64), _mm512_permutex2var_epi16(A, High, B));
+    }
+
+    ScalarPTDPack(Plane0 + i, Plane1 + i, Packet, Pixels - i);
+}
+
+static inline FEE_TARGET_AVX512 __m512 LoadBound512(const float *const *Bounds, int b, int Broadcast, size_t i)
+{
+    return Broadcast ? _mm512_set1_ps(Bounds[b][0]) : _mm512_loadu_ps(Bounds[b] + i);
+}
+
+static inline FEE_TARGET_AVX512 __m128i LimitLevel512(__m512 Value, const float *const *Bounds, int First, int Broadcast, size_t i)
+{
+    const __m512i One = _mm512_set1_epi32(1);
+    __m512i Levels = _mm512_set1_epi32(2);
+    __mmask16 InWarn = _mm512_mask_cmp_ps_mask(_mm512_cmp_ps_mask(Value, LoadBound512(Bounds, First, Broadcast, i), _CMP_GE_OQ),
+                                               Value, LoadBound512(Bounds, First + 1, Broadcast, i), _CMP_LE_OQ);
+    __mmask16 InAlarm = _mm512_mask_cmp_ps_mask(_mm512_cmp_ps_mask(Value, LoadBound512(Bounds, First + 2, Broadcast, i), _CMP_GE_OQ),
+                                                Value, LoadBound512(Bounds, First + 3, Broadcast, i), _CMP_LE_OQ);
+
+    Levels = _mm512_mask_sub_epi32(Levels, InWarn, Levels, One);
+    Levels = _mm512_mask_sub_epi32(Levels, InAlarm, Levels, One);
+
+    return _mm512_cvtepi32_epi8(Levels);
+}
+
+FEE_TARGET_AVX512 void AVX512LimitLevels(const float *Values, size_t Count, const float *const *Bounds, int Broadcast,
+                                         uint8_t *Loose, uint8_t *Strict)
+{
+    __m512 V;
+    size_t i;
+
+    for (i = 0; i + 16 <= Count; i += 16)
+    {
+        V = _mm512_loadu_ps(Values + i);
+        _mm_storeu_si128((__m128i *)(Loose + i), LimitLevel512(V, Bounds, 0, Broadcast, i));
+        _mm_storeu_si128((__m128i *)(Strict + i), LimitLevel512(V, Bounds, 4, Broadcast, i));
+    }
+
+    LimitLevelsTail(Values, i, Count, Bounds, Broadcast, Loose, Strict);
+}
+
+#endif
@@ -0,0 +1,555 @@
+/**
+ * @file fee_errindex.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library bitmap index of TC_ERROR and VAU_ERROR functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fee.h>
+#include <fee_errindex.h>
+
+/*A container holds the sequence numbers that share their upper 16 bits*/
+#define CONTAINER_BITS 16
+#define CONTAINER_VALUES (1u << CONTAINER_BITS)
+#define CONTAINER_WORDS (CONTAINER_VALUES / 64)
+
+/*Sorted arrays larger than this use more memory than a bitmap (2 bytes per value against 8 KiB)*/
+#define ARRAY_MAX_VALUES 4096
+#define ARRAY_INITIAL_VALUES 4
+
+/*Bitmap index of the VAU_ERROR bits*/
+#define VAU_BITMAP_BASE 16
+
+#define INITIAL_PACKETS 1024
+
+/*Sorted array of values while sparse, plain bitmap once dense*/
+typedef struct
+{
+    uint32_t Key;          /*Upper 16 bits of the sequence numbers*/
+    uint32_t Cardinality;
+    uint32_t Capacity;     /*Values allocated in Values*/
+    uint16_t *Values;      /*Sorted values. NULL once the container is a bitmap*/
+    uint64_t *Words;       /*CONTAINER_WORDS words. NULL while the container is an array*/
+
+} Container_t;
+
+typedef struct
+{
+    Container_t *Containers; /*Sorted by key*/
+    size_t NumContainers;
+    size_t Capacity;
+    uint64_t Count;
+
+} Bitmap_t;
+
+struct fee_errindex
+{
+    Bitmap_t Bitmaps[FEE_ERRINDEX_NUM_BITMAPS];
+    uint64_t *Timestamps;   /*Timestamp of every sequence number, in order*/
+    size_t NumPackets;
+    size_t Capacity;
+};
+
+static void ContainerFree(Container_t *Container)
+{
+    free(Container->Values);
+    free(Container->Words);
+}
+
+/*Appends a value greater than every value of the container*/
+static int ContainerAppend(Container_t *Container, uint16_t Value)
+{
+    uint16_t *Values;
+    uint32_t Capacity, i;
+
+    if (Container->Words != NULL)
+    {
+        Container->Words[Value >> 6] |= 1ULL << (Value & 63);
+        Container->Cardinality++;
+        return FEE_EXIT_SUCCESS;
+    }
+
+    if (Container->Cardinality == ARRAY_MAX_VALUES)
+    {
+        Container->Words = (uint64_t *)calloc(CONTAINER_WORDS, sizeof(uint64_t));
+        if (Container->Words == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        for (i = 0; i < Container->Cardinality; i++)
+        {
+            Container->Words[Container->Values[i] >> 6] |= 1ULL << (Container->Values[i] & 63);
+        }
+        free(Container->Values);
+        Container->Values = NULL;
+        Container->Capacity = 0;
+
+        return ContainerAppend(Container, Value);
+    }
+
+    if (Container->Cardinality == Container->Capacity)
+    {
+        Capacity = Container->Capacity == 0 ? ARRAY_INITIAL_VALUES : 2 * Container->Capacity;
+        Values = (uint16_t *)realloc(Container->Values, Capacity * sizeof(uint16_t));
+        if (Values == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Container->Values = Values;
+        Container->Capacity = Capacity;
+    }
+    Container->Values[Container->Cardinality++] = Value;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/*Appends a sequence number greater than every sequence number of the bitmap*/
+static int BitmapAppend(Bitmap_t *Bitmap, uint32_t Sequence)
+{
+    Container_t *Containers;
+    uint32_t Key = Sequence >> CONTAINER_BITS;
+    size_t Capacity;
+
+    if (Bitmap->NumContainers == 0 || Bitmap->Containers[Bitmap->NumContainers - 1].Key != Key)
+    {
+        if (Bitmap->NumContainers == Bitmap->Capacity)
+        {
+            Capacity = Bitmap->Capacity == 0 ? 1 : 2 * Bitmap->Capacity;
+            Containers = (Container_t *)realloc(Bitmap->Containers, Capacity * sizeof(Container_t));
+            if (Containers == NULL)
+            {
+                return FEE_EXIT_ERROR;
+            }
+            Bitmap->Containers = Containers;
+            Bitmap->Capacity = Capacity;
+        }
+        memset(&Bitmap->Containers[Bitmap->NumContainers], 0, sizeof(Container_t));
+        Bitmap->Containers[Bitmap->NumContainers++].Key = Key;
+    }
+
+    if (ContainerAppend(&Bitmap->Containers[Bitmap->NumContainers - 1], (uint16_t)Sequence) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    Bitmap->Count++;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/*Removes the last sequence number appended to the bitmap*/
+static void BitmapRemoveLast(Bitmap_t *Bitmap, uint32_t Sequence)
+{
+    Container_t *Container = &Bitmap->Containers[Bitmap->NumContainers - 1];
+
+    if (Container->Words != NULL)
+    {
+        Container->Words[(uint16_t)Sequence >> 6] &= ~(1ULL << (Sequence & 63));
+    }
+    Container->Cardinality--;
+    if (Container->Cardinality == 0)
+    {
+        ContainerFree(Container);
+        Bitmap->NumContainers--;
+    }
+    Bitmap->Count--;
+}
+
+static const Container_t *BitmapFind(const Bitmap_t *Bitmap, uint32_t Key)
+{
+    size_t Low = 0, High = Bitmap->NumContainers, Middle;
+
+    while (Low < High)
+    {
+        Middle = Low + (High - Low) / 2;
+        if (Bitmap->Containers[Middle].Key < Key)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return Low < Bitmap->NumContainers && Bitmap->Containers[Low].Key == Key ? &Bitmap->Containers[Low] : NULL;
+}
+
+static void WordsLoad(uint64_t *Words, const Container_t *Container)
+{
+    uint32_t i;
+
+    if (Container->Words != NULL)
+    {
+        memcpy(Words, Container->Words, CONTAINER_WORDS * sizeof(uint64_t));
+        return;
+    }
+    memset(Words, 0, CONTAINER_WORDS * sizeof(uint64_t));
+    for (i = 0; i < Container->Cardinality; i++)
+    {
+        Words[Container->Values[i] >> 6] |= 1ULL << (Container->Values[i] & 63);
+    }
+}
+
+static void WordsOr(uint64_t *Words, const Container_t *Container)
+{
+    uint32_t i;
+
+    if (Container->Words != NULL)
+    {
+        for (i = 0; i < CONTAINER_WORDS; i++)
+        {
+            Words[i] |= Container->Words[i];
+        }
+        return;
+    }
+    for (i = 0; i < Container->Cardinality; i++)
+    {
+        Words[Container->Values[i] >> 6] |= 1ULL << (Container->Values[i] & 63);
+    }
+}
+
+/*Words &= Container*/
+static void WordsAnd(uint64_t *Words, const Container_t *Container, uint64_t *Scratch)
+{
+    uint32_t i;
+    uint16_t Value;
+
+    if (Container->Words != NULL)
+    {
+        for (i = 0; i < CONTAINER_WORDS; i++)
+        {
+            Words[i] &= Container->Words[i];
+        }
+        return;
+    }
+    memset(Scratch, 0, CONTAINER_WORDS * sizeof(uint64_t));
+    for (i = 0; i < Container->Cardinality; i++)
+    {
+        Value = Container->Values[i];
+        Scratch[Value >> 6] |= Words[Value >> 6] & (1ULL << (Value & 63));
+    }
+    memcpy(Words, Scratch, CONTAINER_WORDS * sizeof(uint64_t));
+}
+
+/*First sequence number whose timestamp is at or after Timestamp*/
+static size_t LowerBound(const fee_errindex_t *Index, uint64_t Timestamp)
+{
+    size_t Low = 0, High = Index->NumPackets, Middle;
+
+    while (Low < High)
+    {
+        Middle = Low + (High - Low) / 2;
+        if (Index->Timestamps[Middle] < Timestamp)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return Low;
+}
+
+/*Matches of a container key. Returns 0 if no packet of the key can match*/
+static int EvaluateKey(const fee_errindex_t *Index, uint32_t All, uint32_t Any, uint32_t Key, uint64_t *Words,
+                       uint64_t *Scratch)
+{
+    const Container_t *Container;
+    int Loaded = 0, Found = 0, Bit;
+
+    for (Bit = 0; Bit < FEE_ERRINDEX_NUM_BITMAPS; Bit++)
+    {
+        if ((All >> Bit) & 1u)
+        {
+            Container = BitmapFind(&Index->Bitmaps[Bit], Key);
+            if (Container == NULL)
+            {
+                return 0;
+            }
+            if (Loaded)
+            {
+                WordsAnd(Words, Container, Scratch);
+            }
+            else
+            {
+                WordsLoad(Words, Container);
+                Loaded = 1;
+            }
+        }
+    }
+
+    if (Any == 0)
+    {
+        return 1;
+    }
+
+    memset(Scratch, 0, CONTAINER_WORDS * sizeof(uint64_t));
+    for (Bit = 0; Bit < FEE_ERRINDEX_NUM_BITMAPS; Bit++)
+    {
+        if ((Any >> Bit) & 1u)
+        {
+            Container = BitmapFind(&Index->Bitmaps[Bit], Key);
+            if (Container != NULL)
+            {
+                WordsOr(Scratch, Container);
+                Found = 1;
+            }
+        }
+    }
+    if (!Found)
+    {
+        return 0;
+    }
+
+    if (Loaded)
+    {
+        for (Bit = 0; Bit < (int)CONTAINER_WORDS; Bit++)
+        {
+            Words[Bit] &= Scratch[Bit];
+        }
+    }
+    else
+    {
+        memcpy(Words, Scratch, CONTAINER_WORDS * sizeof(uint64_t));
+    }
+
+    return 1;
+}
+
+/*Appends the sequence numbers of Words, in the requested order, while they fit*/
+static void Emit(const uint64_t *Words, uint32_t Key, int Latest, uint32_t *Sequences, size_t Capacity, size_t *NumMatches)
+{
+    uint32_t i, w;
+    uint64_t Word;
+    int Bit;
+
+    for (i = 0; i < CONTAINER_WORDS; i++)
+    {
+        w = Latest ? CONTAINER_WORDS - 1 - i : i;
+        Word = Words[w];
+        if (*NumMatches >= Capacity)
+        {
+            *NumMatches += (size_t)__builtin_popcountll(Word);
+            continue;
+        }
+        while (Word != 0)
+        {
+            Bit = Latest ? 63 - __builtin_clzll(Word) : __builtin_ctzll(Word);
+            Word &= ~(1ULL << Bit);
+            if (*NumMatches < Capacity)
+            {
+                Sequences[*NumMatches] = (Key << CONTAINER_BITS) | (w << 6) | (uint32_t)Bit;
+            }
+            (*NumMatches)++;
+        }
+    }
+}
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+int fee_errindex_create(fee_errindex_t **Index)
+{
+    if (Index == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    *Index = (fee_errindex_t *)calloc(1, sizeof(fee_errindex_t));
+
+    return *Index != NULL ? FEE_EXIT_SUCCESS : FEE_EXIT_ERROR;
+}
+
+void fee_errindex_destroy(fee_errindex_t *Index)
+{
+    size_t i, j;
+
+    if (Index == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < FEE_ERRINDEX_NUM_BITMAPS; i++)
+    {
+        for (j = 0; j < Index->Bitmaps[i].NumContainers; j++)
+        {
+            ContainerFree(&Index->Bitmaps[i].Containers[j]);
+        }
+        free(Index->Bitmaps[i].Containers);
+    }
+    free(Index->Timestamps);
+    free(Index);
+}
+
+int fee_errindex_add(fee_errindex_t *Index, uint64_t Timestamp, uint16_t TCError, uint16_t VAUError, uint32_t *Sequence)
+{
+    uint64_t *Timestamps;
+    uint32_t Bits = (uint32_t)TCError | ((uint32_t)VAUError << VAU_BITMAP_BASE);
+    uint32_t Next;
+    size_t Capacity;
+    int Bit;
+
+    if (Index == NULL || Index->NumPackets >= UINT32_MAX)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    if (Index->NumPackets == Index->Capacity)
+    {
+        Capacity = Index->Capacity == 0 ? INITIAL_PACKETS : 2 * Index->Capacity;
+        Timestamps = (uint64_t *)realloc(Index->Timestamps, Capacity * sizeof(uint64_t));
+        if (Timestamps == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Index->Timestamps = Timestamps;
+        Index->Capacity = Capacity;
+    }
+
+    /*A packet is either in every bitmap of its bits or in none of them*/
+    Next = (uint32_t)Index->NumPackets;
+    for (Bit = 0; Bit < FEE_ERRINDEX_NUM_BITMAPS; Bit++)
+    {
+        if (((Bits >> Bit) & 1u) && BitmapAppend(&Index->Bitmaps[Bit], Next) != FEE_EXIT_SUCCESS)
+        {
+            while (--Bit >= 0)
+            {
+                if ((Bits >> Bit) & 1u)
+                {
+                    BitmapRemoveLast(&Index->Bitmaps[Bit], Next);
+                }
+            }
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    if (Index->NumPackets > 0 && Timestamp < Index->Timestamps[Index->NumPackets - 1])
+    {
+        Timestamp = Index->Timestamps[Index->NumPackets - 1];
+    }
+    Index->Timestamps[Index->NumPackets++] = Timestamp;
+
+    if (Sequence != NULL)
+    {
+        *Sequence = Next;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_errindex_add_tm(fee_errindex_t *Index, uint64_t Timestamp, const fee_TM_t *TM, uint32_t *Sequence)
+{
+    if (TM == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return fee_errindex_add(Index, Timestamp, TM->TC_ERROR, TM->VAU_ERROR, Sequence);
+}
+
+int fee_errindex_query(const fee_errindex_t *Index, const fee_errindex_query_t *Query, uint32_t *Sequences,
+                       size_t Capacity, size_t *NumMatches)
+{
+    uint64_t Words[CONTAINER_WORDS], Scratch[CONTAINER_WORDS];
+    uint32_t All, Any, FirstKey, LastKey, Key, i;
+    size_t First, End;
+
+    if (Index == NULL || Query == NULL || NumMatches == NULL || (Sequences == NULL && Capacity > 0))
+    {
+        return FEE_EXIT_ERROR;
+    }
+    All = (uint32_t)Query->TCAll | ((uint32_t)Query->VAUAll << VAU_BITMAP_BASE);
+    Any = (uint32_t)Query->TCAny | ((uint32_t)Query->VAUAny << VAU_BITMAP_BASE);
+    if (All == 0 && Any == 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    *NumMatches = 0;
+    First = LowerBound(Index, Query->FirstTimestamp);
+    End = Query->LastTimestamp == UINT64_MAX ? Index->NumPackets : LowerBound(Index, Query->LastTimestamp + 1);
+    if (First >= End)
+    {
+        return FEE_EXIT_SUCCESS;
+    }
+
+    FirstKey = (uint32_t)(First >> CONTAINER_BITS);
+    LastKey = (uint32_t)((End - 1) >> CONTAINER_BITS);
+    for (i = 0; i <= LastKey - FirstKey; i++)
+    {
+        Key = Query->Latest ? LastKey - i : FirstKey + i;
+        if (!EvaluateKey(Index, All, Any, Key, Words, Scratch))
+        {
+            continue;
+        }
+
+        /*Packets outside the time range*/
+        if (Key == FirstKey)
+        {
+            memset(Words, 0, ((First & (CONTAINER_VALUES - 1)) >> 6) * sizeof(uint64_t));
+            Words[(First & (CONTAINER_VALUES - 1)) >> 6] &= ~0ULL << (First & 63);
+        }
+        if (Key == LastKey)
+        {
+            Words[((End - 1) & (CONTAINER_VALUES - 1)) >> 6] &= ~0ULL >> (63 - ((End - 1) & 63));
+            memset(&Words[(((End - 1) & (CONTAINER_VALUES - 1)) >> 6) + 1], 0,
+                   (CONTAINER_WORDS - 1 - (((End - 1) & (CONTAINER_VALUES - 1)) >> 6)) * sizeof(uint64_t));
+        }
+
+        Emit(Words, Key, Query->Latest, Sequences, Capacity, NumMatches);
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_errindex_timestamp(const fee_errindex_t *Index, uint32_t Sequence, uint64_t *Timestamp)
+{
+    if (Index == NULL || Timestamp == NULL || Sequence >= Index->NumPackets)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    *Timestamp = Index->Timestamps[Sequence];
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_errindex_info(const fee_errindex_t *Index, fee_errindex_info_t *Info)
+{
+    const Container_t *Container;
+    size_t i, j;
+
+    if (Info == NULL)
+    {
+        return;
+    }
+    memset(Info, 0, sizeof(*Info));
+    if (Index == NULL)
+    {
+        return;
+    }
+
+    Info->NumPackets = Index->NumPackets;
+    Info->MemoryBytes = sizeof(fee_errindex_t) + Index->Capacity * sizeof(uint64_t);
+    for (i = 0; i < FEE_ERRINDEX_NUM_BITMAPS; i++)
+    {
+        Info->BitCounts[i] = Index->Bitmaps[i].Count;
+        Info->MemoryBytes += Index->Bitmaps[i].Capacity * sizeof(Container_t);
+        for (j = 0; j < Index->Bitmaps[i].NumContainers; j++)
+        {
+            Container = &Index->Bitmaps[i].Containers[j];
+            Info->MemoryBytes += Container->Capacity * sizeof(uint16_t) +
+                                 (Container->Words != NULL ? CONTAINER_WORDS * sizeof(uint64_t) : 0);
+        }
+    }
+}
@@ -0,0 +1,343 @@
+/**
+ * @file fee_generator.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library synthetic TC/TM/PTD packet generator.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fee_generator.h>
+
+#define GEN_PRINT_BUFFER_BYTES 4096
+#define GEN_MAX_BYTE_CHARS 4 /*"255 "*/
+
+void fee_gen_config_default(fee_gen_config_t *Config)
+{
+    int Band;
+
+    memset(Config, 0, sizeof(fee_gen_config_t));
+
+    Config->WOISIZE = 282;
+    Config->NBTAIL = 0;
+    Config->SPATIALBINNINGMODE = SPATALBIN_NOTENABLE;
+    for (Band = 0; Band < FEE_GEN_NUM_BANDS; Band++)
+    {
+        Config->BinningSize[Band] = 1;
+    }
+    Config->BandSize[0] = 225;
+    Config->Pattern = FEE_GEN_PATTERN_RAMP;
+    Config->PatternValue = 1;
+    Config->Seed = 1;
+}
+
+void fee_gen_config_maximum(fee_gen_config_t *Config)
+{
+    fee_gen_config_default(Config);
+
+    Config->WOISIZE = TC_WOISIZE_MAX;
+    Config->NBTAIL = TC_NBTAIL_MAX;
+    Config->BandSize[0] = TC_FREQBINNINGBAND_1_BANDSIZE_MAX;
+    Config->BandSize[1] = TC_FREQBINNINGBAND_2_BANDSIZE_MAX;
+    Config->BandSize[2] = TC_FREQBINNINGBAND_3_BANDSIZE_MAX;
+    Config->BandSize[3] = TC_FREQBINNINGBAND_4_BANDSIZE_MAX;
+    Config->BandSize[4] = TC_FREQBINNINGBAND_5_BANDSIZE_MAX;
+    Config->Pattern = FEE_GEN_PATTERN_NOISE;
+}
+
+int fee_gen_TM(const fee_gen_config_t *Config, uint32_t FrameIndex, fee_TM_t *TM_Data_Struct)
+{
+    fee_TC_t *TC = &TM_Data_Struct->Returned_TC;
+    uint16_t *Bands[FEE_GEN_NUM_BANDS];
+    int Band;
+
+    memset(TM_Data_Struct, 0, sizeof(fee_TM_t));
+
+    /*Operational TC of the 2022-03-14 CHANNEL_2 captures*/
+    TC->TC_COUNTER = (uint16_t)(Config->FirstCounter + FrameIndex);
+    TC->OPMODE = OPMODE_OPERATIONAL;
+    TC->EXPO_TIME = 4280;
+    TC->DUOUTDRAINTVLTG = 174;
+    TC->DURESETVLTG = 148;
+    TC->DUDUMPVLTG = 47;
+    TC->DUOUTGATEVLTG = 123;
+    TC->DUIMGCKHVLTG = 86;
+    TC->DUSTGCKHVLTG = 103;
+    TC->DUREGCKHVLTG = 129;
+    TC->DUDUMPCKHVLTG = 128;
+    TC->DURESETCKHVLTG = 191;
+    TC->NBSMEAR = 62;
+    TC->WOISTART = 255;
+    TC->FTPTIME = 81;
+    TC->IMGSTGCKRFTIME = 20;
+    TC->IMGSTGCKOVTIME = 10;
+    TC->IMGSTGCKPWTIME = 52;
+    TC->REGLINADVTIME = 40;
+    TC->LINADVREGTIME = 40;
+    TC->RCKPTIME = 91;
+    TC->REGCKOVTIME = 3;
+    TC->R1REGCKONTIME = 17;
+    TC->R3REGCKONTIME = 12;
+    TC->R2CKRISEDELTIME = 3;
+    TC->RESETCKONTIME = 7;
+    TC->RESETCKFALLDELTIME = 3;
+    TC->ADC1TIME = 28;
+    TC->ADC2TIME = 55;
+    TC->ADC1RDDLY = 45;
+    TC->ADC2RDDLY = 45;
+    TC->DULAMBDA = 112;
+    TC->PIXEL_MIN = 0;
+    TC->PIXEL_MAX = 64000;
+    TC->CDSPARAMS = 540;
+    TC->HCNBSAMPLE = 8;
+
+    /*Geometry*/
+    TC->WOISIZE = Config->WOISIZE;
+    TC->NBTAIL = Config->NBTAIL;
+    TC->SPATIALBINNINGMODE = Config->SPATIALBINNINGMODE;
+
+    Bands[0] = &TC->FREQBINNINGBAND_1;
+    Bands[1] = &TC->FREQBINNINGBAND_2;
+    Bands[2] = &TC->FREQBINNINGBAND_3;
+    Bands[3] = &TC->FREQBINNINGBAND_4;
+    Bands[4] = &TC->FREQBINNINGBAND_5;
+    for (Band = 0; Band < FEE_GEN_NUM_BANDS; Band++)
+    {
+        /*Disabled bands are encoded as 0, as in the captures*/
+        *Bands[Band] = Config->BandSize[Band] == 0
+                           ? 0
+                           : fee_fill_freqbinningband_parameter(Config->BinningSize[Band], Config->BandSize[Band]);
+    }
+
+    if (Config->Pattern == FEE_GEN_PATTERN_SYNTHETIC_1)
+    {
+        TC->SYNTPATTERN = SYNTHETIC_PATTERN_1;
+    }
+    else if (Config->Pattern == FEE_GEN_PATTERN_SYNTHETIC_2)
+    {
+        TC->SYNTPATTERN = SYNTHETIC_PATTERN_2;
+    }
+    else
+    {
+        TC->SYNTPATTERN = NO_SYNTHETIC_PATTERN;
+    }
+
+    /*Measurements of the 2022-03-14 CHANNEL_2 captures*/
+    TM_Data_Struct->TM_COUNTER = Config->FirstCounter + FrameIndex;
+    TM_Data_Struct->CCDTEMP_MEAS1 = 32376;
+    TM_Data_Struct->CCDTEMP_MEAS2 = 32304;
+    TM_Data_Struct->VAUTEMP_MEAS = 19856;
+    TM_Data_Struct->FPPETEMP_MEAS = 20173;
+    TM_Data_Struct->VODE_MEAS = 24;
+    TM_Data_Struct->VODF_MEAS = 24;
+    TM_Data_Struct->VODG_MEAS = 24;
+    TM_Data_Struct->VODH_MEAS = 30;
+    TM_Data_Struct->VRD_MEAS = 32;
+    TM_Data_Struct->VDD_MEAS = 2056;
+    TM_Data_Struct->VOG_MEAS = 64;
+    TM_Data_Struct->IPHIH_MEAS = 14408;
+    TM_Data_Struct->SPHIH_MEAS = 14198;
+    TM_Data_Struct->RPHIH_MEAS = 14415;
+    TM_Data_Struct->PHIRH_MEAS = 16568;
+    TM_Data_Struct->VDGH_MEAS = 16548;
+    TM_Data_Struct->VANAP_MEAS = 22669;
+    TM_Data_Struct->VANAN_MEAS = 21656;
+    TM_Data_Struct->VDET_MEAS = 10392;
+    TM_Data_Struct->VDRV_MEAS = 13560;
+    TM_Data_Struct->VDIG_MEAS = 22760;
+    TM_Data_Struct->IDIG_MEAS = 9121;
+
+    return fee_TC_BoundsCheck(*TC);
+}
+
+void fee_gen_image(const fee_gen_config_t *Config, uint32_t FrameIndex, fee_PTD_t *PTD_Data)
+{
+    size_t Rows = PTD_Data->PTDImageMatrixTotalSizes.ImageTotalRows;
+    size_t Columns = PTD_Data->PTDImageMatrixTotalSizes.ImageTotalColumns;
+    size_t Row, Column, Index;
+    uint32_t State = Config->Seed + FrameIndex;
+    uint16_t Value = 0;
+    int CCD;
+
+    /*xorshift32 must not be seeded with 0*/
+    if (State == 0)
+    {
+        State = 0x9E3779B9u;
+    }
+
+    for (CCD = 0; CCD < FEE_NUM_CCD; CCD++)
+    {
+        for (Row = 0, Index = 0; Row < Rows; Row++)
+        {
+            for (Column = 0; Column < Columns; Column++, Index++)
+            {
+                switch (Config->Pattern)
+                {
+                case FEE_GEN_PATTERN_NOISE:
+                    State ^= State << 13;
+                    State ^= State >> 17;
+                    State ^= State << 5;
+                    Value = (uint16_t)(State >> 16);
+                    break;
+                case FEE_GEN_PATTERN_SYNTHETIC_1:
+                    Value = (uint16_t)Column;
+                    break;
+                case FEE_GEN_PATTERN_SYNTHETIC_2:
+                    Value = (uint16_t)Row;
+                    break;
+                case FEE_GEN_PATTERN_CONSTANT:
+                    Value = Config->PatternValue;
+                    break;
+                case FEE_GEN_PATTERN_RAMP:
+                default:
+                    Value = (uint16_t)(Index * Config->PatternValue + (size_t)CCD * Rows + FrameIndex);
+                    break;
+                }
+
+                PTD_Data->ImageMatrix[CCD][Index] = Value;
+            }
+        }
+
+        /*There is no dark info in the smear rows*/
+        for (Row = PTD_Data->PTDSizes.NumDataRows; Row < PTD_Data->PTDSizes.NumDataRows + FEE_NUM_SMEAR_ROWS && Row < Rows; Row++)
+        {
+            for (Column = 0; Column < (size_t)PTD_Data->PTDSizes.NumDarkInfoPerRow_EveryCCD / FEE_NUM_CCD; Column++)
+            {
+                PTD_Data->ImageMatrix[CCD][Row * Columns + Column] = 0;
+            }
+        }
+    }
+}
+
+int fee_gen_frame(const fee_gen_config_t *Config, uint32_t FrameIndex, fee_gen_frame_t *Frame)
+{
+    fee_TM_t TM_Data_Struct;
+
+    if (fee_gen_TM(Config, FrameIndex, &TM_Data_Struct) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return fee_gen_frame_from_TM(Config, TM_Data_Struct, FrameIndex, Frame);
+}
+
+int fee_gen_frame_from_TM(const fee_gen_config_t *Config, fee_TM_t TM_Data_Struct, uint32_t FrameIndex, fee_gen_frame_t *Frame)
+{
+    fee_PTD_t *PTD = &Frame->PTD;
+    size_t ImageBytes;
+    uint8_t *Packet;
+    uint16_t *Plane;
+    int CCD;
+
+    Frame->TM = TM_Data_Struct;
+
+    if (fee_TC_Write(TM_Data_Struct.Returned_TC, Frame->TC_Packet) != FEE_EXIT_SUCCESS ||
+        fee_TM_Write(TM_Data_Struct, Frame->TM_Packet) != FEE_EXIT_SUCCESS ||
+        fee_Calculate_PTD_Sizes(TM_Data_Struct, &PTD->PTDSizes, &PTD->PTDImageMatrixTotalSizes) != FEE_EXIT_SUCCESS ||
+        PTD->PTDSizes.DataPacketTotalBytes == 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Grow the buffers*/
+    ImageBytes = PTD->PTDImageMatrixTotalSizes.ImageMatrixBytes;
+    if (ImageBytes > Frame->ImageCapacityBytes)
+    {
+        for (CCD = 0; CCD < FEE_NUM_CCD; CCD++)
+        {
+            Plane = realloc(PTD->ImageMatrix[CCD], ImageBytes);
+            if (Plane == NULL)
+            {
+                return FEE_EXIT_ERROR;
+            }
+            PTD->ImageMatrix[CCD] = Plane;
+        }
+        Frame->ImageCapacityBytes = ImageBytes;
+    }
+
+    if (PTD->PTDSizes.DataPacketTotalBytes > Frame->PacketCapacityBytes)
+    {
+        Packet = realloc(Frame->PTD_Packet, PTD->PTDSizes.DataPacketTotalBytes);
+        if (Packet == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Frame->PTD_Packet = Packet;
+        Frame->PacketCapacityBytes = PTD->PTDSizes.DataPacketTotalBytes;
+    }
+
+    PTD->PIXEL_DATA_COUNTER = Config->FirstCounter + FrameIndex;
+    PTD->VOLTAGES_REFERENCES[0] = 22669;
+    PTD->VOLTAGES_REFERENCES[1] = 21656;
+    PTD->VOLTAGES_REFERENCES[2] = 10392;
+    PTD->VOLTAGES_REFERENCES[3] = 13560;
+
+    fee_gen_image(Config, FrameIndex, PTD);
+
+    return fee_PTD_Write(TM_Data_Struct, *PTD, Frame->PTD_Packet);
+}
+
+void fee_gen_frame_free(fee_gen_frame_t *Frame)
+{
+    int CCD;
+
+    for (CCD = 0; CCD < FEE_NUM_CCD; CCD++)
+    {
+        free(Frame->PTD.ImageMatrix[CCD]);
+    }
+    free(Frame->PTD_Packet);
+
+    memset(Frame, 0, sizeof(fee_gen_frame_t));
+}
+
+int fee_gen_fprint_packet(FILE *fp, uint64_t Timestamp, const uint8_t *Packet, size_t PacketBytes, int IsPTD)
+{
+    char Buffer[GEN_PRINT_BUFFER_BYTES];
+    size_t Length = 0, i;
+    uint8_t Byte;
+
+    if (IsPTD)
+    {
+        Length = (size_t)snprintf(Buffer, sizeof(Buffer), "%llu - %zu ", (unsigned long long)Timestamp, PacketBytes);
+    }
+    else
+    {
+        Length = (size_t)snprintf(Buffer, sizeof(Buffer), "%llu - ", (unsigned long long)Timestamp);
+    }
+
+    /*Every byte is followed by a space, the line ends with " \n" as in the captures*/
+    for (i = 0; i < PacketBytes; i++)
+    {
+        if (Length + GEN_MAX_BYTE_CHARS > sizeof(Buffer))
+        {
+            if (fwrite(Buffer, 1, Length, fp) != Length)
+            {
+                return FEE_EXIT_ERROR;
+            }
+            Length = 0;
+        }
+
+        Byte = Packet[i];
+        if (Byte >= 100)
+        {
+            Buffer[Length++] = (char)('0' + Byte / 100);
+        }
+        if (Byte >= 10)
+        {
+            Buffer[Length++] = (char)('0' + (Byte / 10) % 10);
+        }
+        Buffer[Length++] = (char)('0' + Byte % 10);
+        Buffer[Length++] = ' ';
+    }
+
+    if (fwrite(Buffer, 1, Length, fp) != Length || fputc('\n', fp) == EOF)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
@@ -0,0 +1,420 @@
+/**
+ * @file fee_limits.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library limit monitoring functions. The kernel gives the level of every value against the limits and
+ *  against the limits shrunk by the hysteresis; the new state of a channel is the plain level, unless its current
+ *  state is higher and the value has not gone back past the shrunk limits.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <fee.h>
+#include <fee_limits.h>
+#include "../common/fee_dispatch_internal.h"
+
+/*Packets of a batch checked at once*/
+#define LIMITS_CHUNK_PACKETS 256
+
+#define LIMITS_INITIAL_CHANNELS 32
+#define LIMITS_MAX_LINE 512
+
+struct fee_limits
+{
+    size_t NumChannels;
+    uint32_t *Fields;
+    uint32_t MaxField;
+    float *Bounds;                       /*LIMIT_NUM_BOUNDS rows of NumChannels bounds*/
+    const float *Rows[LIMIT_NUM_BOUNDS]; /*Rows of Bounds*/
+    uint8_t *States;
+    float *Values;                       /*Values of the channels*/
+    uint8_t *Loose;                      /*Levels of the values, for the largest of NumChannels and LIMITS_CHUNK_PACKETS*/
+    uint8_t *Strict;
+};
+
+static const struct
+{
+    const char *Name;
+    size_t Offset;
+} FloatFields[FEE_TM_FLOAT_NUM_FIELDS] = {
+    {"CCDTEMP_MEAS1", offsetof(fee_TM_Float_t, CCDTEMP_MEAS1_f)},
+    {"CCDTEMP_MEAS2", offsetof(fee_TM_Float_t, CCDTEMP_MEAS2_f)},
+    {"VAUTEMP_MEAS", offsetof(fee_TM_Float_t, VAUTEMP_MEAS_f)},
+    {"FPPETEMP_MEAS", offsetof(fee_TM_Float_t, FPPETEMP_MEAS_f)},
+    {"VODE_MEAS", offsetof(fee_TM_Float_t, VODE_MEAS_f)},
+    {"VODF_MEAS", offsetof(fee_TM_Float_t, VODF_MEAS_f)},
+    {"VODG_MEAS", offsetof(fee_TM_Float_t, VODG_MEAS_f)},
+    {"VODH_MEAS", offsetof(fee_TM_Float_t, VODH_MEAS_f)},
+    {"VRD_MEAS", offsetof(fee_TM_Float_t, VRD_MEAS_f)},
+    {"VDD_MEAS", offsetof(fee_TM_Float_t, VDD_MEAS_f)},
+    {"VOG_MEAS", offsetof(fee_TM_Float_t, VOG_MEAS_f)},
+    {"IPHIH_MEAS", offsetof(fee_TM_Float_t, IPHIH_MEAS_f)},
+    {"SPHIH_MEAS", offsetof(fee_TM_Float_t, SPHIH_MEAS_f)},
+    {"RPHIH_MEAS", offsetof(fee_TM_Float_t, RPHIH_MEAS_f)},
+    {"PHIRH_MEAS", offsetof(fee_TM_Float_t, PHIRH_MEAS_f)},
+    {"VDGH_MEAS", offsetof(fee_TM_Float_t, VDGH_MEAS_f)},
+    {"VANAP_MEAS", offsetof(fee_TM_Float_t, VANAP_MEAS_f)},
+    {"VDET_MEAS", offsetof(fee_TM_Float_t, VDET_MEAS_f)},
+    {"VANAN_MEAS", offsetof(fee_TM_Float_t, VANAN_MEAS_f)},
+    {"VDRV_MEAS", offsetof(fee_TM_Float_t, VDRV_MEAS_f)},
+    {"VDIG_MEAS", offsetof(fee_TM_Float_t, VDIG_MEAS_f)},
+    {"IDIG_MEAS", offsetof(fee_TM_Float_t, IDIG_MEAS_f)},
+};
+
+static int IsValidLimit(const fee_limit_t *Limit)
+{
+    /*Written so that NaN limits fail every comparison*/
+    return Limit->AlarmLow <= Limit->WarnLow && Limit->WarnLow <= Limit->WarnHigh && Limit->WarnHigh <= Limit->AlarmHigh &&
+           Limit->Hysteresis >= 0.0f && 2.0f * Limit->Hysteresis <= Limit->WarnHigh - Limit->WarnLow;
+}
+
+/*Next state of a channel, and the transition if it changes*/
+static void UpdateState(uint8_t *State, uint8_t Loose, uint8_t Strict, uint32_t Channel, uint32_t Field, size_t Packet,
+                        float Value, fee_limit_transition_t *Transitions, size_t Capacity, size_t *NumTransitions)
+{
+    uint8_t Next = Strict < *State ? Strict : *State;
+
+    Next = Loose > Next ? Loose : Next;
+    if (Next == *State)
+    {
+        return;
+    }
+
+    if (*NumTransitions < Capacity)
+    {
+        Transitions[*NumTransitions].Channel = Channel;
+        Transitions[*NumTransitions].Field = Field;
+        Transitions[*NumTransitions].Packet = Packet;
+        Transitions[*NumTransitions].From = (fee_limit_state_t)*State;
+        Transitions[*NumTransitions].To = (fee_limit_state_t)Next;
+        Transitions[*NumTransitions].Value = Value;
+    }
+    (*NumTransitions)++;
+    *State = Next;
+}
+
+static int ParseField(const char *Name, uint32_t *Field)
+{
+    char *End;
+    unsigned long Index;
+    int FieldIt;
+
+    for (FieldIt = 0; FieldIt < FEE_TM_FLOAT_NUM_FIELDS; FieldIt++)
+    {
+        if (strcmp(Name, FloatFields[FieldIt].Name) == 0)
+        {
+            *Field = (uint32_t)FieldIt;
+            return FEE_EXIT_SUCCESS;
+        }
+    }
+
+    if (Name[0] < '0' || Name[0] > '9')
+    {
+        return FEE_EXIT_ERROR;
+    }
+    Index = strtoul(Name, &End, 10);
+    if (*End != '\0' || Index >= UINT32_MAX)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    *Field = (uint32_t)Index;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/*Line of a text table: field name or index, four limits and an optional hysteresis*/
+static int ParseLine(char *Line, fee_limit_t *Limit)
+{
+    float *Numbers[5] = {&Limit->WarnLow, &Limit->WarnHigh, &Limit->AlarmLow, &Limit->AlarmHigh, &Limit->Hysteresis};
+    const char *Blanks = " \t\r\n";
+    char *Next, *End;
+    int NumNumbers = 0;
+
+    Next = Line + strcspn(Line, Blanks);
+    if (*Next != '\0')
+    {
+        *Next++ = '\0';
+    }
+    if (ParseField(Line, &Limit->Field) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Limit->Hysteresis = 0.0f;
+    for (Next += strspn(Next, Blanks); *Next != '\0'; Next = End + strspn(End, Blanks))
+    {
+        if (NumNumbers == 5)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        *Numbers[NumNumbers++] = strtof(Next, &End);
+        if (End == Next || (*End != '\0' && strchr(Blanks, *End) == NULL))
+        {
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    return NumNumbers >= 4 ? FEE_EXIT_SUCCESS : FEE_EXIT_ERROR;
+}
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+int fee_limits_create(const fee_limit_t *Table, size_t NumChannels, fee_limits_t **Limits)
+{
+    fee_limits_t *New;
+    size_t i, Scratch = NumChannels > LIMITS_CHUNK_PACKETS ? NumChannels : LIMITS_CHUNK_PACKETS;
+    int b;
+
+    if (Table == NULL || NumChannels == 0 || NumChannels > UINT32_MAX || Limits == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    for (i = 0; i < NumChannels; i++)
+    {
+        if (!IsValidLimit(&Table[i]) || Table[i].Field == UINT32_MAX)
+        {
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    New = (fee_limits_t *)calloc(1, sizeof(fee_limits_t));
+    if (New == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    New->NumChannels = NumChannels;
+    New->Fields = (uint32_t *)malloc(NumChannels * sizeof(uint32_t));
+    New->Bounds = (float *)malloc(LIMIT_NUM_BOUNDS * NumChannels * sizeof(float));
+    New->States = (uint8_t *)calloc(NumChannels, sizeof(uint8_t));
+    New->Values = (float *)malloc(NumChannels * sizeof(float));
+    New->Loose = (uint8_t *)malloc(Scratch);
+    New->Strict = (uint8_t *)malloc(Scratch);
+    if (New->Fields == NULL || New->Bounds == NULL || New->States == NULL || New->Values == NULL ||
+        New->Loose == NULL || New->Strict == NULL)
+    {
+        fee_limits_destroy(New);
+        return FEE_EXIT_ERROR;
+    }
+
+    for (b = 0; b < LIMIT_NUM_BOUNDS; b++)
+    {
+        New->Rows[b] = New->Bounds + (size_t)b * NumChannels;
+    }
+    for (i = 0; i < NumChannels; i++)
+    {
+        New->Fields[i] = Table[i].Field;
+        New->MaxField = Table[i].Field > New->MaxField ? Table[i].Field : New->MaxField;
+        New->Bounds[0 * NumChannels + i] = Table[i].WarnLow;
+        New->Bounds[1 * NumChannels + i] = Table[i].WarnHigh;
+        New->Bounds[2 * NumChannels + i] = Table[i].AlarmLow;
+        New->Bounds[3 * NumChannels + i] = Table[i].AlarmHigh;
+        New->Bounds[4 * NumChannels + i] = Table[i].WarnLow + Table[i].Hysteresis;
+        New->Bounds[5 * NumChannels + i] = Table[i].WarnHigh - Table[i].Hysteresis;
+        New->Bounds[6 * NumChannels + i] = Table[i].AlarmLow + Table[i].Hysteresis;
+        New->Bounds[7 * NumChannels + i] = Table[i].AlarmHigh - Table[i].Hysteresis;
+    }
+
+    *Limits = New;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_limits_load(const char *Path, fee_limits_t **Limits)
+{
+    FILE *fp;
+    char Line[LIMITS_MAX_LINE], *First;
+    fee_limit_t *Table = NULL, *Grown;
+    size_t NumChannels = 0, Capacity = 0;
+    int Status = FEE_EXIT_SUCCESS;
+
+    if (Path == NULL || Limits == NULL || (fp = fopen(Path, "r")) == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    while (Status == FEE_EXIT_SUCCESS && fgets(Line, sizeof(Line), fp) != NULL)
+    {
+        /*Lines longer than the buffer are not valid*/
+        if (strchr(Line, '\n') == NULL && !feof(fp))
+        {
+            Status = FEE_EXIT_ERROR;
+            break;
+        }
+        First = Line + strspn(Line, " \t\r\n");
+        if (*First == '\0' || *First == '#')
+        {
+            continue;
+        }
+
+        if (NumChannels == Capacity)
+        {
+            Capacity = Capacity == 0 ? LIMITS_INITIAL_CHANNELS : 2 * Capacity;
+            Grown = (fee_limit_t *)realloc(Table, Capacity * sizeof(fee_limit_t));
+            if (Grown == NULL)
+            {
+                Status = FEE_EXIT_ERROR;
+                break;
+            }
+            Table = Grown;
+        }
+
+        Status = ParseLine(First, &Table[NumChannels++]);
+    }
+    if (ferror(fp))
+    {
+        Status = FEE_EXIT_ERROR;
+    }
+    fclose(fp);
+
+    if (Status == FEE_EXIT_SUCCESS)
+    {
+        Status = fee_limits_create(Table, NumChannels, Limits);
+    }
+    free(Table);
+
+    return Status;
+}
+
+void fee_limits_destroy(fee_limits_t *Limits)
+{
+    if (Limits == NULL)
+    {
+        return;
+    }
+
+    free(Limits->Fields);
+    free(Limits->Bounds);
+    free(Limits->States);
+    free(Limits->Values);
+    free(Limits->Loose);
+    free(Limits->Strict);
+    free(Limits);
+}
+
+int fee_limits_eval(fee_limits_t *Limits, const float *Values, size_t NumValues, fee_limit_transition_t *Transitions,
+                    size_t Capacity, size_t *NumTransitions)
+{
+    size_t i;
+
+    if (Limits == NULL || Values == NULL || NumTransitions == NULL || (Transitions == NULL && Capacity > 0) ||
+        NumValues <= Limits->MaxField)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (i = 0; i < Limits->NumChannels; i++)
+    {
+        Limits->Values[i] = Values[Limits->Fields[i]];
+    }
+    GetKernelTable()->LimitLevels(Limits->Values, Limits->NumChannels, Limits->Rows, 0, Limits->Loose, Limits->Strict);
+
+    *NumTransitions = 0;
+    for (i = 0; i < Limits->NumChannels; i++)
+    {
+        UpdateState(&Limits->States[i], Limits->Loose[i], Limits->Strict[i], (uint32_t)i, Limits->Fields[i], 0,
+                    Limits->Values[i], Transitions, Capacity, NumTransitions);
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_limits_eval_tm(fee_limits_t *Limits, const fee_TM_Float_t *TM, fee_limit_transition_t *Transitions,
+                       size_t Capacity, size_t *NumTransitions)
+{
+    float Values[FEE_TM_FLOAT_NUM_FIELDS];
+    int FieldIt;
+
+    if (TM == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (FieldIt = 0; FieldIt < FEE_TM_FLOAT_NUM_FIELDS; FieldIt++)
+    {
+        memcpy(&Values[FieldIt], (const uint8_t *)TM + FloatFields[FieldIt].Offset, sizeof(float));
+    }
+
+    return fee_limits_eval(Limits, Values, FEE_TM_FLOAT_NUM_FIELDS, Transitions, Capacity, NumTransitions);
+}
+
+int fee_limits_eval_batch(fee_limits_t *Limits, const float *Columns, size_t NumFields, size_t Stride,
+                          size_t NumPackets, fee_limit_transition_t *Transitions, size_t Capacity,
+                          size_t *NumTransitions)
+{
+    const LimitLevelsKernel_t LimitLevels = GetKernelTable()->LimitLevels;
+    const float *Bounds[LIMIT_NUM_BOUNDS];
+    const float *Column;
+    size_t Channel, First, Count, i;
+    int b;
+
+    if (Limits == NULL || Columns == NULL || NumTransitions == NULL || (Transitions == NULL && Capacity > 0) ||
+        NumFields <= Limits->MaxField || Stride < NumPackets)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Every channel runs over the batch with its bounds broadcast, so the columns are read contiguously*/
+    *NumTransitions = 0;
+    for (Channel = 0; Channel < Limits->NumChannels; Channel++)
+    {
+        Column = Columns + (size_t)Limits->Fields[Channel] * Stride;
+        for (b = 0; b < LIMIT_NUM_BOUNDS; b++)
+        {
+            Bounds[b] = Limits->Rows[b] + Channel;
+        }
+
+        for (First = 0; First < NumPackets; First += Count)
+        {
+            Count = NumPackets - First < LIMITS_CHUNK_PACKETS ? NumPackets - First : LIMITS_CHUNK_PACKETS;
+            LimitLevels(Column + First, Count, Bounds, 1, Limits->Loose, Limits->Strict);
+            for (i = 0; i < Count; i++)
+            {
+                UpdateState(&Limits->States[Channel], Limits->Loose[i], Limits->Strict[i], (uint32_t)Channel,
+                            Limits->Fields[Channel], First + i, Column[First + i], Transitions, Capacity, NumTransitions);
+            }
+        }
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+fee_limit_state_t fee_limits_state(const fee_limits_t *Limits, size_t Channel)
+{
+    if (Limits == NULL || Channel >= Limits->NumChannels)
+    {
+        return FEE_LIMIT_OK;
+    }
+
+    return (fee_limit_state_t)Limits->States[Channel];
+}
+
+void fee_limits_reset(fee_limits_t *Limits)
+{
+    if (Limits != NULL)
+    {
+        memset(Limits->States, FEE_LIMIT_OK, Limits->NumChannels);
+    }
+}
+
+size_t fee_limits_num_channels(const fee_limits_t *Limits)
+{
+    return Limits != NULL ? Limits->NumChannels : 0;
+}
+
+const char *fee_limits_field_name(fee_TM_FloatField_t Field)
+{
+    if ((int)Field < 0 || Field >= FEE_TM_FLOAT_NUM_FIELDS)
+    {
+        return NULL;
+    }
+
+    return FloatFields[Field].Name;
+}
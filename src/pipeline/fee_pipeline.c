@@ -0,0 +1,579 @@
+/**
+ * @file fee_pipeline.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library lock-free packet pipeline functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <fee.h>
+#include <fee_pipeline.h>
+#include "../common/fee_common.h"
+
+/*Idle rounds of a stage spinning before yielding the CPU, and yielding before sleeping*/
+#define PIPELINE_SPIN_ROUNDS 64
+#define PIPELINE_YIELD_ROUNDS 256
+/*Sleep of an idle stage, in nanoseconds. It bounds the wakeup latency of an idle pipeline*/
+#define PIPELINE_IDLE_SLEEP_NS 20000
+
+struct fee_spsc_ring
+{
+    /*Producer cache line*/
+    _Alignas(FEE_CACHE_LINE_BYTES) atomic_size_t Head; /*Next slot to be written*/
+    size_t CachedTail;                                 /*Last Tail seen by the producer*/
+
+    /*Consumer cache line*/
+    _Alignas(FEE_CACHE_LINE_BYTES) atomic_size_t Tail; /*Next slot to be read*/
+    size_t CachedHead;                                 /*Last Head seen by the consumer*/
+
+    /*Read-only information*/
+    _Alignas(FEE_CACHE_LINE_BYTES) size_t Capacity;
+    size_t Mask;
+    fee_packet_desc_t *Slots;
+};
+
+struct fee_buffer_pool
+{
+    /*Free buffer indexes. Released (produced) by the consumer and acquired by the producer*/
+    _Alignas(FEE_CACHE_LINE_BYTES) atomic_size_t FreeHead;
+    _Alignas(FEE_CACHE_LINE_BYTES) atomic_size_t FreeTail;
+
+    _Alignas(FEE_CACHE_LINE_BYTES) size_t NumBuffers;
+    size_t Capacity;
+    size_t Mask;
+    size_t BufferBytes; /*Size of every buffer rounded up to the cache line size*/
+    size_t *FreeIndexes;
+    atomic_uchar *InUse; /*Ownership of every buffer. Set on acquire and cleared on release*/
+    uint8_t *Memory;
+};
+
+/*Information of a stage thread*/
+typedef struct
+{
+    fee_pipeline_t *Pipeline;
+    fee_pipeline_stage_t Stage;
+    fee_spsc_ring_t *Input;
+    fee_spsc_ring_t *Output;
+    fee_packet_desc_t *Batch;
+    pthread_t Thread;
+    int Started;
+
+} PipelineStage_t;
+
+struct fee_pipeline
+{
+    _Alignas(FEE_CACHE_LINE_BYTES) atomic_int Stop;
+    size_t NumStages;
+    size_t BatchSize;
+    fee_spsc_ring_t **Rings; /*NumStages + 1 rings. Ring n is the input of stage n*/
+    PipelineStage_t *Stages;
+};
+
+/**
+ * @brief Function that returns the lowest power of two greater or equal than Value.
+ */
+static size_t RoundUpPowerOfTwo(size_t Value)
+{
+    size_t Power = 1;
+
+    while (Power < Value)
+    {
+        Power <<= 1;
+    }
+
+    return Power;
+}
+
+/**
+ * @brief Function that waits while a stage has nothing to do. It spins first, then yields the CPU and finally sleeps.
+ *
+ * @param IdleRounds [Input/Output] Number of consecutive idle rounds of the stage.
+ */
+static void PipelineBackoff(unsigned int *IdleRounds)
+{
+    struct timespec Sleep = {0, PIPELINE_IDLE_SLEEP_NS};
+
+    if (*IdleRounds < PIPELINE_SPIN_ROUNDS)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    else if (*IdleRounds < PIPELINE_YIELD_ROUNDS)
+    {
+        sched_yield();
+    }
+    else
+    {
+        nanosleep(&Sleep, NULL);
+    }
+
+    if (*IdleRounds < PIPELINE_YIELD_ROUNDS)
+    {
+        (*IdleRounds)++;
+    }
+}
+
+static void *AlignedAlloc(size_t Bytes)
+{
+    void *Memory = NULL;
+
+    if (posix_memalign(&Memory, FEE_CACHE_LINE_BYTES, Bytes) != 0)
+    {
+        return NULL;
+    }
+
+    return Memory;
+}
+
+int fee_spsc_ring_create(size_t Capacity, fee_spsc_ring_t **Ring)
+{
+    fee_spsc_ring_t *NewRing;
+
+    if (Capacity == 0 || Ring == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    NewRing = AlignedAlloc(sizeof(fee_spsc_ring_t));
+    if (NewRing == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(NewRing, 0, sizeof(fee_spsc_ring_t));
+    NewRing->Capacity = RoundUpPowerOfTwo(Capacity);
+    NewRing->Mask = NewRing->Capacity - 1;
+    NewRing->Slots = AlignedAlloc(NewRing->Capacity * sizeof(fee_packet_desc_t));
+    if (NewRing->Slots == NULL)
+    {
+        free(NewRing);
+        return FEE_EXIT_ERROR;
+    }
+
+    atomic_init(&NewRing->Head, 0);
+    atomic_init(&NewRing->Tail, 0);
+
+    *Ring = NewRing;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_spsc_ring_destroy(fee_spsc_ring_t *Ring)
+{
+    if (Ring == NULL)
+    {
+        return;
+    }
+
+    free(Ring->Slots);
+    free(Ring);
+}
+
+size_t fee_spsc_ring_push(fee_spsc_ring_t *Ring, const fee_packet_desc_t *Descs, size_t NumDescs)
+{
+    size_t Head = atomic_load_explicit(&Ring->Head, memory_order_relaxed);
+    size_t Free = Ring->Capacity - (Head - Ring->CachedTail);
+    size_t i;
+
+    /*Only read the consumer index (and its cache line) when the cached one says the ring is full*/
+    if (Free < NumDescs)
+    {
+        Ring->CachedTail = atomic_load_explicit(&Ring->Tail, memory_order_acquire);
+        Free = Ring->Capacity - (Head - Ring->CachedTail);
+    }
+
+    if (NumDescs > Free)
+    {
+        NumDescs = Free;
+    }
+
+    for (i = 0; i < NumDescs; i++)
+    {
+        Ring->Slots[(Head + i) & Ring->Mask] = Descs[i];
+    }
+
+    atomic_store_explicit(&Ring->Head, Head + NumDescs, memory_order_release);
+
+    return NumDescs;
+}
+
+size_t fee_spsc_ring_pop(fee_spsc_ring_t *Ring, fee_packet_desc_t *Descs, size_t MaxDescs)
+{
+    size_t Tail = atomic_load_explicit(&Ring->Tail, memory_order_relaxed);
+    size_t Available = Ring->CachedHead - Tail;
+    size_t i;
+
+    /*Only read the producer index (and its cache line) when the cached one says the ring is empty*/
+    if (Available < MaxDescs)
+    {
+        Ring->CachedHead = atomic_load_explicit(&Ring->Head, memory_order_acquire);
+        Available = Ring->CachedHead - Tail;
+    }
+
+    if (MaxDescs > Available)
+    {
+        MaxDescs = Available;
+    }
+
+    for (i = 0; i < MaxDescs; i++)
+    {
+        Descs[i] = Ring->Slots[(Tail + i) & Ring->Mask];
+    }
+
+    atomic_store_explicit(&Ring->Tail, Tail + MaxDescs, memory_order_release);
+
+    return MaxDescs;
+}
+
+int fee_buffer_pool_create(size_t NumBuffers, size_t BufferBytes, fee_buffer_pool_t **Pool)
+{
+    fee_buffer_pool_t *NewPool;
+    size_t i;
+
+    if (NumBuffers == 0 || BufferBytes == 0 || Pool == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    NewPool = AlignedAlloc(sizeof(fee_buffer_pool_t));
+    if (NewPool == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(NewPool, 0, sizeof(fee_buffer_pool_t));
+    NewPool->NumBuffers = NumBuffers;
+    NewPool->Capacity = RoundUpPowerOfTwo(NumBuffers);
+    NewPool->Mask = NewPool->Capacity - 1;
+    NewPool->BufferBytes = (BufferBytes + FEE_CACHE_LINE_BYTES - 1) / FEE_CACHE_LINE_BYTES * FEE_CACHE_LINE_BYTES;
+    NewPool->FreeIndexes = malloc(NewPool->Capacity * sizeof(size_t));
+    NewPool->InUse = malloc(NumBuffers * sizeof(atomic_uchar));
+    NewPool->Memory = AlignedAlloc(NewPool->BufferBytes * NumBuffers);
+
+    if (NewPool->FreeIndexes == NULL || NewPool->InUse == NULL || NewPool->Memory == NULL)
+    {
+        fee_buffer_pool_destroy(NewPool);
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Every buffer is free at the beginning*/
+    for (i = 0; i < NumBuffers; i++)
+    {
+        NewPool->FreeIndexes[i] = i;
+        atomic_init(&NewPool->InUse[i], 0);
+    }
+    atomic_init(&NewPool->FreeTail, 0);
+    atomic_init(&NewPool->FreeHead, NumBuffers);
+
+    *Pool = NewPool;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_buffer_pool_destroy(fee_buffer_pool_t *Pool)
+{
+    if (Pool == NULL)
+    {
+        return;
+    }
+
+    free(Pool->FreeIndexes);
+    free(Pool->InUse);
+    free(Pool->Memory);
+    free(Pool);
+}
+
+int fee_buffer_pool_acquire(fee_buffer_pool_t *Pool, uint8_t **Buffer, size_t *BufferIndex)
+{
+    size_t Tail = atomic_load_explicit(&Pool->FreeTail, memory_order_relaxed);
+    size_t Head = atomic_load_explicit(&Pool->FreeHead, memory_order_acquire);
+
+    if (Head == Tail)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    *BufferIndex = Pool->FreeIndexes[Tail & Pool->Mask];
+    *Buffer = Pool->Memory + *BufferIndex * Pool->BufferBytes;
+    atomic_store_explicit(&Pool->InUse[*BufferIndex], 1, memory_order_relaxed);
+
+    atomic_store_explicit(&Pool->FreeTail, Tail + 1, memory_order_release);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_buffer_pool_release(fee_buffer_pool_t *Pool, size_t BufferIndex)
+{
+    size_t Head = atomic_load_explicit(&Pool->FreeHead, memory_order_relaxed);
+    size_t Tail = atomic_load_explicit(&Pool->FreeTail, memory_order_acquire);
+
+    if (BufferIndex >= Pool->NumBuffers || Head - Tail >= Pool->NumBuffers)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Only acquired buffers can be released, so a buffer released twice is never handed out twice*/
+    if (!atomic_exchange_explicit(&Pool->InUse[BufferIndex], 0, memory_order_relaxed))
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Pool->FreeIndexes[Head & Pool->Mask] = BufferIndex;
+
+    atomic_store_explicit(&Pool->FreeHead, Head + 1, memory_order_release);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+uint8_t *fee_buffer_pool_buffer(fee_buffer_pool_t *Pool, size_t BufferIndex)
+{
+    if (BufferIndex >= Pool->NumBuffers)
+    {
+        return NULL;
+    }
+
+    return Pool->Memory + BufferIndex * Pool->BufferBytes;
+}
+
+size_t fee_buffer_pool_buffer_bytes(const fee_buffer_pool_t *Pool)
+{
+    return Pool->BufferBytes;
+}
+
+int fee_pipeline_stage_checksum(fee_packet_desc_t *Desc, void *StageData)
+{
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+
+    (void)StageData;
+
+    if (Desc->Type == FEE_PACKET_TM)
+    {
+        if (Desc->PacketBytes < TM_PACKET_BYTES)
+        {
+            return FEE_EXIT_ERROR;
+        }
+
+        return fee_CheckTelemetryChecksum(Desc->Packet);
+    }
+
+    if (Desc->Type == FEE_PACKET_PTD)
+    {
+        if (fee_Calculate_PTD_Sizes(Desc->TM, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS ||
+            PTDSizes.DataPacketTotalBytes < PTD_CHECKSUM_BYTES ||
+            Desc->PacketBytes < PTDSizes.DataPacketTotalBytes)
+        {
+            return FEE_EXIT_ERROR;
+        }
+
+        return fee_CheckPTDChecksum(Desc->Packet, PTDSizes);
+    }
+
+    return FEE_EXIT_ERROR;
+}
+
+int fee_pipeline_stage_decode(fee_packet_desc_t *Desc, void *StageData)
+{
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+
+    (void)StageData;
+
+    if (Desc->Type == FEE_PACKET_TM)
+    {
+        if (Desc->PacketBytes < TM_PACKET_BYTES)
+        {
+            return FEE_EXIT_ERROR;
+        }
+
+        return fee_TM_Read(Desc->Packet, &Desc->TM);
+    }
+
+    if (Desc->Type == FEE_PACKET_PTD)
+    {
+        /*The length is checked before reading, as the stage may be used without the checksum stage*/
+        if (fee_Calculate_PTD_Sizes(Desc->TM, &PTDSizes, &ImageMatrixSizes) != FEE_EXIT_SUCCESS ||
+            Desc->PacketBytes < PTDSizes.DataPacketTotalBytes)
+        {
+            return FEE_EXIT_ERROR;
+        }
+
+        return fee_PTD_Read(Desc->Packet, Desc->TM, &Desc->PTD);
+    }
+
+    return FEE_EXIT_ERROR;
+}
+
+/**
+ * @brief Thread of a stage. It pops a batch of descriptors from the input ring, runs the stage over them and
+ *  pushes them to the output ring, until the pipeline is stopped.
+ */
+static void *PipelineStageThread(void *Arg)
+{
+    PipelineStage_t *Stage = Arg;
+    fee_pipeline_t *Pipeline = Stage->Pipeline;
+    unsigned int IdleRounds = 0;
+    size_t NumDescs, Pushed, i;
+
+    while (!atomic_load_explicit(&Pipeline->Stop, memory_order_acquire))
+    {
+        NumDescs = fee_spsc_ring_pop(Stage->Input, Stage->Batch, Pipeline->BatchSize);
+        if (NumDescs == 0)
+        {
+            PipelineBackoff(&IdleRounds);
+            continue;
+        }
+        IdleRounds = 0;
+
+        for (i = 0; i < NumDescs; i++)
+        {
+            if (Stage->Batch[i].Status == FEE_EXIT_SUCCESS)
+            {
+                Stage->Batch[i].Status = Stage->Stage.Process(&Stage->Batch[i], Stage->Stage.StageData);
+            }
+        }
+
+        /*Wait for room in the next ring. It only happens when the next stage falls behind*/
+        Pushed = 0;
+        while (Pushed < NumDescs)
+        {
+            Pushed += fee_spsc_ring_push(Stage->Output, Stage->Batch + Pushed, NumDescs - Pushed);
+            if (Pushed < NumDescs)
+            {
+                if (atomic_load_explicit(&Pipeline->Stop, memory_order_acquire))
+                {
+                    return NULL;
+                }
+                PipelineBackoff(&IdleRounds);
+            }
+        }
+        IdleRounds = 0;
+    }
+
+    return NULL;
+}
+
+int fee_pipeline_create(const fee_pipeline_config_t *Config, fee_pipeline_t **Pipeline)
+{
+    fee_pipeline_t *NewPipeline;
+    size_t i;
+
+    if (Config == NULL || Pipeline == NULL || Config->Stages == NULL || Config->NumStages == 0 || Config->RingCapacity == 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (i = 0; i < Config->NumStages; i++)
+    {
+        if (Config->Stages[i].Process == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    NewPipeline = AlignedAlloc(sizeof(fee_pipeline_t));
+    if (NewPipeline == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(NewPipeline, 0, sizeof(fee_pipeline_t));
+    atomic_init(&NewPipeline->Stop, 0);
+    NewPipeline->NumStages = Config->NumStages;
+    NewPipeline->BatchSize = Config->BatchSize ? Config->BatchSize : FEE_PIPELINE_DEFAULT_BATCH;
+    NewPipeline->Rings = calloc(Config->NumStages + 1, sizeof(fee_spsc_ring_t *));
+    NewPipeline->Stages = calloc(Config->NumStages, sizeof(PipelineStage_t));
+
+    if (NewPipeline->Rings == NULL || NewPipeline->Stages == NULL)
+    {
+        fee_pipeline_destroy(NewPipeline);
+        return FEE_EXIT_ERROR;
+    }
+
+    for (i = 0; i < Config->NumStages + 1; i++)
+    {
+        if (fee_spsc_ring_create(Config->RingCapacity, &NewPipeline->Rings[i]) != FEE_EXIT_SUCCESS)
+        {
+            fee_pipeline_destroy(NewPipeline);
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    for (i = 0; i < Config->NumStages; i++)
+    {
+        PipelineStage_t *Stage = &NewPipeline->Stages[i];
+
+        Stage->Pipeline = NewPipeline;
+        Stage->Stage = Config->Stages[i];
+        Stage->Input = NewPipeline->Rings[i];
+        Stage->Output = NewPipeline->Rings[i + 1];
+        Stage->Batch = malloc(NewPipeline->BatchSize * sizeof(fee_packet_desc_t));
+
+        if (Stage->Batch == NULL || pthread_create(&Stage->Thread, NULL, PipelineStageThread, Stage) != 0)
+        {
+            fee_pipeline_destroy(NewPipeline);
+            return FEE_EXIT_ERROR;
+        }
+        Stage->Started = 1;
+    }
+
+    *Pipeline = NewPipeline;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_pipeline_destroy(fee_pipeline_t *Pipeline)
+{
+    size_t i;
+
+    if (Pipeline == NULL)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&Pipeline->Stop, 1, memory_order_release);
+
+    if (Pipeline->Stages != NULL)
+    {
+        for (i = 0; i < Pipeline->NumStages; i++)
+        {
+            if (Pipeline->Stages[i].Started)
+            {
+                pthread_join(Pipeline->Stages[i].Thread, NULL);
+            }
+            free(Pipeline->Stages[i].Batch);
+        }
+    }
+
+    if (Pipeline->Rings != NULL)
+    {
+        for (i = 0; i < Pipeline->NumStages + 1; i++)
+        {
+            fee_spsc_ring_destroy(Pipeline->Rings[i]);
+        }
+    }
+
+    free(Pipeline->Stages);
+    free(Pipeline->Rings);
+    free(Pipeline);
+}
+
+size_t fee_pipeline_submit(fee_pipeline_t *Pipeline, const fee_packet_desc_t *Descs, size_t NumDescs)
+{
+    return fee_spsc_ring_push(Pipeline->Rings[0], Descs, NumDescs);
+}
+
+size_t fee_pipeline_receive(fee_pipeline_t *Pipeline, fee_packet_desc_t *Descs, size_t MaxDescs)
+{
+    return fee_spsc_ring_pop(Pipeline->Rings[Pipeline->NumStages], Descs, MaxDescs);
+}
@@ -0,0 +1,291 @@
+/**
+ * @file fee_queue.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library bounded frame queue functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <fee.h>
+#include <fee_queue.h>
+
+struct fee_frame_queue
+{
+    fee_frame_queue_config_t Config;
+    fee_packet_desc_t *Slots; /*Circular buffer of Config.Capacity frames*/
+    size_t Head;              /*Slot of the oldest frame*/
+    size_t Pressure;          /*Frames pushed since the decimation threshold was reached (FEE_QUEUE_DECIMATE)*/
+    int Closed;
+    fee_frame_queue_counters_t Counters;
+
+    pthread_mutex_t Lock;
+    pthread_cond_t NotEmpty;
+    pthread_cond_t NotFull;
+};
+
+static uint64_t MonotonicNanoseconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*Remove the oldest frame. The lock must be held and the queue must not be empty*/
+static void TakeOldest(fee_frame_queue_t *Queue, fee_packet_desc_t *Frame)
+{
+    *Frame = Queue->Slots[Queue->Head];
+    Queue->Head = (Queue->Head + 1) % Queue->Config.Capacity;
+    Queue->Counters.Depth--;
+}
+
+/*Decide whether a pushed frame is queued. The lock must be held. DroppedFrame is set if a queued frame is dropped*/
+static int AdmitFrame(fee_frame_queue_t *Queue, fee_packet_desc_t *DroppedFrame, int *Dropped)
+{
+    int Full = Queue->Counters.Depth == Queue->Config.Capacity;
+
+    switch (Queue->Config.Policy)
+    {
+    case FEE_QUEUE_DROP_OLDEST:
+        if (Full)
+        {
+            TakeOldest(Queue, DroppedFrame);
+            *Dropped = 1;
+            Queue->Counters.DroppedOldest++;
+        }
+        return 1;
+
+    case FEE_QUEUE_DECIMATE:
+        if (Queue->Counters.Depth < Queue->Config.DecimationThreshold)
+        {
+            Queue->Pressure = 0;
+        }
+        else if (Queue->Pressure++ % Queue->Config.DecimationFactor != 0)
+        {
+            Queue->Counters.Decimated++;
+            return 0;
+        }
+        /*Fall through*/
+    case FEE_QUEUE_DROP_NEWEST:
+        if (Full)
+        {
+            Queue->Counters.DroppedNewest++;
+            return 0;
+        }
+        return 1;
+
+    default:
+        return 1;
+    }
+}
+
+int fee_frame_queue_create(const fee_frame_queue_config_t *Config, fee_frame_queue_t **Queue)
+{
+    fee_frame_queue_t *NewQueue;
+
+    if (Config == NULL || Queue == NULL || Config->Capacity == 0 || fee_frame_queue_policy_name(Config->Policy) == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    NewQueue = calloc(1, sizeof(fee_frame_queue_t));
+    if (NewQueue == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    NewQueue->Config = *Config;
+    if (NewQueue->Config.DecimationFactor == 0)
+    {
+        NewQueue->Config.DecimationFactor = FEE_QUEUE_DEFAULT_DECIMATION;
+    }
+    if (NewQueue->Config.DecimationThreshold == 0 || NewQueue->Config.DecimationThreshold > Config->Capacity)
+    {
+        NewQueue->Config.DecimationThreshold = (Config->Capacity + 1) / 2;
+    }
+
+    NewQueue->Slots = calloc(Config->Capacity, sizeof(fee_packet_desc_t));
+    if (NewQueue->Slots == NULL)
+    {
+        free(NewQueue);
+        return FEE_EXIT_ERROR;
+    }
+
+    pthread_mutex_init(&NewQueue->Lock, NULL);
+    pthread_cond_init(&NewQueue->NotEmpty, NULL);
+    pthread_cond_init(&NewQueue->NotFull, NULL);
+
+    *Queue = NewQueue;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_frame_queue_destroy(fee_frame_queue_t *Queue)
+{
+    fee_packet_desc_t Frame;
+
+    if (Queue == NULL)
+    {
+        return;
+    }
+
+    while (Queue->Counters.Depth > 0)
+    {
+        TakeOldest(Queue, &Frame);
+        if (Queue->Config.Release != NULL)
+        {
+            Queue->Config.Release(Queue->Config.ReleaseData, &Frame);
+        }
+    }
+
+    pthread_cond_destroy(&Queue->NotEmpty);
+    pthread_cond_destroy(&Queue->NotFull);
+    pthread_mutex_destroy(&Queue->Lock);
+    free(Queue->Slots);
+    free(Queue);
+}
+
+int fee_frame_queue_push(fee_frame_queue_t *Queue, const fee_packet_desc_t *Frame, int *Accepted)
+{
+    fee_packet_desc_t DroppedFrame;
+    fee_packet_desc_t RejectedFrame = *Frame;
+    int Dropped = 0, Admitted;
+    uint64_t WaitStart;
+
+    pthread_mutex_lock(&Queue->Lock);
+
+    if (Queue->Config.Policy == FEE_QUEUE_BLOCK && !Queue->Closed && Queue->Counters.Depth == Queue->Config.Capacity)
+    {
+        WaitStart = MonotonicNanoseconds();
+        while (!Queue->Closed && Queue->Counters.Depth == Queue->Config.Capacity)
+        {
+            pthread_cond_wait(&Queue->NotFull, &Queue->Lock);
+        }
+        Queue->Counters.BlockedPushes++;
+        Queue->Counters.BlockedNanoseconds += MonotonicNanoseconds() - WaitStart;
+    }
+
+    if (Queue->Closed)
+    {
+        pthread_mutex_unlock(&Queue->Lock);
+        return FEE_EXIT_ERROR;
+    }
+
+    Queue->Counters.Pushed++;
+    Admitted = AdmitFrame(Queue, &DroppedFrame, &Dropped);
+    if (Admitted)
+    {
+        Queue->Slots[(Queue->Head + Queue->Counters.Depth) % Queue->Config.Capacity] = *Frame;
+        Queue->Counters.Depth++;
+        Queue->Counters.Accepted++;
+        if (Queue->Counters.Depth > Queue->Counters.HighWatermark)
+        {
+            Queue->Counters.HighWatermark = Queue->Counters.Depth;
+        }
+        pthread_cond_signal(&Queue->NotEmpty);
+    }
+
+    pthread_mutex_unlock(&Queue->Lock);
+
+    /*Dropped frames are released out of the lock*/
+    if (Queue->Config.Release != NULL)
+    {
+        if (Dropped)
+        {
+            Queue->Config.Release(Queue->Config.ReleaseData, &DroppedFrame);
+        }
+        if (!Admitted)
+        {
+            Queue->Config.Release(Queue->Config.ReleaseData, &RejectedFrame);
+        }
+    }
+
+    if (Accepted != NULL)
+    {
+        *Accepted = Admitted;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_frame_queue_pop(fee_frame_queue_t *Queue, fee_packet_desc_t *Frame)
+{
+    pthread_mutex_lock(&Queue->Lock);
+
+    while (Queue->Counters.Depth == 0 && !Queue->Closed)
+    {
+        pthread_cond_wait(&Queue->NotEmpty, &Queue->Lock);
+    }
+
+    if (Queue->Counters.Depth == 0)
+    {
+        pthread_mutex_unlock(&Queue->Lock);
+        return FEE_EXIT_ERROR;
+    }
+
+    TakeOldest(Queue, Frame);
+    Queue->Counters.Popped++;
+    pthread_cond_signal(&Queue->NotFull);
+    pthread_mutex_unlock(&Queue->Lock);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_frame_queue_try_pop(fee_frame_queue_t *Queue, fee_packet_desc_t *Frame)
+{
+    pthread_mutex_lock(&Queue->Lock);
+
+    if (Queue->Counters.Depth == 0)
+    {
+        pthread_mutex_unlock(&Queue->Lock);
+        return FEE_EXIT_ERROR;
+    }
+
+    TakeOldest(Queue, Frame);
+    Queue->Counters.Popped++;
+    pthread_cond_signal(&Queue->NotFull);
+    pthread_mutex_unlock(&Queue->Lock);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_frame_queue_close(fee_frame_queue_t *Queue)
+{
+    pthread_mutex_lock(&Queue->Lock);
+    Queue->Closed = 1;
+    pthread_cond_broadcast(&Queue->NotEmpty);
+    pthread_cond_broadcast(&Queue->NotFull);
+    pthread_mutex_unlock(&Queue->Lock);
+}
+
+void fee_frame_queue_counters(fee_frame_queue_t *Queue, fee_frame_queue_counters_t *Counters)
+{
+    pthread_mutex_lock(&Queue->Lock);
+    *Counters = Queue->Counters;
+    pthread_mutex_unlock(&Queue->Lock);
+}
+
+const char *fee_frame_queue_policy_name(fee_queue_policy_t Policy)
+{
+    switch (Policy)
+    {
+    case FEE_QUEUE_BLOCK:
+        return "block";
+    case FEE_QUEUE_DROP_OLDEST:
+        return "drop-oldest";
+    case FEE_QUEUE_DROP_NEWEST:
+        return "drop-newest";
+    case FEE_QUEUE_DECIMATE:
+        return "decimate";
+    default:
+        return NULL;
+    }
+}
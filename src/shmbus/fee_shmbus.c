@@ -0,0 +1,521 @@
+/**
+ * @file fee_shmbus.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library shared-memory frame bus functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fee.h>
+#include <fee_shmbus.h>
+#include <fee_pipeline.h>
+
+/*"FEESHMBS" in ASCII*/
+#define SHMBUS_MAGIC 0x53424D4853454546ULL
+
+/*Sequence of the slots that have never been published*/
+#define SHMBUS_NO_SEQUENCE UINT64_MAX
+
+#define ROUND_UP_CACHE_LINE(Bytes) (((Bytes) + FEE_CACHE_LINE_BYTES - 1) / FEE_CACHE_LINE_BYTES * FEE_CACHE_LINE_BYTES)
+
+/*Shared state of a reader. Only its own process writes it, except fee_shmbus_evict*/
+typedef struct
+{
+    _Alignas(FEE_CACHE_LINE_BYTES) _Atomic uint64_t Cursor; /*Sequence of the next frame to be released*/
+    _Atomic int32_t Pid;                                     /*Process of the reader, for diagnosis*/
+
+} ShmBusReader_t;
+
+/*Beginning of the shared memory. Every offset is relative to it, as each process maps it at its own address*/
+typedef struct
+{
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t NumSlots;
+    uint64_t PlaneBytes;
+    uint64_t SlotBytes;
+    uint64_t SlotsOffset;
+    uint64_t TotalBytes;
+
+    _Alignas(FEE_CACHE_LINE_BYTES) _Atomic uint64_t WriteSequence; /*Sequence of the next published frame*/
+    _Atomic uint64_t Busy;
+    _Alignas(FEE_CACHE_LINE_BYTES) _Atomic uint64_t ActiveReaders; /*Bit of every attached reader*/
+    ShmBusReader_t Readers[FEE_SHMBUS_MAX_READERS];
+
+} ShmBusHeader_t;
+
+/*Header of a slot. The planes of every CCD follow it, PlaneBytes apart*/
+typedef struct
+{
+    _Alignas(FEE_CACHE_LINE_BYTES) _Atomic uint64_t Sequence;
+    _Atomic uint64_t ReaderMask; /*Bit of every reader that has not released the frame yet*/
+    fee_TM_t TM;
+    uint32_t PIXEL_DATA_COUNTER;
+    uint16_t VOLTAGES_REFERENCES[4];
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t PTDImageMatrixTotalSizes;
+
+} ShmBusSlot_t;
+
+struct fee_shmbus
+{
+    ShmBusHeader_t *Header;
+    int Fd;
+    char *Name;        /*Name to be unlinked. NULL for a memfd*/
+    int Reserved;      /*A slot has been reserved and not committed*/
+    uint64_t Sequence; /*Sequence of the reserved slot*/
+};
+
+struct fee_shmbus_reader
+{
+    ShmBusHeader_t *Header;
+    int Fd;
+    uint32_t Id;
+    uint64_t Bit;
+    uint64_t Cursor;
+    int Reading; /*The frame of Cursor has been read and not released*/
+};
+
+static ShmBusSlot_t *GetSlot(ShmBusHeader_t *Header, uint64_t Sequence)
+{
+    return (ShmBusSlot_t *)((uint8_t *)Header + Header->SlotsOffset + (Sequence % Header->NumSlots) * Header->SlotBytes);
+}
+
+static uint16_t *GetPlane(ShmBusHeader_t *Header, ShmBusSlot_t *Slot, int CCD)
+{
+    return (uint16_t *)((uint8_t *)Slot + ROUND_UP_CACHE_LINE(sizeof(ShmBusSlot_t)) + (size_t)CCD * Header->PlaneBytes);
+}
+
+/*Remove the references of a reader from every slot. Its active bit must be clear, so that no new slot gets it*/
+static void ClearReaderBit(ShmBusHeader_t *Header, uint64_t Bit)
+{
+    uint32_t i;
+
+    for (i = 0; i < Header->NumSlots; i++)
+    {
+        atomic_fetch_and(&GetSlot(Header, i)->ReaderMask, ~Bit);
+    }
+}
+
+int fee_shmbus_create(const char *Name, const fee_shmbus_config_t *Config, fee_shmbus_t **Bus)
+{
+    fee_shmbus_t *NewBus;
+    ShmBusHeader_t *Header;
+    uint64_t PlaneBytes, SlotBytes, SlotsOffset, TotalBytes;
+    uint32_t i;
+
+    if (Config == NULL || Bus == NULL || Config->NumSlots == 0 || Config->PlaneBytes == 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    PlaneBytes = ROUND_UP_CACHE_LINE(Config->PlaneBytes);
+    SlotBytes = ROUND_UP_CACHE_LINE(sizeof(ShmBusSlot_t)) + FEE_NUM_CCD * PlaneBytes;
+    SlotsOffset = ROUND_UP_CACHE_LINE(sizeof(ShmBusHeader_t));
+    TotalBytes = SlotsOffset + (uint64_t)Config->NumSlots * SlotBytes;
+
+    NewBus = calloc(1, sizeof(fee_shmbus_t));
+    if (NewBus == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*The name is only kept (and unlinked) once this bus has created it*/
+    if (Name != NULL)
+    {
+        NewBus->Fd = shm_open(Name, O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (NewBus->Fd >= 0 && (NewBus->Name = strdup(Name)) == NULL)
+        {
+            shm_unlink(Name);
+            close(NewBus->Fd);
+            NewBus->Fd = -1;
+        }
+    }
+    else
+    {
+        NewBus->Fd = memfd_create("fee_shmbus", MFD_CLOEXEC);
+    }
+
+    if (NewBus->Fd < 0 || ftruncate(NewBus->Fd, (off_t)TotalBytes) != 0 ||
+        (Header = mmap(NULL, TotalBytes, PROT_READ | PROT_WRITE, MAP_SHARED, NewBus->Fd, 0)) == MAP_FAILED)
+    {
+        fee_shmbus_destroy(NewBus);
+        return FEE_EXIT_ERROR;
+    }
+    NewBus->Header = Header;
+
+    /*The memory is zeroed by ftruncate*/
+    Header->Version = FEE_SHMBUS_VERSION;
+    Header->NumSlots = Config->NumSlots;
+    Header->PlaneBytes = PlaneBytes;
+    Header->SlotBytes = SlotBytes;
+    Header->SlotsOffset = SlotsOffset;
+    Header->TotalBytes = TotalBytes;
+    for (i = 0; i < Config->NumSlots; i++)
+    {
+        atomic_store(&GetSlot(Header, i)->Sequence, SHMBUS_NO_SEQUENCE);
+    }
+    atomic_store(&Header->WriteSequence, 0);
+    /*Readers check the magic last*/
+    atomic_thread_fence(memory_order_release);
+    Header->Magic = SHMBUS_MAGIC;
+
+    *Bus = NewBus;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_shmbus_destroy(fee_shmbus_t *Bus)
+{
+    if (Bus == NULL)
+    {
+        return;
+    }
+
+    if (Bus->Header != NULL)
+    {
+        munmap(Bus->Header, Bus->Header->TotalBytes);
+    }
+    if (Bus->Fd >= 0)
+    {
+        close(Bus->Fd);
+    }
+    if (Bus->Name != NULL)
+    {
+        shm_unlink(Bus->Name);
+        free(Bus->Name);
+    }
+    free(Bus);
+}
+
+int fee_shmbus_fd(const fee_shmbus_t *Bus)
+{
+    return Bus->Fd;
+}
+
+int fee_shmbus_reserve(fee_shmbus_t *Bus, const fee_TM_t *TM, fee_PTD_t *PTD)
+{
+    ShmBusHeader_t *Header = Bus->Header;
+    ShmBusSlot_t *Slot;
+    uint64_t Sequence = atomic_load_explicit(&Header->WriteSequence, memory_order_relaxed);
+    int k;
+
+    if (fee_Calculate_PTD_Sizes(*TM, &PTD->PTDSizes, &PTD->PTDImageMatrixTotalSizes) != FEE_EXIT_SUCCESS ||
+        PTD->PTDImageMatrixTotalSizes.ImageMatrixBytes > Header->PlaneBytes)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*The releases of the readers are acquired before the planes are overwritten*/
+    Slot = GetSlot(Header, Sequence);
+    if (atomic_load_explicit(&Slot->ReaderMask, memory_order_acquire) != 0)
+    {
+        atomic_fetch_add_explicit(&Header->Busy, 1, memory_order_relaxed);
+        return FEE_EXIT_ERROR;
+    }
+
+    Slot->TM = *TM;
+    for (k = 0; k < FEE_NUM_CCD; k++)
+    {
+        PTD->ImageMatrix[k] = GetPlane(Header, Slot, k);
+    }
+    Bus->Reserved = 1;
+    Bus->Sequence = Sequence;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_shmbus_commit(fee_shmbus_t *Bus, const fee_PTD_t *PTD)
+{
+    ShmBusHeader_t *Header = Bus->Header;
+    ShmBusSlot_t *Slot;
+    uint64_t Active, StillActive;
+
+    if (!Bus->Reserved)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Slot = GetSlot(Header, Bus->Sequence);
+    if (PTD->ImageMatrix[0] != GetPlane(Header, Slot, 0))
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Slot->PIXEL_DATA_COUNTER = PTD->PIXEL_DATA_COUNTER;
+    memcpy(Slot->VOLTAGES_REFERENCES, PTD->VOLTAGES_REFERENCES, sizeof(Slot->VOLTAGES_REFERENCES));
+    Slot->PTDSizes = PTD->PTDSizes;
+    Slot->PTDImageMatrixTotalSizes = PTD->PTDImageMatrixTotalSizes;
+    atomic_store_explicit(&Slot->Sequence, Bus->Sequence, memory_order_relaxed);
+
+    /*Readers that detach meanwhile have cleared their bit in the slots or are cleared here*/
+    Active = atomic_load(&Header->ActiveReaders);
+    atomic_store(&Slot->ReaderMask, Active);
+    StillActive = atomic_load(&Header->ActiveReaders);
+    if ((Active & ~StillActive) != 0)
+    {
+        atomic_fetch_and(&Slot->ReaderMask, StillActive);
+    }
+
+    atomic_store_explicit(&Header->WriteSequence, Bus->Sequence + 1, memory_order_release);
+    Bus->Reserved = 0;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_shmbus_publish(fee_shmbus_t *Bus, const fee_TM_t *TM, const fee_PTD_t *PTD)
+{
+    fee_PTD_t Slot;
+    int k;
+
+    if (fee_shmbus_reserve(Bus, TM, &Slot) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (k = 0; k < FEE_NUM_CCD; k++)
+    {
+        memcpy(Slot.ImageMatrix[k], PTD->ImageMatrix[k], Slot.PTDImageMatrixTotalSizes.ImageMatrixBytes);
+    }
+    Slot.PIXEL_DATA_COUNTER = PTD->PIXEL_DATA_COUNTER;
+    memcpy(Slot.VOLTAGES_REFERENCES, PTD->VOLTAGES_REFERENCES, sizeof(Slot.VOLTAGES_REFERENCES));
+
+    return fee_shmbus_commit(Bus, &Slot);
+}
+
+int fee_shmbus_evict(fee_shmbus_t *Bus, uint32_t ReaderId)
+{
+    uint64_t Bit;
+
+    if (ReaderId >= FEE_SHMBUS_MAX_READERS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Bit = 1ULL << ReaderId;
+    if ((atomic_fetch_and(&Bus->Header->ActiveReaders, ~Bit) & Bit) == 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    ClearReaderBit(Bus->Header, Bit);
+    atomic_store(&Bus->Header->Readers[ReaderId].Pid, 0);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_shmbus_counters(const fee_shmbus_t *Bus, fee_shmbus_counters_t *Counters)
+{
+    ShmBusHeader_t *Header = Bus->Header;
+    uint64_t Active = atomic_load(&Header->ActiveReaders);
+    uint64_t Cursor;
+    uint32_t i;
+
+    memset(Counters, 0, sizeof(fee_shmbus_counters_t));
+    Counters->Published = atomic_load(&Header->WriteSequence);
+    Counters->Busy = atomic_load(&Header->Busy);
+
+    for (i = 0; i < FEE_SHMBUS_MAX_READERS; i++)
+    {
+        if (Active & (1ULL << i))
+        {
+            Counters->ActiveReaders++;
+            Cursor = atomic_load(&Header->Readers[i].Cursor);
+            if (Cursor < Counters->Published && Counters->Published - Cursor > Counters->MaxLag)
+            {
+                Counters->MaxLag = Counters->Published - Cursor;
+            }
+        }
+    }
+}
+
+int fee_shmbus_attach(const char *Name, fee_shmbus_reader_t **Reader)
+{
+    int Fd, Status;
+
+    if (Name == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Fd = shm_open(Name, O_RDWR, 0);
+    if (Fd < 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Status = fee_shmbus_attach_fd(Fd, Reader);
+    close(Fd);
+
+    return Status;
+}
+
+int fee_shmbus_attach_fd(int Fd, fee_shmbus_reader_t **Reader)
+{
+    fee_shmbus_reader_t *NewReader;
+    ShmBusHeader_t *Header;
+    ShmBusSlot_t *Slot;
+    struct stat Stat;
+    uint64_t Active, Mask;
+    uint32_t Id, i;
+
+    if (Reader == NULL || fstat(Fd, &Stat) != 0 || (size_t)Stat.st_size < sizeof(ShmBusHeader_t))
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Header = mmap(NULL, (size_t)Stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    if (Header == MAP_FAILED)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    if (Header->Magic != SHMBUS_MAGIC || Header->Version != FEE_SHMBUS_VERSION || Header->TotalBytes > (uint64_t)Stat.st_size)
+    {
+        munmap(Header, (size_t)Stat.st_size);
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Take the lowest free reader*/
+    Active = atomic_load(&Header->ActiveReaders);
+    do
+    {
+        if (Active == UINT64_MAX)
+        {
+            munmap(Header, (size_t)Stat.st_size);
+            return FEE_EXIT_ERROR;
+        }
+        Id = (uint32_t)__builtin_ctzll(~Active);
+    } while (!atomic_compare_exchange_weak(&Header->ActiveReaders, &Active, Active | (1ULL << Id)));
+
+    NewReader = calloc(1, sizeof(fee_shmbus_reader_t));
+    if (NewReader == NULL || (NewReader->Fd = dup(Fd)) < 0)
+    {
+        atomic_fetch_and(&Header->ActiveReaders, ~(1ULL << Id));
+        free(NewReader);
+        munmap(Header, (size_t)Stat.st_size);
+        return FEE_EXIT_ERROR;
+    }
+
+    NewReader->Header = Header;
+    NewReader->Id = Id;
+    NewReader->Bit = 1ULL << Id;
+    NewReader->Cursor = atomic_load(&Header->WriteSequence);
+    atomic_store(&Header->Readers[Id].Cursor, NewReader->Cursor);
+    atomic_store(&Header->Readers[Id].Pid, (int32_t)getpid());
+
+    /*Frames published before the cursor may have taken the bit while it was being set*/
+    for (i = 0; i < Header->NumSlots; i++)
+    {
+        Slot = GetSlot(Header, i);
+        Mask = atomic_load(&Slot->ReaderMask);
+        if ((Mask & NewReader->Bit) != 0 && atomic_load(&Slot->Sequence) < NewReader->Cursor)
+        {
+            atomic_fetch_and(&Slot->ReaderMask, ~NewReader->Bit);
+        }
+    }
+
+    *Reader = NewReader;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_shmbus_detach(fee_shmbus_reader_t *Reader)
+{
+    ShmBusHeader_t *Header;
+
+    if (Reader == NULL)
+    {
+        return;
+    }
+
+    Header = Reader->Header;
+    if (atomic_fetch_and(&Header->ActiveReaders, ~Reader->Bit) & Reader->Bit)
+    {
+        ClearReaderBit(Header, Reader->Bit);
+        atomic_store(&Header->Readers[Reader->Id].Pid, 0);
+    }
+
+    munmap(Header, Header->TotalBytes);
+    close(Reader->Fd);
+    free(Reader);
+}
+
+uint32_t fee_shmbus_reader_id(const fee_shmbus_reader_t *Reader)
+{
+    return Reader->Id;
+}
+
+int fee_shmbus_read(fee_shmbus_reader_t *Reader, fee_TM_t *TM, fee_PTD_t *PTD, uint64_t *Sequence)
+{
+    ShmBusHeader_t *Header = Reader->Header;
+    uint64_t WriteSequence = atomic_load_explicit(&Header->WriteSequence, memory_order_acquire);
+    ShmBusSlot_t *Slot = NULL;
+    int k;
+
+    /*Skip the frames published without the bit of the reader*/
+    while (!Reader->Reading && Reader->Cursor < WriteSequence)
+    {
+        Slot = GetSlot(Header, Reader->Cursor);
+        if ((atomic_load_explicit(&Slot->ReaderMask, memory_order_acquire) & Reader->Bit) != 0 &&
+            atomic_load_explicit(&Slot->Sequence, memory_order_relaxed) == Reader->Cursor)
+        {
+            Reader->Reading = 1;
+            break;
+        }
+        Reader->Cursor++;
+    }
+    atomic_store_explicit(&Header->Readers[Reader->Id].Cursor, Reader->Cursor, memory_order_relaxed);
+
+    if (!Reader->Reading)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Slot = GetSlot(Header, Reader->Cursor);
+    if (TM != NULL)
+    {
+        *TM = Slot->TM;
+    }
+    PTD->PIXEL_DATA_COUNTER = Slot->PIXEL_DATA_COUNTER;
+    memcpy(PTD->VOLTAGES_REFERENCES, Slot->VOLTAGES_REFERENCES, sizeof(PTD->VOLTAGES_REFERENCES));
+    PTD->PTDSizes = Slot->PTDSizes;
+    PTD->PTDImageMatrixTotalSizes = Slot->PTDImageMatrixTotalSizes;
+    for (k = 0; k < FEE_NUM_CCD; k++)
+    {
+        PTD->ImageMatrix[k] = GetPlane(Header, Slot, k);
+    }
+    if (Sequence != NULL)
+    {
+        *Sequence = Reader->Cursor;
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_shmbus_release(fee_shmbus_reader_t *Reader)
+{
+    if (!Reader->Reading)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    atomic_fetch_and_explicit(&GetSlot(Reader->Header, Reader->Cursor)->ReaderMask, ~Reader->Bit, memory_order_release);
+    Reader->Reading = 0;
+    Reader->Cursor++;
+    atomic_store_explicit(&Reader->Header->Readers[Reader->Id].Cursor, Reader->Cursor, memory_order_relaxed);
+
+    return FEE_EXIT_SUCCESS;
+}
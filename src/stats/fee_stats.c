@@ -0,0 +1,413 @@
+/**
+ * @file fee_stats.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library hot-path statistics. Every thread updates its own block of counters, so the instrumented
+ *  functions do not share cache lines nor take locks. Blocks are linked in a global list that is walked by the
+ *  snapshots, and the counters of finished threads are folded into a retired block.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <string.h>
+#include <fee_stats.h>
+#include "../common/fee_stats_internal.h"
+
+static const char *const StatsOpNames[FEE_STATS_NUM_OPS] = {
+    "fee_TC_Write",
+    "fee_TM_Read",
+    "fee_PTD_Read",
+    "fee_PTD_Write",
+    "fee_Calculate_PTD_Sizes",
+    "fee_CheckTeleCommandChecksum",
+    "fee_CheckTelemetryChecksum",
+    "fee_CheckPTDChecksum",
+};
+
+const char *fee_stats_op_name(fee_stats_op_t Op)
+{
+    if ((unsigned)Op >= FEE_STATS_NUM_OPS)
+    {
+        return NULL;
+    }
+
+    return StatsOpNames[Op];
+}
+
+int fee_stats_bucket_bounds(size_t Bucket, uint64_t *LowerNs, uint64_t *UpperNs)
+{
+    unsigned int Exponent;
+    uint64_t SubBucket;
+
+    if (Bucket >= FEE_STATS_NUM_BUCKETS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*The first buckets are exact*/
+    if (Bucket < FEE_STATS_SUB_BUCKETS)
+    {
+        *LowerNs = Bucket;
+        *UpperNs = Bucket;
+        return FEE_EXIT_SUCCESS;
+    }
+
+    Exponent = (unsigned int)(Bucket / FEE_STATS_SUB_BUCKETS) + FEE_STATS_SUB_BUCKET_BITS - 1;
+    SubBucket = Bucket % FEE_STATS_SUB_BUCKETS;
+
+    *LowerNs = (FEE_STATS_SUB_BUCKETS + SubBucket) << (Exponent - FEE_STATS_SUB_BUCKET_BITS);
+    *UpperNs = *LowerNs + (((uint64_t)1 << (Exponent - FEE_STATS_SUB_BUCKET_BITS)) - 1);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_stats_percentile(const fee_stats_op_snapshot_t *Op, double Fraction, uint64_t *LatencyNs)
+{
+    uint64_t Total = 0, Target, Accumulated = 0, Lower;
+    size_t Bucket;
+
+    if (Fraction < 0.0 || Fraction > 1.0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (Bucket = 0; Bucket < FEE_STATS_NUM_BUCKETS; Bucket++)
+    {
+        Total += Op->Histogram[Bucket];
+    }
+    if (Total == 0)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    /*Rank of the percentile, starting at 1*/
+    Target = (uint64_t)(Fraction * (double)Total + 0.5);
+    if (Target == 0)
+    {
+        Target = 1;
+    }
+
+    for (Bucket = 0; Bucket < FEE_STATS_NUM_BUCKETS; Bucket++)
+    {
+        Accumulated += Op->Histogram[Bucket];
+        if (Accumulated >= Target)
+        {
+            break;
+        }
+    }
+
+    return fee_stats_bucket_bounds(Bucket, &Lower, LatencyNs);
+}
+
+#ifdef FEE_ENABLE_STATS
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+/*Counters of a function. They are only written by the owner thread, so relaxed load + store updates are enough*/
+typedef struct
+{
+    _Atomic uint64_t Calls;
+    _Atomic uint64_t Bytes;
+    _Atomic uint64_t Failures[FEE_STATS_NUM_FAILS];
+    _Atomic uint64_t TotalNs;
+    _Atomic uint64_t MaxNs;
+    _Atomic uint64_t Histogram[FEE_STATS_NUM_BUCKETS];
+
+} StatsCounters_t;
+
+typedef struct StatsBlock
+{
+    _Atomic uint64_t Generation; /*Reset generation of the counters*/
+    StatsCounters_t Ops[FEE_STATS_NUM_OPS];
+    struct StatsBlock *Prev;
+    struct StatsBlock *Next;
+
+} StatsBlock_t;
+
+static pthread_mutex_t StatsMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t StatsKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t StatsKey;
+static StatsBlock_t *StatsBlocks = NULL;            /*Blocks of the running threads. Protected by StatsMutex*/
+static fee_stats_snapshot_t StatsRetired;           /*Counters of the finished threads. Protected by StatsMutex*/
+static _Atomic uint64_t StatsGeneration = 1;        /*Incremented by every fee_stats_reset*/
+static _Thread_local StatsBlock_t *StatsThreadBlock = NULL;
+
+static inline void CounterAdd(_Atomic uint64_t *Counter, uint64_t Value)
+{
+    atomic_store_explicit(Counter, atomic_load_explicit(Counter, memory_order_relaxed) + Value, memory_order_relaxed);
+}
+
+static inline size_t LatencyBucket(uint64_t LatencyNs)
+{
+    unsigned int Exponent;
+
+    if (LatencyNs < FEE_STATS_SUB_BUCKETS)
+    {
+        return (size_t)LatencyNs;
+    }
+
+    Exponent = 63u - (unsigned int)__builtin_clzll(LatencyNs);
+
+    return (size_t)(Exponent - FEE_STATS_SUB_BUCKET_BITS + 1) * FEE_STATS_SUB_BUCKETS +
+           (size_t)((LatencyNs >> (Exponent - FEE_STATS_SUB_BUCKET_BITS)) & (FEE_STATS_SUB_BUCKETS - 1));
+}
+
+/*Add the counters of a block to a snapshot*/
+static void AccumulateBlock(const StatsBlock_t *Block, fee_stats_snapshot_t *Snapshot)
+{
+    const StatsCounters_t *Counters;
+    fee_stats_op_snapshot_t *Op;
+    uint64_t MaxNs;
+    size_t OpIt, It;
+
+    for (OpIt = 0; OpIt < FEE_STATS_NUM_OPS; OpIt++)
+    {
+        Counters = &Block->Ops[OpIt];
+        Op = &Snapshot->Ops[OpIt];
+
+        Op->Calls += atomic_load_explicit(&Counters->Calls, memory_order_relaxed);
+        Op->Bytes += atomic_load_explicit(&Counters->Bytes, memory_order_relaxed);
+        Op->TotalNs += atomic_load_explicit(&Counters->TotalNs, memory_order_relaxed);
+        MaxNs = atomic_load_explicit(&Counters->MaxNs, memory_order_relaxed);
+        if (MaxNs > Op->MaxNs)
+        {
+            Op->MaxNs = MaxNs;
+        }
+        for (It = 0; It < FEE_STATS_NUM_FAILS; It++)
+        {
+            Op->Failures[It] += atomic_load_explicit(&Counters->Failures[It], memory_order_relaxed);
+        }
+        for (It = 0; It < FEE_STATS_NUM_BUCKETS; It++)
+        {
+            Op->Histogram[It] += atomic_load_explicit(&Counters->Histogram[It], memory_order_relaxed);
+        }
+    }
+}
+
+static void MergeSnapshot(fee_stats_snapshot_t *Destination, const fee_stats_snapshot_t *Source)
+{
+    size_t OpIt, It;
+
+    for (OpIt = 0; OpIt < FEE_STATS_NUM_OPS; OpIt++)
+    {
+        fee_stats_op_snapshot_t *Dst = &Destination->Ops[OpIt];
+        const fee_stats_op_snapshot_t *Src = &Source->Ops[OpIt];
+
+        Dst->Calls += Src->Calls;
+        Dst->Bytes += Src->Bytes;
+        Dst->TotalNs += Src->TotalNs;
+        Dst->MaxNs = Src->MaxNs > Dst->MaxNs ? Src->MaxNs : Dst->MaxNs;
+        for (It = 0; It < FEE_STATS_NUM_FAILS; It++)
+        {
+            Dst->Failures[It] += Src->Failures[It];
+        }
+        for (It = 0; It < FEE_STATS_NUM_BUCKETS; It++)
+        {
+            Dst->Histogram[It] += Src->Histogram[It];
+        }
+    }
+}
+
+/*Thread exit: fold the counters into the retired block and unlink the block*/
+static void ReleaseThreadBlock(void *Data)
+{
+    StatsBlock_t *Block = Data;
+
+    pthread_mutex_lock(&StatsMutex);
+
+    if (atomic_load_explicit(&Block->Generation, memory_order_acquire) ==
+        atomic_load_explicit(&StatsGeneration, memory_order_acquire))
+    {
+        AccumulateBlock(Block, &StatsRetired);
+    }
+
+    if (Block->Prev != NULL)
+    {
+        Block->Prev->Next = Block->Next;
+    }
+    else
+    {
+        StatsBlocks = Block->Next;
+    }
+    if (Block->Next != NULL)
+    {
+        Block->Next->Prev = Block->Prev;
+    }
+
+    pthread_mutex_unlock(&StatsMutex);
+
+    free(Block);
+}
+
+static void CreateStatsKey(void)
+{
+    pthread_key_create(&StatsKey, ReleaseThreadBlock);
+}
+
+/*Block of the calling thread. It is created and registered on first use*/
+static StatsBlock_t *ThreadBlock(void)
+{
+    StatsBlock_t *Block = StatsThreadBlock;
+    uint64_t Generation;
+    size_t OpIt, It;
+
+    if (Block == NULL)
+    {
+        Block = calloc(1, sizeof(StatsBlock_t));
+        if (Block == NULL)
+        {
+            return NULL;
+        }
+
+        pthread_once(&StatsKeyOnce, CreateStatsKey);
+        pthread_setspecific(StatsKey, Block);
+
+        atomic_store_explicit(&Block->Generation, atomic_load_explicit(&StatsGeneration, memory_order_acquire),
+                              memory_order_relaxed);
+
+        pthread_mutex_lock(&StatsMutex);
+        Block->Next = StatsBlocks;
+        if (StatsBlocks != NULL)
+        {
+            StatsBlocks->Prev = Block;
+        }
+        StatsBlocks = Block;
+        pthread_mutex_unlock(&StatsMutex);
+
+        StatsThreadBlock = Block;
+    }
+
+    /*Clear the counters after a fee_stats_reset*/
+    Generation = atomic_load_explicit(&StatsGeneration, memory_order_acquire);
+    if (atomic_load_explicit(&Block->Generation, memory_order_relaxed) != Generation)
+    {
+        for (OpIt = 0; OpIt < FEE_STATS_NUM_OPS; OpIt++)
+        {
+            StatsCounters_t *Counters = &Block->Ops[OpIt];
+
+            atomic_store_explicit(&Counters->Calls, 0, memory_order_relaxed);
+            atomic_store_explicit(&Counters->Bytes, 0, memory_order_relaxed);
+            atomic_store_explicit(&Counters->TotalNs, 0, memory_order_relaxed);
+            atomic_store_explicit(&Counters->MaxNs, 0, memory_order_relaxed);
+            for (It = 0; It < FEE_STATS_NUM_FAILS; It++)
+            {
+                atomic_store_explicit(&Counters->Failures[It], 0, memory_order_relaxed);
+            }
+            for (It = 0; It < FEE_STATS_NUM_BUCKETS; It++)
+            {
+                atomic_store_explicit(&Counters->Histogram[It], 0, memory_order_relaxed);
+            }
+        }
+        atomic_store_explicit(&Block->Generation, Generation, memory_order_release);
+    }
+
+    return Block;
+}
+
+uint64_t StatsNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void StatsRecord(fee_stats_op_t Op, uint64_t LatencyNs, int Status, uint64_t Bytes, fee_stats_fail_t Reason)
+{
+    StatsBlock_t *Block;
+    StatsCounters_t *Counters;
+
+    Block = ThreadBlock();
+    if (Block == NULL)
+    {
+        return;
+    }
+
+    Counters = &Block->Ops[Op];
+
+    CounterAdd(&Counters->Calls, 1);
+    CounterAdd(&Counters->TotalNs, LatencyNs);
+    CounterAdd(&Counters->Histogram[LatencyBucket(LatencyNs)], 1);
+    if (LatencyNs > atomic_load_explicit(&Counters->MaxNs, memory_order_relaxed))
+    {
+        atomic_store_explicit(&Counters->MaxNs, LatencyNs, memory_order_relaxed);
+    }
+
+    if (Status == FEE_EXIT_SUCCESS)
+    {
+        CounterAdd(&Counters->Bytes, Bytes);
+    }
+    else if ((unsigned)Reason < FEE_STATS_NUM_FAILS)
+    {
+        CounterAdd(&Counters->Failures[Reason], 1);
+    }
+}
+
+int fee_stats_snapshot(fee_stats_snapshot_t *Snapshot)
+{
+    const StatsBlock_t *Block;
+    uint64_t Generation;
+
+    if (Snapshot == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(Snapshot, 0, sizeof(fee_stats_snapshot_t));
+    Snapshot->Enabled = 1;
+
+    pthread_mutex_lock(&StatsMutex);
+
+    Generation = atomic_load_explicit(&StatsGeneration, memory_order_acquire);
+
+    MergeSnapshot(Snapshot, &StatsRetired);
+
+    /*Blocks not cleared since the last reset count as empty*/
+    for (Block = StatsBlocks; Block != NULL; Block = Block->Next)
+    {
+        if (atomic_load_explicit(&Block->Generation, memory_order_acquire) == Generation)
+        {
+            AccumulateBlock(Block, Snapshot);
+        }
+    }
+
+    pthread_mutex_unlock(&StatsMutex);
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_stats_reset(void)
+{
+    pthread_mutex_lock(&StatsMutex);
+
+    memset(&StatsRetired, 0, sizeof(StatsRetired));
+    atomic_fetch_add_explicit(&StatsGeneration, 1, memory_order_acq_rel);
+
+    pthread_mutex_unlock(&StatsMutex);
+}
+
+#else
+
+int fee_stats_snapshot(fee_stats_snapshot_t *Snapshot)
+{
+    if (Snapshot == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(Snapshot, 0, sizeof(fee_stats_snapshot_t));
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_stats_reset(void)
+{
+}
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file fee_stream.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library stream continuity tracker.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <string.h>
+#include <fee_stream.h>
+
+/*Read a big-endian counter from a raw packet*/
+static inline uint32_t PeekCounter16(const uint8_t *Packet, size_t Offset)
+{
+    return ((uint32_t)Packet[Offset] << 8) | (uint32_t)Packet[Offset + 1];
+}
+
+static inline uint32_t PeekCounter32(const uint8_t *Packet, size_t Offset)
+{
+    return ((uint32_t)Packet[Offset] << 24) | ((uint32_t)Packet[Offset + 1] << 16) |
+           ((uint32_t)Packet[Offset + 2] << 8) | (uint32_t)Packet[Offset + 3];
+}
+
+/*Restart the tracking at a counter*/
+static inline void StartStream(fee_stream_counter_t *Counter, uint32_t Value)
+{
+    Counter->Started = 1;
+    Counter->Highest = Value;
+    Counter->Window = 1;
+    Counter->Expected++;
+}
+
+int fee_stream_counter_init(fee_stream_counter_t *Counter, unsigned int Bits, uint32_t ResyncGap, int AllowRepeats)
+{
+    uint32_t Mask;
+
+    if (Bits == 0 || Bits > 32)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Mask = (uint32_t)(((uint64_t)1 << Bits) - 1);
+
+    /*Forward and backward jumps must be distinguishable*/
+    if (ResyncGap == 0)
+    {
+        ResyncGap = Mask / 2;
+    }
+    if (ResyncGap > Mask / 2)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(Counter, 0, sizeof(fee_stream_counter_t));
+    Counter->Mask = Mask;
+    Counter->ResyncGap = ResyncGap;
+    Counter->AllowRepeats = AllowRepeats;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+fee_stream_event_t fee_stream_counter_update(fee_stream_counter_t *Counter, uint32_t Value, uint32_t *Missing)
+{
+    uint32_t Ahead, Behind;
+    uint64_t Bit;
+
+    if (Missing != NULL)
+    {
+        *Missing = 0;
+    }
+
+    Value &= Counter->Mask;
+    Counter->Received++;
+
+    if (!Counter->Started)
+    {
+        StartStream(Counter, Value);
+        return FEE_STREAM_IN_ORDER;
+    }
+
+    /*Distances modulo 2^bits handle the wraparound*/
+    Ahead = (Value - Counter->Highest) & Counter->Mask;
+    Behind = (Counter->Highest - Value) & Counter->Mask;
+
+    if (Ahead == 0)
+    {
+        if (Counter->AllowRepeats)
+        {
+            Counter->Repeats++;
+            return FEE_STREAM_REPEAT;
+        }
+        Counter->Duplicates++;
+        return FEE_STREAM_DUPLICATE;
+    }
+
+    if (Ahead <= Counter->ResyncGap)
+    {
+        Counter->Window = Ahead >= FEE_STREAM_WINDOW ? 1 : (Counter->Window << Ahead) | 1;
+        Counter->Highest = Value;
+        Counter->Expected += Ahead;
+
+        if (Ahead == 1)
+        {
+            return FEE_STREAM_IN_ORDER;
+        }
+
+        Counter->Lost += Ahead - 1;
+        Counter->Gaps++;
+        if (Missing != NULL)
+        {
+            *Missing = Ahead - 1;
+        }
+        return FEE_STREAM_GAP;
+    }
+
+    if (Behind < FEE_STREAM_WINDOW)
+    {
+        Bit = (uint64_t)1 << Behind;
+        if (Counter->Window & Bit)
+        {
+            Counter->Duplicates++;
+            return FEE_STREAM_DUPLICATE;
+        }
+
+        Counter->Window |= Bit;
+        Counter->Reordered++;
+        if (Counter->Lost > 0)
+        {
+            Counter->Lost--;
+        }
+        return FEE_STREAM_REORDERED;
+    }
+
+    if (Behind <= Counter->ResyncGap)
+    {
+        Counter->Late++;
+        return FEE_STREAM_LATE;
+    }
+
+    Counter->Resyncs++;
+    StartStream(Counter, Value);
+    return FEE_STREAM_RESYNC;
+}
+
+double fee_stream_counter_loss_rate(const fee_stream_counter_t *Counter)
+{
+    if (Counter->Expected == 0)
+    {
+        return 0.0;
+    }
+
+    return (double)Counter->Lost / (double)Counter->Expected;
+}
+
+void fee_stream_tracker_init(fee_stream_tracker_t *Tracker)
+{
+    fee_stream_counter_init(&Tracker->TM, FEE_STREAM_TM_COUNTER_BITS, FEE_STREAM_DEFAULT_RESYNC_GAP, 0);
+    fee_stream_counter_init(&Tracker->TC_Echo, FEE_STREAM_TC_COUNTER_BITS, FEE_STREAM_DEFAULT_RESYNC_GAP, 1);
+    fee_stream_counter_init(&Tracker->TC, FEE_STREAM_TC_COUNTER_BITS, FEE_STREAM_DEFAULT_RESYNC_GAP, 0);
+    fee_stream_counter_init(&Tracker->PTD, FEE_STREAM_PIXEL_DATA_COUNTER_BITS, FEE_STREAM_DEFAULT_RESYNC_GAP, 0);
+}
+
+fee_stream_event_t fee_stream_update_TM(fee_stream_tracker_t *Tracker, const fee_TM_t *TM_Data_Struct)
+{
+    fee_stream_counter_update(&Tracker->TC_Echo, TM_Data_Struct->Returned_TC.TC_COUNTER, NULL);
+
+    return fee_stream_counter_update(&Tracker->TM, TM_Data_Struct->TM_COUNTER, NULL);
+}
+
+fee_stream_event_t fee_stream_update_TC(fee_stream_tracker_t *Tracker, const fee_TC_t *TC_Data_Struct)
+{
+    return fee_stream_counter_update(&Tracker->TC, TC_Data_Struct->TC_COUNTER, NULL);
+}
+
+fee_stream_event_t fee_stream_update_PTD(fee_stream_tracker_t *Tracker, const fee_PTD_t *PTD_Data)
+{
+    return fee_stream_counter_update(&Tracker->PTD, PTD_Data->PIXEL_DATA_COUNTER, NULL);
+}
+
+fee_stream_event_t fee_stream_peek_TM(fee_stream_tracker_t *Tracker, const uint8_t *TM_Packet)
+{
+    fee_stream_counter_update(&Tracker->TC_Echo, PeekCounter16(TM_Packet, TM_OFFSET_TC_COUNTER), NULL);
+
+    return fee_stream_counter_update(&Tracker->TM, PeekCounter32(TM_Packet, TM_OFFSET_TM_COUNTER), NULL);
+}
+
+fee_stream_event_t fee_stream_peek_TC(fee_stream_tracker_t *Tracker, const uint8_t *TC_Packet)
+{
+    return fee_stream_counter_update(&Tracker->TC, PeekCounter16(TC_Packet, TC_OFFSET_TC_COUNTER), NULL);
+}
+
+fee_stream_event_t fee_stream_peek_PTD(fee_stream_tracker_t *Tracker, const uint8_t *PTD_Packet)
+{
+    return fee_stream_counter_update(&Tracker->PTD, PeekCounter32(PTD_Packet, PTD_OFFSET_PIXEL_DATA_COUNTER), NULL);
+}
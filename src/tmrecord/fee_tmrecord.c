@@ -0,0 +1,367 @@
+/**
+ * @file fee_tmrecord.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Fee library packed TM record and configuration table functions.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <fee.h>
+#include <fee_tmrecord.h>
+#include "../common/fee_common.h"
+
+/*Parts of the configuration echo in a TM packet*/
+#define ECHO_FIRST_OFFSET TM_OFFSET_TC_COUNTER
+#define ECHO_FIRST_BYTES (TM_OFFSET_CCDTEMP_MEAS1 - TM_OFFSET_TC_COUNTER)
+#define ECHO_SECOND_OFFSET TM_OFFSET_ACQSTARTDELAY
+#define ECHO_SECOND_BYTES (TM_OFFSET_CHECKSUM - TM_OFFSET_ACQSTARTDELAY)
+
+#define TABLE_INITIAL_SLOTS 16
+#define EMPTY_SLOT UINT32_MAX
+
+typedef struct
+{
+    uint8_t Echo[FEE_TM_CONFIG_ECHO_BYTES];
+    fee_TC_t TC; /*Decoded echo*/
+    uint64_t Hash;
+
+} ConfigEntry_t;
+
+struct fee_tm_config_table
+{
+    ConfigEntry_t *Entries;  /*Indexed by id*/
+    size_t NumEntries;
+    size_t Capacity;
+    uint32_t *Slots;         /*Open addressing hash of the ids. EMPTY_SLOT if free*/
+    size_t NumSlots;         /*Power of two, at least twice NumEntries*/
+    uint32_t LastId;         /*Id of the last packed record. Consecutive packets usually share it*/
+};
+
+/*fee_TM_t field of every measurement word*/
+static const size_t WordFields[FEE_TM_RECORD_NUM_WORDS] = {
+    offsetof(fee_TM_t, CCDTEMP_MEAS1), offsetof(fee_TM_t, CCDTEMP_MEAS2), offsetof(fee_TM_t, VAUTEMP_MEAS),
+    offsetof(fee_TM_t, FPPETEMP_MEAS), offsetof(fee_TM_t, VODE_MEAS), offsetof(fee_TM_t, VODF_MEAS),
+    offsetof(fee_TM_t, VODG_MEAS), offsetof(fee_TM_t, VODH_MEAS), offsetof(fee_TM_t, VRD_MEAS),
+    offsetof(fee_TM_t, VDD_MEAS), offsetof(fee_TM_t, VOG_MEAS), offsetof(fee_TM_t, IPHIH_MEAS),
+    offsetof(fee_TM_t, SPHIH_MEAS), offsetof(fee_TM_t, RPHIH_MEAS), offsetof(fee_TM_t, PHIRH_MEAS),
+    offsetof(fee_TM_t, VDGH_MEAS), offsetof(fee_TM_t, VANAP_MEAS), offsetof(fee_TM_t, VANAN_MEAS),
+    offsetof(fee_TM_t, VDET_MEAS), offsetof(fee_TM_t, VDRV_MEAS), offsetof(fee_TM_t, VDIG_MEAS),
+    offsetof(fee_TM_t, IDIG_MEAS), offsetof(fee_TM_t, TC_ERROR), offsetof(fee_TM_t, VAU_ERROR),
+};
+
+static void GetEcho(const uint8_t *Packet, uint8_t *Echo)
+{
+    memcpy(Echo, Packet + ECHO_FIRST_OFFSET, ECHO_FIRST_BYTES);
+    memcpy(Echo + ECHO_FIRST_BYTES, Packet + ECHO_SECOND_OFFSET, ECHO_SECOND_BYTES);
+}
+
+static void PutEcho(const uint8_t *Echo, uint8_t *Packet)
+{
+    memcpy(Packet + ECHO_FIRST_OFFSET, Echo, ECHO_FIRST_BYTES);
+    memcpy(Packet + ECHO_SECOND_OFFSET, Echo + ECHO_FIRST_BYTES, ECHO_SECOND_BYTES);
+}
+
+/*FNV-1a*/
+static uint64_t HashEcho(const uint8_t *Echo)
+{
+    uint64_t Hash = 0xCBF29CE484222325ULL;
+    size_t i;
+
+    for (i = 0; i < FEE_TM_CONFIG_ECHO_BYTES; i++)
+    {
+        Hash = (Hash ^ Echo[i]) * 0x100000001B3ULL;
+    }
+
+    return Hash;
+}
+
+static size_t FindSlot(const fee_tm_config_table_t *Table, const uint8_t *Echo, uint64_t Hash)
+{
+    size_t Slot = (size_t)Hash & (Table->NumSlots - 1);
+    const ConfigEntry_t *Entry;
+
+    while (Table->Slots[Slot] != EMPTY_SLOT)
+    {
+        Entry = &Table->Entries[Table->Slots[Slot]];
+        if (Entry->Hash == Hash && memcmp(Entry->Echo, Echo, FEE_TM_CONFIG_ECHO_BYTES) == 0)
+        {
+            break;
+        }
+        Slot = (Slot + 1) & (Table->NumSlots - 1);
+    }
+
+    return Slot;
+}
+
+static int GrowSlots(fee_tm_config_table_t *Table)
+{
+    size_t NumSlots = Table->NumSlots * 2, i, Slot;
+    uint32_t *Slots = (uint32_t *)malloc(NumSlots * sizeof(uint32_t));
+
+    if (Slots == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    for (i = 0; i < NumSlots; i++)
+    {
+        Slots[i] = EMPTY_SLOT;
+    }
+    for (i = 0; i < Table->NumEntries; i++)
+    {
+        Slot = (size_t)Table->Entries[i].Hash & (NumSlots - 1);
+        while (Slots[Slot] != EMPTY_SLOT)
+        {
+            Slot = (Slot + 1) & (NumSlots - 1);
+        }
+        Slots[Slot] = (uint32_t)i;
+    }
+
+    free(Table->Slots);
+    Table->Slots = Slots;
+    Table->NumSlots = NumSlots;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/*Id of an echo, interning it if it is new. The echo is decoded once, when it is added*/
+static int Intern(fee_tm_config_table_t *Table, const uint8_t *Echo, uint32_t *ConfigId)
+{
+    fee_TM_Packet_t Packet;
+    fee_TM_t TM;
+    ConfigEntry_t *Entries;
+    uint64_t Hash;
+    size_t Slot, Capacity;
+
+    if (Table->NumEntries > 0 && memcmp(Table->Entries[Table->LastId].Echo, Echo, FEE_TM_CONFIG_ECHO_BYTES) == 0)
+    {
+        *ConfigId = Table->LastId;
+        return FEE_EXIT_SUCCESS;
+    }
+
+    Hash = HashEcho(Echo);
+    Slot = FindSlot(Table, Echo, Hash);
+    if (Table->Slots[Slot] != EMPTY_SLOT)
+    {
+        Table->LastId = Table->Slots[Slot];
+        *ConfigId = Table->LastId;
+        return FEE_EXIT_SUCCESS;
+    }
+
+    if (Table->NumEntries >= EMPTY_SLOT)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    if (Table->NumEntries == Table->Capacity)
+    {
+        Capacity = Table->Capacity * 2;
+        Entries = (ConfigEntry_t *)realloc(Table->Entries, Capacity * sizeof(ConfigEntry_t));
+        if (Entries == NULL)
+        {
+            return FEE_EXIT_ERROR;
+        }
+        Table->Entries = Entries;
+        Table->Capacity = Capacity;
+    }
+
+    memset(Packet, 0, sizeof(Packet));
+    PutEcho(Echo, Packet);
+    if (DeserializeTM(Packet, &TM) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    memcpy(Table->Entries[Table->NumEntries].Echo, Echo, FEE_TM_CONFIG_ECHO_BYTES);
+    Table->Entries[Table->NumEntries].TC = TM.Returned_TC;
+    Table->Entries[Table->NumEntries].Hash = Hash;
+    Table->Slots[Slot] = (uint32_t)Table->NumEntries;
+    Table->LastId = (uint32_t)Table->NumEntries;
+    Table->NumEntries++;
+
+    *ConfigId = Table->LastId;
+
+    /*Load factor of one half at most*/
+    if (2 * Table->NumEntries > Table->NumSlots)
+    {
+        return GrowSlots(Table);
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+/* ---------------------------- */
+/* ---- Public Functions ------ */
+/* ---------------------------- */
+
+int fee_tm_config_table_create(fee_tm_config_table_t **Table)
+{
+    fee_tm_config_table_t *New;
+    size_t i;
+
+    if (Table == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    New = (fee_tm_config_table_t *)calloc(1, sizeof(fee_tm_config_table_t));
+    if (New == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+    New->Capacity = TABLE_INITIAL_SLOTS / 2;
+    New->NumSlots = TABLE_INITIAL_SLOTS;
+    New->Entries = (ConfigEntry_t *)malloc(New->Capacity * sizeof(ConfigEntry_t));
+    New->Slots = (uint32_t *)malloc(New->NumSlots * sizeof(uint32_t));
+    if (New->Entries == NULL || New->Slots == NULL)
+    {
+        fee_tm_config_table_destroy(New);
+        return FEE_EXIT_ERROR;
+    }
+    for (i = 0; i < New->NumSlots; i++)
+    {
+        New->Slots[i] = EMPTY_SLOT;
+    }
+
+    *Table = New;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+void fee_tm_config_table_destroy(fee_tm_config_table_t *Table)
+{
+    if (Table == NULL)
+    {
+        return;
+    }
+
+    free(Table->Entries);
+    free(Table->Slots);
+    free(Table);
+}
+
+size_t fee_tm_config_table_size(const fee_tm_config_table_t *Table)
+{
+    return Table != NULL ? Table->NumEntries : 0;
+}
+
+int fee_tm_config_get(const fee_tm_config_table_t *Table, uint32_t ConfigId, fee_TC_t *TC)
+{
+    if (Table == NULL || TC == NULL || ConfigId >= Table->NumEntries)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    *TC = Table->Entries[ConfigId].TC;
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_record_from_packet(fee_tm_config_table_t *Table, const fee_TM_Packet_t Packet, fee_tm_record_t *Record)
+{
+    uint8_t Echo[FEE_TM_CONFIG_ECHO_BYTES];
+    const uint8_t *Word = Packet + TM_OFFSET_CCDTEMP_MEAS1;
+    int WordIt;
+
+    if (Table == NULL || Packet == NULL || Record == NULL)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    GetEcho(Packet, Echo);
+    if (Intern(Table, Echo, &Record->ConfigId) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Record->TM_COUNTER = ((uint32_t)Packet[0] << 24) | ((uint32_t)Packet[1] << 16) | ((uint32_t)Packet[2] << 8) | Packet[3];
+    for (WordIt = 0; WordIt < FEE_TM_RECORD_NUM_WORDS; WordIt++, Word += 2)
+    {
+        Record->Words[WordIt] = (uint16_t)((Word[0] << 8) | Word[1]);
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_record_from_packets(fee_tm_config_table_t *Table, const fee_TM_Packet_t *Packets, size_t NumPackets,
+                               fee_tm_record_t *Records)
+{
+    size_t i;
+
+    if (Packets == NULL || (Records == NULL && NumPackets > 0))
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    for (i = 0; i < NumPackets; i++)
+    {
+        if (fee_tm_record_from_packet(Table, Packets[i], &Records[i]) != FEE_EXIT_SUCCESS)
+        {
+            return FEE_EXIT_ERROR;
+        }
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_record_from_tm(fee_tm_config_table_t *Table, const fee_TM_t *TM, fee_tm_record_t *Record)
+{
+    fee_TM_Packet_t Packet;
+
+    if (TM == NULL || fee_TM_Write(*TM, Packet) != FEE_EXIT_SUCCESS)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    return fee_tm_record_from_packet(Table, Packet, Record);
+}
+
+int fee_tm_record_to_tm(const fee_tm_config_table_t *Table, const fee_tm_record_t *Record, fee_TM_t *TM)
+{
+    int WordIt;
+
+    if (Table == NULL || Record == NULL || TM == NULL || Record->ConfigId >= Table->NumEntries)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    TM->TM_COUNTER = Record->TM_COUNTER;
+    TM->Returned_TC = Table->Entries[Record->ConfigId].TC;
+    for (WordIt = 0; WordIt < FEE_TM_RECORD_NUM_WORDS; WordIt++)
+    {
+        memcpy((uint8_t *)TM + WordFields[WordIt], &Record->Words[WordIt], sizeof(uint16_t));
+    }
+
+    return FEE_EXIT_SUCCESS;
+}
+
+int fee_tm_record_to_packet(const fee_tm_config_table_t *Table, const fee_tm_record_t *Record, fee_TM_Packet_t Packet)
+{
+    uint8_t *Word = Packet + TM_OFFSET_CCDTEMP_MEAS1;
+    uint16_t Checksum;
+    int WordIt;
+
+    if (Table == NULL || Record == NULL || Packet == NULL || Record->ConfigId >= Table->NumEntries)
+    {
+        return FEE_EXIT_ERROR;
+    }
+
+    Packet[0] = (uint8_t)(Record->TM_COUNTER >> 24);
+    Packet[1] = (uint8_t)(Record->TM_COUNTER >> 16);
+    Packet[2] = (uint8_t)(Record->TM_COUNTER >> 8);
+    Packet[3] = (uint8_t)Record->TM_COUNTER;
+    PutEcho(Table->Entries[Record->ConfigId].Echo, Packet);
+    for (WordIt = 0; WordIt < FEE_TM_RECORD_NUM_WORDS; WordIt++, Word += 2)
+    {
+        Word[0] = (uint8_t)(Record->Words[WordIt] >> 8);
+        Word[1] = (uint8_t)Record->Words[WordIt];
+    }
+
+    Checksum = XORChecksum16(Packet, TM_PACKET_BYTES - TM_CHECKSUM_BYTES);
+    memcpy(Packet + TM_OFFSET_CHECKSUM, &Checksum, TM_CHECKSUM_BYTES);
+
+    return FEE_EXIT_SUCCESS;
+}
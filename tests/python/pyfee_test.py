@@ -0,0 +1,143 @@
+"""
+@file pyfee_test.py
+@author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+@brief  pyfee Test. The test reads an example file which contains TM packets, decodes them one by one and in a
+ batch, from several threads, and compares every column. If a PTD file is given, its packets are decoded with the
+ closest previous TM and the planes are checked against the sizes of the packet.
+@version 0.1
+@date 2026-10-19
+
+@copyright Copyright (c) 2026
+"""
+import sys
+import threading
+
+import pyfee
+
+NUM_THREADS = 4
+
+
+def read_packets(path, skip, size=None):
+    """Read the packets of a capture as (timestamp, bytes)"""
+    packets = []
+    with open(path) as f:
+        for line in f:
+            tokens = line.split()
+            if len(tokens) <= skip:
+                continue
+            data = bytes(int(tok) for tok in tokens[skip:])
+            packets.append((int(tokens[0]), data[:size] if size else data))
+    return packets
+
+
+def tm_test(tm_packets):
+    are_equal = True
+    data = b"".join(packet for _, packet in tm_packets)
+
+    columns = pyfee.read_tm_batch(data)
+    status = memoryview(columns["status"]).tolist()
+    if len(status) != len(tm_packets) or any(status):
+        print("Error: unexpected batch status")
+        return False
+
+    lists = {name: memoryview(column).tolist() for name, column in columns.items()}
+    for i, (_, packet) in enumerate(tm_packets):
+        fields = pyfee.read_tm(packet)
+        for name, value in fields.items():
+            if lists[name][i] != value:
+                print("Error at packet %d, field %s: %d != %d" % (i, name, lists[name][i], value))
+                are_equal = False
+
+    # Corrupted packet
+    corrupted = bytearray(data)
+    corrupted[pyfee.TM_PACKET_BYTES] ^= 0x01
+    columns = pyfee.read_tm_batch(corrupted)
+    status = memoryview(columns["status"]).tolist()
+    if status[1] != pyfee.STATUS_CHECKSUM or status.count(pyfee.STATUS_OK) != len(tm_packets) - 1:
+        print("Error: corrupted packet not reported")
+        are_equal = False
+    try:
+        pyfee.read_tm(corrupted[pyfee.TM_PACKET_BYTES:2 * pyfee.TM_PACKET_BYTES])
+        print("Error: corrupted packet decoded")
+        are_equal = False
+    except pyfee.error:
+        pass
+
+    try:
+        pyfee.read_tm_batch(data[:-1])
+        print("Error: truncated batch decoded")
+        are_equal = False
+    except ValueError:
+        pass
+
+    # Concurrent batches
+    results = [None] * NUM_THREADS
+
+    def worker(index):
+        batch = pyfee.read_tm_batch(data)
+        results[index] = {name: memoryview(column).tolist() for name, column in batch.items()}
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(NUM_THREADS)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    if any(result != lists for result in results):
+        print("Error: concurrent batches differ")
+        are_equal = False
+
+    return are_equal
+
+
+def ptd_test(tm_packets, ptd_packets):
+    are_equal = True
+
+    for timestamp, packet in ptd_packets:
+        tm = [tm for ts, tm in tm_packets if ts <= timestamp][-1]
+        sizes = pyfee.ptd_sizes(tm)
+        frame = pyfee.read_ptd(packet, tm)
+
+        if frame["pixel_data_counter"] != int.from_bytes(packet[:4], "big"):
+            print("Error: wrong PIXEL_DATA_COUNTER")
+            are_equal = False
+
+        for plane in frame["planes"]:
+            view = memoryview(plane)
+            if view.shape != (sizes["image_rows"], sizes["image_columns"]) or view.format != "H" or view.readonly:
+                print("Error: wrong plane %s %s" % (view.shape, view.format))
+                are_equal = False
+
+        # Planes go back to the pool and are reused by the next decode
+        first = memoryview(frame["planes"][0]).tolist()
+        del frame, view, plane
+        if memoryview(pyfee.read_ptd(packet, tm)["planes"][0]).tolist() != first:
+            print("Error: decode not repeatable")
+            are_equal = False
+
+    return are_equal
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print("Argument Error: The program should be executed as: %s TM_MessageFile [PTD_MessageFile]" % sys.argv[0])
+        return 1
+
+    tm_packets = read_packets(sys.argv[1], 2, pyfee.TM_PACKET_BYTES)
+    if not tm_packets:
+        print("Error: no packets read")
+        return 1
+
+    are_equal = tm_test(tm_packets)
+    if len(sys.argv) == 3:
+        are_equal = ptd_test(tm_packets, read_packets(sys.argv[2], 3)) and are_equal
+
+    if are_equal:
+        print("pyfee Test Success!")
+        return 0
+
+    print("pyfee Test Error!")
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,217 @@
+/**
+ * @file PTD_kernel_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  PTD Kernel Test. Frames are generated for geometries with and without a specialized kernel. The PTD
+ *  packets written by fee_PTD_Write are compared with a reference serialization of the generated images, and the
+ *  images read back by fee_PTD_Read with the generated ones. If FEE_PTD_KERNELS is "generic", every geometry must
+ *  be reported as generic. Every geometry is checked with the kernels of every CPU tier supported by the host.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_generator.h>
+#include <fee_dispatch.h>
+
+#define NUM_FRAMES 2
+
+/*Reference serialization: counter, data rows, smear rows (no dark info), over-scan rows, voltages and checksum*/
+size_t reference_serialize(const fee_PTD_t *PTD, uint8_t *Packet)
+{
+   size_t Bytes = 0, Row, Column, Rows, k, i;
+   size_t Columns = PTD->PTDImageMatrixTotalSizes.ImageTotalColumns;
+   uint16_t Checksum = 0, Word;
+
+   for (i = 0; i < 4; i++)
+   {
+      Packet[Bytes++] = (uint8_t)(PTD->PIXEL_DATA_COUNTER >> (24 - 8 * i));
+   }
+
+   Rows = PTD->PTDImageMatrixTotalSizes.ImageTotalRows;
+   for (Row = 0; Row < Rows; Row++)
+   {
+      int IsSmear = Row >= PTD->PTDSizes.NumDataRows && Row < PTD->PTDSizes.NumDataRows + FEE_NUM_SMEAR_ROWS;
+
+      if (!IsSmear)
+      {
+         for (k = 0; k < FEE_NUM_CCD; k++)
+         {
+            for (Column = 0; Column < 2; Column++)
+            {
+               Word = PTD->ImageMatrix[k][Row * Columns + Column];
+               Packet[Bytes++] = (uint8_t)(Word >> 8);
+               Packet[Bytes++] = (uint8_t)Word;
+            }
+         }
+      }
+
+      for (Column = 2; Column < Columns; Column++)
+      {
+         for (k = 0; k < FEE_NUM_CCD; k++)
+         {
+            Word = PTD->ImageMatrix[k][Row * Columns + Column];
+            Packet[Bytes++] = (uint8_t)(Word >> 8);
+            Packet[Bytes++] = (uint8_t)Word;
+         }
+      }
+   }
+
+   for (i = 0; i < 4; i++)
+   {
+      Packet[Bytes++] = (uint8_t)(PTD->VOLTAGES_REFERENCES[i] >> 8);
+      Packet[Bytes++] = (uint8_t)PTD->VOLTAGES_REFERENCES[i];
+   }
+
+   for (i = 0; i < Bytes; i += 2)
+   {
+      memcpy(&Word, Packet + i, 2);
+      Checksum ^= Word;
+   }
+   memcpy(Packet + Bytes, &Checksum, 2);
+
+   return Bytes + 2;
+}
+
+int geometry_test(const fee_gen_config_t *Config, const char *ExpectedKernel, int *AreEqual)
+{
+   fee_gen_frame_t Frame;
+   fee_PTD_t PTD_Read;
+   uint8_t *Reference;
+   uint16_t *Planes;
+   const char *Kernel;
+   const char *Env = getenv("FEE_PTD_KERNELS");
+   char VectorKernel[32];
+   fee_cpu_tier_t Tier = fee_dispatch_kernel_tier(FEE_KERNEL_PTD_UNPACK);
+   size_t ImageBytes, Bytes;
+   uint32_t FrameIt;
+   int k;
+
+   memset(&Frame, 0, sizeof(Frame));
+
+   for (FrameIt = 0; FrameIt < NUM_FRAMES; FrameIt++)
+   {
+      if (fee_gen_frame(Config, FrameIt, &Frame) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error generating the frame\n");
+         fee_gen_frame_free(&Frame);
+         return EXIT_FAILURE;
+      }
+
+      Kernel = fee_PTD_KernelName(Frame.TM);
+      if (Env != NULL && strcmp(Env, "generic") == 0)
+      {
+         ExpectedKernel = "generic";
+      }
+      else if (Tier != FEE_CPU_TIER_SCALAR)
+      {
+         /*Vector kernels handle every row length*/
+         snprintf(VectorKernel, sizeof(VectorKernel), "vector-%s", fee_dispatch_tier_name(Tier));
+         ExpectedKernel = VectorKernel;
+      }
+      if (strcmp(Kernel, ExpectedKernel) != 0)
+      {
+         printf("Error: kernel %s, expected %s\n", Kernel, ExpectedKernel);
+         *AreEqual = 0;
+      }
+
+      /*Written packet*/
+      Reference = (uint8_t *)malloc(Frame.PTD.PTDSizes.DataPacketTotalBytes);
+      Bytes = reference_serialize(&Frame.PTD, Reference);
+      if (Bytes != Frame.PTD.PTDSizes.DataPacketTotalBytes || memcmp(Reference, Frame.PTD_Packet, Bytes) != 0)
+      {
+         printf("Error: %s packet differs from the reference\n", Kernel);
+         *AreEqual = 0;
+      }
+      free(Reference);
+
+      /*Read image*/
+      ImageBytes = Frame.PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes;
+      Planes = (uint16_t *)malloc(FEE_NUM_CCD * ImageBytes);
+      memset(&PTD_Read, 0, sizeof(PTD_Read));
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         PTD_Read.ImageMatrix[k] = Planes + k * ImageBytes / sizeof(uint16_t);
+      }
+
+      if (fee_CheckPTDChecksum(Frame.PTD_Packet, Frame.PTD.PTDSizes) != FEE_EXIT_SUCCESS ||
+          fee_PTD_Read(Frame.PTD_Packet, Frame.TM, &PTD_Read) != FEE_EXIT_SUCCESS ||
+          PTD_Read.PIXEL_DATA_COUNTER != Frame.PTD.PIXEL_DATA_COUNTER ||
+          memcmp(PTD_Read.VOLTAGES_REFERENCES, Frame.PTD.VOLTAGES_REFERENCES, sizeof(PTD_Read.VOLTAGES_REFERENCES)) != 0 ||
+          memcmp(&PTD_Read.PTDSizes, &Frame.PTD.PTDSizes, sizeof(fee_PTDSizes_t)) != 0)
+      {
+         printf("Error reading the %s packet\n", Kernel);
+         *AreEqual = 0;
+      }
+
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         if (memcmp(PTD_Read.ImageMatrix[k], Frame.PTD.ImageMatrix[k], ImageBytes) != 0)
+         {
+            printf("Error: %s image of CCD %d differs\n", Kernel, k);
+            *AreEqual = 0;
+         }
+      }
+      free(Planes);
+   }
+
+   fee_gen_frame_free(&Frame);
+
+   return EXIT_SUCCESS;
+}
+
+int main(void)
+{
+   fee_gen_config_t Config;
+   int AreEqual = 1, Status = EXIT_SUCCESS, Tier;
+
+   for (Tier = FEE_CPU_TIER_SCALAR; Tier <= (int)fee_dispatch_detected_tier(); Tier++)
+   {
+      fee_dispatch_set_tier((fee_cpu_tier_t)Tier);
+
+      /*Production geometry*/
+      fee_gen_config_default(&Config);
+      Config.Pattern = FEE_GEN_PATTERN_NOISE;
+      Status |= geometry_test(&Config, "row225", &AreEqual);
+
+      /*Same row length with spatial binning, over-scan rows and three bands*/
+      Config.WOISIZE = 101;
+      Config.NBTAIL = 9;
+      Config.SPATIALBINNINGMODE = SPATIALBIN_ENABLE;
+      Config.BinningSize[0] = 2;
+      Config.BandSize[0] = 300;
+      Config.BinningSize[1] = 1;
+      Config.BandSize[1] = 50;
+      Config.BinningSize[2] = 4;
+      Config.BandSize[2] = 100;
+      Status |= geometry_test(&Config, "row225", &AreEqual);
+
+      /*Geometry without kernel*/
+      Config.BandSize[2] = 96;
+      Status |= geometry_test(&Config, "generic", &AreEqual);
+
+      /*Largest geometry*/
+      fee_gen_config_maximum(&Config);
+      Status |= geometry_test(&Config, "row2250", &AreEqual);
+   }
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   if (AreEqual)
+   {
+      printf("PTD Kernel Test Success!\n");
+      return EXIT_SUCCESS;
+   }
+   else
+   {
+      printf("PTD Kernel Test Error!\n");
+      return EXIT_FAILURE;
+   }
+}
@@ -2,7 +2,8 @@
  * @file PTD_test.c
  * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
  * @brief  PTD Test. The test reads an example files which contains PTD packets, deserialize the information, 
- *  re-serializes it and checks if both packets (the original and the re-serialized) are equal.    
+ *  re-serializes it and checks if both packets (the original and the re-serialized) are equal. Then, a pixel word
+ *  and a byte at an odd offset are patched in place with fee_PTD_SetParameter.
  * @version 0.1
  * @date 2022-05-03
  * 
@@ -40,6 +41,9 @@ int PTD_test(FILE *fTM, FILE *fDTP, int *AreEqual)
     int counter, byte_counter_TM, byte_counter_FDTP;
     long int timestamp_DTP = 0, timestamp_TM = 0;
     fee_PTD_t PTD_Data;
+    uint16_t PixelPatch;
+    uint8_t CounterPatch;
+    uint32_t ExpectedCounter;
 
     *AreEqual = 1;
 
@@ -156,6 +160,29 @@ int PTD_test(FILE *fTM, FILE *fDTP, int *AreEqual)
             }
         }
 
+        /*Patch the first pixel word of CCD 0 and the lowest byte of the pixel data counter, at an odd offset*/
+        PixelPatch = PTD_Data.ImageMatrix[0][0] ^ 0xA5A5;
+        CounterPatch = (uint8_t)(PTD_Data.PIXEL_DATA_COUNTER ^ 0xFF);
+        ExpectedCounter = (PTD_Data.PIXEL_DATA_COUNTER & 0xFFFFFF00) | CounterPatch;
+        if (fee_PTD_SetParameter(PixelDataPacketGenerated, PTD_Data.PTDSizes, sizeof(PTD_Data.PIXEL_DATA_COUNTER),
+                                 sizeof(PixelPatch), PixelPatch) != FEE_EXIT_SUCCESS ||
+            fee_PTD_SetParameter(PixelDataPacketGenerated, PTD_Data.PTDSizes, sizeof(PTD_Data.PIXEL_DATA_COUNTER) - 1,
+                                 sizeof(CounterPatch), CounterPatch) != FEE_EXIT_SUCCESS ||
+            fee_PTD_SetParameter(PixelDataPacketGenerated, PTD_Data.PTDSizes, PTD_Data.PTDSizes.DataPacketTotalBytes - 2,
+                                 sizeof(CounterPatch), CounterPatch) != FEE_EXIT_ERROR)
+        {
+            printf("Error at fee_PTD_SetParameter\n");
+            *AreEqual = 0;
+        }
+
+        if (fee_CheckPTDChecksum(PixelDataPacketGenerated, PTD_Data.PTDSizes) != FEE_EXIT_SUCCESS ||
+            fee_PTD_Read(PixelDataPacketGenerated, TM_Data_Struct, &PTD_Data) != FEE_EXIT_SUCCESS ||
+            PTD_Data.ImageMatrix[0][0] != PixelPatch || PTD_Data.PIXEL_DATA_COUNTER != ExpectedCounter)
+        {
+            printf("Error at patched PTD packet\n");
+            *AreEqual = 0;
+        }
+
         free_loop(PTD_Data.ImageMatrix, FEE_NUM_CCD);
     }
 
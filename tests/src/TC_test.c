@@ -21,6 +21,8 @@ int TC_test(FILE *fp, int *AreEqual)
    fee_TC_Packet_t TC_Message = {0};
    fee_TC_Packet_t TC_Message_Generated = {0};
    fee_TC_t TC_Data_Struct = {0};
+   fee_TC_t TC_Batch[2];
+   uint64_t ViolationMask = 0, ExpectedMask = 0, BatchMasks[2];
    char *tok;
    int counter, byte_counter;
    
@@ -59,6 +61,25 @@ int TC_test(FILE *fp, int *AreEqual)
          return EXIT_FAILURE;
       }
 
+      /*Check that every violated field is reported, one by one and in batch*/
+      TC_Batch[0] = TC_Data_Struct;
+      TC_Batch[1] = TC_Data_Struct;
+      TC_Batch[1].EXPO_TIME = TC_EXPO_TIME_MIN - 1;
+      TC_Batch[1].FREQBINNINGBAND_3 = fee_fill_freqbinningband_parameter(1, TC_FREQBINNINGBAND_3_BANDSIZE_MAX + 1);
+      TC_Batch[1].CDSPARAMS = fee_fill_cdsparam_parameter(3, 0);
+      TC_Batch[1].SYNTPATTERN = 1;
+      ExpectedMask = TC_FIELD_BIT(TC_FIELD_EXPO_TIME) | TC_FIELD_BIT(TC_FIELD_FREQBINNINGBAND_3_BANDSIZE) |
+                     TC_FIELD_BIT(TC_FIELD_CDSPARAMS_MODE) | TC_FIELD_BIT(TC_FIELD_SYNTPATTERN);
+
+      if (fee_TC_BoundsCheck_Mask(TC_Batch[1], &ViolationMask) != FEE_EXIT_ERROR || ViolationMask != ExpectedMask ||
+          fee_TC_BoundsCheck(TC_Batch[1]) != FEE_EXIT_ERROR ||
+          fee_TC_BoundsCheck_Batch(TC_Batch, 2, BatchMasks) != FEE_EXIT_ERROR ||
+          BatchMasks[0] != 0 || BatchMasks[1] != ExpectedMask)
+      {
+         printf("Error at fee_TC_BoundsCheck_Mask\n");
+         return EXIT_FAILURE;
+      }
+
       /*Serialize back TC*/
       if (fee_TC_Write(TC_Data_Struct, TC_Message_Generated) != FEE_EXIT_SUCCESS)
       {
@@ -75,6 +96,14 @@ int TC_test(FILE *fp, int *AreEqual)
             *AreEqual = 0;
          }
       }
+
+      /*Patch the TC counter in place and check that the checksum is kept consistent*/
+      if (fee_TC_SetParameter(TC_Message_Generated, TC_OFFSET_TC_COUNTER, sizeof(TC_Data_Struct.TC_COUNTER), (uint16_t)(TC_Data_Struct.TC_COUNTER + 1)) != FEE_EXIT_SUCCESS ||
+          fee_CheckTeleCommandChecksum(TC_Message_Generated) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error at fee_TC_SetParameter\n");
+         *AreEqual = 0;
+      }
    }
 
    return EXIT_SUCCESS;
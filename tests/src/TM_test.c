@@ -19,7 +19,10 @@ int TM_test(FILE *fp,  int *AreEqual)
 {
    fee_TM_Packet_t TM_Message = {0};
    fee_TM_Packet_t TM_Message_Generated = {0};
+   fee_TM_Packet_t TM_Message_Patched = {0};
+   uint8_t DrainPatch;
    fee_TM_t TM_Data_Struct = {0};
+   fee_TM_t TM_Data_Struct_Patched = {0};
    char *tok;
    int counter, byte_counter;
    *AreEqual = 1;
@@ -62,6 +65,37 @@ int TM_test(FILE *fp,  int *AreEqual)
             *AreEqual = 0;
          }
       }
+
+      /*Re-stamp the TM counter in place and check that the checksum is kept consistent*/
+      /*DUOUTDRAINTVLTG is an 8 bits field at an odd offset, which changes the second byte of the checksum*/
+      DrainPatch = (uint8_t)(TM_Data_Struct.Returned_TC.DUOUTDRAINTVLTG ^ 0xFF);
+      if (fee_TM_SetParameter(TM_Message_Generated, TM_OFFSET_TM_COUNTER, sizeof(TM_Data_Struct.TM_COUNTER), TM_Data_Struct.TM_COUNTER + 1) != FEE_EXIT_SUCCESS ||
+          fee_TM_SetParameter(TM_Message_Generated, TM_OFFSET_CCDTEMP_MEAS1, sizeof(TM_Data_Struct.CCDTEMP_MEAS1), 0x1234) != FEE_EXIT_SUCCESS ||
+          fee_TM_SetParameter(TM_Message_Generated, TM_OFFSET_DUOUTDRAINTVLTG, sizeof(TM_Data_Struct.Returned_TC.DUOUTDRAINTVLTG),
+                              DrainPatch) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error at fee_TM_SetParameter\n");
+         return EXIT_FAILURE;
+      }
+
+      if (fee_CheckTelemetryChecksum(TM_Message_Generated) != FEE_EXIT_SUCCESS ||
+          fee_TM_Read(TM_Message_Generated, &TM_Data_Struct_Patched) != FEE_EXIT_SUCCESS ||
+          TM_Data_Struct_Patched.TM_COUNTER != TM_Data_Struct.TM_COUNTER + 1 ||
+          TM_Data_Struct_Patched.CCDTEMP_MEAS1 != 0x1234 ||
+          TM_Data_Struct_Patched.Returned_TC.DUOUTDRAINTVLTG != DrainPatch)
+      {
+         printf("Error at patched TM packet\n");
+         *AreEqual = 0;
+      }
+
+      /*A parameter that overlaps the checksum is rejected and the packet is not changed*/
+      memcpy(TM_Message_Patched, TM_Message_Generated, TM_PACKET_BYTES);
+      if (fee_TM_SetParameter(TM_Message_Generated, TM_OFFSET_CHECKSUM - 1, sizeof(uint16_t), 0xFFFF) != FEE_EXIT_ERROR ||
+          memcmp(TM_Message_Patched, TM_Message_Generated, TM_PACKET_BYTES) != 0)
+      {
+         printf("Error at fee_TM_SetParameter over the checksum\n");
+         *AreEqual = 0;
+      }
    }
 
    return EXIT_SUCCESS;
@@ -0,0 +1,240 @@
+/**
+ * @file archive_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  TM Archive Test. The packets of the TM capture are written to an archive and read back, and they must be
+ *  byte for byte the original ones, in less than a fifth of their raw size. Seeking must reach the first packet of
+ *  a timestamp. Blocks of random packets, wrong checksums, timestamps out of order and counter wrap-arounds must
+ *  also decode exactly, and truncated blocks must be rejected.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fee.h>
+#include <fee_capture.h>
+#include <fee_archive.h>
+
+#define MAX_PACKETS 8192
+#define BLOCK_PACKETS 256
+#define MIN_RATIO 5.0
+#define NUM_RANDOM_PACKETS 300
+#define ARCHIVE_FILE "archive_test.tma"
+
+uint64_t Timestamps[MAX_PACKETS];
+fee_TM_Packet_t Packets[MAX_PACKETS];
+uint64_t DecodedTimestamps[MAX_PACKETS];
+fee_TM_Packet_t DecodedPackets[MAX_PACKETS];
+
+uint32_t xorshift32(uint32_t *State)
+{
+   *State ^= *State << 13;
+   *State ^= *State >> 17;
+   *State ^= *State << 5;
+   return *State;
+}
+
+int load_capture(const char *Path, size_t *NumPackets)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+
+   if (fee_capture_open(Path, &Capture) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error opening %s\n", Path);
+      return EXIT_FAILURE;
+   }
+
+   *NumPackets = 0;
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (*NumPackets < MAX_PACKETS && fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      if (Packet.Type == FEE_CAPTURE_TM)
+      {
+         Timestamps[*NumPackets] = Packet.Timestamp;
+         memcpy(Packets[*NumPackets], Packet.Bytes, TM_PACKET_BYTES);
+         (*NumPackets)++;
+      }
+   }
+   fee_capture_iter_free(&Iter);
+   fee_capture_close(Capture);
+
+   return *NumPackets > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int file_test(size_t NumPackets)
+{
+   fee_tm_archive_writer_t *Writer = NULL;
+   fee_tm_archive_reader_t *Reader = NULL;
+   fee_tm_archive_info_t Info;
+   fee_TM_Packet_t Packet;
+   uint64_t Timestamp;
+   size_t i, j;
+   double Ratio;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_tm_archive_writer_open(ARCHIVE_FILE, BLOCK_PACKETS, &Writer) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating %s\n", ARCHIVE_FILE);
+      return EXIT_FAILURE;
+   }
+   for (i = 0; i < NumPackets && Status == EXIT_SUCCESS; i++)
+   {
+      if (fee_tm_archive_append(Writer, Timestamps[i], Packets[i]) != FEE_EXIT_SUCCESS)
+      {
+         Status = EXIT_FAILURE;
+      }
+   }
+   if (fee_tm_archive_writer_close(Writer) != FEE_EXIT_SUCCESS || Status != EXIT_SUCCESS ||
+       fee_tm_archive_reader_open(ARCHIVE_FILE, &Reader) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error writing %s\n", ARCHIVE_FILE);
+      unlink(ARCHIVE_FILE);
+      return EXIT_FAILURE;
+   }
+
+   if (fee_tm_archive_info(Reader, &Info) != FEE_EXIT_SUCCESS || Info.NumPackets != NumPackets ||
+       Info.NumBlocks != (NumPackets + BLOCK_PACKETS - 1) / BLOCK_PACKETS)
+   {
+      printf("Error: wrong archive information\n");
+      Status = EXIT_FAILURE;
+   }
+
+   Ratio = (double)(NumPackets * (TM_PACKET_BYTES + sizeof(uint64_t))) / (double)Info.ArchiveBytes;
+   printf("%zu packets archived in %llu bytes (%.1fx)\n", NumPackets, (unsigned long long)Info.ArchiveBytes, Ratio);
+   if (Ratio < MIN_RATIO)
+   {
+      printf("Error: compression ratio below %.1f\n", MIN_RATIO);
+      Status = EXIT_FAILURE;
+   }
+
+   for (i = 0; Status == EXIT_SUCCESS && fee_tm_archive_next(Reader, &Timestamp, Packet) == FEE_EXIT_SUCCESS; i++)
+   {
+      if (i >= NumPackets || Timestamp != Timestamps[i] || memcmp(Packet, Packets[i], TM_PACKET_BYTES) != 0)
+      {
+         printf("Error at archived packet %zu\n", i);
+         Status = EXIT_FAILURE;
+      }
+   }
+   if (Status == EXIT_SUCCESS && i != NumPackets)
+   {
+      printf("Error: %zu packets read back\n", i);
+      Status = EXIT_FAILURE;
+   }
+
+   /*Seeks, including the ones before and after every packet*/
+   for (i = 0; Status == EXIT_SUCCESS && i < NumPackets; i += 97)
+   {
+      for (j = 0; j < NumPackets && Timestamps[j] < Timestamps[i] + 1; j++)
+      {
+      }
+      if (fee_tm_archive_seek(Reader, Timestamps[i]) != FEE_EXIT_SUCCESS ||
+          fee_tm_archive_next(Reader, &Timestamp, Packet) != FEE_EXIT_SUCCESS || Timestamp != Timestamps[i] ||
+          fee_tm_archive_seek(Reader, Timestamps[i] + 1) != FEE_EXIT_SUCCESS ||
+          (j < NumPackets) != (fee_tm_archive_next(Reader, &Timestamp, Packet) == FEE_EXIT_SUCCESS) ||
+          (j < NumPackets && memcmp(Packet, Packets[j], TM_PACKET_BYTES) != 0))
+      {
+         printf("Error seeking %llu\n", (unsigned long long)Timestamps[i]);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   fee_tm_archive_reader_close(Reader);
+   unlink(ARCHIVE_FILE);
+
+   return Status;
+}
+
+int roundtrip(const uint64_t *BlockTimestamps, const fee_TM_Packet_t *BlockPackets, size_t NumPackets, const char *Name)
+{
+   size_t Bound = fee_tm_archive_block_bound(NumPackets), BlockBytes = 0;
+   uint8_t *Block = (uint8_t *)malloc(Bound);
+   int Status = EXIT_SUCCESS;
+
+   if (Block == NULL ||
+       fee_tm_archive_encode_block(BlockTimestamps, BlockPackets, NumPackets, Block, Bound, &BlockBytes) != FEE_EXIT_SUCCESS ||
+       fee_tm_archive_decode_block(Block, BlockBytes, DecodedTimestamps, DecodedPackets, NumPackets) != FEE_EXIT_SUCCESS ||
+       memcmp(DecodedTimestamps, BlockTimestamps, NumPackets * sizeof(uint64_t)) != 0 ||
+       memcmp(DecodedPackets, BlockPackets, NumPackets * sizeof(fee_TM_Packet_t)) != 0)
+   {
+      printf("Error encoding %s\n", Name);
+      Status = EXIT_FAILURE;
+   }
+   else if (fee_tm_archive_decode_block(Block, BlockBytes - 1, DecodedTimestamps, DecodedPackets, NumPackets) == FEE_EXIT_SUCCESS ||
+            fee_tm_archive_encode_block(BlockTimestamps, BlockPackets, NumPackets, Block, BlockBytes - 1, &BlockBytes) == FEE_EXIT_SUCCESS ||
+            (NumPackets > 1 &&
+             fee_tm_archive_decode_block(Block, BlockBytes, DecodedTimestamps, DecodedPackets, NumPackets - 1) == FEE_EXIT_SUCCESS))
+   {
+      printf("Error: %s accepted in a short buffer\n", Name);
+      Status = EXIT_FAILURE;
+   }
+
+   free(Block);
+   return Status;
+}
+
+int block_test(size_t NumPackets)
+{
+   uint32_t State = 2026, i, j;
+   int Status = EXIT_SUCCESS;
+
+   Status |= roundtrip(Timestamps, Packets, 1, "a single packet");
+
+   /*Wrong checksums, repeated and out of order timestamps and a counter wrap-around*/
+   for (i = 0; i < BLOCK_PACKETS && i < NumPackets; i++)
+   {
+      Packets[i][TM_OFFSET_CHECKSUM] ^= (uint8_t)(i % 3 == 0);
+      Timestamps[i] = i % 5 == 0 ? Timestamps[i] - 1000 * i : Timestamps[i] + (i % 7 == 0 ? UINT64_MAX / 3 : 0);
+      Packets[i][0] = 0xFF;
+      Packets[i][1] = 0xFF;
+   }
+   Status |= roundtrip(Timestamps, Packets, i, "corner cases");
+
+   /*Random packets*/
+   for (i = 0; i < NUM_RANDOM_PACKETS; i++)
+   {
+      Timestamps[i] = ((uint64_t)xorshift32(&State) << 32) | xorshift32(&State);
+      for (j = 0; j < TM_PACKET_BYTES; j++)
+      {
+         Packets[i][j] = (uint8_t)xorshift32(&State);
+      }
+   }
+   Status |= roundtrip(Timestamps, Packets, NUM_RANDOM_PACKETS, "random packets");
+
+   return Status;
+}
+
+int main(int argc, char *argv[])
+{
+   size_t NumPackets = 0;
+   int Status = EXIT_SUCCESS;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <TM capture>\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   if (load_capture(argv[1], &NumPackets) != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   Status |= file_test(NumPackets);
+   Status |= block_test(NumPackets);
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("TM Archive Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file async_test.cpp
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Async Test. A stream of generated TM + PTD frames, some of them with a corrupted PTD, is decoded by
+ *  fee::decode_stream from memory, from a truncated source, with a compile-time geometry and from many channel
+ *  sources fed in small chunks by another thread and decoded on a thread executor. Every decoded frame is compared
+ *  with fee_PTD_Read, and errors must be reported for the corrupted and truncated frames. Streams with a TM without
+ *  PTD geometry, a corrupted TM and failing decoders must report their errors and end or go on as documented.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <latch>
+#include <thread>
+#include <vector>
+#include <fee_async.hpp>
+
+extern "C"
+{
+#include <fee_generator.h>
+}
+
+#define NUM_FRAMES 12
+#define CORRUPTED_FRAME_PERIOD 5
+#define NUM_CHANNELS 64
+#define CHUNK_BYTES 97
+#define NUM_EXECUTOR_THREADS 2
+
+using Typical = fee::ptd_geometry<282, 0, SPATALBIN_NOTENABLE, fee::freq_binning_band(1, 225)>;
+
+/*Stream of the test and reference decode of every frame*/
+struct stream_t
+{
+   std::vector<uint8_t> Bytes;
+   std::vector<fee::frame> Reference;
+   std::vector<int> Corrupted;
+};
+
+bool is_corrupted(size_t i)
+{
+   return i % CORRUPTED_FRAME_PERIOD == CORRUPTED_FRAME_PERIOD - 1;
+}
+
+int build_stream(stream_t &Stream, bool TypicalGeometry)
+{
+   fee_gen_config_t Config;
+   fee_gen_frame_t Frame = {};
+   int Status = EXIT_SUCCESS;
+
+   for (size_t i = 0; i < NUM_FRAMES && Status == EXIT_SUCCESS; i++)
+   {
+      fee_gen_config_default(&Config);
+      Config.Pattern = FEE_GEN_PATTERN_NOISE;
+      Config.Seed = 39;
+      if (!TypicalGeometry)
+      {
+         Config.WOISIZE = (uint16_t)(5 + 7 * (i % 3));
+         Config.NBTAIL = (uint16_t)(1 + i % 2);
+         Config.SPATIALBINNINGMODE = i % 2 ? SPATIALBIN_ENABLE : SPATALBIN_NOTENABLE;
+         Config.BinningSize[0] = (uint16_t)(1 + i % 3);
+         Config.BandSize[0] = (uint16_t)(Config.BinningSize[0] * 20);
+      }
+
+      if (fee_gen_frame(&Config, (uint32_t)i, &Frame) != FEE_EXIT_SUCCESS)
+      {
+         Status = EXIT_FAILURE;
+         break;
+      }
+
+      size_t PTDBytes = Frame.PTD.PTDSizes.DataPacketTotalBytes;
+      size_t Offset = Stream.Bytes.size();
+      Stream.Bytes.insert(Stream.Bytes.end(), Frame.TM_Packet, Frame.TM_Packet + TM_PACKET_BYTES);
+      Stream.Bytes.insert(Stream.Bytes.end(), Frame.PTD_Packet, Frame.PTD_Packet + PTDBytes);
+      Stream.Corrupted.push_back(is_corrupted(i));
+
+      fee::frame Reference;
+      size_t PlaneWords = (Frame.PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes + 1) / sizeof(uint16_t);
+      fee_TM_Read(Frame.TM_Packet, &Reference.tm);
+      Reference.planes.resize(FEE_NUM_CCD * PlaneWords);
+      for (int k = 0; k < FEE_NUM_CCD; k++)
+      {
+         Reference.ptd.ImageMatrix[k] = Reference.planes.data() + k * PlaneWords;
+      }
+      if (fee_PTD_Read(Frame.PTD_Packet, Frame.TM, &Reference.ptd) != FEE_EXIT_SUCCESS)
+      {
+         Status = EXIT_FAILURE;
+      }
+      Stream.Reference.push_back(std::move(Reference));
+
+      if (is_corrupted(i))
+      {
+         Stream.Bytes[Offset + TM_PACKET_BYTES + PTDBytes / 2] ^= 0x5A;
+      }
+   }
+
+   fee_gen_frame_free(&Frame);
+
+   return Status;
+}
+
+bool same_frame(const fee::frame &Decoded, const fee::frame &Reference)
+{
+   if (memcmp(&Decoded.tm, &Reference.tm, sizeof(fee_TM_t)) != 0 ||
+       Decoded.ptd.PIXEL_DATA_COUNTER != Reference.ptd.PIXEL_DATA_COUNTER ||
+       memcmp(Decoded.ptd.VOLTAGES_REFERENCES, Reference.ptd.VOLTAGES_REFERENCES, sizeof(Reference.ptd.VOLTAGES_REFERENCES)) != 0 ||
+       memcmp(&Decoded.ptd.PTDSizes, &Reference.ptd.PTDSizes, sizeof(fee_PTDSizes_t)) != 0)
+   {
+      return false;
+   }
+
+   for (int k = 0; k < FEE_NUM_CCD; k++)
+   {
+      if (memcmp(Decoded.ptd.ImageMatrix[k], Reference.ptd.ImageMatrix[k], Reference.ptd.PTDImageMatrixTotalSizes.ImageMatrixBytes) != 0)
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+/*Consume a stream and compare every frame. Returns the number of frames, or -1 on a mismatch*/
+template <class Geometry = void, class Source, class Executor>
+fee::task<int> consume(Source &Input, Executor &Exec, const stream_t &Stream, size_t ExpectedFrames, bool ExpectTruncated)
+{
+   auto Frames = fee::decode_stream<Geometry>(Input, Exec);
+   size_t Count = 0;
+
+   while (auto Result = co_await Frames.next())
+   {
+      if (Count == ExpectedFrames)
+      {
+         if (!ExpectTruncated || Result->has_value() || Result->error() != fee::frame_errc::truncated)
+         {
+            printf("Error: unexpected result after the last frame\n");
+            co_return -1;
+         }
+         ExpectTruncated = false;
+         continue;
+      }
+
+      if (Stream.Corrupted[Count])
+      {
+         try
+         {
+            Result->value();
+            printf("Error: corrupted frame %zu not detected\n", Count);
+            co_return -1;
+         }
+         catch (const fee::frame_error &Error)
+         {
+            if (Error.code() != fee::frame_errc::ptd_checksum)
+            {
+               printf("Error: frame %zu: unexpected error %s\n", Count, Error.what());
+               co_return -1;
+            }
+         }
+      }
+      else if (!Result->has_value() || !same_frame(Result->value(), Stream.Reference[Count]))
+      {
+         printf("Error at decoded frame %zu\n", Count);
+         co_return -1;
+      }
+      Count++;
+   }
+
+   co_return ExpectTruncated ? -1 : (int)Count;
+}
+
+/*Source whose reads fail*/
+struct failing_source
+{
+   auto read(uint8_t *, size_t)
+   {
+      struct awaiter
+      {
+         bool await_ready() const noexcept { return true; }
+         void await_suspend(std::coroutine_handle<>) const noexcept {}
+         size_t await_resume() const { throw std::runtime_error("read error"); }
+      };
+      return awaiter{};
+   }
+};
+
+fee::task<int> consume_failing()
+{
+   failing_source Input;
+   fee::inline_executor Exec;
+   auto Frames = fee::decode_stream(Input, Exec);
+
+   try
+   {
+      co_await Frames.next();
+   }
+   catch (const std::runtime_error &)
+   {
+      co_return EXIT_SUCCESS;
+   }
+
+   co_return EXIT_FAILURE;
+}
+
+/*Error of every result of a stream, or 0 for a decoded frame*/
+fee::task<std::vector<int>> collect(const std::vector<uint8_t> &Bytes, fee::decode_options Options)
+{
+   fee::memory_source Input(Bytes.data(), Bytes.size());
+   fee::inline_executor Exec;
+   auto Frames = fee::decode_stream(Input, Exec, Options);
+   std::vector<int> Results;
+
+   while (auto Result = co_await Frames.next())
+   {
+      Results.push_back(Result->has_value() ? 0 : (int)Result->error());
+   }
+
+   co_return Results;
+}
+
+int failing_tm_decoder(uint8_t *, fee_TM_t *)
+{
+   return FEE_EXIT_ERROR;
+}
+
+/*Only the second PTD fails to decode*/
+std::atomic<int> PTDDecodes{0};
+int second_ptd_fails(uint8_t *Packet, const fee_TM_t &TM, fee_PTD_t *PTD)
+{
+   return ++PTDDecodes == 2 ? FEE_EXIT_ERROR : fee_PTD_Read(Packet, TM, PTD);
+}
+
+/*Errors that end the stream must be the last result, while PTD errors let it go on*/
+int errors_test(void)
+{
+   fee_gen_config_t Config;
+   fee_gen_frame_t Frame = {};
+   fee_TM_t NonOperational;
+   fee_TM_Packet_t NonOperationalPacket;
+   fee::decode_options Options, FailingTM, FailingPTD;
+   int Status = EXIT_SUCCESS;
+
+   fee_gen_config_default(&Config);
+   if (fee_gen_frame(&Config, 0, &Frame) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error generating the frame\n");
+      return EXIT_FAILURE;
+   }
+
+   std::vector<uint8_t> Good(Frame.TM_Packet, Frame.TM_Packet + TM_PACKET_BYTES);
+   Good.insert(Good.end(), Frame.PTD_Packet, Frame.PTD_Packet + Frame.PTD.PTDSizes.DataPacketTotalBytes);
+
+   /*A TM without PTD geometry, followed by a good frame*/
+   NonOperational = Frame.TM;
+   NonOperational.Returned_TC.OPMODE = OPMODE_STAND_BY;
+   fee_TM_Write(NonOperational, NonOperationalPacket);
+   std::vector<uint8_t> NoGeometry(NonOperationalPacket, NonOperationalPacket + TM_PACKET_BYTES);
+   NoGeometry.insert(NoGeometry.end(), Good.begin(), Good.end());
+
+   /*A good frame, a TM with a corrupted checksum and another good frame*/
+   std::vector<uint8_t> BadTM(Good);
+   BadTM.insert(BadTM.end(), Good.begin(), Good.end());
+   BadTM[Good.size() + TM_PACKET_BYTES / 2] ^= 0x5A;
+   BadTM.insert(BadTM.end(), Good.begin(), Good.end());
+
+   std::vector<uint8_t> ThreeFrames(Good);
+   ThreeFrames.insert(ThreeFrames.end(), Good.begin(), Good.end());
+   ThreeFrames.insert(ThreeFrames.end(), Good.begin(), Good.end());
+
+   FailingTM.tm_decoder = failing_tm_decoder;
+   FailingPTD.ptd_decoder = second_ptd_fails;
+
+   struct
+   {
+      const char *Name;
+      const std::vector<uint8_t> &Bytes;
+      fee::decode_options Options;
+      std::vector<int> Expected;
+   } Cases[] = {
+      {"ptd_size", NoGeometry, Options, {(int)fee::frame_errc::ptd_size}},
+      {"tm_checksum", BadTM, Options, {0, (int)fee::frame_errc::tm_checksum}},
+      {"tm_decode", ThreeFrames, FailingTM, {(int)fee::frame_errc::tm_decode}},
+      {"ptd_decode", ThreeFrames, FailingPTD, {0, (int)fee::frame_errc::ptd_decode, 0}},
+   };
+
+   for (const auto &Case : Cases)
+   {
+      if (fee::sync_wait(collect(Case.Bytes, Case.Options)) != Case.Expected)
+      {
+         printf("Error: unexpected results of the %s stream\n", Case.Name);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   fee_gen_frame_free(&Frame);
+
+   return Status;
+}
+
+/*Consumer of a channel, started at once. It counts the latch down when it finishes*/
+fee::detail::detached run_channel(fee::channel_source &Input, fee::thread_executor &Exec, const stream_t &Stream,
+                                  std::atomic<int> &Failures, std::latch &Finished)
+{
+   int Frames = co_await consume(Input, Exec, Stream, NUM_FRAMES, false);
+   if (Frames != NUM_FRAMES)
+   {
+      Failures++;
+   }
+   Finished.count_down();
+}
+
+int multiplex_test(const stream_t &Stream)
+{
+   std::vector<fee::channel_source> Channels(NUM_CHANNELS);
+   std::atomic<int> Failures{0};
+   std::latch Finished(NUM_CHANNELS);
+   fee::thread_executor Exec(NUM_EXECUTOR_THREADS);
+
+   for (fee::channel_source &Input : Channels)
+   {
+      run_channel(Input, Exec, Stream, Failures, Finished);
+   }
+
+   /*Every channel receives its stream in small chunks, interleaved with the other channels*/
+   std::thread Producer([&] {
+      for (size_t Offset = 0; Offset < Stream.Bytes.size(); Offset += CHUNK_BYTES)
+      {
+         size_t Bytes = std::min<size_t>(CHUNK_BYTES, Stream.Bytes.size() - Offset);
+         for (fee::channel_source &Input : Channels)
+         {
+            Input.push(Stream.Bytes.data() + Offset, Bytes);
+         }
+      }
+      for (fee::channel_source &Input : Channels)
+      {
+         Input.close();
+      }
+   });
+
+   Producer.join();
+   Finished.wait();
+
+   if (Failures != 0)
+   {
+      printf("Error: %d channels failed\n", Failures.load());
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+int main(void)
+{
+   stream_t Stream, TypicalStream;
+   fee::inline_executor Inline;
+   int Status = EXIT_SUCCESS;
+
+   if (build_stream(Stream, false) != EXIT_SUCCESS || build_stream(TypicalStream, true) != EXIT_SUCCESS)
+   {
+      printf("Error generating the frames\n");
+      return EXIT_FAILURE;
+   }
+
+   /*Whole stream from memory*/
+   fee::memory_source Memory(Stream.Bytes.data(), Stream.Bytes.size());
+   if (fee::sync_wait(consume(Memory, Inline, Stream, NUM_FRAMES, false)) != NUM_FRAMES)
+   {
+      printf("Error decoding the memory stream\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*The last PTD is truncated*/
+   fee::memory_source Truncated(Stream.Bytes.data(), Stream.Bytes.size() - 3);
+   if (fee::sync_wait(consume(Truncated, Inline, Stream, NUM_FRAMES - 1, true)) != NUM_FRAMES - 1)
+   {
+      printf("Error decoding the truncated stream\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*Compile-time geometry decoder*/
+   fee::memory_source TypicalMemory(TypicalStream.Bytes.data(), TypicalStream.Bytes.size());
+   if (fee::sync_wait(consume<Typical>(TypicalMemory, Inline, TypicalStream, NUM_FRAMES, false)) != NUM_FRAMES)
+   {
+      printf("Error decoding the typical geometry stream\n");
+      Status = EXIT_FAILURE;
+   }
+
+   if (fee::sync_wait(consume_failing()) != EXIT_SUCCESS)
+   {
+      printf("Error: source exception not propagated\n");
+      Status = EXIT_FAILURE;
+   }
+
+   if (errors_test() != EXIT_SUCCESS)
+   {
+      Status = EXIT_FAILURE;
+   }
+
+   if (multiplex_test(Stream) != EXIT_SUCCESS)
+   {
+      Status = EXIT_FAILURE;
+   }
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Async Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,469 @@
+/**
+ * @file batch_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Batch Test. Generated frames of several geometries, some of them corrupted or truncated, are decoded with
+ *  fee_PTD_ReadBatch and fee_TM_ReadBatch on a built-in pool, a serial executor, the default pool and with planes
+ *  taken from an image pool. Every result is compared with fee_PTD_Read and fee_TM_Read. The thread pool is also
+ *  checked to run every task of a job exactly once, and to reject jobs run on it from its own tasks.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <fee.h>
+#include <fee_pipeline.h>
+#include <fee_generator.h>
+#include <fee_batch.h>
+
+#define NUM_FRAMES 96
+#define NUM_GEOMETRIES 4
+#define CORRUPTED_PACKET_PERIOD 7
+#define TRUNCATED_PACKET_PERIOD 11
+#define NUM_WORKERS 4
+#define CHUNK_SIZE 3
+#define STRESS_TASKS 100000
+#define STRESS_JOBS 20
+#define NESTED_TASKS 64
+
+/*Frames, reference decodes and descriptors of the test*/
+fee_gen_frame_t Frames[NUM_FRAMES];
+uint8_t *Packets[NUM_FRAMES];
+fee_PTD_t Reference[NUM_FRAMES];
+fee_TM_t ReferenceTM[NUM_FRAMES];
+fee_packet_desc_t Descs[NUM_FRAMES];
+size_t MaxImageBytes = 0;
+
+atomic_int TaskCounts[STRESS_TASKS];
+
+/*Pools of the re-entry test and results of the jobs run from its tasks*/
+fee_thread_pool_t *OuterPool, *InnerPool;
+atomic_int SamePoolSuccesses, OtherPoolFailures;
+
+int is_corrupted(size_t i)
+{
+   return i % CORRUPTED_PACKET_PERIOD == CORRUPTED_PACKET_PERIOD - 1;
+}
+
+int is_truncated(size_t i)
+{
+   return i % TRUNCATED_PACKET_PERIOD == TRUNCATED_PACKET_PERIOD - 1;
+}
+
+/*Executor that runs every task on the calling thread*/
+int serial_executor(void *ExecutorData, size_t NumTasks, fee_task_fn Task, void *TaskData)
+{
+   size_t i;
+
+   (void)ExecutorData;
+   for (i = 0; i < NumTasks; i++)
+   {
+      Task(TaskData, i);
+   }
+
+   return FEE_EXIT_SUCCESS;
+}
+
+void count_task(void *TaskData, size_t TaskIndex)
+{
+   (void)TaskData;
+   atomic_fetch_add(&TaskCounts[TaskIndex], 1);
+}
+
+int generate_frames(void)
+{
+   fee_gen_config_t Config;
+   size_t i;
+   int k;
+
+   for (i = 0; i < NUM_FRAMES; i++)
+   {
+      fee_gen_config_default(&Config);
+      Config.Pattern = FEE_GEN_PATTERN_NOISE;
+      Config.Seed = 38;
+      Config.WOISIZE = (uint16_t)(8 + 13 * (i % NUM_GEOMETRIES));
+      Config.NBTAIL = (uint16_t)(i % NUM_GEOMETRIES);
+      Config.SPATIALBINNINGMODE = i % 2 ? SPATIALBIN_ENABLE : SPATALBIN_NOTENABLE;
+      Config.BinningSize[0] = (uint16_t)(1 + i % NUM_GEOMETRIES);
+      Config.BandSize[0] = (uint16_t)(Config.BinningSize[0] * 24);
+
+      if (fee_gen_frame(&Config, (uint32_t)i, &Frames[i]) != FEE_EXIT_SUCCESS)
+      {
+         return EXIT_FAILURE;
+      }
+
+      /*Packets are copied, so that corrupting them does not change the generated frame*/
+      Packets[i] = malloc(Frames[i].PTD.PTDSizes.DataPacketTotalBytes);
+      if (Packets[i] == NULL)
+      {
+         return EXIT_FAILURE;
+      }
+      memcpy(Packets[i], Frames[i].PTD_Packet, Frames[i].PTD.PTDSizes.DataPacketTotalBytes);
+      if (is_corrupted(i))
+      {
+         Packets[i][Frames[i].PTD.PTDSizes.DataPacketTotalBytes / 2] ^= 0x5A;
+         Frames[i].TM_Packet[TM_PACKET_BYTES / 2] ^= 0x5A;
+      }
+
+      /*Reference decodes*/
+      memset(&Reference[i], 0, sizeof(fee_PTD_t));
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         Reference[i].ImageMatrix[k] = malloc(Frames[i].PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes);
+         if (Reference[i].ImageMatrix[k] == NULL)
+         {
+            return EXIT_FAILURE;
+         }
+      }
+      if (fee_PTD_Read(Packets[i], Frames[i].TM, &Reference[i]) != FEE_EXIT_SUCCESS)
+      {
+         return EXIT_FAILURE;
+      }
+      fee_TM_Read(Frames[i].TM_Packet, &ReferenceTM[i]);
+
+      if (Frames[i].PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes > MaxImageBytes)
+      {
+         MaxImageBytes = Frames[i].PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes;
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+/*Descriptors of the frames. Without an image pool, every descriptor gets its own planes*/
+int prepare_descriptors(fee_packet_desc_t *Desc, int Type, int OwnImages)
+{
+   size_t i;
+   int k;
+
+   for (i = 0; i < NUM_FRAMES; i++)
+   {
+      memset(&Desc[i], 0, sizeof(fee_packet_desc_t));
+      Desc[i].Type = Type;
+      Desc[i].Status = FEE_EXIT_SUCCESS;
+      if (Type == FEE_PACKET_TM)
+      {
+         Desc[i].Packet = Frames[i].TM_Packet;
+         Desc[i].PacketBytes = is_truncated(i) ? TM_PACKET_BYTES - 1 : TM_PACKET_BYTES;
+         continue;
+      }
+
+      Desc[i].Packet = Packets[i];
+      Desc[i].PacketBytes = Frames[i].PTD.PTDSizes.DataPacketTotalBytes - (is_truncated(i) ? 2 : 0);
+      Desc[i].TM = Frames[i].TM;
+      for (k = 0; k < FEE_NUM_CCD && OwnImages; k++)
+      {
+         Desc[i].PTD.ImageMatrix[k] = calloc(1, Frames[i].PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes);
+         if (Desc[i].PTD.ImageMatrix[k] == NULL)
+         {
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+void free_descriptors(fee_packet_desc_t *Desc, int Type)
+{
+   size_t i;
+   int k;
+
+   for (i = 0; i < NUM_FRAMES && Type == FEE_PACKET_PTD; i++)
+   {
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         free(Desc[i].PTD.ImageMatrix[k]);
+      }
+   }
+}
+
+/*Compare the descriptors with the reference decodes. Checksum errors are only expected when they are checked*/
+int check_descriptors(fee_packet_desc_t *Desc, int Type, int CheckChecksum, const char *Name)
+{
+   size_t i;
+   int k, ExpectedError;
+
+   for (i = 0; i < NUM_FRAMES; i++)
+   {
+      ExpectedError = is_truncated(i) || (CheckChecksum && is_corrupted(i));
+      if (ExpectedError)
+      {
+         if (Desc[i].Status != FEE_EXIT_ERROR)
+         {
+            printf("Error: %s: wrong descriptor %zu not detected\n", Name, i);
+            return EXIT_FAILURE;
+         }
+         continue;
+      }
+
+      if (Desc[i].Status != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: %s: descriptor %zu failed\n", Name, i);
+         return EXIT_FAILURE;
+      }
+
+      if (Type == FEE_PACKET_TM)
+      {
+         if (memcmp(&Desc[i].TM, &ReferenceTM[i], sizeof(fee_TM_t)) != 0)
+         {
+            printf("Error: %s: TM of descriptor %zu differs\n", Name, i);
+            return EXIT_FAILURE;
+         }
+         continue;
+      }
+
+      if (Desc[i].PTD.PIXEL_DATA_COUNTER != Reference[i].PIXEL_DATA_COUNTER ||
+          memcmp(Desc[i].PTD.VOLTAGES_REFERENCES, Reference[i].VOLTAGES_REFERENCES, sizeof(Reference[i].VOLTAGES_REFERENCES)) != 0 ||
+          memcmp(&Desc[i].PTD.PTDSizes, &Reference[i].PTDSizes, sizeof(fee_PTDSizes_t)) != 0)
+      {
+         printf("Error: %s: PTD information of descriptor %zu differs\n", Name, i);
+         return EXIT_FAILURE;
+      }
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         if (memcmp(Desc[i].PTD.ImageMatrix[k], Reference[i].ImageMatrix[k], Reference[i].PTDImageMatrixTotalSizes.ImageMatrixBytes) != 0)
+         {
+            printf("Error: %s: image %d of descriptor %zu differs\n", Name, k, i);
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+/*Decode of every descriptor with a configuration and comparison with the reference*/
+int batch_test(int Type, const fee_batch_config_t *Config, const char *Name)
+{
+   int CheckChecksum = Config != NULL && Config->CheckChecksum;
+   int Status, ExpectedStatus = FEE_EXIT_ERROR;
+
+   if (prepare_descriptors(Descs, Type, 1) != EXIT_SUCCESS)
+   {
+      printf("Error: %s: cannot allocate the descriptors\n", Name);
+      free_descriptors(Descs, Type);
+      return EXIT_FAILURE;
+   }
+
+   Status = Type == FEE_PACKET_TM ? fee_TM_ReadBatch(Descs, NUM_FRAMES, Config) : fee_PTD_ReadBatch(Descs, NUM_FRAMES, Config);
+   if (Status != ExpectedStatus || check_descriptors(Descs, Type, CheckChecksum, Name) != EXIT_SUCCESS)
+   {
+      printf("Error: %s failed\n", Name);
+      free_descriptors(Descs, Type);
+      return EXIT_FAILURE;
+   }
+
+   free_descriptors(Descs, Type);
+
+   return EXIT_SUCCESS;
+}
+
+/*Planes taken from an image pool. Buffers of failed descriptors are released too*/
+int image_pool_test(fee_thread_pool_t *Pool)
+{
+   fee_batch_config_t Config = {Pool, NULL, NULL, NULL, CHUNK_SIZE, 1};
+   fee_buffer_pool_t *ImagePool = NULL;
+   fee_packet_desc_t Short[2];
+   int Status = EXIT_SUCCESS;
+   size_t i;
+
+   if (fee_buffer_pool_create(NUM_FRAMES, FEE_NUM_CCD * MaxImageBytes, &ImagePool) != FEE_EXIT_SUCCESS ||
+       prepare_descriptors(Descs, FEE_PACKET_PTD, 0) != EXIT_SUCCESS)
+   {
+      printf("Error creating the image pool\n");
+      fee_buffer_pool_destroy(ImagePool);
+      return EXIT_FAILURE;
+   }
+   Config.ImagePool = ImagePool;
+
+   if (fee_PTD_ReadBatch(Descs, NUM_FRAMES, &Config) != FEE_EXIT_ERROR ||
+       check_descriptors(Descs, FEE_PACKET_PTD, 1, "image pool") != EXIT_SUCCESS)
+   {
+      Status = EXIT_FAILURE;
+   }
+
+   /*The pool is empty, so the next descriptors cannot get planes*/
+   memcpy(Short, Descs, sizeof(Short));
+   Short[0].PTD.ImageMatrix[0] = NULL;
+   Short[1].PTD.ImageMatrix[0] = NULL;
+   if (fee_PTD_ReadBatch(Short, 2, &Config) != FEE_EXIT_ERROR || Short[0].Status != FEE_EXIT_ERROR ||
+       Short[1].Status != FEE_EXIT_ERROR)
+   {
+      printf("Error: empty image pool not detected\n");
+      Status = EXIT_FAILURE;
+   }
+
+   for (i = 0; i < NUM_FRAMES; i++)
+   {
+      if (Descs[i].PTD.ImageMatrix[0] == NULL || fee_buffer_pool_release(ImagePool, Descs[i].ImageBufferIndex) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: image buffer of descriptor %zu not acquired\n", i);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   fee_buffer_pool_destroy(ImagePool);
+
+   return Status;
+}
+
+/*Every task of a job must run exactly once, with any number of tasks*/
+int pool_stress_test(fee_thread_pool_t *Pool)
+{
+   size_t Job, i, NumTasks;
+
+   for (Job = 0; Job < STRESS_JOBS; Job++)
+   {
+      NumTasks = Job % 2 ? STRESS_TASKS : Job;
+      for (i = 0; i < NumTasks; i++)
+      {
+         atomic_store(&TaskCounts[i], 0);
+      }
+
+      if (fee_thread_pool_run(Pool, NumTasks, count_task, NULL) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error running job %zu\n", Job);
+         return EXIT_FAILURE;
+      }
+
+      for (i = 0; i < NumTasks; i++)
+      {
+         if (atomic_load(&TaskCounts[i]) != 1)
+         {
+            printf("Error: task %zu of job %zu run %d times\n", i, Job, atomic_load(&TaskCounts[i]));
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+void empty_task(void *TaskData, size_t TaskIndex)
+{
+   (void)TaskData;
+   (void)TaskIndex;
+}
+
+/*Task that runs jobs from inside a job of OuterPool*/
+void nested_task(void *TaskData, size_t TaskIndex)
+{
+   (void)TaskData;
+   if (fee_thread_pool_run(OuterPool, 1, empty_task, NULL) != FEE_EXIT_ERROR)
+   {
+      atomic_fetch_add(&SamePoolSuccesses, 1);
+   }
+   if (fee_thread_pool_run(InnerPool, 1, empty_task, NULL) != FEE_EXIT_SUCCESS)
+   {
+      atomic_fetch_add(&OtherPoolFailures, 1);
+   }
+   atomic_fetch_add(&TaskCounts[TaskIndex], 1);
+}
+
+/*A job run on the pool of the task is rejected instead of waiting forever. Other pools can be used*/
+int reentry_test(fee_thread_pool_t *Pool)
+{
+   size_t i;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_thread_pool_create(2, &InnerPool) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating the inner pool\n");
+      return EXIT_FAILURE;
+   }
+   OuterPool = Pool;
+   for (i = 0; i < STRESS_TASKS; i++)
+   {
+      atomic_store(&TaskCounts[i], 0);
+   }
+
+   if (fee_thread_pool_run(OuterPool, NESTED_TASKS, nested_task, NULL) != FEE_EXIT_SUCCESS ||
+       atomic_load(&SamePoolSuccesses) != 0 || atomic_load(&OtherPoolFailures) != 0)
+   {
+      printf("Error: nested jobs (%d same pool runs not rejected, %d other pool runs failed)\n",
+             atomic_load(&SamePoolSuccesses), atomic_load(&OtherPoolFailures));
+      Status = EXIT_FAILURE;
+   }
+   for (i = 0; i < NESTED_TASKS && Status == EXIT_SUCCESS; i++)
+   {
+      if (atomic_load(&TaskCounts[i]) != 1)
+      {
+         printf("Error: nested task %zu run %d times\n", i, atomic_load(&TaskCounts[i]));
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   /*The pool accepts jobs again once the outer job has finished*/
+   if (Status == EXIT_SUCCESS && fee_thread_pool_run(OuterPool, 1, empty_task, NULL) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error: pool not usable after the nested jobs\n");
+      Status = EXIT_FAILURE;
+   }
+
+   fee_thread_pool_destroy(InnerPool);
+
+   return Status;
+}
+
+int main(void)
+{
+   fee_thread_pool_t *Pool = NULL;
+   fee_batch_config_t PoolConfig = {NULL, NULL, NULL, NULL, CHUNK_SIZE, 1};
+   fee_batch_config_t SerialConfig = {NULL, serial_executor, NULL, NULL, 0, 1};
+   int Status = EXIT_SUCCESS;
+   size_t i;
+   int k;
+
+   if (fee_thread_pool_create(NUM_WORKERS, &Pool) != FEE_EXIT_SUCCESS || fee_thread_pool_size(Pool) != NUM_WORKERS ||
+       fee_thread_pool_default() == NULL)
+   {
+      printf("Error creating the thread pools\n");
+      fee_thread_pool_destroy(Pool);
+      return EXIT_FAILURE;
+   }
+   PoolConfig.Pool = Pool;
+
+   if (generate_frames() != EXIT_SUCCESS)
+   {
+      printf("Error generating the frames\n");
+      Status = EXIT_FAILURE;
+   }
+
+   if (Status == EXIT_SUCCESS)
+   {
+      Status |= batch_test(FEE_PACKET_PTD, &PoolConfig, "PTD pool");
+      Status |= batch_test(FEE_PACKET_PTD, &SerialConfig, "PTD serial executor");
+      Status |= batch_test(FEE_PACKET_PTD, NULL, "PTD default pool");
+      Status |= batch_test(FEE_PACKET_TM, &PoolConfig, "TM pool");
+      Status |= batch_test(FEE_PACKET_TM, &SerialConfig, "TM serial executor");
+      Status |= batch_test(FEE_PACKET_TM, NULL, "TM default pool");
+      Status |= image_pool_test(Pool);
+      Status |= pool_stress_test(Pool);
+      Status |= reentry_test(Pool);
+   }
+
+   fee_thread_pool_destroy(Pool);
+   for (i = 0; i < NUM_FRAMES; i++)
+   {
+      fee_gen_frame_free(&Frames[i]);
+      free(Packets[i]);
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         free(Reference[i].ImageMatrix[k]);
+      }
+   }
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Batch Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
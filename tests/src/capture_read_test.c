@@ -0,0 +1,264 @@
+/**
+ * @file capture_read_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Parallel Capture Read Test. The TM and PTD captures are read in small byte ranges on a pool of several
+ *  workers, and the records must be the same as reading every capture as a single range on one worker, or on a
+ *  caller-supplied executor that runs the tasks backwards. Records must be in timestamp order, every PTD must be
+ *  described by the TM with its timestamp, and its planes must match a direct fee_PTD_Read of its packet.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fee.h>
+#include <fee_batch.h>
+#include <fee_capture.h>
+
+#define NUM_WORKERS 4
+#define SMALL_RANGE_BYTES 4096
+#define SINGLE_RANGE_BYTES UINT64_MAX
+
+/*Executor that runs the tasks backwards on the calling thread*/
+int backwards_executor(void *ExecutorData, size_t NumTasks, fee_task_fn Task, void *TaskData)
+{
+   (void)ExecutorData;
+
+   while (NumTasks > 0)
+   {
+      Task(TaskData, --NumTasks);
+   }
+
+   return FEE_EXIT_SUCCESS;
+}
+
+size_t count_packets(fee_capture_t *Capture, fee_capture_type_t Type)
+{
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   size_t Count = 0;
+
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      Count += Packet.Type == Type;
+   }
+   fee_capture_iter_free(&Iter);
+
+   return Count;
+}
+
+int compare_records(const fee_capture_records_t *Expected, const fee_capture_records_t *Records)
+{
+   const fee_capture_record_t *A, *B;
+   fee_PTDSizes_t PTDSizes;
+   fee_ImageMatrixTotalSizes_t ImageMatrixSizes;
+   size_t i;
+   int k;
+
+   if (Expected->NumRecords != Records->NumRecords || Expected->NumErrors != Records->NumErrors ||
+       Expected->NumSkipped != Records->NumSkipped)
+   {
+      printf("Error: %zu records instead of %zu\n", Records->NumRecords, Expected->NumRecords);
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < Records->NumRecords; i++)
+   {
+      A = &Expected->Records[i];
+      B = &Records->Records[i];
+      if (A->Timestamp != B->Timestamp || A->CaptureIndex != B->CaptureIndex || A->Offset != B->Offset ||
+          A->Desc.Type != B->Desc.Type || A->Desc.Status != B->Desc.Status || A->Desc.PacketBytes != B->Desc.PacketBytes ||
+          memcmp(A->Desc.Packet, B->Desc.Packet, A->Desc.PacketBytes) != 0 || memcmp(&A->Desc.TM, &B->Desc.TM, sizeof(fee_TM_t)) != 0)
+      {
+         printf("Error at record %zu\n", i);
+         return EXIT_FAILURE;
+      }
+
+      if (A->Desc.Type != FEE_PACKET_PTD || A->Desc.Status != FEE_EXIT_SUCCESS)
+      {
+         continue;
+      }
+      fee_Calculate_PTD_Sizes(A->Desc.TM, &PTDSizes, &ImageMatrixSizes);
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         if (memcmp(A->Desc.PTD.ImageMatrix[k], B->Desc.PTD.ImageMatrix[k], ImageMatrixSizes.ImageMatrixBytes) != 0)
+         {
+            printf("Error at the plane %d of record %zu\n", k, i);
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+/*Order, pairing and planes of the records*/
+int check_records(const fee_capture_records_t *Records, size_t NumTM, size_t NumPTD)
+{
+   const fee_capture_record_t *Record, *LastTM = NULL;
+   fee_PTD_t PTD;
+   size_t i, FoundPTD = 0;
+   int k, Status = EXIT_SUCCESS;
+
+   if (Records->NumRecords != NumTM + NumPTD || Records->NumErrors != 0 || NumPTD == 0)
+   {
+      printf("Error: %zu records (%zu errors) for %zu TM and %zu PTD\n", Records->NumRecords, Records->NumErrors, NumTM, NumPTD);
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < Records->NumRecords && Status == EXIT_SUCCESS; i++)
+   {
+      Record = &Records->Records[i];
+      if (i > 0 && Records->Records[i - 1].Timestamp > Record->Timestamp)
+      {
+         printf("Error: record %zu is out of order\n", i);
+         return EXIT_FAILURE;
+      }
+
+      if (Record->Desc.Type == FEE_PACKET_TM)
+      {
+         LastTM = Record;
+         continue;
+      }
+
+      FoundPTD++;
+      if (LastTM == NULL || LastTM->Timestamp != Record->Timestamp || memcmp(&LastTM->Desc.TM, &Record->Desc.TM, sizeof(fee_TM_t)) != 0)
+      {
+         printf("Error: PTD record %zu is not described by its TM\n", i);
+         return EXIT_FAILURE;
+      }
+
+      memset(&PTD, 0, sizeof(PTD));
+      fee_Calculate_PTD_Sizes(Record->Desc.TM, &PTD.PTDSizes, &PTD.PTDImageMatrixTotalSizes);
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         PTD.ImageMatrix[k] = (uint16_t *)malloc(PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes + 1);
+      }
+      if (fee_PTD_Read(Record->Desc.Packet, Record->Desc.TM, &PTD) != FEE_EXIT_SUCCESS)
+      {
+         Status = EXIT_FAILURE;
+      }
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         if (Status == EXIT_SUCCESS &&
+             memcmp(PTD.ImageMatrix[k], Record->Desc.PTD.ImageMatrix[k], PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes) != 0)
+         {
+            Status = EXIT_FAILURE;
+         }
+         free(PTD.ImageMatrix[k]);
+      }
+      if (Status != EXIT_SUCCESS)
+      {
+         printf("Error: planes of PTD record %zu\n", i);
+      }
+   }
+
+   if (Status == EXIT_SUCCESS && FoundPTD != NumPTD)
+   {
+      printf("Error: %zu PTD records instead of %zu\n", FoundPTD, NumPTD);
+      Status = EXIT_FAILURE;
+   }
+
+   return Status;
+}
+
+int main(int argc, char *argv[])
+{
+   fee_capture_t *Captures[2] = {NULL, NULL};
+   fee_thread_pool_t *Serial = NULL, *Parallel = NULL;
+   fee_batch_config_t Config;
+   fee_capture_records_t Expected, Records;
+   size_t NumTM, NumPTD;
+   int Status = EXIT_SUCCESS;
+
+   if (argc < 3)
+   {
+      printf("Usage: %s <TM capture> <PTD capture>\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   /*The TM capture goes first: PTD lines have the timestamp of the TM that describes them*/
+   if (fee_capture_open(argv[1], &Captures[0]) != FEE_EXIT_SUCCESS || fee_capture_open(argv[2], &Captures[1]) != FEE_EXIT_SUCCESS ||
+       fee_thread_pool_create(1, &Serial) != FEE_EXIT_SUCCESS || fee_thread_pool_create(NUM_WORKERS, &Parallel) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error opening the captures\n");
+      fee_capture_close(Captures[0]);
+      fee_capture_close(Captures[1]);
+      fee_thread_pool_destroy(Serial);
+      return EXIT_FAILURE;
+   }
+   NumTM = count_packets(Captures[0], FEE_CAPTURE_TM);
+   NumPTD = count_packets(Captures[1], FEE_CAPTURE_PTD);
+
+   memset(&Config, 0, sizeof(Config));
+   Config.Pool = Serial;
+   Config.CheckChecksum = 1;
+   if (fee_capture_read_parallel(Captures, 2, SINGLE_RANGE_BYTES, &Config, &Expected) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error reading the captures as single ranges\n");
+      Status = EXIT_FAILURE;
+   }
+   else
+   {
+      Status |= check_records(&Expected, NumTM, NumPTD);
+
+      Config.Pool = Parallel;
+      if (fee_capture_read_parallel(Captures, 2, SMALL_RANGE_BYTES, &Config, &Records) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error reading the captures in parallel\n");
+         Status = EXIT_FAILURE;
+      }
+      else
+      {
+         Status |= compare_records(&Expected, &Records);
+         fee_capture_records_free(&Records);
+      }
+
+      Config.Pool = NULL;
+      Config.Executor = backwards_executor;
+      Config.ChunkSize = 3;
+      if (fee_capture_read_parallel(Captures, 2, SMALL_RANGE_BYTES / 3, &Config, &Records) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error reading the captures with an executor\n");
+         Status = EXIT_FAILURE;
+      }
+      else
+      {
+         Status |= compare_records(&Expected, &Records);
+         fee_capture_records_free(&Records);
+      }
+
+      fee_capture_records_free(&Expected);
+   }
+
+   /*Without their TM, PTD records cannot be decoded*/
+   if (Status == EXIT_SUCCESS)
+   {
+      if (fee_capture_read_parallel(&Captures[1], 1, SMALL_RANGE_BYTES, NULL, &Records) != FEE_EXIT_SUCCESS ||
+          Records.NumRecords != NumPTD || Records.NumErrors != NumPTD)
+      {
+         printf("Error: PTD records decoded without TM\n");
+         Status = EXIT_FAILURE;
+      }
+      fee_capture_records_free(&Records);
+   }
+
+   fee_thread_pool_destroy(Serial);
+   fee_thread_pool_destroy(Parallel);
+   fee_capture_close(Captures[0]);
+   fee_capture_close(Captures[1]);
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Parallel Capture Read Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
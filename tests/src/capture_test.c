@@ -0,0 +1,497 @@
+/**
+ * @file capture_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Capture Index Test. The TM and TC captures are scanned line by line and every packet must have the expected
+ *  type and checksum. Seeking every timestamp through the persistent index, and iterating timestamp ranges, must
+ *  reach the same packets as a linear scan. The index file must be reused while the capture is unchanged and rebuilt
+ *  when it changes. A generated capture checks the PTD type and sizes, and an unsorted one the fallback to a scan.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fee.h>
+#include <fee_generator.h>
+#include <fee_capture.h>
+
+#define MAX_PACKETS 8192
+#define STRIDE 16
+#define NUM_PTD_FRAMES 3
+#define FIRST_TIMESTAMP 1647259994121ULL
+
+#define TM_INDEX_FILE "capture_test_TM.idx"
+#define COPY_FILE "capture_test_copy.txt"
+#define PTD_FILE "capture_test_PTD.txt"
+#define UNSORTED_FILE "capture_test_unsorted.txt"
+
+uint64_t Timestamps[MAX_PACKETS];
+uint64_t Offsets[MAX_PACKETS];
+
+/*Linear scan of a capture. Every packet must be of the given type with a valid checksum*/
+int scan_test(const char *Path, fee_capture_type_t Type, uint64_t *NumPackets)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_capture_open(Path, &Capture) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error opening %s\n", Path);
+      return EXIT_FAILURE;
+   }
+
+   *NumPackets = 0;
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (Status == EXIT_SUCCESS && fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      if (Packet.Type != Type || Packet.PacketIndex != *NumPackets || *NumPackets >= MAX_PACKETS)
+      {
+         printf("Error at packet %llu of %s: type %d\n", (unsigned long long)*NumPackets, Path, (int)Packet.Type);
+         Status = EXIT_FAILURE;
+         break;
+      }
+      if ((Type == FEE_CAPTURE_TM && fee_CheckTelemetryChecksum((uint8_t *)Packet.Bytes) != FEE_EXIT_SUCCESS) ||
+          (Type == FEE_CAPTURE_TC && fee_CheckTeleCommandChecksum((uint8_t *)Packet.Bytes) != FEE_EXIT_SUCCESS))
+      {
+         printf("Error: wrong checksum at packet %llu of %s\n", (unsigned long long)*NumPackets, Path);
+         Status = EXIT_FAILURE;
+      }
+
+      Timestamps[*NumPackets] = Packet.Timestamp;
+      Offsets[*NumPackets] = Packet.Offset;
+      (*NumPackets)++;
+   }
+   fee_capture_iter_free(&Iter);
+   fee_capture_close(Capture);
+
+   if (Status == EXIT_SUCCESS && *NumPackets == 0)
+   {
+      printf("Error: %s has no packets\n", Path);
+      Status = EXIT_FAILURE;
+   }
+
+   return Status;
+}
+
+/*First packet at or after Timestamp, from the linear scan*/
+uint64_t linear_seek(uint64_t NumPackets, uint64_t Timestamp)
+{
+   uint64_t i;
+
+   for (i = 0; i < NumPackets && Timestamps[i] < Timestamp; i++)
+   {
+   }
+
+   return i;
+}
+
+uint64_t linear_count(uint64_t NumPackets, uint64_t First, uint64_t Last)
+{
+   uint64_t i, Count = 0;
+
+   for (i = 0; i < NumPackets; i++)
+   {
+      Count += Timestamps[i] >= First && Timestamps[i] <= Last;
+   }
+
+   return Count;
+}
+
+uint64_t range_count(const fee_capture_index_t *Index, const fee_capture_t *Capture, uint64_t First, uint64_t Last)
+{
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   uint64_t Count = 0;
+
+   fee_capture_index_range(Index, Capture, First, Last, &Iter);
+   while (fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      if (Packet.Timestamp < First || Packet.Timestamp > Last || Packet.Offset != Offsets[Packet.PacketIndex])
+      {
+         Count = UINT64_MAX;
+         break;
+      }
+      Count++;
+   }
+   fee_capture_iter_free(&Iter);
+
+   return Count;
+}
+
+/*Seeking every timestamp (and the ones next to it) must scan at most Stride packets to the linear result*/
+int seek_test(const fee_capture_index_t *Index, const fee_capture_t *Capture, uint64_t NumPackets)
+{
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   uint64_t i, NumEntries, Target, Offset, PacketIndex, Expected, Scanned;
+   uint32_t Stride;
+   int Delta;
+
+   fee_capture_index_entries(Index, &NumEntries, &Stride, NULL);
+
+   for (i = 0; i < NumPackets; i++)
+   {
+      for (Delta = -1; Delta <= 1; Delta++)
+      {
+         Target = Timestamps[i] + (uint64_t)(int64_t)Delta;
+         Expected = linear_seek(NumPackets, Target);
+
+         fee_capture_index_seek(Index, Target, &Offset, &PacketIndex);
+         if (PacketIndex > Expected || Offset != Offsets[PacketIndex])
+         {
+            printf("Error seeking %llu: packet %llu after %llu\n", (unsigned long long)Target,
+                   (unsigned long long)PacketIndex, (unsigned long long)Expected);
+            return EXIT_FAILURE;
+         }
+
+         fee_capture_iter_init(Capture, Offset, UINT64_MAX, &Iter);
+         Iter.PacketIndex = PacketIndex;
+         Scanned = 0;
+         while (fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS && Packet.Timestamp < Target)
+         {
+            Scanned++;
+         }
+         fee_capture_iter_free(&Iter);
+
+         if (Expected < NumPackets && (Packet.PacketIndex != Expected || Scanned > Stride))
+         {
+            printf("Error seeking %llu: packet %llu instead of %llu after %llu packets\n", (unsigned long long)Target,
+                   (unsigned long long)Packet.PacketIndex, (unsigned long long)Expected, (unsigned long long)Scanned);
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+int index_test(const char *Path, uint64_t NumPackets)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_index_t *Index = NULL;
+   const fee_capture_index_entry_t *Entries;
+   uint64_t NumEntries, IndexPackets, First, Last, i;
+   uint32_t Stride;
+   int Status = EXIT_SUCCESS;
+
+   unlink(TM_INDEX_FILE);
+   if (fee_capture_open(Path, &Capture) != FEE_EXIT_SUCCESS ||
+       fee_capture_index_open(Capture, TM_INDEX_FILE, STRIDE, &Index) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error opening the index of %s\n", Path);
+      fee_capture_close(Capture);
+      return EXIT_FAILURE;
+   }
+
+   Entries = fee_capture_index_entries(Index, &NumEntries, &Stride, &IndexPackets);
+   if (Stride != STRIDE || IndexPackets != NumPackets || NumEntries != (NumPackets + STRIDE - 1) / STRIDE)
+   {
+      printf("Error: index of %llu entries for %llu packets\n", (unsigned long long)NumEntries, (unsigned long long)IndexPackets);
+      Status = EXIT_FAILURE;
+   }
+   for (i = 0; Status == EXIT_SUCCESS && i < NumEntries; i++)
+   {
+      if (Entries[i].PacketIndex != i * STRIDE || Entries[i].Offset != Offsets[i * STRIDE] ||
+          Entries[i].Timestamp != Timestamps[i * STRIDE] || Entries[i].Type != FEE_CAPTURE_TM)
+      {
+         printf("Error at index entry %llu\n", (unsigned long long)i);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   if (Status == EXIT_SUCCESS)
+   {
+      Status = seek_test(Index, Capture, NumPackets);
+   }
+
+   for (i = 0; Status == EXIT_SUCCESS && i + 1 < NumPackets; i += NumPackets / 7 + 1)
+   {
+      First = Timestamps[i];
+      Last = Timestamps[(i + NumPackets / 5) < NumPackets ? i + NumPackets / 5 : NumPackets - 1];
+      if (range_count(Index, Capture, First, Last) != linear_count(NumPackets, First, Last))
+      {
+         printf("Error iterating [%llu, %llu]\n", (unsigned long long)First, (unsigned long long)Last);
+         Status = EXIT_FAILURE;
+      }
+   }
+   if (Status == EXIT_SUCCESS && (range_count(Index, Capture, 0, Timestamps[0] - 1) != 0 ||
+                                  range_count(Index, Capture, 0, UINT64_MAX) != NumPackets))
+   {
+      printf("Error iterating the ranges out of the capture\n");
+      Status = EXIT_FAILURE;
+   }
+   fee_capture_index_close(Index);
+   Index = NULL;
+
+   /*The index file is reused with its own stride while the capture does not change*/
+   if (Status == EXIT_SUCCESS)
+   {
+      if (fee_capture_index_open(Capture, TM_INDEX_FILE, STRIDE * 2, &Index) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error reopening the index\n");
+         Status = EXIT_FAILURE;
+      }
+      else
+      {
+         fee_capture_index_entries(Index, &NumEntries, &Stride, NULL);
+         if (Stride != STRIDE || seek_test(Index, Capture, NumPackets) != EXIT_SUCCESS)
+         {
+            printf("Error: the index file was not reused\n");
+            Status = EXIT_FAILURE;
+         }
+         fee_capture_index_close(Index);
+      }
+   }
+
+   fee_capture_close(Capture);
+   unlink(TM_INDEX_FILE);
+
+   return Status;
+}
+
+int copy_lines(const char *Path, const char *CopyPath, uint64_t NumLines)
+{
+   FILE *fIn, *fOut;
+   int c;
+
+   fIn = fopen(Path, "rb");
+   fOut = fopen(CopyPath, "wb");
+   if (fIn == NULL || fOut == NULL)
+   {
+      if (fIn != NULL)
+      {
+         fclose(fIn);
+      }
+      if (fOut != NULL)
+      {
+         fclose(fOut);
+      }
+      return EXIT_FAILURE;
+   }
+
+   while (NumLines > 0 && (c = fgetc(fIn)) != EOF)
+   {
+      fputc(c, fOut);
+      NumLines -= c == '\n';
+   }
+
+   fclose(fIn);
+   return fclose(fOut) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+uint64_t indexed_packets(const char *Path)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_index_t *Index = NULL;
+   uint64_t NumEntries, NumPackets = 0;
+
+   if (fee_capture_open(Path, &Capture) == FEE_EXIT_SUCCESS &&
+       fee_capture_index_open(Capture, NULL, 0, &Index) == FEE_EXIT_SUCCESS)
+   {
+      fee_capture_index_entries(Index, &NumEntries, NULL, &NumPackets);
+   }
+   fee_capture_index_close(Index);
+   fee_capture_close(Capture);
+
+   return NumPackets;
+}
+
+/*An index built for an older version of the capture must be rebuilt*/
+int stale_test(const char *Path, uint64_t NumPackets)
+{
+   int Status = EXIT_SUCCESS;
+
+   if (copy_lines(Path, COPY_FILE, NumPackets / 2) != EXIT_SUCCESS || indexed_packets(COPY_FILE) != NumPackets / 2 ||
+       copy_lines(Path, COPY_FILE, NumPackets) != EXIT_SUCCESS || indexed_packets(COPY_FILE) != NumPackets)
+   {
+      printf("Error: the index of a changed capture was not rebuilt\n");
+      Status = EXIT_FAILURE;
+   }
+
+   unlink(COPY_FILE);
+   unlink(COPY_FILE FEE_CAPTURE_INDEX_EXTENSION);
+
+   return Status;
+}
+
+/*TM lines must report the size of the PTD they describe, and PTD lines their own size*/
+int ptd_test(void)
+{
+   fee_gen_config_t Config;
+   fee_gen_frame_t Frame = {0};
+   fee_capture_t *Capture = NULL;
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   uint32_t PTDBytes[NUM_PTD_FRAMES];
+   uint32_t i, NumPackets = 0;
+   int Status = EXIT_SUCCESS;
+   FILE *fp;
+
+   fp = fopen(PTD_FILE, "w");
+   if (fp == NULL)
+   {
+      return EXIT_FAILURE;
+   }
+   fee_gen_config_default(&Config);
+   for (i = 0; i < NUM_PTD_FRAMES && Status == EXIT_SUCCESS; i++)
+   {
+      Config.WOISIZE = (uint16_t)(Config.WOISIZE - 10 * i);
+      if (fee_gen_frame(&Config, i, &Frame) != FEE_EXIT_SUCCESS ||
+          fee_gen_fprint_packet(fp, FIRST_TIMESTAMP + 2 * i, Frame.TM_Packet, TM_PACKET_BYTES, 0) != FEE_EXIT_SUCCESS ||
+          fee_gen_fprint_packet(fp, FIRST_TIMESTAMP + 2 * i + 1, Frame.PTD_Packet, Frame.PTD.PTDSizes.DataPacketTotalBytes, 1) !=
+              FEE_EXIT_SUCCESS)
+      {
+         Status = EXIT_FAILURE;
+      }
+      PTDBytes[i] = (uint32_t)Frame.PTD.PTDSizes.DataPacketTotalBytes;
+   }
+   fee_gen_frame_free(&Frame);
+   if (fclose(fp) != 0 || Status != EXIT_SUCCESS || fee_capture_open(PTD_FILE, &Capture) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error writing %s\n", PTD_FILE);
+      unlink(PTD_FILE);
+      return EXIT_FAILURE;
+   }
+
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      i = NumPackets / 2;
+      if (i >= NUM_PTD_FRAMES || Packet.Type != (NumPackets % 2 ? FEE_CAPTURE_PTD : FEE_CAPTURE_TM) ||
+          Packet.PTDBytes != PTDBytes[i] || Packet.NumBytes != (NumPackets % 2 ? PTDBytes[i] : TM_PACKET_BYTES))
+      {
+         printf("Error at packet %u of %s\n", NumPackets, PTD_FILE);
+         Status = EXIT_FAILURE;
+         break;
+      }
+      NumPackets++;
+   }
+   fee_capture_iter_free(&Iter);
+   fee_capture_close(Capture);
+   unlink(PTD_FILE);
+
+   if (Status == EXIT_SUCCESS && NumPackets != 2 * NUM_PTD_FRAMES)
+   {
+      printf("Error: %u packets in %s\n", NumPackets, PTD_FILE);
+      Status = EXIT_FAILURE;
+   }
+
+   return Status;
+}
+
+/*Writes the lines of the last scanned capture backwards*/
+int write_reversed(const char *Path, const char *ReversedPath, uint64_t NumPackets)
+{
+   char Line[TM_PACKET_BYTES * 10];
+   FILE *fIn, *fOut;
+   uint64_t i;
+   int Status = EXIT_SUCCESS;
+
+   fIn = fopen(Path, "rb");
+   if (fIn == NULL)
+   {
+      return EXIT_FAILURE;
+   }
+   fOut = fopen(ReversedPath, "wb");
+   if (fOut == NULL)
+   {
+      fclose(fIn);
+      return EXIT_FAILURE;
+   }
+
+   for (i = NumPackets; i > 0 && Status == EXIT_SUCCESS; i--)
+   {
+      if (fseek(fIn, (long)Offsets[i - 1], SEEK_SET) != 0 || fgets(Line, sizeof(Line), fIn) == NULL || fputs(Line, fOut) < 0)
+      {
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   fclose(fIn);
+   if (fclose(fOut) != 0)
+   {
+      Status = EXIT_FAILURE;
+   }
+
+   return Status;
+}
+
+/*The index of a capture with timestamps out of order cannot seek, but ranges must still be complete*/
+int unsorted_test(const char *Path, uint64_t NumPackets)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_index_t *Index = NULL;
+   uint64_t Offset, PacketIndex, First, Last;
+   int Status = EXIT_SUCCESS;
+
+   if (copy_lines(Path, COPY_FILE, NumPackets) != EXIT_SUCCESS || scan_test(COPY_FILE, FEE_CAPTURE_TM, &NumPackets) != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   Status = write_reversed(COPY_FILE, UNSORTED_FILE, NumPackets);
+   unlink(COPY_FILE);
+
+   First = Timestamps[NumPackets / 3];
+   Last = Timestamps[NumPackets / 2];
+   if (Status == EXIT_SUCCESS && scan_test(UNSORTED_FILE, FEE_CAPTURE_TM, &NumPackets) == EXIT_SUCCESS &&
+       fee_capture_open(UNSORTED_FILE, &Capture) == FEE_EXIT_SUCCESS &&
+       fee_capture_index_open(Capture, NULL, STRIDE, &Index) == FEE_EXIT_SUCCESS)
+   {
+      fee_capture_index_seek(Index, Last, &Offset, &PacketIndex);
+      if (Offset != 0 || PacketIndex != 0 || range_count(Index, Capture, First, Last) != linear_count(NumPackets, First, Last))
+      {
+         printf("Error iterating an unsorted capture\n");
+         Status = EXIT_FAILURE;
+      }
+   }
+   else
+   {
+      printf("Error indexing an unsorted capture\n");
+      Status = EXIT_FAILURE;
+   }
+   fee_capture_index_close(Index);
+   fee_capture_close(Capture);
+   unlink(UNSORTED_FILE);
+   unlink(UNSORTED_FILE FEE_CAPTURE_INDEX_EXTENSION);
+
+   return Status;
+}
+
+int main(int argc, char *argv[])
+{
+   uint64_t NumTM = 0, NumTC = 0;
+   int Status = EXIT_SUCCESS;
+
+   if (argc < 3)
+   {
+      printf("Usage: %s <TM capture> <TC capture>\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   if (scan_test(argv[2], FEE_CAPTURE_TC, &NumTC) != EXIT_SUCCESS || scan_test(argv[1], FEE_CAPTURE_TM, &NumTM) != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   Status |= index_test(argv[1], NumTM);
+   Status |= stale_test(argv[1], NumTM);
+   Status |= ptd_test();
+   Status |= unsorted_test(argv[1], NumTM);
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Capture Index Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
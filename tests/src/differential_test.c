@@ -0,0 +1,610 @@
+/**
+ * @file differential_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Differential Test. The fast paths of the library are compared byte for byte with the reference codec (the
+ *  generic PTD loop with the scalar kernels): the PTD kernels of every CPU tier supported by the host, the vector
+ *  checksums, the multi-threaded pipeline and the raw-packet views of the stream tracker. Every iteration draws a
+ *  random geometry and checks generated, corrupted, random and adversarial packets, and truncated lengths. The
+ *  first divergence is reported with the seed and the iteration that reproduce it.
+ *  The program is executed as: differential_test [Iterations] [Seed]
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_dispatch.h>
+#include <fee_generator.h>
+#include <fee_pipeline.h>
+#include <fee_stream.h>
+
+#define DEFAULT_ITERATIONS 48
+#define DEFAULT_SEED 37
+#define MAX_VARIANTS (2 * FEE_CPU_NUM_TIERS)
+#define POISON 0xA5 /*Fill of the outputs, so that bytes written by only one path are detected*/
+#define LARGE_GEOMETRY_PERIOD 16
+
+typedef enum
+{
+   CASE_GENERATED = 0,
+   CASE_CORRUPTED = 1,
+   CASE_RANDOM = 2,
+   CASE_RANDOM_VALID = 3, /*Random bytes with a valid checksum*/
+   CASE_ZEROS = 4,
+   CASE_ONES = 5,
+   CASE_ALTERNATING = 6,
+   NUM_CASES = 7
+
+} packet_case_t;
+
+const char *CaseNames[NUM_CASES] = {"generated", "corrupted", "random", "random-valid", "zeros", "ones", "alternating"};
+
+/*Configuration of the library for a path*/
+typedef struct
+{
+   char Name[32];
+   int Kernels;
+   fee_cpu_tier_t Tier;
+
+} variant_t;
+
+/*Outputs of a PTD decode*/
+typedef struct
+{
+   int Status;
+   int ChecksumStatus;
+   int TruncatedChecksumStatus;
+   fee_PTD_t PTD;
+   uint16_t *Planes;
+
+} ptd_result_t;
+
+variant_t Variants[MAX_VARIANTS]; /*Variants[0] is the reference*/
+size_t NumVariants;
+uint32_t RandomState;
+uint32_t Seed, Iteration;
+int Diverged;
+
+/*xorshift32, so that a seed reproduces the same packets on every platform*/
+uint32_t next_random(void)
+{
+   RandomState ^= RandomState << 13;
+   RandomState ^= RandomState >> 17;
+   RandomState ^= RandomState << 5;
+   return RandomState;
+}
+
+uint32_t random_below(uint32_t Limit)
+{
+   return next_random() % Limit;
+}
+
+void select_variant(const variant_t *Variant)
+{
+   fee_PTD_EnableKernels(Variant->Kernels);
+   fee_dispatch_set_tier(Variant->Tier);
+}
+
+void build_variants(void)
+{
+   int Tier;
+
+   NumVariants = 0;
+   strcpy(Variants[NumVariants].Name, "reference");
+   Variants[NumVariants].Kernels = 0;
+   Variants[NumVariants++].Tier = FEE_CPU_TIER_SCALAR;
+
+   for (Tier = FEE_CPU_TIER_SCALAR; Tier <= (int)fee_dispatch_detected_tier(); Tier++)
+   {
+      snprintf(Variants[NumVariants].Name, sizeof(Variants[0].Name), "kernels/%s", fee_dispatch_tier_name((fee_cpu_tier_t)Tier));
+      Variants[NumVariants].Kernels = 1;
+      Variants[NumVariants++].Tier = (fee_cpu_tier_t)Tier;
+
+      if (Tier != FEE_CPU_TIER_SCALAR)
+      {
+         snprintf(Variants[NumVariants].Name, sizeof(Variants[0].Name), "generic/%s", fee_dispatch_tier_name((fee_cpu_tier_t)Tier));
+         Variants[NumVariants].Kernels = 0;
+         Variants[NumVariants++].Tier = (fee_cpu_tier_t)Tier;
+      }
+   }
+}
+
+/*Index of the first different byte. Length if both buffers are equal*/
+size_t first_difference(const void *A, const void *B, size_t Length)
+{
+   const uint8_t *a = A, *b = B;
+   size_t i;
+
+   for (i = 0; i < Length && a[i] == b[i]; i++)
+   {
+   }
+
+   return i;
+}
+
+/*Only the first divergence is reported. The test stops after it*/
+void report(const char *Case, const char *Variant, const char *What, size_t Offset)
+{
+   if (!Diverged)
+   {
+      printf("First divergence (seed %u, iteration %u): %s packet, %s path, %s differs at byte %zu\n",
+             Seed, Iteration, Case, Variant, What, Offset);
+   }
+   Diverged = 1;
+}
+
+void compare_bytes(const char *Case, const char *Variant, const char *What, const void *Reference, const void *Value,
+                   size_t Length)
+{
+   size_t Offset = first_difference(Reference, Value, Length);
+
+   if (Offset < Length)
+   {
+      report(Case, Variant, What, Offset);
+   }
+}
+
+void compare_status(const char *Case, const char *Variant, const char *What, int Reference, int Value)
+{
+   if (Reference != Value)
+   {
+      report(Case, Variant, What, 0);
+   }
+}
+
+/*Host order words, with the odd byte in the low byte*/
+uint16_t reference_checksum16(const uint8_t *Data, size_t Length)
+{
+   uint16_t Checksum = 0, Word;
+   size_t i;
+
+   for (i = 0; i + 1 < Length; i += 2)
+   {
+      memcpy(&Word, Data + i, 2);
+      Checksum ^= Word;
+   }
+   if (Length % 2)
+   {
+      Checksum ^= Data[Length - 1];
+   }
+
+   return Checksum;
+}
+
+/*Packet of a case. Source is the generated packet. ChecksumBytes is 1 (TC) or 2 (TM and PTD)*/
+void fill_packet(packet_case_t Case, const uint8_t *Source, uint8_t *Packet, size_t Length, int ChecksumBytes)
+{
+   uint16_t Checksum16;
+   uint8_t Checksum8 = 0;
+   size_t i;
+
+   switch (Case)
+   {
+   case CASE_GENERATED:
+   case CASE_CORRUPTED:
+      memcpy(Packet, Source, Length);
+      if (Case == CASE_CORRUPTED)
+      {
+         Packet[random_below((uint32_t)Length)] ^= (uint8_t)(1 + random_below(255));
+      }
+      break;
+   case CASE_RANDOM:
+   case CASE_RANDOM_VALID:
+      for (i = 0; i < Length; i++)
+      {
+         Packet[i] = (uint8_t)next_random();
+      }
+      if (Case == CASE_RANDOM_VALID && ChecksumBytes == 2)
+      {
+         Checksum16 = reference_checksum16(Packet, Length - 2);
+         memcpy(Packet + Length - 2, &Checksum16, 2);
+      }
+      else if (Case == CASE_RANDOM_VALID)
+      {
+         for (i = 0; i + 1 < Length; i++)
+         {
+            Checksum8 ^= Packet[i];
+         }
+         Packet[Length - 1] = Checksum8;
+      }
+      break;
+   case CASE_ZEROS:
+      memset(Packet, 0x00, Length);
+      break;
+   case CASE_ONES:
+      memset(Packet, 0xFF, Length);
+      break;
+   default:
+      for (i = 0; i < Length; i++)
+      {
+         Packet[i] = i % 2 ? 0xAA : 0x55;
+      }
+      break;
+   }
+}
+
+void random_geometry(fee_gen_config_t *Config)
+{
+   int Large = Iteration % LARGE_GEOMETRY_PERIOD == LARGE_GEOMETRY_PERIOD - 1;
+   int Band;
+
+   fee_gen_config_default(Config);
+   Config->Pattern = FEE_GEN_PATTERN_NOISE;
+   Config->Seed = next_random();
+   Config->FirstCounter = next_random();
+   Config->WOISIZE = (uint16_t)(1 + random_below(Large ? TC_WOISIZE_MAX : 48));
+   Config->NBTAIL = (uint16_t)random_below(Large ? 64 : 8);
+   Config->SPATIALBINNINGMODE = random_below(2) ? SPATIALBIN_ENABLE : SPATALBIN_NOTENABLE;
+
+   /*An odd WOISIZE with spatial binning also removes an over-scan row*/
+   if (Config->SPATIALBINNINGMODE == SPATIALBIN_ENABLE && Config->WOISIZE % 2 != 0 && Config->NBTAIL == 0)
+   {
+      Config->NBTAIL = 1;
+   }
+
+   /*fee_TC_BoundsCheck limits the binning to TC_FREQBINNINGBAND_n_BINNINGSIZE_MAX*/
+   for (Band = 0; Band < FEE_GEN_NUM_BANDS; Band++)
+   {
+      Config->BinningSize[Band] = (uint16_t)(1 + random_below(TC_FREQBINNINGBAND_1_BINNINGSIZE_MAX));
+      Config->BandSize[Band] = (uint16_t)(Config->BinningSize[Band] *
+                                          (1 + random_below(TC_FREQBINNINGBAND_1_BANDSIZE_MAX / Config->BinningSize[Band])));
+      /*The first band is always enabled*/
+      if (Band > 0 && random_below(3) == 0)
+      {
+         Config->BandSize[Band] = 0;
+      }
+   }
+}
+
+/*fee_PTD_Write of the generated image must give the packet of the reference*/
+void ptd_write_test(const fee_gen_frame_t *Frame, uint8_t *Packet)
+{
+   size_t Bytes = Frame->PTD.PTDSizes.DataPacketTotalBytes;
+   size_t VariantIt;
+
+   for (VariantIt = 1; VariantIt < NumVariants; VariantIt++)
+   {
+      select_variant(&Variants[VariantIt]);
+      memset(Packet, POISON, Bytes);
+      compare_status("generated", Variants[VariantIt].Name, "write status", FEE_EXIT_SUCCESS,
+                     fee_PTD_Write(Frame->TM, Frame->PTD, Packet));
+      compare_bytes("generated", Variants[VariantIt].Name, "written packet", Frame->PTD_Packet, Packet, Bytes);
+   }
+}
+
+void ptd_read(uint8_t *Packet, const fee_TM_t *TM, size_t TruncatedBytes, size_t PlaneBytes, ptd_result_t *Result)
+{
+   fee_PTDSizes_t Truncated;
+   int k;
+
+   memset(Result->Planes, POISON, FEE_NUM_CCD * PlaneBytes);
+   memset(&Result->PTD, 0, sizeof(fee_PTD_t));
+   for (k = 0; k < FEE_NUM_CCD; k++)
+   {
+      Result->PTD.ImageMatrix[k] = Result->Planes + k * PlaneBytes / sizeof(uint16_t);
+   }
+
+   Result->Status = fee_PTD_Read(Packet, *TM, &Result->PTD);
+   Result->ChecksumStatus = fee_CheckPTDChecksum(Packet, Result->PTD.PTDSizes);
+
+   Truncated = Result->PTD.PTDSizes;
+   Truncated.DataPacketTotalBytes = TruncatedBytes;
+   Result->TruncatedChecksumStatus = fee_CheckPTDChecksum(Packet, Truncated);
+}
+
+void compare_ptd(const char *Case, const char *Variant, const ptd_result_t *Reference, const ptd_result_t *Result,
+                 size_t PlaneBytes)
+{
+   compare_status(Case, Variant, "read status", Reference->Status, Result->Status);
+   compare_status(Case, Variant, "checksum status", Reference->ChecksumStatus, Result->ChecksumStatus);
+   compare_status(Case, Variant, "truncated checksum status", Reference->TruncatedChecksumStatus,
+                  Result->TruncatedChecksumStatus);
+   compare_bytes(Case, Variant, "PIXEL_DATA_COUNTER", &Reference->PTD.PIXEL_DATA_COUNTER, &Result->PTD.PIXEL_DATA_COUNTER,
+                 sizeof(Reference->PTD.PIXEL_DATA_COUNTER));
+   compare_bytes(Case, Variant, "VOLTAGES_REFERENCES", Reference->PTD.VOLTAGES_REFERENCES,
+                 Result->PTD.VOLTAGES_REFERENCES, sizeof(Reference->PTD.VOLTAGES_REFERENCES));
+   compare_bytes(Case, Variant, "PTDSizes", &Reference->PTD.PTDSizes, &Result->PTD.PTDSizes, sizeof(fee_PTDSizes_t));
+   compare_bytes(Case, Variant, "image planes", Reference->Planes, Result->Planes, FEE_NUM_CCD * PlaneBytes);
+}
+
+int ptd_read_test(const fee_gen_frame_t *Frame, uint8_t *Packet)
+{
+   ptd_result_t Reference, Result;
+   size_t Bytes = Frame->PTD.PTDSizes.DataPacketTotalBytes;
+   size_t PlaneBytes = Frame->PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes;
+   size_t TruncatedBytes, VariantIt;
+   int Case;
+
+   Reference.Planes = (uint16_t *)malloc(FEE_NUM_CCD * PlaneBytes);
+   Result.Planes = (uint16_t *)malloc(FEE_NUM_CCD * PlaneBytes);
+   if (Reference.Planes == NULL || Result.Planes == NULL)
+   {
+      free(Reference.Planes);
+      free(Result.Planes);
+      return EXIT_FAILURE;
+   }
+
+   for (Case = 0; Case < NUM_CASES && !Diverged; Case++)
+   {
+      fill_packet((packet_case_t)Case, Frame->PTD_Packet, Packet, Bytes, 2);
+      TruncatedBytes = 2 + random_below((uint32_t)(Bytes - 1));
+
+      select_variant(&Variants[0]);
+      ptd_read(Packet, &Frame->TM, TruncatedBytes, PlaneBytes, &Reference);
+
+      for (VariantIt = 1; VariantIt < NumVariants; VariantIt++)
+      {
+         select_variant(&Variants[VariantIt]);
+         ptd_read(Packet, &Frame->TM, TruncatedBytes, PlaneBytes, &Result);
+         compare_ptd(CaseNames[Case], Variants[VariantIt].Name, &Reference, &Result, PlaneBytes);
+      }
+   }
+
+   free(Reference.Planes);
+   free(Result.Planes);
+
+   return EXIT_SUCCESS;
+}
+
+/*TM and TC decodes, and the views of the stream tracker over the raw packets*/
+void telemetry_test(const fee_gen_frame_t *Frame)
+{
+   fee_TM_Packet_t TM_Packet;
+   fee_TC_Packet_t TC_Packet;
+   fee_TM_t TM_Reference, TM_Result;
+   fee_TC_t TC_Reference, TC_Result;
+   int TM_Status[2], TC_Status[2], TM_Checksum[2], TC_Checksum[2];
+   fee_stream_tracker_t Raw, Decoded;
+   size_t VariantIt;
+   int Case;
+
+   fee_stream_tracker_init(&Raw);
+   fee_stream_tracker_init(&Decoded);
+
+   for (Case = 0; Case < NUM_CASES && !Diverged; Case++)
+   {
+      fill_packet((packet_case_t)Case, Frame->TM_Packet, TM_Packet, TM_PACKET_BYTES, 2);
+      fill_packet((packet_case_t)Case, Frame->TC_Packet, TC_Packet, TC_PACKET_BYTES, 1);
+
+      select_variant(&Variants[0]);
+      memset(&TM_Reference, 0, sizeof(fee_TM_t));
+      memset(&TC_Reference, 0, sizeof(fee_TC_t));
+      TM_Checksum[0] = fee_CheckTelemetryChecksum(TM_Packet);
+      TM_Status[0] = fee_TM_Read(TM_Packet, &TM_Reference);
+      TC_Checksum[0] = fee_CheckTeleCommandChecksum(TC_Packet);
+      TC_Status[0] = fee_TC_Read(TC_Packet, &TC_Reference);
+
+      for (VariantIt = 1; VariantIt < NumVariants; VariantIt++)
+      {
+         select_variant(&Variants[VariantIt]);
+         memset(&TM_Result, 0, sizeof(fee_TM_t));
+         memset(&TC_Result, 0, sizeof(fee_TC_t));
+         TM_Checksum[1] = fee_CheckTelemetryChecksum(TM_Packet);
+         TM_Status[1] = fee_TM_Read(TM_Packet, &TM_Result);
+         TC_Checksum[1] = fee_CheckTeleCommandChecksum(TC_Packet);
+         TC_Status[1] = fee_TC_Read(TC_Packet, &TC_Result);
+
+         compare_status(CaseNames[Case], Variants[VariantIt].Name, "TM checksum status", TM_Checksum[0], TM_Checksum[1]);
+         compare_status(CaseNames[Case], Variants[VariantIt].Name, "TM read status", TM_Status[0], TM_Status[1]);
+         compare_bytes(CaseNames[Case], Variants[VariantIt].Name, "decoded TM", &TM_Reference, &TM_Result, sizeof(fee_TM_t));
+         compare_status(CaseNames[Case], Variants[VariantIt].Name, "TC checksum status", TC_Checksum[0], TC_Checksum[1]);
+         compare_status(CaseNames[Case], Variants[VariantIt].Name, "TC read status", TC_Status[0], TC_Status[1]);
+         compare_bytes(CaseNames[Case], Variants[VariantIt].Name, "decoded TC", &TC_Reference, &TC_Result, sizeof(fee_TC_t));
+      }
+
+      /*Counters peeked from the raw packets must follow the decoded ones*/
+      if (TM_Status[0] == FEE_EXIT_SUCCESS)
+      {
+         compare_status(CaseNames[Case], "stream view", "TM event", fee_stream_update_TM(&Decoded, &TM_Reference),
+                        fee_stream_peek_TM(&Raw, TM_Packet));
+      }
+      if (TC_Status[0] == FEE_EXIT_SUCCESS)
+      {
+         compare_status(CaseNames[Case], "stream view", "TC event", fee_stream_update_TC(&Decoded, &TC_Reference),
+                        fee_stream_peek_TC(&Raw, TC_Packet));
+      }
+      compare_bytes(CaseNames[Case], "stream view", "tracker", &Decoded, &Raw, sizeof(fee_stream_tracker_t));
+   }
+}
+
+/*Descriptor of a PTD or TM packet of a case. PacketBytes may be truncated*/
+int prepare_descriptor(fee_packet_desc_t *Desc, fee_packet_type_t Type, const uint8_t *Packet, size_t PacketBytes,
+                       const fee_TM_t *TM, size_t PlaneBytes)
+{
+   int k;
+
+   memset(Desc, 0, sizeof(fee_packet_desc_t));
+   Desc->Type = Type;
+   Desc->PacketBytes = PacketBytes;
+   Desc->Packet = (uint8_t *)malloc(Type == FEE_PACKET_PTD ? PacketBytes + 1 : TM_PACKET_BYTES);
+   Desc->TM = *TM;
+   if (Desc->Packet == NULL)
+   {
+      return EXIT_FAILURE;
+   }
+   memcpy(Desc->Packet, Packet, Type == FEE_PACKET_PTD ? PacketBytes : TM_PACKET_BYTES);
+
+   if (Type == FEE_PACKET_PTD)
+   {
+      Desc->PTD.ImageMatrix[0] = (uint16_t *)malloc(FEE_NUM_CCD * PlaneBytes);
+      if (Desc->PTD.ImageMatrix[0] == NULL)
+      {
+         return EXIT_FAILURE;
+      }
+      memset(Desc->PTD.ImageMatrix[0], POISON, FEE_NUM_CCD * PlaneBytes);
+      for (k = 1; k < FEE_NUM_CCD; k++)
+      {
+         Desc->PTD.ImageMatrix[k] = Desc->PTD.ImageMatrix[0] + k * PlaneBytes / sizeof(uint16_t);
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+void release_descriptor(fee_packet_desc_t *Desc)
+{
+   free(Desc->Packet);
+   free(Desc->PTD.ImageMatrix[0]);
+   Desc->Packet = NULL;
+   Desc->PTD.ImageMatrix[0] = NULL;
+}
+
+/*Pipeline with the fastest variant against the stages run on this thread with the reference*/
+int pipeline_test(fee_pipeline_t *Pipeline, const fee_gen_frame_t *Frame, uint8_t *Packet)
+{
+   fee_packet_desc_t Reference[2 * NUM_CASES], Submitted[2 * NUM_CASES], Received;
+   size_t Bytes = Frame->PTD.PTDSizes.DataPacketTotalBytes;
+   size_t PlaneBytes = Frame->PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes;
+   size_t NumDescs = 0, NumReceived = 0, PacketBytes, i;
+   int Case, Status = EXIT_SUCCESS;
+
+   for (Case = 0; Case < NUM_CASES; Case++)
+   {
+      /*Odd cases are truncated*/
+      fill_packet((packet_case_t)Case, Frame->PTD_Packet, Packet, Bytes, 2);
+      PacketBytes = Case % 2 ? random_below((uint32_t)Bytes) : Bytes;
+      Status |= prepare_descriptor(&Reference[NumDescs], FEE_PACKET_PTD, Packet, PacketBytes, &Frame->TM, PlaneBytes);
+      Status |= prepare_descriptor(&Submitted[NumDescs], FEE_PACKET_PTD, Packet, PacketBytes, &Frame->TM, PlaneBytes);
+      Submitted[NumDescs].UserData = (void *)NumDescs;
+      NumDescs++;
+
+      fill_packet((packet_case_t)Case, Frame->TM_Packet, Packet, TM_PACKET_BYTES, 2);
+      PacketBytes = Case % 2 ? random_below(TM_PACKET_BYTES) : TM_PACKET_BYTES;
+      Status |= prepare_descriptor(&Reference[NumDescs], FEE_PACKET_TM, Packet, PacketBytes, &Frame->TM, PlaneBytes);
+      Status |= prepare_descriptor(&Submitted[NumDescs], FEE_PACKET_TM, Packet, PacketBytes, &Frame->TM, PlaneBytes);
+      Submitted[NumDescs].UserData = (void *)NumDescs;
+      NumDescs++;
+   }
+
+   if (Status == EXIT_SUCCESS)
+   {
+      select_variant(&Variants[0]);
+      for (i = 0; i < NumDescs; i++)
+      {
+         Reference[i].Status = fee_pipeline_stage_checksum(&Reference[i], NULL);
+         if (Reference[i].Status == FEE_EXIT_SUCCESS)
+         {
+            Reference[i].Status = fee_pipeline_stage_decode(&Reference[i], NULL);
+         }
+      }
+
+      select_variant(&Variants[NumVariants - 1]);
+      if (fee_pipeline_submit(Pipeline, Submitted, NumDescs) != NumDescs)
+      {
+         printf("Error submitting to the pipeline\n");
+         Status = EXIT_FAILURE;
+         NumDescs = 0;
+      }
+
+      while (NumReceived < NumDescs)
+      {
+         if (fee_pipeline_receive(Pipeline, &Received, 1) != 1)
+         {
+            continue;
+         }
+         i = (size_t)Received.UserData;
+         Submitted[i] = Received;
+         NumReceived++;
+
+         compare_status(CaseNames[i / 2], "pipeline", "status", Reference[i].Status, Received.Status);
+         if (Reference[i].Status == FEE_EXIT_SUCCESS && Received.Status == FEE_EXIT_SUCCESS && i % 2 == 0)
+         {
+            compare_bytes(CaseNames[i / 2], "pipeline", "PTD image planes", Reference[i].PTD.ImageMatrix[0],
+                          Received.PTD.ImageMatrix[0], FEE_NUM_CCD * PlaneBytes);
+         }
+         else if (Reference[i].Status == FEE_EXIT_SUCCESS && Received.Status == FEE_EXIT_SUCCESS)
+         {
+            compare_bytes(CaseNames[i / 2], "pipeline", "decoded TM", &Reference[i].TM, &Received.TM, sizeof(fee_TM_t));
+         }
+      }
+   }
+
+   for (i = 0; i < 2 * NUM_CASES; i++)
+   {
+      release_descriptor(&Reference[i]);
+      release_descriptor(&Submitted[i]);
+   }
+
+   return Status;
+}
+
+int main(int argc, char *argv[])
+{
+   fee_pipeline_stage_t Stages[2] = {{fee_pipeline_stage_checksum, NULL}, {fee_pipeline_stage_decode, NULL}};
+   fee_pipeline_config_t Config = {Stages, 2, 2 * NUM_CASES, 4};
+   fee_pipeline_t *Pipeline = NULL;
+   fee_gen_config_t Geometry;
+   fee_gen_frame_t Frame;
+   uint8_t *Packet = NULL;
+   uint32_t Iterations = DEFAULT_ITERATIONS;
+   int Status = EXIT_SUCCESS;
+
+   if (argc > 3)
+   {
+      printf("Argument Error: The program should be executed as: %s [Iterations] [Seed] \n", argv[0]);
+      return EXIT_FAILURE;
+   }
+   Iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_ITERATIONS;
+   Seed = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : DEFAULT_SEED;
+   RandomState = Seed != 0 ? Seed : DEFAULT_SEED;
+
+   build_variants();
+   memset(&Frame, 0, sizeof(Frame));
+   memset(&Geometry, 0, sizeof(Geometry));
+
+   if (fee_pipeline_create(&Config, &Pipeline) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating the pipeline\n");
+      return EXIT_FAILURE;
+   }
+
+   for (Iteration = 0; Iteration < Iterations && !Diverged && Status == EXIT_SUCCESS; Iteration++)
+   {
+      /*The reference generates the frame and writes its packets*/
+      random_geometry(&Geometry);
+      select_variant(&Variants[0]);
+      if (fee_gen_frame(&Geometry, Iteration, &Frame) != FEE_EXIT_SUCCESS ||
+          Frame.PTD.PTDSizes.DataPacketTotalBytes < 2)
+      {
+         printf("Error generating the frame of iteration %u\n", Iteration);
+         Status = EXIT_FAILURE;
+         break;
+      }
+
+      Packet = (uint8_t *)realloc(Packet, Frame.PTD.PTDSizes.DataPacketTotalBytes);
+      if (Packet == NULL)
+      {
+         Status = EXIT_FAILURE;
+         break;
+      }
+
+      ptd_write_test(&Frame, Packet);
+      Status |= ptd_read_test(&Frame, Packet);
+      telemetry_test(&Frame);
+      Status |= pipeline_test(Pipeline, &Frame, Packet);
+   }
+
+   fee_pipeline_destroy(Pipeline);
+   fee_gen_frame_free(&Frame);
+   free(Packet);
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   if (!Diverged)
+   {
+      printf("Differential Test Success! (%u iterations, %zu paths)\n", Iterations, NumVariants);
+      return EXIT_SUCCESS;
+   }
+   else
+   {
+      printf("Differential Test Error!\n");
+      return EXIT_FAILURE;
+   }
+}
@@ -0,0 +1,171 @@
+/**
+ * @file dispatch_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Dispatch Test. The checksums of random TC packets and of random PTD packets of every length up to a few
+ *  vectors, at misaligned addresses, are checked with the kernels of every CPU tier supported by the host against
+ *  a reference calculation. If FEE_CPU_TIER is set, the selected tier must follow it.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_dispatch.h>
+
+#define MAX_PTD_BYTES 520 /*Several AVX-512 blocks plus every tail length*/
+#define NUM_TC_PACKETS 64
+
+/*Host order words, with the odd byte in the low byte*/
+uint16_t reference_checksum16(const uint8_t *Data, size_t Length)
+{
+   uint16_t Checksum = 0, Word;
+   size_t i;
+
+   for (i = 0; i + 1 < Length; i += 2)
+   {
+      memcpy(&Word, Data + i, 2);
+      Checksum ^= Word;
+   }
+   if (Length % 2)
+   {
+      Checksum ^= Data[Length - 1];
+   }
+
+   return Checksum;
+}
+
+void tc_test(int *AreEqual)
+{
+   fee_TC_Packet_t Packet;
+   uint8_t Checksum;
+   int PacketIt, i;
+
+   for (PacketIt = 0; PacketIt < NUM_TC_PACKETS; PacketIt++)
+   {
+      Checksum = 0;
+      for (i = 0; i < TC_PACKET_BYTES - 1; i++)
+      {
+         Packet[i] = (uint8_t)rand();
+         Checksum ^= Packet[i];
+      }
+      Packet[TC_PACKET_BYTES - 1] = Checksum;
+
+      if (fee_CheckTeleCommandChecksum(Packet) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: valid TC checksum rejected\n");
+         *AreEqual = 0;
+      }
+
+      Packet[PacketIt % (TC_PACKET_BYTES - 1)] ^= 0x10;
+      if (fee_CheckTeleCommandChecksum(Packet) == FEE_EXIT_SUCCESS)
+      {
+         printf("Error: corrupted TC checksum accepted\n");
+         *AreEqual = 0;
+      }
+   }
+}
+
+void ptd_test(int *AreEqual)
+{
+   uint8_t Buffer[MAX_PTD_BYTES + 2 + 3];
+   uint8_t *Packet;
+   uint16_t Checksum;
+   fee_PTDSizes_t Sizes;
+   size_t Length, Misalignment, i;
+
+   memset(&Sizes, 0, sizeof(Sizes));
+
+   for (Length = 0; Length <= MAX_PTD_BYTES; Length++)
+   {
+      Misalignment = Length % 4;
+      Packet = Buffer + Misalignment;
+      for (i = 0; i < Length; i++)
+      {
+         Packet[i] = (uint8_t)rand();
+      }
+      Checksum = reference_checksum16(Packet, Length);
+      memcpy(Packet + Length, &Checksum, 2);
+      Sizes.DataPacketTotalBytes = Length + 2;
+
+      if (fee_CheckPTDChecksum(Packet, Sizes) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: valid checksum of %zu bytes rejected\n", Length);
+         *AreEqual = 0;
+      }
+
+      if (Length > 0)
+      {
+         Packet[Length - 1] ^= 0x01;
+         if (fee_CheckPTDChecksum(Packet, Sizes) == FEE_EXIT_SUCCESS)
+         {
+            printf("Error: corrupted checksum of %zu bytes accepted\n", Length);
+            *AreEqual = 0;
+         }
+      }
+   }
+}
+
+int main(void)
+{
+   const char *Env = getenv(FEE_CPU_TIER_ENV);
+   int AreEqual = 1, Tier, Kernel;
+
+   /*Tier requested by the environment*/
+   if (Env != NULL && strcmp(Env, "scalar") == 0 && fee_dispatch_selected_tier() != FEE_CPU_TIER_SCALAR)
+   {
+      printf("Error: %s ignored\n", FEE_CPU_TIER_ENV);
+      AreEqual = 0;
+   }
+
+   if (fee_dispatch_report(stdout) != FEE_EXIT_SUCCESS ||
+       fee_dispatch_set_tier(FEE_CPU_NUM_TIERS) != FEE_EXIT_ERROR ||
+       fee_dispatch_tier_name(FEE_CPU_NUM_TIERS) != NULL || fee_dispatch_kernel_name(FEE_NUM_KERNELS) != NULL)
+   {
+      printf("Error: invalid arguments accepted\n");
+      AreEqual = 0;
+   }
+
+   srand(36);
+   for (Tier = FEE_CPU_TIER_SCALAR; Tier < FEE_CPU_NUM_TIERS; Tier++)
+   {
+      if (fee_dispatch_set_tier((fee_cpu_tier_t)Tier) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: tier %s rejected\n", fee_dispatch_tier_name((fee_cpu_tier_t)Tier));
+         AreEqual = 0;
+      }
+
+      /*Tiers above the host are lowered, and no kernel exceeds the selected tier*/
+      if ((Tier <= (int)fee_dispatch_detected_tier() && (int)fee_dispatch_selected_tier() != Tier) ||
+          fee_dispatch_selected_tier() > fee_dispatch_detected_tier())
+      {
+         printf("Error: tier %s not selected\n", fee_dispatch_tier_name((fee_cpu_tier_t)Tier));
+         AreEqual = 0;
+      }
+      for (Kernel = 0; Kernel < FEE_NUM_KERNELS; Kernel++)
+      {
+         if (fee_dispatch_kernel_tier((fee_kernel_t)Kernel) > fee_dispatch_selected_tier())
+         {
+            printf("Error: %s above the selected tier\n", fee_dispatch_kernel_name((fee_kernel_t)Kernel));
+            AreEqual = 0;
+         }
+      }
+
+      tc_test(&AreEqual);
+      ptd_test(&AreEqual);
+   }
+
+   if (AreEqual)
+   {
+      printf("Dispatch Test Success!\n");
+      return EXIT_SUCCESS;
+   }
+   else
+   {
+      printf("Dispatch Test Error!\n");
+      return EXIT_FAILURE;
+   }
+}
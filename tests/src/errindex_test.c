@@ -0,0 +1,282 @@
+/**
+ * @file errindex_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Error Bitmap Index Test. The packets of the TM capture, and a long synthetic series with dense and sparse
+ *  error bits, are indexed, and random AND/OR queries restricted to random time ranges must return the same packets
+ *  as a scan of every packet, in both orders and with any result capacity.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fee.h>
+#include <fee_capture.h>
+#include <fee_errindex.h>
+
+#define NUM_SYNTHETIC_PACKETS 200000
+#define NUM_QUERIES 400
+#define MAX_RESULTS NUM_SYNTHETIC_PACKETS
+
+uint64_t Timestamps[NUM_SYNTHETIC_PACKETS];
+uint16_t TCErrors[NUM_SYNTHETIC_PACKETS];
+uint16_t VAUErrors[NUM_SYNTHETIC_PACKETS];
+uint32_t Expected[MAX_RESULTS];
+uint32_t Results[MAX_RESULTS];
+
+uint32_t xorshift32(uint32_t *State)
+{
+   *State ^= *State << 13;
+   *State ^= *State >> 17;
+   *State ^= *State << 5;
+   return *State;
+}
+
+int matches(const fee_errindex_query_t *Query, size_t i)
+{
+   return (TCErrors[i] & Query->TCAll) == Query->TCAll && (VAUErrors[i] & Query->VAUAll) == Query->VAUAll &&
+          ((Query->TCAny | Query->VAUAny) == 0 || (TCErrors[i] & Query->TCAny) != 0 || (VAUErrors[i] & Query->VAUAny) != 0) &&
+          Timestamps[i] >= Query->FirstTimestamp && Timestamps[i] <= Query->LastTimestamp;
+}
+
+int check_query(const fee_errindex_t *Index, const fee_errindex_query_t *Query, size_t NumPackets, size_t Capacity)
+{
+   size_t i, NumExpected = 0, NumMatches = 0;
+
+   for (i = 0; i < NumPackets; i++)
+   {
+      if (matches(Query, Query->Latest ? NumPackets - 1 - i : i))
+      {
+         Expected[NumExpected++] = (uint32_t)(Query->Latest ? NumPackets - 1 - i : i);
+      }
+   }
+
+   if (fee_errindex_query(Index, Query, Results, Capacity, &NumMatches) != FEE_EXIT_SUCCESS || NumMatches != NumExpected ||
+       memcmp(Results, Expected, (NumExpected < Capacity ? NumExpected : Capacity) * sizeof(uint32_t)) != 0)
+   {
+      printf("Error: query TC %04X/%04X VAU %04X/%04X [%llu, %llu] returned %zu packets instead of %zu\n", Query->TCAll,
+             Query->TCAny, Query->VAUAll, Query->VAUAny, (unsigned long long)Query->FirstTimestamp,
+             (unsigned long long)Query->LastTimestamp, NumMatches, NumExpected);
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+uint16_t random_bits(uint32_t *State, int MaxBits)
+{
+   uint16_t Bits = 0;
+   int i, NumBits = (int)(xorshift32(State) % (uint32_t)(MaxBits + 1));
+
+   for (i = 0; i < NumBits; i++)
+   {
+      Bits |= (uint16_t)(1u << (xorshift32(State) % 16));
+   }
+
+   return Bits;
+}
+
+int random_queries(const fee_errindex_t *Index, size_t NumPackets, uint32_t *State)
+{
+   fee_errindex_query_t Query;
+   int i, Status = EXIT_SUCCESS;
+   uint64_t Span = Timestamps[NumPackets - 1] - Timestamps[0] + 1;
+
+   for (i = 0; i < NUM_QUERIES && Status == EXIT_SUCCESS; i++)
+   {
+      memset(&Query, 0, sizeof(Query));
+      Query.TCAll = random_bits(State, 2);
+      Query.VAUAll = random_bits(State, 1);
+      Query.TCAny = random_bits(State, 3);
+      Query.VAUAny = random_bits(State, 2);
+      if ((Query.TCAll | Query.VAUAll | Query.TCAny | Query.VAUAny) == 0)
+      {
+         Query.TCAny = TC_ERROR_CHECKSUM_error;
+      }
+      Query.FirstTimestamp = i % 4 == 0 ? 0 : Timestamps[0] + xorshift32(State) % Span;
+      Query.LastTimestamp = i % 3 == 0 ? UINT64_MAX : Query.FirstTimestamp + xorshift32(State) % Span;
+      Query.Latest = i % 2;
+
+      Status = check_query(Index, &Query, NumPackets, i % 5 == 0 ? (size_t)(xorshift32(State) % 64) : MAX_RESULTS);
+   }
+
+   return Status;
+}
+
+/*The masks of a TM capture*/
+int capture_test(const char *Path)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   fee_errindex_t *Index = NULL;
+   fee_TM_t TM;
+   size_t NumPackets = 0;
+   uint32_t Sequence, State = 45;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_capture_open(Path, &Capture) != FEE_EXIT_SUCCESS || fee_errindex_create(&Index) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error opening %s\n", Path);
+      fee_capture_close(Capture);
+      return EXIT_FAILURE;
+   }
+
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (NumPackets < NUM_SYNTHETIC_PACKETS && Status == EXIT_SUCCESS && fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      if (Packet.Type != FEE_CAPTURE_TM || Packet.NumBytes != TM_PACKET_BYTES)
+      {
+         continue;
+      }
+      fee_TM_Read((uint8_t *)Packet.Bytes, &TM);
+      if (fee_errindex_add_tm(Index, Packet.Timestamp, &TM, &Sequence) != FEE_EXIT_SUCCESS || Sequence != NumPackets)
+      {
+         printf("Error indexing packet %zu\n", NumPackets);
+         Status = EXIT_FAILURE;
+      }
+      Timestamps[NumPackets] = NumPackets > 0 && Packet.Timestamp < Timestamps[NumPackets - 1] ? Timestamps[NumPackets - 1] : Packet.Timestamp;
+      TCErrors[NumPackets] = TM.TC_ERROR;
+      VAUErrors[NumPackets] = TM.VAU_ERROR;
+      NumPackets++;
+   }
+   fee_capture_iter_free(&Iter);
+   fee_capture_close(Capture);
+
+   if (Status == EXIT_SUCCESS && NumPackets == 0)
+   {
+      printf("Error: no TM packets in %s\n", Path);
+      Status = EXIT_FAILURE;
+   }
+   if (Status == EXIT_SUCCESS)
+   {
+      Status = random_queries(Index, NumPackets, &State);
+   }
+
+   fee_errindex_destroy(Index);
+   return Status;
+}
+
+/*Several containers, with bits dense enough to be bitmaps and bits sparse enough to be arrays*/
+int synthetic_test(void)
+{
+   fee_errindex_t *Index = NULL;
+   fee_errindex_info_t Info;
+   fee_errindex_query_t Query;
+   uint64_t Timestamp = 1000, Read;
+   uint32_t State = 2026, Random;
+   size_t i, NumMatches;
+   int Bit, Status = EXIT_SUCCESS;
+
+   if (fee_errindex_create(&Index) != FEE_EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < NUM_SYNTHETIC_PACKETS && Status == EXIT_SUCCESS; i++)
+   {
+      TCErrors[i] = 0;
+      VAUErrors[i] = 0;
+      for (Bit = 0; Bit < 16; Bit++)
+      {
+         /*From one packet in two (bit 0) to one in 2^15 (bit 15)*/
+         Random = xorshift32(&State);
+         TCErrors[i] |= (uint16_t)(((Random & ((1u << Bit) * 2 - 1)) == 0) << Bit);
+         VAUErrors[i] |= (uint16_t)(((Random >> 16) % (16u << Bit) == 0) << (15 - Bit));
+      }
+      /*Bursts of a bit that is otherwise rare*/
+      if ((i / 10000) % 7 == 3)
+      {
+         TCErrors[i] |= TC_ERROR_CHECKSUM_error;
+      }
+      Timestamp += xorshift32(&State) % 4;
+      Timestamps[i] = Timestamp;
+      if (fee_errindex_add(Index, Timestamp, TCErrors[i], VAUErrors[i], NULL) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error indexing packet %zu\n", i);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   fee_errindex_info(Index, &Info);
+   if (Status == EXIT_SUCCESS && Info.NumPackets != NUM_SYNTHETIC_PACKETS)
+   {
+      printf("Error: %llu packets indexed\n", (unsigned long long)Info.NumPackets);
+      Status = EXIT_FAILURE;
+   }
+   for (Bit = 0; Bit < FEE_ERRINDEX_NUM_BITMAPS && Status == EXIT_SUCCESS; Bit++)
+   {
+      memset(&Query, 0, sizeof(Query));
+      Query.LastTimestamp = UINT64_MAX;
+      Query.TCAll = Bit < 16 ? (uint16_t)(1u << Bit) : 0;
+      Query.VAUAll = Bit < 16 ? 0 : (uint16_t)(1u << (Bit - 16));
+      if (fee_errindex_query(Index, &Query, NULL, 0, &NumMatches) != FEE_EXIT_SUCCESS || NumMatches != Info.BitCounts[Bit])
+      {
+         printf("Error: bit count %d\n", Bit);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   if (Status == EXIT_SUCCESS)
+   {
+      Status = random_queries(Index, NUM_SYNTHETIC_PACKETS, &State);
+   }
+
+   /*Latest checksum error: the question of the operators*/
+   if (Status == EXIT_SUCCESS)
+   {
+      memset(&Query, 0, sizeof(Query));
+      Query.TCAll = TC_ERROR_CHECKSUM_error;
+      Query.LastTimestamp = Timestamps[NUM_SYNTHETIC_PACKETS / 2];
+      Query.Latest = 1;
+      Status = check_query(Index, &Query, NUM_SYNTHETIC_PACKETS, 1);
+      if (Status == EXIT_SUCCESS &&
+          (fee_errindex_timestamp(Index, Results[0], &Read) != FEE_EXIT_SUCCESS || Read != Timestamps[Results[0]]))
+      {
+         printf("Error: timestamp of packet %u\n", Results[0]);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   /*Empty queries and unknown packets*/
+   memset(&Query, 0, sizeof(Query));
+   Query.LastTimestamp = UINT64_MAX;
+   if (fee_errindex_query(Index, &Query, Results, MAX_RESULTS, &NumMatches) == FEE_EXIT_SUCCESS ||
+       fee_errindex_timestamp(Index, NUM_SYNTHETIC_PACKETS, &Read) == FEE_EXIT_SUCCESS)
+   {
+      printf("Error: invalid requests accepted\n");
+      Status = EXIT_FAILURE;
+   }
+
+   printf("%d packets indexed in %zu bytes\n", NUM_SYNTHETIC_PACKETS, Info.MemoryBytes);
+
+   fee_errindex_destroy(Index);
+   return Status;
+}
+
+int main(int argc, char *argv[])
+{
+   int Status = EXIT_SUCCESS;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <TM capture>\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   Status |= capture_test(argv[1]);
+   Status |= synthetic_test();
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Error Bitmap Index Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file fields_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Field Accessors Test. Every fee_TC_get_<FIELD> and fee_TM_get_<FIELD> accessor must return, for every
+ *  packet of the TC and TM captures and for packets of random bytes, the value that fee_TC_Read and fee_TM_Read store
+ *  in the structure. The checksum accessors must agree with the checksum checks.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_capture.h>
+#include <fee_fields.h>
+
+#define NUM_RANDOM_PACKETS 1000
+
+uint32_t xorshift32(uint32_t *State)
+{
+   *State ^= *State << 13;
+   *State ^= *State >> 17;
+   *State ^= *State << 5;
+   return *State;
+}
+
+/*XOR of the bytes of a TC packet before the checksum*/
+uint8_t tc_checksum(const uint8_t *Packet)
+{
+   uint8_t Checksum = 0;
+   int i;
+
+   for (i = 0; i < TC_OFFSET_CHECKSUM; i++)
+   {
+      Checksum ^= Packet[i];
+   }
+
+   return Checksum;
+}
+
+/*XOR of the 16-bit words of a TM packet before the checksum, in host order*/
+uint16_t tm_checksum(const uint8_t *Packet)
+{
+   uint16_t Checksum = 0, Word;
+   int i;
+
+   for (i = 0; i < TM_OFFSET_CHECKSUM; i += 2)
+   {
+      memcpy(&Word, Packet + i, sizeof(uint16_t));
+      Checksum ^= Word;
+   }
+
+   return Checksum;
+}
+
+/*Name of the first accessor that does not match the structure. NULL if all match*/
+const char *check_tc(const uint8_t *Packet)
+{
+   fee_TC_t TC;
+
+   if (fee_TC_Read((uint8_t *)Packet, &TC) != FEE_EXIT_SUCCESS)
+   {
+      return "fee_TC_Read";
+   }
+#define CHECK_TC(Name, Bits)                                   \
+   if (fee_TC_get_##Name(Packet) != (uint##Bits##_t)TC.Name) \
+   {                                                         \
+      return #Name;                                          \
+   }
+   FEE_TC_FIELDS(CHECK_TC)
+#undef CHECK_TC
+
+   return NULL;
+}
+
+const char *check_tm(const uint8_t *Packet)
+{
+   fee_TM_t TM;
+
+   if (fee_TM_Read((uint8_t *)Packet, &TM) != FEE_EXIT_SUCCESS)
+   {
+      return "fee_TM_Read";
+   }
+   if (fee_TM_get_TM_COUNTER(Packet) != TM.TM_COUNTER)
+   {
+      return "TM_COUNTER";
+   }
+#define CHECK_TM_TC(Name, Bits)                                             \
+   if (fee_TM_get_##Name(Packet) != (uint##Bits##_t)TM.Returned_TC.Name) \
+   {                                                                     \
+      return #Name;                                                      \
+   }
+   FEE_TC_FIELDS(CHECK_TM_TC)
+#undef CHECK_TM_TC
+#define CHECK_TM(Name, Bits)                                   \
+   if (fee_TM_get_##Name(Packet) != (uint##Bits##_t)TM.Name) \
+   {                                                         \
+      return #Name;                                          \
+   }
+   FEE_TM_MEAS_FIELDS(CHECK_TM)
+#undef CHECK_TM
+
+   return NULL;
+}
+
+int capture_test(const char *Path)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   uint8_t Bytes[TM_PACKET_BYTES];
+   size_t NumTC = 0, NumTM = 0;
+   const char *Field = NULL;
+
+   if (fee_capture_open(Path, &Capture) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error opening %s\n", Path);
+      return EXIT_FAILURE;
+   }
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (Field == NULL && fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      if (Packet.Type == FEE_CAPTURE_TC && Packet.NumBytes == TC_PACKET_BYTES)
+      {
+         memcpy(Bytes, Packet.Bytes, TC_PACKET_BYTES);
+         Field = check_tc(Bytes);
+         if (Field == NULL &&
+             (fee_CheckTeleCommandChecksum(Bytes) == FEE_EXIT_SUCCESS) != (fee_TC_get_CHECKSUM(Bytes) == tc_checksum(Bytes)))
+         {
+            Field = "CHECKSUM";
+         }
+         NumTC++;
+      }
+      else if (Packet.Type == FEE_CAPTURE_TM && Packet.NumBytes == TM_PACKET_BYTES)
+      {
+         memcpy(Bytes, Packet.Bytes, TM_PACKET_BYTES);
+         Field = check_tm(Bytes);
+         if (Field == NULL &&
+             (fee_CheckTelemetryChecksum(Bytes) == FEE_EXIT_SUCCESS) != (fee_TM_get_CHECKSUM(Bytes) == tm_checksum(Bytes)))
+         {
+            Field = "CHECKSUM";
+         }
+         NumTM++;
+      }
+   }
+   fee_capture_iter_free(&Iter);
+   fee_capture_close(Capture);
+
+   if (Field != NULL)
+   {
+      printf("Error: accessor of %s does not match in %s\n", Field, Path);
+      return EXIT_FAILURE;
+   }
+   printf("%s: %zu TC and %zu TM packets checked\n", Path, NumTC, NumTM);
+
+   return NumTC + NumTM > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int random_test(void)
+{
+   uint8_t Packet[TM_PACKET_BYTES];
+   uint32_t State = 2026;
+   const char *Field = NULL;
+   int i, j;
+
+   for (i = 0; i < NUM_RANDOM_PACKETS && Field == NULL; i++)
+   {
+      for (j = 0; j < TM_PACKET_BYTES; j++)
+      {
+         Packet[j] = (uint8_t)xorshift32(&State);
+      }
+      Field = i % 2 == 0 ? check_tc(Packet) : check_tm(Packet);
+   }
+
+   if (Field != NULL)
+   {
+      printf("Error: accessor of %s does not match in random packet %d\n", Field, i - 1);
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+   int Status = EXIT_SUCCESS, i;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <capture> [<capture> ...]\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   for (i = 1; i < argc; i++)
+   {
+      Status |= capture_test(argv[i]);
+   }
+   Status |= random_test();
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Field Accessors Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
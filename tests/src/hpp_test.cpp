@@ -0,0 +1,154 @@
+/**
+ * @file hpp_test.cpp
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  C++ Layer Test. Frames of several geometries are generated and their PTD packets are decoded by
+ *  fee::decode_ptd<Geometry> and by fee_PTD_Read. Both decodings must be equal, also when the TM does not match the
+ *  geometry of the template and the C API is used.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fee.hpp>
+
+extern "C"
+{
+#include <fee_generator.h>
+}
+
+#define NUM_FRAMES 3
+
+using Typical = fee::ptd_geometry<282, 0, SPATALBIN_NOTENABLE, fee::freq_binning_band(1, 225)>;
+using Binned = fee::ptd_geometry<33, 5, SPATIALBIN_ENABLE, fee::freq_binning_band(2, 64), fee::freq_binning_band(1, 16),
+                                 fee::freq_binning_band(4, 32)>;
+using Maximum = fee::ptd_geometry<536, 1023, SPATALBIN_NOTENABLE, fee::freq_binning_band(1, 450), fee::freq_binning_band(1, 450),
+                                  fee::freq_binning_band(1, 450), fee::freq_binning_band(1, 450), fee::freq_binning_band(1, 450)>;
+
+static_assert(Typical::image_columns == 2 + 225 && Typical::image_rows == 282 + 2, "Typical geometry");
+static_assert(Binned::data_rows == 16 && Binned::overscan_rows == 2 && Binned::row_pixels == 32 + 16 + 8, "Binned geometry");
+static_assert(fee::layout::find(fee::layout::tm_fields, "TC_ERROR").offset == 116, "TC_ERROR offset");
+static_assert(fee::layout::find(fee::layout::tc_fields, "UNKNOWN").bytes == 0, "Unknown field");
+
+/*Decode a PTD with fee_PTD_Read and with decode_ptd<Geometry> and compare them*/
+template <class Geometry>
+int compare_frame(const fee_gen_frame_t &Frame, int ExpectMatch)
+{
+   fee_PTD_t Reference = {}, Decoded = {};
+   size_t ImageBytes = Frame.PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes;
+   std::vector<uint16_t> Planes(4 * ImageBytes / sizeof(uint16_t) + 4, 0xFFFF);
+   int AreEqual = 1;
+
+   for (int k = 0; k < FEE_NUM_CCD; k++)
+   {
+      Reference.ImageMatrix[k] = Planes.data() + k * ImageBytes / sizeof(uint16_t);
+      Decoded.ImageMatrix[k] = Planes.data() + (FEE_NUM_CCD + k) * ImageBytes / sizeof(uint16_t);
+   }
+
+   if (Geometry::matches(Frame.TM) != (ExpectMatch != 0))
+   {
+      printf("Error: unexpected geometry match\n");
+      return 0;
+   }
+
+   if (fee_PTD_Read(Frame.PTD_Packet, Frame.TM, &Reference) != FEE_EXIT_SUCCESS ||
+       fee::decode_ptd<Geometry>(Frame.PTD_Packet, Frame.TM, &Decoded) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error decoding the PTD\n");
+      return 0;
+   }
+
+   if (Reference.PIXEL_DATA_COUNTER != Decoded.PIXEL_DATA_COUNTER ||
+       memcmp(Reference.VOLTAGES_REFERENCES, Decoded.VOLTAGES_REFERENCES, sizeof(Reference.VOLTAGES_REFERENCES)) != 0 ||
+       memcmp(&Reference.PTDSizes, &Decoded.PTDSizes, sizeof(fee_PTDSizes_t)) != 0 ||
+       memcmp(&Reference.PTDImageMatrixTotalSizes, &Decoded.PTDImageMatrixTotalSizes, sizeof(fee_ImageMatrixTotalSizes_t)) != 0)
+   {
+      printf("Error: PTD header or sizes differ\n");
+      AreEqual = 0;
+   }
+
+   for (int k = 0; k < FEE_NUM_CCD; k++)
+   {
+      if (memcmp(Reference.ImageMatrix[k], Decoded.ImageMatrix[k], ImageBytes) != 0 ||
+          memcmp(Frame.PTD.ImageMatrix[k], Decoded.ImageMatrix[k], ImageBytes) != 0)
+      {
+         printf("Error: image of CCD %d differs\n", k);
+         AreEqual = 0;
+      }
+   }
+
+   if (ExpectMatch && Decoded.PTDSizes.DataPacketTotalBytes != Geometry::packet_bytes)
+   {
+      printf("Error: wrong packet size\n");
+      AreEqual = 0;
+   }
+
+   return AreEqual;
+}
+
+/*Generate frames of a configuration and decode them with and without the matching geometry*/
+template <class Geometry, class Other>
+int geometry_test(const fee_gen_config_t &Config)
+{
+   fee_gen_frame_t Frame;
+   int AreEqual = 1;
+
+   memset(&Frame, 0, sizeof(Frame));
+
+   for (uint32_t FrameIt = 0; FrameIt < NUM_FRAMES; FrameIt++)
+   {
+      if (fee_gen_frame(&Config, FrameIt, &Frame) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error generating the frame\n");
+         AreEqual = 0;
+         break;
+      }
+
+      AreEqual = compare_frame<Geometry>(Frame, 1) && AreEqual;
+      AreEqual = compare_frame<Other>(Frame, 0) && AreEqual;
+   }
+
+   fee_gen_frame_free(&Frame);
+
+   return AreEqual;
+}
+
+int main()
+{
+   fee_gen_config_t Config;
+   int AreEqual = 1;
+
+   fee_gen_config_default(&Config);
+   Config.Pattern = FEE_GEN_PATTERN_NOISE;
+   AreEqual = geometry_test<Typical, Binned>(Config) && AreEqual;
+
+   fee_gen_config_default(&Config);
+   Config.WOISIZE = 33;
+   Config.NBTAIL = 5;
+   Config.SPATIALBINNINGMODE = SPATIALBIN_ENABLE;
+   Config.BinningSize[0] = 2;
+   Config.BandSize[0] = 64;
+   Config.BinningSize[1] = 1;
+   Config.BandSize[1] = 16;
+   Config.BinningSize[2] = 4;
+   Config.BandSize[2] = 32;
+   AreEqual = geometry_test<Binned, Typical>(Config) && AreEqual;
+
+   fee_gen_config_maximum(&Config);
+   AreEqual = geometry_test<Maximum, Typical>(Config) && AreEqual;
+
+   if (AreEqual)
+   {
+      printf("C++ Layer Test Success!\n");
+      return EXIT_SUCCESS;
+   }
+   else
+   {
+      printf("C++ Layer Test Error!\n");
+      return EXIT_FAILURE;
+   }
+}
@@ -0,0 +1,159 @@
+/**
+ * @file inline_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Inline Functions Test. The test is built in FEE_INLINE mode, so the calls to the hot functions are replaced
+ *  by the definitions of fee_inline.h, and they are compared with the exported functions of the library, called
+ *  through their addresses: every value of the bit-field helpers, and random packets, patches and image indexes.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef FEE_INLINE
+#define FEE_INLINE
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+
+#define NUM_RANDOM 100000
+
+/*Exported functions. Their addresses are not replaced*/
+void (*const Exported_getFreqBinningBand_parameters)(uint16_t, uint16_t *, uint16_t *) = fee_getFreqBinningBand_parameters;
+void (*const Exported_getCDSParam_parameters)(uint16_t, uint16_t *, uint16_t *) = fee_getCDSParam_parameters;
+uint16_t (*const Exported_fill_cdsparam_parameter)(cds_params_t, int) = fee_fill_cdsparam_parameter;
+uint16_t (*const Exported_fill_freqbinningband_parameter)(int, int) = fee_fill_freqbinningband_parameter;
+size_t (*const Exported_PTDImageIndx)(size_t, size_t, size_t) = fee_PTDImageIndx;
+uint16_t (*const Exported_checksum16_patch)(uint16_t, size_t, const uint8_t *, const uint8_t *, size_t) = fee_checksum16_patch;
+uint8_t (*const Exported_checksum8_patch)(uint8_t, const uint8_t *, const uint8_t *, size_t) = fee_checksum8_patch;
+int (*const Exported_CheckTeleCommandChecksum)(fee_TC_Packet_t) = fee_CheckTeleCommandChecksum;
+int (*const Exported_CheckTelemetryChecksum)(fee_TM_Packet_t) = fee_CheckTelemetryChecksum;
+
+uint32_t xorshift32(uint32_t *State)
+{
+   *State ^= *State << 13;
+   *State ^= *State >> 17;
+   *State ^= *State << 5;
+   return *State;
+}
+
+int bitfield_test(void)
+{
+   uint16_t A1, A2, B1, B2;
+   uint32_t Value;
+   int Mode, Size;
+
+   for (Value = 0; Value <= UINT16_MAX; Value++)
+   {
+      fee_getFreqBinningBand_parameters((uint16_t)Value, &A1, &B1);
+      Exported_getFreqBinningBand_parameters((uint16_t)Value, &A2, &B2);
+      if (A1 != A2 || B1 != B2)
+      {
+         printf("Error: fee_getFreqBinningBand_parameters(%u)\n", Value);
+         return EXIT_FAILURE;
+      }
+      fee_getCDSParam_parameters((uint16_t)Value, &A1, &B1);
+      Exported_getCDSParam_parameters((uint16_t)Value, &A2, &B2);
+      if (A1 != A2 || B1 != B2)
+      {
+         printf("Error: fee_getCDSParam_parameters(%u)\n", Value);
+         return EXIT_FAILURE;
+      }
+   }
+
+   for (Mode = -2; Mode < 8; Mode++)
+   {
+      for (Size = -4; Size < 1100; Size++)
+      {
+         if (fee_fill_cdsparam_parameter((cds_params_t)Mode, Size) != Exported_fill_cdsparam_parameter((cds_params_t)Mode, Size) ||
+             fee_fill_freqbinningband_parameter(Mode, Size) != Exported_fill_freqbinningband_parameter(Mode, Size))
+         {
+            printf("Error: fill functions (%d, %d)\n", Mode, Size);
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+int random_test(void)
+{
+   fee_TC_Packet_t TC;
+   fee_TM_Packet_t TM;
+   uint8_t Old[16], New[16];
+   uint32_t State = 2026;
+   size_t Row, Col, Columns, Offset, Length, j;
+   uint16_t Checksum16;
+   uint8_t Checksum8;
+   int i;
+
+   for (i = 0; i < NUM_RANDOM; i++)
+   {
+      for (j = 0; j < TM_PACKET_BYTES; j++)
+      {
+         TM[j] = (uint8_t)xorshift32(&State);
+      }
+      memcpy(TC, TM, TC_PACKET_BYTES);
+      /*Half of the packets get a valid checksum*/
+      if (i % 2 == 0)
+      {
+         TC[TC_OFFSET_CHECKSUM] = fee_inline_TC_checksum(TC);
+         Checksum16 = fee_inline_TM_checksum(TM);
+         memcpy(TM + TM_OFFSET_CHECKSUM, &Checksum16, sizeof(Checksum16));
+      }
+      if (fee_CheckTeleCommandChecksum(TC) != Exported_CheckTeleCommandChecksum(TC) ||
+          fee_CheckTelemetryChecksum(TM) != Exported_CheckTelemetryChecksum(TM) ||
+          (i % 2 == 0 && fee_CheckTelemetryChecksum(TM) != FEE_EXIT_SUCCESS))
+      {
+         printf("Error: checksum check of random packet %d\n", i);
+         return EXIT_FAILURE;
+      }
+
+      Offset = xorshift32(&State) % TM_OFFSET_CHECKSUM;
+      Length = xorshift32(&State) % sizeof(Old);
+      Checksum16 = (uint16_t)xorshift32(&State);
+      Checksum8 = (uint8_t)Checksum16;
+      for (j = 0; j < Length; j++)
+      {
+         Old[j] = (uint8_t)xorshift32(&State);
+         New[j] = (uint8_t)xorshift32(&State);
+      }
+      if (fee_checksum16_patch(Checksum16, Offset, Old, New, Length) != Exported_checksum16_patch(Checksum16, Offset, Old, New, Length) ||
+          fee_checksum8_patch(Checksum8, Old, New, Length) != Exported_checksum8_patch(Checksum8, Old, New, Length))
+      {
+         printf("Error: checksum patch %d\n", i);
+         return EXIT_FAILURE;
+      }
+
+      Row = xorshift32(&State) % 4096;
+      Col = xorshift32(&State) % 4096;
+      Columns = xorshift32(&State) % 4096 + 1;
+      if (fee_PTDImageIndx(Row, Col, Columns) != Exported_PTDImageIndx(Row, Col, Columns))
+      {
+         printf("Error: fee_PTDImageIndx(%zu, %zu, %zu)\n", Row, Col, Columns);
+         return EXIT_FAILURE;
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+int main(void)
+{
+   int Status = EXIT_SUCCESS;
+
+   Status |= bitfield_test();
+   Status |= random_test();
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Inline Functions Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,401 @@
+/**
+ * @file limits_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Limit Monitoring Test. Hundreds of channels with random limits, infinite limits and hysteresis follow
+ *  random walks with NaN values, with the kernels of every CPU tier supported by the host, and their states and
+ *  transitions must be those of a reference state machine, packet by packet and in SoA batches. The converted
+ *  parameters of the TM capture are checked with a table loaded from a text file, and invalid tables are rejected.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <fee.h>
+#include <fee_dispatch.h>
+#include <fee_capture.h>
+#include <fee_limits.h>
+
+#define NUM_CHANNELS 301 /*Every tail length of the kernels*/
+#define NUM_FIELDS 64
+#define NUM_PACKETS 700
+#define MAX_TRANSITIONS (NUM_CHANNELS * NUM_PACKETS)
+#define TABLE_FILE "limits_test.lim"
+
+fee_limit_t Table[NUM_CHANNELS];
+float Columns[NUM_FIELDS * NUM_PACKETS];
+fee_limit_transition_t Expected[MAX_TRANSITIONS];
+fee_limit_transition_t ExpectedByPacket[MAX_TRANSITIONS];
+fee_limit_transition_t Transitions[MAX_TRANSITIONS];
+fee_TM_Float_t TMValues[NUM_PACKETS];
+
+uint32_t xorshift32(uint32_t *State)
+{
+   *State ^= *State << 13;
+   *State ^= *State >> 17;
+   *State ^= *State << 5;
+   return *State;
+}
+
+float uniform(uint32_t *State, float Low, float High)
+{
+   return Low + (High - Low) * (float)(xorshift32(State) >> 8) / (float)(1u << 24);
+}
+
+/*Reference state machine: the state only decreases once the value is Hysteresis inside the limits it had crossed*/
+fee_limit_state_t reference_state(const fee_limit_t *Limit, fee_limit_state_t State, float Value)
+{
+   float H = Limit->Hysteresis;
+   int OutAlarm = !(Value >= Limit->AlarmLow && Value <= Limit->AlarmHigh);
+   int OutWarn = !(Value >= Limit->WarnLow && Value <= Limit->WarnHigh);
+
+   if (OutAlarm)
+   {
+      return FEE_LIMIT_ALARM;
+   }
+   if (State == FEE_LIMIT_ALARM && !(Value >= Limit->AlarmLow + H && Value <= Limit->AlarmHigh - H))
+   {
+      return FEE_LIMIT_ALARM;
+   }
+   if (OutWarn)
+   {
+      return FEE_LIMIT_WARN;
+   }
+   if (State != FEE_LIMIT_OK && !(Value >= Limit->WarnLow + H && Value <= Limit->WarnHigh - H))
+   {
+      return FEE_LIMIT_WARN;
+   }
+
+   return FEE_LIMIT_OK;
+}
+
+void random_table(uint32_t *State)
+{
+   float Center, Warn, Alarm;
+   int i;
+
+   for (i = 0; i < NUM_CHANNELS; i++)
+   {
+      Center = uniform(State, -100.0f, 100.0f);
+      Warn = uniform(State, 1.0f, 10.0f);
+      Alarm = Warn + uniform(State, 0.0f, 5.0f);
+      Table[i].Field = xorshift32(State) % NUM_FIELDS;
+      Table[i].WarnLow = Center - Warn;
+      Table[i].WarnHigh = Center + Warn;
+      Table[i].AlarmLow = i % 7 == 0 ? -INFINITY : Center - Alarm;
+      Table[i].AlarmHigh = i % 11 == 0 ? INFINITY : Center + Alarm;
+      Table[i].Hysteresis = i % 5 == 0 ? 0.0f : uniform(State, 0.0f, Warn);
+   }
+}
+
+/*Random walks that cross the limits of the channels of every field*/
+void random_columns(uint32_t *State)
+{
+   float Value;
+   int f, p;
+
+   for (f = 0; f < NUM_FIELDS; f++)
+   {
+      Value = uniform(State, -100.0f, 100.0f);
+      for (p = 0; p < NUM_PACKETS; p++)
+      {
+         Value += uniform(State, -4.0f, 4.0f);
+         Value = Value > 120.0f ? 120.0f : (Value < -120.0f ? -120.0f : Value);
+         Columns[f * NUM_PACKETS + p] = xorshift32(State) % 97 == 0 ? NAN : Value;
+      }
+   }
+}
+
+/*Transitions of the reference, by channel and then by packet*/
+size_t reference_transitions(void)
+{
+   fee_limit_state_t State, Next;
+   size_t NumExpected = 0;
+   float Value;
+   int c, p;
+
+   for (c = 0; c < NUM_CHANNELS; c++)
+   {
+      State = FEE_LIMIT_OK;
+      for (p = 0; p < NUM_PACKETS; p++)
+      {
+         Value = Columns[Table[c].Field * NUM_PACKETS + p];
+         Next = reference_state(&Table[c], State, Value);
+         if (Next != State)
+         {
+            Expected[NumExpected].Channel = (uint32_t)c;
+            Expected[NumExpected].Field = Table[c].Field;
+            Expected[NumExpected].Packet = (size_t)p;
+            Expected[NumExpected].From = State;
+            Expected[NumExpected].To = Next;
+            Expected[NumExpected].Value = Value;
+            NumExpected++;
+         }
+         State = Next;
+      }
+   }
+
+   return NumExpected;
+}
+
+int same_transition(const fee_limit_transition_t *A, const fee_limit_transition_t *B)
+{
+   return A->Channel == B->Channel && A->Field == B->Field && A->Packet == B->Packet && A->From == B->From &&
+          A->To == B->To && memcmp(&A->Value, &B->Value, sizeof(float)) == 0;
+}
+
+int compare_by_packet(const void *A, const void *B)
+{
+   const fee_limit_transition_t *TA = (const fee_limit_transition_t *)A, *TB = (const fee_limit_transition_t *)B;
+
+   if (TA->Packet != TB->Packet)
+   {
+      return TA->Packet < TB->Packet ? -1 : 1;
+   }
+
+   return TA->Channel < TB->Channel ? -1 : (TA->Channel > TB->Channel);
+}
+
+int random_test(fee_cpu_tier_t Tier)
+{
+   fee_limits_t *Limits = NULL;
+   float Values[NUM_FIELDS];
+   size_t NumExpected, NumTransitions, Found = 0, i, j;
+   uint32_t State = 2026 + (uint32_t)Tier;
+   int f, p, Status = EXIT_SUCCESS;
+
+   random_table(&State);
+   random_columns(&State);
+   NumExpected = reference_transitions();
+   memcpy(ExpectedByPacket, Expected, NumExpected * sizeof(fee_limit_transition_t));
+   qsort(ExpectedByPacket, NumExpected, sizeof(fee_limit_transition_t), compare_by_packet);
+
+   if (fee_limits_create(Table, NUM_CHANNELS, &Limits) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating the monitor\n");
+      return EXIT_FAILURE;
+   }
+
+   /*Packet by packet*/
+   for (p = 0; p < NUM_PACKETS && Status == EXIT_SUCCESS; p++)
+   {
+      for (f = 0; f < NUM_FIELDS; f++)
+      {
+         Values[f] = Columns[f * NUM_PACKETS + p];
+      }
+      if (fee_limits_eval(Limits, Values, NUM_FIELDS, Transitions, MAX_TRANSITIONS, &NumTransitions) != FEE_EXIT_SUCCESS)
+      {
+         Status = EXIT_FAILURE;
+      }
+      for (i = 0; i < NumTransitions && Status == EXIT_SUCCESS; i++, Found++)
+      {
+         Transitions[i].Packet = (size_t)p;
+         if (Found >= NumExpected || !same_transition(&Transitions[i], &ExpectedByPacket[Found]))
+         {
+            Status = EXIT_FAILURE;
+         }
+      }
+   }
+   if (Status != EXIT_SUCCESS || Found != NumExpected)
+   {
+      printf("Error: %zu transitions packet by packet instead of %zu (%s)\n", Found, NumExpected, fee_dispatch_tier_name(Tier));
+      fee_limits_destroy(Limits);
+      return EXIT_FAILURE;
+   }
+
+   /*SoA batches, in two calls and with a short transition buffer*/
+   fee_limits_reset(Limits);
+   if (fee_limits_eval_batch(Limits, Columns, NUM_FIELDS, NUM_PACKETS, NUM_PACKETS / 3, Transitions, MAX_TRANSITIONS,
+                             &NumTransitions) != FEE_EXIT_SUCCESS)
+   {
+      Status = EXIT_FAILURE;
+   }
+   for (i = 0, j = 0; i < NumTransitions && Status == EXIT_SUCCESS; i++, j++)
+   {
+      while (j < NumExpected && Expected[j].Packet >= NUM_PACKETS / 3)
+      {
+         j++;
+      }
+      Status = j < NumExpected && same_transition(&Transitions[i], &Expected[j]) ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+   Found = NumTransitions;
+   for (f = 0; f < NUM_FIELDS; f++)
+   {
+      memmove(&Columns[f * (NUM_PACKETS - NUM_PACKETS / 3)], &Columns[f * NUM_PACKETS + NUM_PACKETS / 3],
+              (NUM_PACKETS - NUM_PACKETS / 3) * sizeof(float));
+   }
+   if (fee_limits_eval_batch(Limits, Columns, NUM_FIELDS, NUM_PACKETS - NUM_PACKETS / 3, NUM_PACKETS - NUM_PACKETS / 3,
+                             Transitions, 5, &NumTransitions) != FEE_EXIT_SUCCESS)
+   {
+      Status = EXIT_FAILURE;
+   }
+   for (i = 0, j = 0; i < 5 && i < NumTransitions && Status == EXIT_SUCCESS; i++, j++)
+   {
+      while (j < NumExpected && Expected[j].Packet < NUM_PACKETS / 3)
+      {
+         j++;
+      }
+      Transitions[i].Packet += NUM_PACKETS / 3;
+      Status = j < NumExpected && same_transition(&Transitions[i], &Expected[j]) ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+   if (Status != EXIT_SUCCESS || Found + NumTransitions != NumExpected)
+   {
+      printf("Error: %zu transitions in batches instead of %zu (%s)\n", Found + NumTransitions, NumExpected,
+             fee_dispatch_tier_name(Tier));
+      Status = EXIT_FAILURE;
+   }
+
+   fee_limits_destroy(Limits);
+   return Status;
+}
+
+int write_file(const char *Text)
+{
+   FILE *fp = fopen(TABLE_FILE, "w");
+
+   if (fp == NULL)
+   {
+      return EXIT_FAILURE;
+   }
+   fputs(Text, fp);
+   fclose(fp);
+
+   return EXIT_SUCCESS;
+}
+
+/*Loaded tables, and the converted parameters of a TM capture*/
+int table_test(const char *Path)
+{
+   const char *Invalid[] = {"UNKNOWN_MEAS 0 1 -1 2\n", "VDD_MEAS 1 0 -1 2\n", "VDD_MEAS 0 1 -1 2 0.6\n",
+                            "VDD_MEAS 0 1 -1 2 0 7\n", "VDD_MEAS 0 1 -1\n", "VDD_MEAS 0 1x -1 2\n", "# only a comment\n"};
+   const char *Text = "# Field          WarnLow WarnHigh AlarmLow AlarmHigh Hysteresis\n"
+                      "CCDTEMP_MEAS1    -300    300      -inf     inf       1\n"
+                      "\n"
+                      "  VDD_MEAS       0       10       -5       15\n"
+                      "21               0       0.001    -1       1         0.0005\n";
+   fee_limit_t TMTable[3];
+   fee_limits_t *Limits = NULL;
+   fee_capture_t *Capture = NULL;
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   fee_TM_t TM;
+   fee_limit_state_t States[3] = {FEE_LIMIT_OK, FEE_LIMIT_OK, FEE_LIMIT_OK};
+   size_t NumTransitions, NumPackets = 0, Total = 0, i, k;
+   const float *Values;
+   int Status = EXIT_SUCCESS;
+
+   for (i = 0; i < sizeof(Invalid) / sizeof(Invalid[0]); i++)
+   {
+      if (write_file(Invalid[i]) != EXIT_SUCCESS || fee_limits_load(TABLE_FILE, &Limits) == FEE_EXIT_SUCCESS)
+      {
+         printf("Error: invalid table accepted: %s", Invalid[i]);
+         fee_limits_destroy(Limits);
+         unlink(TABLE_FILE);
+         return EXIT_FAILURE;
+      }
+   }
+
+   if (write_file(Text) != EXIT_SUCCESS || fee_limits_load(TABLE_FILE, &Limits) != FEE_EXIT_SUCCESS ||
+       fee_limits_num_channels(Limits) != 3)
+   {
+      printf("Error loading the table\n");
+      fee_limits_destroy(Limits);
+      unlink(TABLE_FILE);
+      return EXIT_FAILURE;
+   }
+   unlink(TABLE_FILE);
+
+   memset(TMTable, 0, sizeof(TMTable));
+   TMTable[0] = (fee_limit_t){FEE_TM_FLOAT_CCDTEMP_MEAS1, -300.0f, 300.0f, -INFINITY, INFINITY, 1.0f};
+   TMTable[1] = (fee_limit_t){FEE_TM_FLOAT_VDD_MEAS, 0.0f, 10.0f, -5.0f, 15.0f, 0.0f};
+   TMTable[2] = (fee_limit_t){FEE_TM_FLOAT_IDIG_MEAS, 0.0f, 0.001f, -1.0f, 1.0f, 0.0005f};
+
+   if (fee_capture_open(Path, &Capture) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error opening %s\n", Path);
+      fee_limits_destroy(Limits);
+      return EXIT_FAILURE;
+   }
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (NumPackets < NUM_PACKETS && Status == EXIT_SUCCESS && fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      if (Packet.Type != FEE_CAPTURE_TM || Packet.NumBytes != TM_PACKET_BYTES)
+      {
+         continue;
+      }
+      fee_TM_Read((uint8_t *)Packet.Bytes, &TM);
+      fee_convert_TM_parameters(TM, &TMValues[NumPackets]);
+      if (fee_limits_eval_tm(Limits, &TMValues[NumPackets], Transitions, MAX_TRANSITIONS, &NumTransitions) != FEE_EXIT_SUCCESS)
+      {
+         Status = EXIT_FAILURE;
+      }
+
+      Values = (const float *)&TMValues[NumPackets];
+      for (i = 0, k = 0; i < 3 && Status == EXIT_SUCCESS; i++)
+      {
+         fee_limit_state_t Next = reference_state(&TMTable[i], States[i], Values[TMTable[i].Field]);
+
+         if (Next != States[i] && (k >= NumTransitions || Transitions[k].Channel != i || Transitions[k++].To != Next))
+         {
+            Status = EXIT_FAILURE;
+         }
+         States[i] = Next;
+         if (fee_limits_state(Limits, i) != Next)
+         {
+            Status = EXIT_FAILURE;
+         }
+      }
+      if (k != NumTransitions)
+      {
+         Status = EXIT_FAILURE;
+      }
+      Total += NumTransitions;
+      NumPackets++;
+   }
+   fee_capture_iter_free(&Iter);
+   fee_capture_close(Capture);
+   fee_limits_destroy(Limits);
+
+   if (Status != EXIT_SUCCESS || NumPackets == 0)
+   {
+      printf("Error checking packet %zu of the capture\n", NumPackets);
+      return EXIT_FAILURE;
+   }
+   printf("%zu TM packets checked, %zu transitions\n", NumPackets, Total);
+
+   return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+   int Tier, Status = EXIT_SUCCESS;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <TM capture>\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   for (Tier = FEE_CPU_TIER_SCALAR; Tier <= (int)fee_dispatch_detected_tier(); Tier++)
+   {
+      fee_dispatch_set_tier((fee_cpu_tier_t)Tier);
+      Status |= random_test((fee_cpu_tier_t)Tier);
+   }
+   fee_dispatch_set_tier(fee_dispatch_detected_tier());
+
+   Status |= table_test(argv[1]);
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Limit Monitoring Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
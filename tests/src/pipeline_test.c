@@ -0,0 +1,305 @@
+/**
+ * @file pipeline_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Pipeline Test. The test reads an example file which contains TM packets, copies them into pooled buffers and
+ *  pushes them through a checksum + decode pipeline. Decoded packets are compared with fee_TM_Read, and packets
+ *  with a corrupted checksum must be reported as failed. The buffer pool must reject a buffer released twice, and the
+ *  decode stage must reject a truncated PTD packet on its own, before reading it.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_pipeline.h>
+#include <fee_generator.h>
+
+#define NUM_POOL_BUFFERS 64
+#define CORRUPTED_PACKET_PERIOD 10
+#define NUM_SMALL_POOL_BUFFERS 4
+
+char str[TM_PACKET_BYTES * 10];
+
+/*Check a processed descriptor and give its buffer back*/
+int check_descriptor(fee_buffer_pool_t *Pool, fee_packet_desc_t *Desc, size_t ExpectedSequence, int *AreEqual)
+{
+   fee_TM_t TM_Data_Struct = {0};
+   size_t Sequence = (size_t)Desc->UserData;
+
+   /*Descriptors must be received in submission order*/
+   if (Sequence != ExpectedSequence)
+   {
+      printf("Error: packet %zu received out of order\n", Sequence);
+      *AreEqual = 0;
+   }
+
+   if (Sequence % CORRUPTED_PACKET_PERIOD == 0)
+   {
+      if (Desc->Status != FEE_EXIT_ERROR)
+      {
+         printf("Error: corrupted packet %zu not detected\n", Sequence);
+         *AreEqual = 0;
+      }
+   }
+   else if (Desc->Status != FEE_EXIT_SUCCESS ||
+            fee_TM_Read(Desc->Packet, &TM_Data_Struct) != FEE_EXIT_SUCCESS ||
+            memcmp(&TM_Data_Struct, &Desc->TM, sizeof(fee_TM_t)) != 0)
+   {
+      printf("Error at decoded packet %zu\n", Sequence);
+      *AreEqual = 0;
+   }
+
+   return fee_buffer_pool_release(Pool, Desc->BufferIndex);
+}
+
+int pipeline_test(FILE *fp, int *AreEqual)
+{
+   fee_pipeline_stage_t Stages[2] = {{fee_pipeline_stage_checksum, NULL}, {fee_pipeline_stage_decode, NULL}};
+   fee_pipeline_config_t Config = {Stages, 2, 16, 8};
+   fee_pipeline_t *Pipeline = NULL;
+   fee_buffer_pool_t *Pool = NULL;
+   fee_packet_desc_t Desc;
+   char *tok;
+   int counter, byte_counter;
+   size_t Submitted = 0, Received = 0;
+
+   *AreEqual = 1;
+
+   if (fee_buffer_pool_create(NUM_POOL_BUFFERS, TM_PACKET_BYTES, &Pool) != FEE_EXIT_SUCCESS ||
+       fee_pipeline_create(&Config, &Pipeline) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating the pipeline\n");
+      fee_buffer_pool_destroy(Pool);
+      return EXIT_FAILURE;
+   }
+
+   while (fgets(str, TM_PACKET_BYTES * 10, fp))
+   {
+      memset(&Desc, 0, sizeof(Desc));
+      Desc.Type = FEE_PACKET_TM;
+      Desc.PacketBytes = TM_PACKET_BYTES;
+      Desc.UserData = (void *)Submitted;
+
+      /*Wait for a free buffer, receiving processed packets meanwhile*/
+      while (fee_buffer_pool_acquire(Pool, &Desc.Packet, &Desc.BufferIndex) != FEE_EXIT_SUCCESS)
+      {
+         fee_packet_desc_t Done;
+         if (fee_pipeline_receive(Pipeline, &Done, 1) == 1)
+         {
+            check_descriptor(Pool, &Done, Received, AreEqual);
+            Received++;
+         }
+      }
+
+      byte_counter = 0;
+      for (tok = strtok(str, " "), counter = 0; tok != NULL; tok = strtok(NULL, " "), counter++)
+      {
+         if (tok[0] && strstr(tok, "\n") == NULL && counter > 1 && byte_counter < TM_PACKET_BYTES)
+         {
+            Desc.Packet[byte_counter] = (uint8_t)atoi(tok);
+            byte_counter++;
+         }
+      }
+
+      if (Submitted % CORRUPTED_PACKET_PERIOD == 0)
+      {
+         Desc.Packet[TM_PACKET_BYTES - 1] ^= 0x5A;
+      }
+
+      while (fee_pipeline_submit(Pipeline, &Desc, 1) != 1)
+      {
+         fee_packet_desc_t Done;
+         if (fee_pipeline_receive(Pipeline, &Done, 1) == 1)
+         {
+            check_descriptor(Pool, &Done, Received, AreEqual);
+            Received++;
+         }
+      }
+      Submitted++;
+   }
+
+   /*Drain the pipeline*/
+   while (Received < Submitted)
+   {
+      fee_packet_desc_t Done[8];
+      size_t NumDone = fee_pipeline_receive(Pipeline, Done, 8);
+
+      for (size_t i = 0; i < NumDone; i++)
+      {
+         check_descriptor(Pool, &Done[i], Received, AreEqual);
+         Received++;
+      }
+   }
+
+   fee_pipeline_destroy(Pipeline);
+   fee_buffer_pool_destroy(Pool);
+
+   if (Submitted == 0)
+   {
+      printf("Error: no packets read\n");
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+int double_release_test(void)
+{
+   fee_buffer_pool_t *Pool = NULL;
+   uint8_t *Buffer;
+   size_t Indexes[NUM_SMALL_POOL_BUFFERS], First, Second, i, j;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_buffer_pool_create(NUM_SMALL_POOL_BUFFERS, TM_PACKET_BYTES, &Pool) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating the buffer pool\n");
+      return EXIT_FAILURE;
+   }
+
+   /*The free list is not full, so only the ownership of the buffer detects the second release*/
+   if (fee_buffer_pool_acquire(Pool, &Buffer, &First) != FEE_EXIT_SUCCESS ||
+       fee_buffer_pool_acquire(Pool, &Buffer, &Second) != FEE_EXIT_SUCCESS ||
+       fee_buffer_pool_release(Pool, First) != FEE_EXIT_SUCCESS ||
+       fee_buffer_pool_release(Pool, First) != FEE_EXIT_ERROR)
+   {
+      printf("Error: buffer %zu released twice\n", First);
+      Status = EXIT_FAILURE;
+   }
+
+   /*Every free buffer is handed out once*/
+   for (i = 0; i < NUM_SMALL_POOL_BUFFERS - 1 && Status == EXIT_SUCCESS; i++)
+   {
+      if (fee_buffer_pool_acquire(Pool, &Buffer, &Indexes[i]) != FEE_EXIT_SUCCESS || Indexes[i] == Second)
+      {
+         printf("Error: buffer pool acquire %zu\n", i);
+         Status = EXIT_FAILURE;
+      }
+      for (j = 0; j < i && Status == EXIT_SUCCESS; j++)
+      {
+         if (Indexes[i] == Indexes[j])
+         {
+            printf("Error: buffer %zu acquired twice\n", Indexes[i]);
+            Status = EXIT_FAILURE;
+         }
+      }
+   }
+   if (Status == EXIT_SUCCESS && fee_buffer_pool_acquire(Pool, &Buffer, &Indexes[0]) != FEE_EXIT_ERROR)
+   {
+      printf("Error: empty buffer pool acquire\n");
+      Status = EXIT_FAILURE;
+   }
+
+   fee_buffer_pool_destroy(Pool);
+
+   return Status;
+}
+
+/*Decode stage used without the checksum stage. The truncated packet buffer is exactly PacketBytes long*/
+int truncated_ptd_test(void)
+{
+   fee_gen_config_t Config;
+   fee_gen_frame_t Frame;
+   fee_packet_desc_t Desc;
+   size_t PacketBytes;
+   int Status = EXIT_SUCCESS, Allocated, Truncated, k;
+
+   memset(&Frame, 0, sizeof(Frame));
+   fee_gen_config_default(&Config);
+   if (fee_gen_frame(&Config, 0, &Frame) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error generating the PTD frame\n");
+      return EXIT_FAILURE;
+   }
+
+   for (Truncated = 0; Truncated < 2; Truncated++)
+   {
+      /*The truncated packet lacks pixel data, not only the checksum, which fee_PTD_Read does not read*/
+      PacketBytes = Frame.PTD.PTDSizes.DataPacketTotalBytes / (Truncated ? 2 : 1);
+      memset(&Desc, 0, sizeof(Desc));
+      Desc.Type = FEE_PACKET_PTD;
+      Desc.PacketBytes = PacketBytes;
+      Desc.TM = Frame.TM;
+      Desc.Packet = malloc(PacketBytes);
+      Allocated = Desc.Packet != NULL;
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         Desc.PTD.ImageMatrix[k] = malloc(Frame.PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes);
+         Allocated = Allocated && Desc.PTD.ImageMatrix[k] != NULL;
+      }
+
+      if (!Allocated)
+      {
+         printf("Error allocating the PTD descriptor\n");
+         Status = EXIT_FAILURE;
+      }
+      else
+      {
+         memcpy(Desc.Packet, Frame.PTD_Packet, PacketBytes);
+         if (fee_pipeline_stage_decode(&Desc, NULL) != (Truncated ? FEE_EXIT_ERROR : FEE_EXIT_SUCCESS))
+         {
+            printf("Error: decode stage of a %s PTD packet\n", Truncated ? "truncated" : "complete");
+            Status = EXIT_FAILURE;
+         }
+      }
+
+      free(Desc.Packet);
+      for (k = 0; k < FEE_NUM_CCD; k++)
+      {
+         free(Desc.PTD.ImageMatrix[k]);
+      }
+   }
+
+   fee_gen_frame_free(&Frame);
+
+   return Status;
+}
+
+int main(int argc, char *argv[])
+{
+   FILE *fp;
+   int AreEqual = 1;
+
+   if (argc != 2)
+   {
+      printf("Argument Error: The program should be executed as: %s TM_MessageFile \n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   /* opening file for reading */
+   fp = fopen(argv[1], "r");
+   if (fp == NULL)
+   {
+      perror("Error opening file");
+      return (EXIT_FAILURE);
+   }
+
+   // Run test
+   if (pipeline_test(fp, &AreEqual) != EXIT_SUCCESS)
+   {
+      fclose(fp);
+      return EXIT_FAILURE;
+   }
+
+   // Clean-up
+   fclose(fp);
+
+   if (double_release_test() != EXIT_SUCCESS || truncated_ptd_test() != EXIT_SUCCESS)
+   {
+      AreEqual = 0;
+   }
+
+   if (AreEqual)
+   {
+      printf("Pipeline Test Success!\n");
+      return EXIT_SUCCESS;
+   }
+   else
+   {
+      printf("Pipeline Test Error!\n");
+      return EXIT_FAILURE;
+   }
+}
@@ -0,0 +1,324 @@
+/**
+ * @file queue_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Frame Queue Test. Frames are pushed into full queues of every policy and the queued, dropped and decimated
+ *  frames and the counters are checked. A blocking queue is also fed by a producer thread faster than its consumer,
+ *  which must receive every frame in order, and a producer blocked on a full queue must be woken when it is closed.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <fee.h>
+#include <fee_pipeline.h>
+#include <fee_queue.h>
+
+#define NUM_PUSHED 20
+#define NUM_STREAMED 10000
+#define SMALL_CAPACITY 4
+
+/*Sequences of the released frames*/
+size_t Released[NUM_PUSHED];
+size_t NumReleased;
+
+void release_frame(void *ReleaseData, fee_packet_desc_t *Frame)
+{
+   (void)ReleaseData;
+   Released[NumReleased++] = (size_t)(uintptr_t)Frame->UserData;
+}
+
+void make_frame(fee_packet_desc_t *Frame, size_t Sequence)
+{
+   memset(Frame, 0, sizeof(fee_packet_desc_t));
+   Frame->Type = FEE_PACKET_PTD;
+   Frame->PTD.PIXEL_DATA_COUNTER = (uint32_t)Sequence;
+   Frame->UserData = (void *)(uintptr_t)Sequence;
+}
+
+/*Push NUM_PUSHED frames without consumer and check the queued sequences, the released ones and the counters*/
+int policy_test(const fee_frame_queue_config_t *Config, const size_t *Queued, size_t NumQueued, const size_t *Dropped,
+                size_t NumDropped, const fee_frame_queue_counters_t *Expected)
+{
+   const char *Name = fee_frame_queue_policy_name(Config->Policy);
+   fee_frame_queue_t *Queue = NULL;
+   fee_frame_queue_counters_t Counters;
+   fee_packet_desc_t Frame;
+   size_t i, NumAccepted = 0;
+   int Accepted, Status = EXIT_SUCCESS;
+
+   NumReleased = 0;
+   if (fee_frame_queue_create(Config, &Queue) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating the %s queue\n", Name);
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < NUM_PUSHED; i++)
+   {
+      make_frame(&Frame, i);
+      if (fee_frame_queue_push(Queue, &Frame, &Accepted) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: %s: push %zu failed\n", Name, i);
+         Status = EXIT_FAILURE;
+      }
+      NumAccepted += (size_t)Accepted;
+   }
+
+   fee_frame_queue_counters(Queue, &Counters);
+   if (Counters.Pushed != NUM_PUSHED || Counters.Accepted != NumAccepted || Counters.Accepted != Expected->Accepted ||
+       Counters.DroppedOldest != Expected->DroppedOldest || Counters.DroppedNewest != Expected->DroppedNewest ||
+       Counters.Decimated != Expected->Decimated || Counters.Depth != NumQueued || Counters.HighWatermark != NumQueued ||
+       Counters.BlockedPushes != 0)
+   {
+      printf("Error: %s: wrong counters\n", Name);
+      Status = EXIT_FAILURE;
+   }
+
+   if (NumReleased != NumDropped || (NumDropped > 0 && memcmp(Released, Dropped, NumDropped * sizeof(size_t)) != 0))
+   {
+      printf("Error: %s: wrong dropped frames\n", Name);
+      Status = EXIT_FAILURE;
+   }
+
+   for (i = 0; i < NumQueued; i++)
+   {
+      if (fee_frame_queue_try_pop(Queue, &Frame) != FEE_EXIT_SUCCESS || (size_t)(uintptr_t)Frame.UserData != Queued[i] ||
+          Frame.PTD.PIXEL_DATA_COUNTER != Queued[i])
+      {
+         printf("Error: %s: wrong queued frame %zu\n", Name, i);
+         Status = EXIT_FAILURE;
+      }
+   }
+   if (fee_frame_queue_try_pop(Queue, &Frame) != FEE_EXIT_ERROR)
+   {
+      printf("Error: %s: queue not empty\n", Name);
+      Status = EXIT_FAILURE;
+   }
+
+   fee_frame_queue_destroy(Queue);
+
+   return Status;
+}
+
+int policies_test(void)
+{
+   fee_frame_queue_config_t Config = {SMALL_CAPACITY, FEE_QUEUE_DROP_OLDEST, 0, 0, release_frame, NULL};
+   fee_frame_queue_counters_t Expected = {0};
+   size_t Newest[SMALL_CAPACITY] = {16, 17, 18, 19};
+   size_t Oldest[SMALL_CAPACITY] = {0, 1, 2, 3};
+   size_t Dropped[NUM_PUSHED];
+   size_t Decimated[8] = {0, 1, 2, 3, 4, 7, 10, 13};
+   size_t DecimatedDropped[12] = {5, 6, 8, 9, 11, 12, 14, 15, 16, 17, 18, 19};
+   size_t i;
+   int Status = EXIT_SUCCESS;
+
+   /*The newest frames are kept*/
+   for (i = 0; i < NUM_PUSHED - SMALL_CAPACITY; i++)
+   {
+      Dropped[i] = i;
+   }
+   Expected.Accepted = NUM_PUSHED;
+   Expected.DroppedOldest = NUM_PUSHED - SMALL_CAPACITY;
+   Status |= policy_test(&Config, Newest, SMALL_CAPACITY, Dropped, NUM_PUSHED - SMALL_CAPACITY, &Expected);
+
+   /*The oldest frames are kept*/
+   for (i = 0; i < NUM_PUSHED - SMALL_CAPACITY; i++)
+   {
+      Dropped[i] = SMALL_CAPACITY + i;
+   }
+   Config.Policy = FEE_QUEUE_DROP_NEWEST;
+   memset(&Expected, 0, sizeof(Expected));
+   Expected.Accepted = SMALL_CAPACITY;
+   Expected.DroppedNewest = NUM_PUSHED - SMALL_CAPACITY;
+   Status |= policy_test(&Config, Oldest, SMALL_CAPACITY, Dropped, NUM_PUSHED - SMALL_CAPACITY, &Expected);
+
+   /*From 4 queued frames, one of every 3 is kept until the 8 slots are full*/
+   Config.Policy = FEE_QUEUE_DECIMATE;
+   Config.Capacity = 8;
+   Config.DecimationFactor = 3;
+   Config.DecimationThreshold = 4;
+   memset(&Expected, 0, sizeof(Expected));
+   Expected.Accepted = 8;
+   Expected.Decimated = 10;
+   Expected.DroppedNewest = 2;
+   Status |= policy_test(&Config, Decimated, 8, DecimatedDropped, 12, &Expected);
+
+   /*Queues not full do not drop*/
+   Config.Policy = FEE_QUEUE_BLOCK;
+   Config.Capacity = NUM_PUSHED;
+   for (i = 0; i < NUM_PUSHED; i++)
+   {
+      Dropped[i] = i;
+   }
+   memset(&Expected, 0, sizeof(Expected));
+   Expected.Accepted = NUM_PUSHED;
+   Status |= policy_test(&Config, Dropped, NUM_PUSHED, NULL, 0, &Expected);
+
+   return Status;
+}
+
+void *producer_thread(void *Arg)
+{
+   fee_frame_queue_t *Queue = Arg;
+   fee_packet_desc_t Frame;
+   size_t i;
+
+   for (i = 0; i < NUM_STREAMED; i++)
+   {
+      make_frame(&Frame, i);
+      if (fee_frame_queue_push(Queue, &Frame, NULL) != FEE_EXIT_SUCCESS)
+      {
+         break;
+      }
+   }
+   fee_frame_queue_close(Queue);
+
+   return NULL;
+}
+
+/*A blocking queue keeps every frame of a producer faster than its consumer*/
+int block_test(void)
+{
+   fee_frame_queue_config_t Config = {SMALL_CAPACITY, FEE_QUEUE_BLOCK, 0, 0, NULL, NULL};
+   struct timespec Delay = {0, 10000000};
+   fee_frame_queue_t *Queue = NULL;
+   fee_frame_queue_counters_t Counters;
+   fee_packet_desc_t Frame;
+   pthread_t Producer;
+   size_t Expected = 0;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_frame_queue_create(&Config, &Queue) != FEE_EXIT_SUCCESS ||
+       pthread_create(&Producer, NULL, producer_thread, Queue) != 0)
+   {
+      printf("Error starting the blocking queue test\n");
+      fee_frame_queue_destroy(Queue);
+      return EXIT_FAILURE;
+   }
+
+   /*The producer fills the queue and waits*/
+   nanosleep(&Delay, NULL);
+
+   while (fee_frame_queue_pop(Queue, &Frame) == FEE_EXIT_SUCCESS)
+   {
+      if ((size_t)(uintptr_t)Frame.UserData != Expected)
+      {
+         printf("Error: frame %zu received instead of %zu\n", (size_t)(uintptr_t)Frame.UserData, Expected);
+         Status = EXIT_FAILURE;
+      }
+      Expected++;
+   }
+   pthread_join(Producer, NULL);
+
+   fee_frame_queue_counters(Queue, &Counters);
+   if (Expected != NUM_STREAMED || Counters.Popped != NUM_STREAMED || Counters.Accepted != NUM_STREAMED ||
+       Counters.BlockedPushes == 0 || Counters.BlockedNanoseconds == 0 || Counters.HighWatermark != SMALL_CAPACITY ||
+       Counters.DroppedOldest + Counters.DroppedNewest + Counters.Decimated != 0)
+   {
+      printf("Error: blocking queue lost frames or has wrong counters\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*Closed queues reject pushes*/
+   make_frame(&Frame, 0);
+   if (fee_frame_queue_push(Queue, &Frame, NULL) != FEE_EXIT_ERROR)
+   {
+      printf("Error: push into a closed queue\n");
+      Status = EXIT_FAILURE;
+   }
+
+   fee_frame_queue_destroy(Queue);
+
+   return Status;
+}
+
+void *closer_thread(void *Arg)
+{
+   struct timespec Delay = {0, 10000000};
+
+   nanosleep(&Delay, NULL);
+   fee_frame_queue_close(Arg);
+
+   return NULL;
+}
+
+/*A producer blocked on a full queue is woken by close, and destroy releases the queued frames*/
+int close_test(void)
+{
+   fee_frame_queue_config_t Config = {SMALL_CAPACITY, FEE_QUEUE_BLOCK, 0, 0, release_frame, NULL};
+   fee_frame_queue_t *Queue = NULL;
+   fee_packet_desc_t Frame;
+   pthread_t Closer;
+   size_t i;
+   int Status = EXIT_SUCCESS;
+
+   NumReleased = 0;
+   if (fee_frame_queue_create(&Config, &Queue) != FEE_EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < SMALL_CAPACITY; i++)
+   {
+      make_frame(&Frame, i);
+      fee_frame_queue_push(Queue, &Frame, NULL);
+   }
+
+   pthread_create(&Closer, NULL, closer_thread, Queue);
+   make_frame(&Frame, SMALL_CAPACITY);
+   if (fee_frame_queue_push(Queue, &Frame, NULL) != FEE_EXIT_ERROR)
+   {
+      printf("Error: blocked push not failed by close\n");
+      Status = EXIT_FAILURE;
+   }
+   pthread_join(Closer, NULL);
+
+   /*The consumers still get the queued frames*/
+   if (fee_frame_queue_pop(Queue, &Frame) != FEE_EXIT_SUCCESS || (size_t)(uintptr_t)Frame.UserData != 0)
+   {
+      printf("Error: queued frame lost at close\n");
+      Status = EXIT_FAILURE;
+   }
+
+   fee_frame_queue_destroy(Queue);
+   if (NumReleased != SMALL_CAPACITY - 1)
+   {
+      printf("Error: %zu frames released at destroy\n", NumReleased);
+      Status = EXIT_FAILURE;
+   }
+
+   return Status;
+}
+
+int main(void)
+{
+   fee_frame_queue_config_t Config = {0, FEE_QUEUE_BLOCK, 0, 0, NULL, NULL};
+   fee_frame_queue_t *Queue = NULL;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_frame_queue_create(&Config, &Queue) != FEE_EXIT_ERROR || fee_frame_queue_policy_name((fee_queue_policy_t)4) != NULL)
+   {
+      printf("Error: wrong configuration accepted\n");
+      Status = EXIT_FAILURE;
+   }
+
+   Status |= policies_test();
+   Status |= block_test();
+   Status |= close_test();
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Queue Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
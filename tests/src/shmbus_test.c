@@ -0,0 +1,342 @@
+/**
+ * @file shmbus_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Shared-Memory Frame Bus Test. Generated frames are decoded straight into the slots of a bus and read in
+ *  place by two readers, which must see the same planes as fee_PTD_Read. Slots must only be reused when every
+ *  reader has released them, or when a reader detaches or is evicted. A forked process attaches to a named bus and
+ *  checks every published frame.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <fee.h>
+#include <fee_generator.h>
+#include <fee_shmbus.h>
+
+#define NUM_SLOTS 4
+#define NUM_FRAMES 16
+#define NUM_CHILD_FRAMES 200
+#define PLANE_BYTES (64 * 1024)
+
+fee_gen_frame_t Frames[NUM_FRAMES];
+
+int generate_frames(void)
+{
+   fee_gen_config_t Config;
+   uint32_t i;
+
+   for (i = 0; i < NUM_FRAMES; i++)
+   {
+      fee_gen_config_default(&Config);
+      Config.Pattern = FEE_GEN_PATTERN_NOISE;
+      Config.Seed = 41;
+      Config.WOISIZE = (uint16_t)(10 + 3 * (i % 4));
+      Config.NBTAIL = (uint16_t)(i % 3);
+      Config.BandSize[0] = 40;
+      if (fee_gen_frame(&Config, i, &Frames[i]) != FEE_EXIT_SUCCESS ||
+          Frames[i].PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes > PLANE_BYTES)
+      {
+         return EXIT_FAILURE;
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+/*Decode a frame straight into the next slot*/
+int publish_frame(fee_shmbus_t *Bus, const fee_gen_frame_t *Frame)
+{
+   fee_PTD_t PTD = {0};
+
+   if (fee_shmbus_reserve(Bus, &Frame->TM, &PTD) != FEE_EXIT_SUCCESS ||
+       fee_PTD_Read(Frame->PTD_Packet, Frame->TM, &PTD) != FEE_EXIT_SUCCESS)
+   {
+      return FEE_EXIT_ERROR;
+   }
+
+   return fee_shmbus_commit(Bus, &PTD);
+}
+
+int same_frame(const fee_TM_t *TM, const fee_PTD_t *PTD, const fee_gen_frame_t *Frame)
+{
+   int k;
+
+   if (memcmp(TM, &Frame->TM, sizeof(fee_TM_t)) != 0 || PTD->PIXEL_DATA_COUNTER != Frame->PTD.PIXEL_DATA_COUNTER ||
+       memcmp(PTD->VOLTAGES_REFERENCES, Frame->PTD.VOLTAGES_REFERENCES, sizeof(PTD->VOLTAGES_REFERENCES)) != 0 ||
+       memcmp(&PTD->PTDSizes, &Frame->PTD.PTDSizes, sizeof(fee_PTDSizes_t)) != 0)
+   {
+      return 0;
+   }
+
+   for (k = 0; k < FEE_NUM_CCD; k++)
+   {
+      if (memcmp(PTD->ImageMatrix[k], Frame->PTD.ImageMatrix[k], Frame->PTD.PTDImageMatrixTotalSizes.ImageMatrixBytes) != 0)
+      {
+         return 0;
+      }
+   }
+
+   return 1;
+}
+
+/*Read, check and release the next frame of a reader*/
+int consume_frame(fee_shmbus_reader_t *Reader, uint64_t ExpectedSequence)
+{
+   fee_TM_t TM;
+   fee_PTD_t PTD;
+   uint64_t Sequence;
+
+   if (fee_shmbus_read(Reader, &TM, &PTD, &Sequence) != FEE_EXIT_SUCCESS || Sequence != ExpectedSequence ||
+       !same_frame(&TM, &PTD, &Frames[Sequence % NUM_FRAMES]) || fee_shmbus_release(Reader) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error: reader %u: wrong frame %llu\n", fee_shmbus_reader_id(Reader), (unsigned long long)ExpectedSequence);
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+/*Two readers of a memfd bus. A slot is only reused when both have released it*/
+int reclamation_test(void)
+{
+   fee_shmbus_config_t Config = {NUM_SLOTS, PLANE_BYTES};
+   fee_shmbus_t *Bus = NULL;
+   fee_shmbus_reader_t *Fast = NULL, *Slow = NULL, *Late = NULL;
+   fee_shmbus_counters_t Counters;
+   fee_PTD_t PTD;
+   uint64_t Sequence, i;
+   int Status = EXIT_SUCCESS;
+
+   if (fee_shmbus_create(NULL, &Config, &Bus) != FEE_EXIT_SUCCESS ||
+       fee_shmbus_attach_fd(fee_shmbus_fd(Bus), &Fast) != FEE_EXIT_SUCCESS ||
+       fee_shmbus_attach_fd(fee_shmbus_fd(Bus), &Slow) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error creating the memfd bus\n");
+      fee_shmbus_detach(Fast);
+      fee_shmbus_destroy(Bus);
+      return EXIT_FAILURE;
+   }
+
+   if (fee_shmbus_read(Fast, NULL, &PTD, NULL) != FEE_EXIT_ERROR || fee_shmbus_release(Fast) != FEE_EXIT_ERROR)
+   {
+      printf("Error: frame read from an empty bus\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*The ring fills up*/
+   for (i = 0; i < NUM_SLOTS; i++)
+   {
+      if (publish_frame(Bus, &Frames[i]) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error publishing frame %llu\n", (unsigned long long)i);
+         Status = EXIT_FAILURE;
+      }
+   }
+   if (publish_frame(Bus, &Frames[NUM_SLOTS]) != FEE_EXIT_ERROR)
+   {
+      printf("Error: referenced slot reused\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*The fast reader alone does not free the slots*/
+   for (i = 0; i < NUM_SLOTS; i++)
+   {
+      Status |= consume_frame(Fast, i);
+   }
+   if (publish_frame(Bus, &Frames[NUM_SLOTS]) != FEE_EXIT_ERROR)
+   {
+      printf("Error: slot reused before the slow reader released it\n");
+      Status = EXIT_FAILURE;
+   }
+
+   fee_shmbus_counters(Bus, &Counters);
+   if (Counters.Published != NUM_SLOTS || Counters.Busy != 2 || Counters.ActiveReaders != 2 || Counters.MaxLag != NUM_SLOTS)
+   {
+      printf("Error: wrong counters of the full bus\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*Reading twice without releasing returns the same frame*/
+   if (fee_shmbus_read(Slow, NULL, &PTD, &Sequence) != FEE_EXIT_SUCCESS || Sequence != 0 ||
+       fee_shmbus_read(Slow, NULL, &PTD, &Sequence) != FEE_EXIT_SUCCESS || Sequence != 0)
+   {
+      printf("Error: repeated read\n");
+      Status = EXIT_FAILURE;
+   }
+   Status |= fee_shmbus_release(Slow) == FEE_EXIT_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+   if (publish_frame(Bus, &Frames[NUM_SLOTS]) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error: released slot not reused\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*A late reader only gets the new frames*/
+   if (fee_shmbus_attach_fd(fee_shmbus_fd(Bus), &Late) != FEE_EXIT_SUCCESS ||
+       fee_shmbus_read(Late, NULL, &PTD, NULL) != FEE_EXIT_ERROR)
+   {
+      printf("Error: late reader\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*Detaching and evicting drop the references of the slow and late readers*/
+   fee_shmbus_detach(Slow);
+   if (fee_shmbus_evict(Bus, fee_shmbus_reader_id(Late)) != FEE_EXIT_SUCCESS ||
+       fee_shmbus_evict(Bus, fee_shmbus_reader_id(Late)) != FEE_EXIT_ERROR)
+   {
+      printf("Error evicting the late reader\n");
+      Status = EXIT_FAILURE;
+   }
+   for (i = 1; i < NUM_SLOTS + 1; i++)
+   {
+      Status |= consume_frame(Fast, NUM_SLOTS + i - 1);
+      if (publish_frame(Bus, &Frames[(NUM_SLOTS + i) % NUM_FRAMES]) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: slots of the detached readers not released\n");
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   fee_shmbus_detach(Late);
+   fee_shmbus_detach(Fast);
+   fee_shmbus_destroy(Bus);
+
+   return Status;
+}
+
+/*A process attached by name checks every published frame*/
+int child_reader(const char *Name, int ReadyFd)
+{
+   fee_shmbus_reader_t *Reader = NULL;
+   uint64_t Expected = 0;
+   fee_TM_t TM;
+   fee_PTD_t PTD;
+   uint64_t Sequence;
+   char Ready = 1;
+
+   if (fee_shmbus_attach(Name, &Reader) != FEE_EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+   if (write(ReadyFd, &Ready, 1) != 1)
+   {
+      return EXIT_FAILURE;
+   }
+
+   while (Expected < NUM_CHILD_FRAMES)
+   {
+      if (fee_shmbus_read(Reader, &TM, &PTD, &Sequence) != FEE_EXIT_SUCCESS)
+      {
+         usleep(100);
+         continue;
+      }
+      if (Sequence != Expected || !same_frame(&TM, &PTD, &Frames[Sequence % NUM_FRAMES]))
+      {
+         printf("Error: child read a wrong frame %llu\n", (unsigned long long)Sequence);
+         return EXIT_FAILURE;
+      }
+      fee_shmbus_release(Reader);
+      Expected++;
+   }
+
+   fee_shmbus_detach(Reader);
+
+   return EXIT_SUCCESS;
+}
+
+int process_test(void)
+{
+   fee_shmbus_config_t Config = {NUM_SLOTS, PLANE_BYTES};
+   fee_shmbus_t *Bus = NULL;
+   char Name[64];
+   int Pipe[2], ChildStatus = 0, Status = EXIT_SUCCESS;
+   char Ready;
+   uint64_t i;
+   pid_t Child;
+
+   snprintf(Name, sizeof(Name), "/fee_shmbus_test_%d", (int)getpid());
+   if (fee_shmbus_create(Name, &Config, &Bus) != FEE_EXIT_SUCCESS || pipe(Pipe) != 0)
+   {
+      printf("Error creating the named bus\n");
+      fee_shmbus_destroy(Bus);
+      return EXIT_FAILURE;
+   }
+
+   Child = fork();
+   if (Child == 0)
+   {
+      close(Pipe[0]);
+      _exit(child_reader(Name, Pipe[1]));
+   }
+   close(Pipe[1]);
+
+   if (Child < 0 || read(Pipe[0], &Ready, 1) != 1)
+   {
+      printf("Error starting the reader process\n");
+      Status = EXIT_FAILURE;
+   }
+
+   /*The child is slower than the writer, which retries while the ring is full*/
+   for (i = 0; i < NUM_CHILD_FRAMES && Status == EXIT_SUCCESS; i++)
+   {
+      while (publish_frame(Bus, &Frames[i % NUM_FRAMES]) != FEE_EXIT_SUCCESS)
+      {
+         usleep(50);
+      }
+   }
+
+   if (Child > 0 && (waitpid(Child, &ChildStatus, 0) != Child || !WIFEXITED(ChildStatus) || WEXITSTATUS(ChildStatus) != 0))
+   {
+      printf("Error: reader process failed\n");
+      Status = EXIT_FAILURE;
+   }
+
+   close(Pipe[0]);
+   fee_shmbus_destroy(Bus);
+
+   return Status;
+}
+
+int main(void)
+{
+   fee_shmbus_config_t Config = {0, PLANE_BYTES};
+   fee_shmbus_t *Bus = NULL;
+   int Status = EXIT_SUCCESS;
+   uint32_t i;
+
+   if (generate_frames() != EXIT_SUCCESS)
+   {
+      printf("Error generating the frames\n");
+      return EXIT_FAILURE;
+   }
+
+   if (fee_shmbus_create(NULL, &Config, &Bus) != FEE_EXIT_ERROR)
+   {
+      printf("Error: wrong configuration accepted\n");
+      Status = EXIT_FAILURE;
+   }
+
+   Status |= reclamation_test();
+   Status |= process_test();
+
+   for (i = 0; i < NUM_FRAMES; i++)
+   {
+      fee_gen_frame_free(&Frames[i]);
+   }
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Shared-Memory Frame Bus Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file stats_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Statistics Test. The test reads an example file which contains TM packets, checks and decodes them in the
+ *  main thread and in a second thread, corrupting some of them, and compares the statistics snapshot with the
+ *  expected counters. If the library is built without FEE_ENABLE_STATS, snapshots must be empty.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <fee.h>
+#include <fee_stats.h>
+
+#define MAX_TM_PACKETS 4096
+#define CORRUPTED_PACKET_PERIOD 7
+
+char str[TM_PACKET_BYTES * 10];
+fee_TM_Packet_t TM_Packets[MAX_TM_PACKETS];
+size_t NumPackets = 0;
+
+/*Check and decode every packet. Returns the number of corrupted packets*/
+size_t process_packets(void)
+{
+   fee_TM_Packet_t TM_Message;
+   fee_TM_t TM_Data_Struct;
+   size_t i, Corrupted = 0;
+
+   for (i = 0; i < NumPackets; i++)
+   {
+      memcpy(TM_Message, TM_Packets[i], TM_PACKET_BYTES);
+      if (i % CORRUPTED_PACKET_PERIOD == 0)
+      {
+         TM_Message[0] ^= 0x01;
+         Corrupted++;
+      }
+
+      if (fee_CheckTelemetryChecksum(TM_Message) == FEE_EXIT_SUCCESS)
+      {
+         fee_TM_Read(TM_Message, &TM_Data_Struct);
+      }
+   }
+
+   return Corrupted;
+}
+
+void *thread_main(void *Data)
+{
+   *(size_t *)Data = process_packets();
+   return NULL;
+}
+
+/*Consecutive buckets must cover every latency*/
+int check_buckets(void)
+{
+   uint64_t Lower, Upper, Expected = 0;
+   size_t Bucket;
+
+   for (Bucket = 0; Bucket < FEE_STATS_NUM_BUCKETS; Bucket++)
+   {
+      if (fee_stats_bucket_bounds(Bucket, &Lower, &Upper) != FEE_EXIT_SUCCESS || Lower != Expected || Upper < Lower)
+      {
+         printf("Error at bucket %zu\n", Bucket);
+         return 0;
+      }
+      Expected = Upper + 1;
+   }
+
+   return Expected == 0 && fee_stats_bucket_bounds(FEE_STATS_NUM_BUCKETS, &Lower, &Upper) == FEE_EXIT_ERROR;
+}
+
+int check_snapshot(size_t Corrupted, int *AreEqual)
+{
+   static fee_stats_snapshot_t Snapshot;
+   const fee_stats_op_snapshot_t *Checksum, *Read;
+   uint64_t HistogramCalls = 0, P99;
+   size_t Bucket;
+
+   fee_stats_snapshot(&Snapshot);
+
+   Checksum = &Snapshot.Ops[FEE_STATS_CHECK_TM_CHECKSUM];
+   Read = &Snapshot.Ops[FEE_STATS_TM_READ];
+
+   if (!Snapshot.Enabled)
+   {
+      if (Checksum->Calls != 0 || Read->Calls != 0)
+      {
+         printf("Error: statistics collected without FEE_ENABLE_STATS\n");
+         *AreEqual = 0;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   for (Bucket = 0; Bucket < FEE_STATS_NUM_BUCKETS; Bucket++)
+   {
+      HistogramCalls += Read->Histogram[Bucket];
+   }
+
+   if (Checksum->Calls != 2 * NumPackets ||
+       Checksum->Failures[FEE_STATS_FAIL_CHECKSUM] != Corrupted ||
+       Checksum->Bytes != (2 * NumPackets - Corrupted) * TM_PACKET_BYTES ||
+       Read->Calls != 2 * NumPackets - Corrupted ||
+       Read->Bytes != Read->Calls * TM_PACKET_BYTES ||
+       HistogramCalls != Read->Calls ||
+       fee_stats_percentile(Read, 0.99, &P99) != FEE_EXIT_SUCCESS ||
+       P99 > Read->MaxNs * 2 ||
+       Snapshot.Ops[FEE_STATS_PTD_READ].Calls != 0)
+   {
+      printf("Error: unexpected statistics. Checksum calls %llu failures %llu, TM_Read calls %llu\n",
+             (unsigned long long)Checksum->Calls, (unsigned long long)Checksum->Failures[FEE_STATS_FAIL_CHECKSUM],
+             (unsigned long long)Read->Calls);
+      *AreEqual = 0;
+   }
+
+   /*Reset*/
+   fee_stats_reset();
+   fee_stats_snapshot(&Snapshot);
+   if (Snapshot.Ops[FEE_STATS_CHECK_TM_CHECKSUM].Calls != 0 || Snapshot.Ops[FEE_STATS_TM_READ].Calls != 0)
+   {
+      printf("Error: statistics not reset\n");
+      *AreEqual = 0;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+int stats_test(FILE *fp, int *AreEqual)
+{
+   pthread_t Thread;
+   size_t CorruptedThread = 0, Corrupted;
+   char *tok;
+   int counter, byte_counter;
+
+   *AreEqual = check_buckets();
+
+   while (NumPackets < MAX_TM_PACKETS && fgets(str, TM_PACKET_BYTES * 10, fp))
+   {
+      byte_counter = 0;
+      for (tok = strtok(str, " "), counter = 0; tok != NULL; tok = strtok(NULL, " "), counter++)
+      {
+         if (tok[0] && strstr(tok, "\n") == NULL && counter > 1 && byte_counter < TM_PACKET_BYTES)
+         {
+            TM_Packets[NumPackets][byte_counter] = (uint8_t)atoi(tok);
+            byte_counter++;
+         }
+      }
+      NumPackets++;
+   }
+
+   if (NumPackets == 0)
+   {
+      printf("Error: no packets read\n");
+      return EXIT_FAILURE;
+   }
+
+   fee_stats_reset();
+
+   /*The counters of the finished thread must be kept*/
+   if (pthread_create(&Thread, NULL, thread_main, &CorruptedThread) != 0)
+   {
+      return EXIT_FAILURE;
+   }
+   Corrupted = process_packets();
+   pthread_join(Thread, NULL);
+
+   return check_snapshot(Corrupted + CorruptedThread, AreEqual);
+}
+
+int main(int argc, char *argv[])
+{
+   FILE *fp;
+   int AreEqual = 1;
+
+   if (argc != 2)
+   {
+      printf("Argument Error: The program should be executed as: %s TM_MessageFile \n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   /* opening file for reading */
+   fp = fopen(argv[1], "r");
+   if (fp == NULL)
+   {
+      perror("Error opening file");
+      return (EXIT_FAILURE);
+   }
+
+   // Run test
+   if (stats_test(fp, &AreEqual) != EXIT_SUCCESS)
+   {
+      fclose(fp);
+      return EXIT_FAILURE;
+   }
+
+   // Clean-up
+   fclose(fp);
+
+   if (AreEqual)
+   {
+      printf("Stats Test Success!\n");
+      return EXIT_SUCCESS;
+   }
+   else
+   {
+      printf("Stats Test Error!\n");
+      return EXIT_FAILURE;
+   }
+}
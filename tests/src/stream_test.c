@@ -0,0 +1,210 @@
+/**
+ * @file stream_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Stream Test. The test follows the counters of example TC and TM files, from the raw packets and from the
+ *  decoded ones, and checks that no packet is reported lost. Afterwards, sequences with wraparound, gaps,
+ *  duplicates and reorderings are checked against the expected events and totals.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_stream.h>
+
+char str[TM_PACKET_BYTES * 10];
+
+/*Read the next packet of a file. Returns the number of bytes read*/
+int read_packet(FILE *fp, uint8_t *Packet, int PacketBytes)
+{
+   char *tok;
+   int counter, byte_counter = 0;
+
+   if (fgets(str, TM_PACKET_BYTES * 10, fp) == NULL)
+   {
+      return 0;
+   }
+
+   for (tok = strtok(str, " "), counter = 0; tok != NULL; tok = strtok(NULL, " "), counter++)
+   {
+      if (tok[0] && strstr(tok, "\n") == NULL && counter > 1 && byte_counter < PacketBytes)
+      {
+         Packet[byte_counter] = (uint8_t)atoi(tok);
+         byte_counter++;
+      }
+   }
+
+   return byte_counter;
+}
+
+int capture_test(FILE *fTC, FILE *fTM, int *AreEqual)
+{
+   fee_stream_tracker_t Raw, Decoded;
+   fee_TC_Packet_t TC_Packet;
+   fee_TM_Packet_t TM_Packet;
+   fee_TC_t TC_Data_Struct;
+   fee_TM_t TM_Data_Struct;
+
+   fee_stream_tracker_init(&Raw);
+   fee_stream_tracker_init(&Decoded);
+
+   while (read_packet(fTC, TC_Packet, TC_PACKET_BYTES) == TC_PACKET_BYTES)
+   {
+      fee_TC_Read(TC_Packet, &TC_Data_Struct);
+      fee_stream_peek_TC(&Raw, TC_Packet);
+      fee_stream_update_TC(&Decoded, &TC_Data_Struct);
+   }
+
+   while (read_packet(fTM, TM_Packet, TM_PACKET_BYTES) == TM_PACKET_BYTES)
+   {
+      fee_TM_Read(TM_Packet, &TM_Data_Struct);
+      fee_stream_peek_TM(&Raw, TM_Packet);
+      fee_stream_update_TM(&Decoded, &TM_Data_Struct);
+   }
+
+   if (memcmp(&Raw, &Decoded, sizeof(fee_stream_tracker_t)) != 0)
+   {
+      printf("Error: raw and decoded trackers differ\n");
+      *AreEqual = 0;
+   }
+
+   if (Raw.TM.Received == 0 || Raw.TC.Received == 0)
+   {
+      printf("Error: no packets read\n");
+      return EXIT_FAILURE;
+   }
+
+   if (Raw.TM.Lost != 0 || Raw.TM.Duplicates != 0 || Raw.TM.Expected != Raw.TM.Received ||
+       Raw.TC.Lost != 0 || Raw.TC.Duplicates != 0 ||
+       Raw.TC_Echo.Lost != 0 || Raw.TC_Echo.Duplicates != 0)
+   {
+      printf("Error: unexpected losses in the capture\n");
+      *AreEqual = 0;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+/*Feed a sequence and compare the events*/
+void check_sequence(fee_stream_counter_t *Counter, const uint32_t *Values, const fee_stream_event_t *Events,
+                    size_t Num, int *AreEqual)
+{
+   size_t i;
+   fee_stream_event_t Event;
+
+   for (i = 0; i < Num; i++)
+   {
+      Event = fee_stream_counter_update(Counter, Values[i], NULL);
+      if (Event != Events[i])
+      {
+         printf("Error at value %u: event %d, expected %d\n", Values[i], (int)Event, (int)Events[i]);
+         *AreEqual = 0;
+      }
+   }
+}
+
+void sequence_test(int *AreEqual)
+{
+   fee_stream_counter_t Counter;
+   uint32_t Missing;
+   const uint32_t Values16[] = {65533, 65534, 65535, 0, 3, 1, 1, 2, 4, 104, 30, 6000};
+   const fee_stream_event_t Events16[] = {FEE_STREAM_IN_ORDER, FEE_STREAM_IN_ORDER, FEE_STREAM_IN_ORDER,
+                                          FEE_STREAM_IN_ORDER, FEE_STREAM_GAP, FEE_STREAM_REORDERED,
+                                          FEE_STREAM_DUPLICATE, FEE_STREAM_REORDERED, FEE_STREAM_IN_ORDER,
+                                          FEE_STREAM_GAP, FEE_STREAM_LATE, FEE_STREAM_RESYNC};
+   const uint32_t Values32[] = {0xFFFFFFFEu, 0xFFFFFFFFu, 0, 1, 1};
+   const fee_stream_event_t Events32[] = {FEE_STREAM_IN_ORDER, FEE_STREAM_IN_ORDER, FEE_STREAM_IN_ORDER,
+                                          FEE_STREAM_IN_ORDER, FEE_STREAM_REPEAT};
+
+   /*16 bits counter*/
+   fee_stream_counter_init(&Counter, FEE_STREAM_TC_COUNTER_BITS, FEE_STREAM_DEFAULT_RESYNC_GAP, 0);
+   check_sequence(&Counter, Values16, Events16, sizeof(Values16) / sizeof(Values16[0]), AreEqual);
+
+   /*65533..104 (108 counters) and the restart at 6000 are expected. 5..103 are lost*/
+   if (Counter.Received != 12 || Counter.Expected != 109 || Counter.Lost != 99 || Counter.Gaps != 2 ||
+       Counter.Duplicates != 1 || Counter.Reordered != 2 || Counter.Late != 1 || Counter.Resyncs != 1 ||
+       fee_stream_counter_loss_rate(&Counter) != 99.0 / 109.0)
+   {
+      printf("Error: unexpected 16 bits totals\n");
+      *AreEqual = 0;
+   }
+
+   if (fee_stream_counter_update(&Counter, 6003, &Missing) != FEE_STREAM_GAP || Missing != 2)
+   {
+      printf("Error: unexpected number of missing counters\n");
+      *AreEqual = 0;
+   }
+
+   /*32 bits counter with repeats*/
+   fee_stream_counter_init(&Counter, FEE_STREAM_TM_COUNTER_BITS, 0, 1);
+   check_sequence(&Counter, Values32, Events32, sizeof(Values32) / sizeof(Values32[0]), AreEqual);
+   if (Counter.Lost != 0 || Counter.Expected != 4 || Counter.Repeats != 1)
+   {
+      printf("Error: unexpected 32 bits totals\n");
+      *AreEqual = 0;
+   }
+
+   /*Invalid configurations*/
+   if (fee_stream_counter_init(&Counter, 0, 0, 0) != FEE_EXIT_ERROR ||
+       fee_stream_counter_init(&Counter, 16, 40000, 0) != FEE_EXIT_ERROR)
+   {
+      printf("Error: invalid configuration accepted\n");
+      *AreEqual = 0;
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   FILE *fTC, *fTM;
+   int AreEqual = 1;
+
+   if (argc != 3)
+   {
+      printf("Argument Error: The program should be executed as: %s TC_MessageFile TM_MessageFile \n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   /* opening files for reading */
+   fTC = fopen(argv[1], "r");
+   if (fTC == NULL)
+   {
+      perror("Error opening file");
+      return EXIT_FAILURE;
+   }
+
+   fTM = fopen(argv[2], "r");
+   if (fTM == NULL)
+   {
+      fclose(fTC);
+      perror("Error opening file");
+      return EXIT_FAILURE;
+   }
+
+   // Run test
+   if (capture_test(fTC, fTM, &AreEqual) != EXIT_SUCCESS)
+   {
+      fclose(fTC);
+      fclose(fTM);
+      return EXIT_FAILURE;
+   }
+   sequence_test(&AreEqual);
+
+   // Clean-up
+   fclose(fTC);
+   fclose(fTM);
+
+   if (AreEqual)
+   {
+      printf("Stream Test Success!\n");
+      return EXIT_SUCCESS;
+   }
+   else
+   {
+      printf("Stream Test Error!\n");
+      return EXIT_FAILURE;
+   }
+}
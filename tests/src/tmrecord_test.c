@@ -0,0 +1,259 @@
+/**
+ * @file tmrecord_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Packed TM Record Test. Every TM packet of a capture is packed and unpacked: the packet bytes must come back
+ *  exactly (with a valid checksum), the unpacked fee_TM_t must be the one fee_TM_Read gives, and packing it again
+ *  must give the same counter, words and configuration. Packets that repeat a configuration echo must share its id,
+ *  and unknown ids must be rejected. Interning the configurations must not be counted as TM reads by the statistics.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_capture.h>
+#include <fee_tmrecord.h>
+#include <fee_stats.h>
+
+#define MAX_PACKETS 100000
+#define NUM_CONFIGS 4
+
+fee_TM_Packet_t Packets[MAX_PACKETS];
+fee_tm_record_t Records[MAX_PACKETS];
+fee_stats_snapshot_t Snapshot;
+
+/*XOR of the 16-bit words of the packet before the checksum, in host order*/
+uint16_t checksum(const uint8_t *Packet)
+{
+   uint16_t Checksum = 0, Word;
+   int i;
+
+   for (i = 0; i < TM_OFFSET_CHECKSUM; i += 2)
+   {
+      memcpy(&Word, Packet + i, sizeof(uint16_t));
+      Checksum ^= Word;
+   }
+
+   return Checksum;
+}
+
+int same_tc(const fee_TC_t *A, const fee_TC_t *B)
+{
+   fee_TM_Packet_t PacketA, PacketB;
+   fee_TM_t TMA, TMB;
+
+   memset(&TMA, 0, sizeof(TMA));
+   memset(&TMB, 0, sizeof(TMB));
+   TMA.Returned_TC = *A;
+   TMB.Returned_TC = *B;
+   fee_TM_Write(TMA, PacketA);
+   fee_TM_Write(TMB, PacketB);
+
+   return memcmp(PacketA, PacketB, TM_PACKET_BYTES) == 0;
+}
+
+int same_tm(const fee_TM_t *A, const fee_TM_t *B)
+{
+   return A->TM_COUNTER == B->TM_COUNTER && same_tc(&A->Returned_TC, &B->Returned_TC) &&
+          A->CCDTEMP_MEAS1 == B->CCDTEMP_MEAS1 && A->CCDTEMP_MEAS2 == B->CCDTEMP_MEAS2 &&
+          A->VAUTEMP_MEAS == B->VAUTEMP_MEAS && A->FPPETEMP_MEAS == B->FPPETEMP_MEAS &&
+          A->VODE_MEAS == B->VODE_MEAS && A->VODF_MEAS == B->VODF_MEAS && A->VODG_MEAS == B->VODG_MEAS &&
+          A->VODH_MEAS == B->VODH_MEAS && A->VRD_MEAS == B->VRD_MEAS && A->VDD_MEAS == B->VDD_MEAS &&
+          A->VOG_MEAS == B->VOG_MEAS && A->IPHIH_MEAS == B->IPHIH_MEAS && A->SPHIH_MEAS == B->SPHIH_MEAS &&
+          A->RPHIH_MEAS == B->RPHIH_MEAS && A->PHIRH_MEAS == B->PHIRH_MEAS && A->VDGH_MEAS == B->VDGH_MEAS &&
+          A->VANAP_MEAS == B->VANAP_MEAS && A->VANAN_MEAS == B->VANAN_MEAS && A->VDET_MEAS == B->VDET_MEAS &&
+          A->VDRV_MEAS == B->VDRV_MEAS && A->VDIG_MEAS == B->VDIG_MEAS && A->IDIG_MEAS == B->IDIG_MEAS &&
+          A->TC_ERROR == B->TC_ERROR && A->VAU_ERROR == B->VAU_ERROR;
+}
+
+size_t load_packets(const char *Path)
+{
+   fee_capture_t *Capture = NULL;
+   fee_capture_iter_t Iter;
+   fee_capture_packet_t Packet;
+   size_t NumPackets = 0;
+
+   if (fee_capture_open(Path, &Capture) != FEE_EXIT_SUCCESS)
+   {
+      return 0;
+   }
+   fee_capture_iter_init(Capture, 0, UINT64_MAX, &Iter);
+   while (NumPackets < MAX_PACKETS && fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+   {
+      if (Packet.Type == FEE_CAPTURE_TM && Packet.NumBytes == TM_PACKET_BYTES)
+      {
+         memcpy(Packets[NumPackets++], Packet.Bytes, TM_PACKET_BYTES);
+      }
+   }
+   fee_capture_iter_free(&Iter);
+   fee_capture_close(Capture);
+
+   return NumPackets;
+}
+
+/*Packets with the configuration echo of one of the first NUM_CONFIGS packets must share its id*/
+int shared_test(size_t NumPackets)
+{
+   fee_tm_config_table_t *Table = NULL;
+   fee_TM_Packet_t Packet;
+   fee_tm_record_t Record;
+   uint32_t ConfigIds[NUM_CONFIGS];
+   size_t i;
+   int Status = EXIT_SUCCESS;
+
+   if (NumPackets < NUM_CONFIGS || fee_tm_config_table_create(&Table) != FEE_EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < NumPackets && Status == EXIT_SUCCESS; i++)
+   {
+      memcpy(Packet, Packets[i], TM_PACKET_BYTES);
+      memcpy(Packet + TM_OFFSET_TC_COUNTER, Packets[i % NUM_CONFIGS] + TM_OFFSET_TC_COUNTER,
+             TM_OFFSET_CCDTEMP_MEAS1 - TM_OFFSET_TC_COUNTER);
+      memcpy(Packet + TM_OFFSET_ACQSTARTDELAY, Packets[i % NUM_CONFIGS] + TM_OFFSET_ACQSTARTDELAY,
+             TM_OFFSET_CHECKSUM - TM_OFFSET_ACQSTARTDELAY);
+      if (fee_tm_record_from_packet(Table, Packet, &Record) != FEE_EXIT_SUCCESS ||
+          (i >= NUM_CONFIGS && Record.ConfigId != ConfigIds[i % NUM_CONFIGS]) ||
+          fee_tm_record_to_packet(Table, &Record, Packets[i]) != FEE_EXIT_SUCCESS ||
+          memcmp(Packet, Packets[i], TM_OFFSET_CHECKSUM) != 0)
+      {
+         printf("Error: packet %zu does not share the configuration of packet %zu\n", i, i % NUM_CONFIGS);
+         Status = EXIT_FAILURE;
+      }
+      if (i < NUM_CONFIGS)
+      {
+         ConfigIds[i] = Record.ConfigId;
+      }
+   }
+   if (Status == EXIT_SUCCESS && fee_tm_config_table_size(Table) != (size_t)ConfigIds[NUM_CONFIGS - 1] + 1)
+   {
+      printf("Error: %zu shared configurations instead of %u\n", fee_tm_config_table_size(Table),
+             ConfigIds[NUM_CONFIGS - 1] + 1);
+      Status = EXIT_FAILURE;
+   }
+
+   fee_tm_config_table_destroy(Table);
+   return Status;
+}
+
+int main(int argc, char *argv[])
+{
+   fee_tm_config_table_t *Table = NULL;
+   fee_TM_Packet_t Packet;
+   fee_TM_t TM, Unpacked;
+   fee_tm_record_t Record;
+   fee_TC_t TC;
+   uint16_t Checksum;
+   size_t NumPackets, NumValid = 0, i;
+   int Status = EXIT_SUCCESS;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <TM capture>\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   NumPackets = load_packets(argv[1]);
+   if (NumPackets == 0)
+   {
+      printf("Error reading TM packets from %s\n", argv[1]);
+      return EXIT_FAILURE;
+   }
+
+   fee_stats_reset();
+   if (fee_tm_config_table_create(&Table) != FEE_EXIT_SUCCESS ||
+       fee_tm_record_from_packets(Table, (const fee_TM_Packet_t *)Packets, NumPackets, Records) != FEE_EXIT_SUCCESS)
+   {
+      printf("Error packing the capture\n");
+      fee_tm_config_table_destroy(Table);
+      return EXIT_FAILURE;
+   }
+
+   /*The echoes are decoded by the library, not read by the caller*/
+   fee_stats_snapshot(&Snapshot);
+   if (Snapshot.Ops[FEE_STATS_TM_READ].Calls != 0)
+   {
+      printf("Error: %llu TM reads counted while packing\n", (unsigned long long)Snapshot.Ops[FEE_STATS_TM_READ].Calls);
+      Status = EXIT_FAILURE;
+   }
+
+   for (i = 0; i < NumPackets && Status == EXIT_SUCCESS; i++)
+   {
+      /*Exact bytes, with a valid checksum*/
+      if (fee_tm_record_to_packet(Table, &Records[i], Packet) != FEE_EXIT_SUCCESS ||
+          memcmp(Packet, Packets[i], TM_OFFSET_CHECKSUM) != 0)
+      {
+         printf("Error: packet %zu is not unpacked to its bytes\n", i);
+         Status = EXIT_FAILURE;
+         break;
+      }
+      memcpy(&Checksum, Packet + TM_OFFSET_CHECKSUM, sizeof(uint16_t));
+      if (Checksum != checksum(Packet))
+      {
+         printf("Error: packet %zu is unpacked with a wrong checksum\n", i);
+         Status = EXIT_FAILURE;
+      }
+      if (memcmp(Packet, Packets[i], TM_PACKET_BYTES) == 0)
+      {
+         NumValid++;
+      }
+
+      /*Same decoded packet as fee_TM_Read, and the same record when it is packed again*/
+      fee_TM_Read(Packets[i], &TM);
+      if (fee_tm_record_to_tm(Table, &Records[i], &Unpacked) != FEE_EXIT_SUCCESS || !same_tm(&TM, &Unpacked) ||
+          fee_tm_config_get(Table, Records[i].ConfigId, &TC) != FEE_EXIT_SUCCESS || !same_tc(&TC, &TM.Returned_TC))
+      {
+         printf("Error: packet %zu is not unpacked to its fee_TM_t\n", i);
+         Status = EXIT_FAILURE;
+      }
+      if (Status == EXIT_SUCCESS &&
+          (fee_tm_record_from_tm(Table, &TM, &Record) != FEE_EXIT_SUCCESS || Record.TM_COUNTER != TM.TM_COUNTER ||
+           memcmp(Record.Words, Records[i].Words, sizeof(Record.Words)) != 0 ||
+           fee_tm_config_get(Table, Record.ConfigId, &TC) != FEE_EXIT_SUCCESS || !same_tc(&TC, &TM.Returned_TC)))
+      {
+         printf("Error: fee_TM_t of packet %zu is not packed to its record\n", i);
+         Status = EXIT_FAILURE;
+      }
+   }
+
+   if (Status == EXIT_SUCCESS && (fee_tm_config_table_size(Table) == 0 || fee_tm_config_table_size(Table) > NumPackets))
+   {
+      printf("Error: %zu configurations for %zu packets\n", fee_tm_config_table_size(Table), NumPackets);
+      Status = EXIT_FAILURE;
+   }
+   if (Status == EXIT_SUCCESS)
+   {
+      Status = shared_test(NumPackets);
+   }
+
+   Record = Records[0];
+   Record.ConfigId = (uint32_t)fee_tm_config_table_size(Table);
+   if (Status == EXIT_SUCCESS && (fee_tm_record_to_packet(Table, &Record, Packet) == FEE_EXIT_SUCCESS ||
+                                  fee_tm_record_to_tm(Table, &Record, &Unpacked) == FEE_EXIT_SUCCESS ||
+                                  fee_tm_config_get(Table, Record.ConfigId, &TC) == FEE_EXIT_SUCCESS))
+   {
+      printf("Error: unknown configuration accepted\n");
+      Status = EXIT_FAILURE;
+   }
+
+   if (Status == EXIT_SUCCESS)
+   {
+      printf("%zu TM packets (%zu with a valid checksum), %zu configurations, %zu bytes per record instead of %d\n",
+             NumPackets, NumValid, fee_tm_config_table_size(Table), sizeof(fee_tm_record_t), TM_PACKET_BYTES);
+   }
+   fee_tm_config_table_destroy(Table);
+
+   if (Status != EXIT_SUCCESS)
+   {
+      return EXIT_FAILURE;
+   }
+
+   printf("Packed TM Record Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
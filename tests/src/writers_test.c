@@ -0,0 +1,145 @@
+/**
+ * @file writers_test.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief  Packet Writers Test. fee_TC_Write and fee_TM_Write are compared byte for byte with a reference writer (a
+ *  zeroed packet, every field stored at its offset and the checksum calculated over the whole packet) for random
+ *  structures whose fields take every bit pattern. The output packets are poisoned before writing, so that spare
+ *  bytes that are not zeroed are detected, and the written packets must pass the checksum checks. As the reference
+ *  writer shares the field lists and offsets with the writers, every written packet is also read back with fee_TC_Read
+ *  and fee_TM_Read, which do not use them, and must give the written structure.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fee.h>
+#include <fee_fields.h>
+
+#define NUM_PACKETS 20000
+#define POISON 0xA5
+
+uint32_t xorshift32(uint32_t *State)
+{
+   *State ^= *State << 13;
+   *State ^= *State >> 17;
+   *State ^= *State << 5;
+   return *State;
+}
+
+void store(uint8_t *Packet, size_t Offset, uint32_t Value, int Bits)
+{
+   int i;
+
+   for (i = 0; i < Bits / 8; i++)
+   {
+      Packet[Offset + i] = (uint8_t)(Value >> (Bits - 8 * (i + 1)));
+   }
+}
+
+void reference_tc(const fee_TC_t *TC, uint8_t *Packet)
+{
+   int i;
+
+   memset(Packet, 0, TC_PACKET_BYTES);
+#define STORE_TC(Name, Bits) store(Packet, TC_OFFSET_##Name, (uint32_t)TC->Name, Bits);
+   FEE_TC_FIELDS(STORE_TC)
+#undef STORE_TC
+   for (i = 0; i < TC_OFFSET_CHECKSUM; i++)
+   {
+      Packet[TC_OFFSET_CHECKSUM] ^= Packet[i];
+   }
+}
+
+void reference_tm(const fee_TM_t *TM, uint8_t *Packet)
+{
+   uint16_t Checksum = 0, Word;
+   int i;
+
+   memset(Packet, 0, TM_PACKET_BYTES);
+   store(Packet, TM_OFFSET_TM_COUNTER, TM->TM_COUNTER, 32);
+#define STORE_TM_TC(Name, Bits) store(Packet, TM_OFFSET_##Name, (uint32_t)TM->Returned_TC.Name, Bits);
+   FEE_TC_FIELDS(STORE_TM_TC)
+#undef STORE_TM_TC
+#define STORE_TM(Name, Bits) store(Packet, TM_OFFSET_##Name, (uint32_t)TM->Name, Bits);
+   FEE_TM_MEAS_FIELDS(STORE_TM)
+#undef STORE_TM
+   for (i = 0; i < TM_OFFSET_CHECKSUM; i += 2)
+   {
+      memcpy(&Word, Packet + i, sizeof(uint16_t));
+      Checksum ^= Word;
+   }
+   memcpy(Packet + TM_OFFSET_CHECKSUM, &Checksum, sizeof(uint16_t));
+}
+
+/*Every field takes a random value of its packet width. Enum fields take any 16 bits value*/
+void random_tc(fee_TC_t *TC, uint32_t *State)
+{
+   memset(TC, 0, sizeof(fee_TC_t));
+#define RANDOM_FIELD(Name, Bits) TC->Name = (uint##Bits##_t)xorshift32(State);
+   FEE_TC_FIELDS(RANDOM_FIELD)
+#undef RANDOM_FIELD
+}
+
+void random_tm(fee_TM_t *TM, uint32_t *State)
+{
+   memset(TM, 0, sizeof(fee_TM_t));
+   TM->TM_COUNTER = xorshift32(State);
+   random_tc(&TM->Returned_TC, State);
+#define RANDOM_MEAS(Name, Bits) TM->Name = (uint##Bits##_t)xorshift32(State);
+   FEE_TM_MEAS_FIELDS(RANDOM_MEAS)
+#undef RANDOM_MEAS
+}
+
+int main(void)
+{
+   fee_TC_t TC, TCRead;
+   fee_TM_t TM, TMRead;
+   fee_TC_Packet_t TCPacket, TCReference;
+   fee_TM_Packet_t TMPacket, TMReference;
+   uint32_t State = 2026;
+   int i;
+
+   for (i = 0; i < NUM_PACKETS; i++)
+   {
+      random_tc(&TC, &State);
+      reference_tc(&TC, TCReference);
+      memset(TCPacket, POISON, sizeof(TCPacket));
+      if (fee_TC_Write(TC, TCPacket) != FEE_EXIT_SUCCESS || memcmp(TCPacket, TCReference, TC_PACKET_BYTES) != 0 ||
+          fee_CheckTeleCommandChecksum(TCPacket) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: TC packet %d does not match the reference\n", i);
+         return EXIT_FAILURE;
+      }
+      memset(&TCRead, 0, sizeof(fee_TC_t));
+      if (fee_TC_Read(TCPacket, &TCRead) != FEE_EXIT_SUCCESS || memcmp(&TC, &TCRead, sizeof(fee_TC_t)) != 0)
+      {
+         printf("Error: TC packet %d is not read back as written\n", i);
+         return EXIT_FAILURE;
+      }
+
+      random_tm(&TM, &State);
+      reference_tm(&TM, TMReference);
+      memset(TMPacket, POISON, sizeof(TMPacket));
+      if (fee_TM_Write(TM, TMPacket) != FEE_EXIT_SUCCESS || memcmp(TMPacket, TMReference, TM_PACKET_BYTES) != 0 ||
+          fee_CheckTelemetryChecksum(TMPacket) != FEE_EXIT_SUCCESS)
+      {
+         printf("Error: TM packet %d does not match the reference\n", i);
+         return EXIT_FAILURE;
+      }
+      memset(&TMRead, 0, sizeof(fee_TM_t));
+      if (fee_TM_Read(TMPacket, &TMRead) != FEE_EXIT_SUCCESS || memcmp(&TM, &TMRead, sizeof(fee_TM_t)) != 0)
+      {
+         printf("Error: TM packet %d is not read back as written\n", i);
+         return EXIT_FAILURE;
+      }
+   }
+
+   printf("%d TC and TM packets written\n", NUM_PACKETS);
+   printf("Packet Writers Test Success!\n");
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file fee_capindex.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Command line capture indexer. It builds (or reuses) the timestamp index of an "_Analysis.txt" capture and
+ *  summarizes the packets of a timestamp range, seeking through the index instead of reading the whole capture.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fee_capture.h>
+
+typedef struct
+{
+    const char *Capture;
+    const char *Index;
+    unsigned long Stride;
+    int Rebuild;
+    uint64_t First;
+    uint64_t Last;
+
+} CapindexOptions_t;
+
+static void Usage(const char *Program)
+{
+    printf("Usage: %s [options] CAPTURE\n"
+           "  --index FILE          Index file (default CAPTURE" FEE_CAPTURE_INDEX_EXTENSION ")\n"
+           "  --stride N            Packets between index entries of a new index (default %d)\n"
+           "  --rebuild             Rebuild the index even if it is up to date\n"
+           "  --from MS             First timestamp of the summarized range\n"
+           "  --to MS               Last timestamp of the summarized range\n",
+           Program, FEE_CAPTURE_DEFAULT_STRIDE);
+}
+
+static int Summarize(const CapindexOptions_t *Options, const fee_capture_t *Capture, const fee_capture_index_t *Index)
+{
+    static const char *TypeNames[] = {"TC", "TM", "PTD", "unknown"};
+    fee_capture_iter_t Iter;
+    fee_capture_packet_t Packet;
+    uint64_t Counts[FEE_CAPTURE_UNKNOWN + 1] = {0};
+    uint64_t NumEntries, NumPackets, PTDBytes = 0, FirstFound = 0, LastFound = 0, Total = 0;
+    uint32_t Stride;
+    int Type;
+
+    fee_capture_index_entries(Index, &NumEntries, &Stride, &NumPackets);
+    printf("%s: %llu packets, %llu index entries every %u packets\n", Options->Capture, (unsigned long long)NumPackets,
+           (unsigned long long)NumEntries, Stride);
+
+    fee_capture_index_range(Index, Capture, Options->First, Options->Last, &Iter);
+    while (fee_capture_next(&Iter, &Packet) == FEE_EXIT_SUCCESS)
+    {
+        if (Total++ == 0)
+        {
+            FirstFound = Packet.Timestamp;
+        }
+        LastFound = Packet.Timestamp;
+        Counts[Packet.Type]++;
+        if (Packet.Type == FEE_CAPTURE_PTD)
+        {
+            PTDBytes += Packet.PTDBytes;
+        }
+    }
+    fee_capture_iter_free(&Iter);
+
+    printf("Range [%llu, %llu]: %llu packets", (unsigned long long)FirstFound, (unsigned long long)LastFound,
+           (unsigned long long)Total);
+    for (Type = 0; Type <= FEE_CAPTURE_UNKNOWN; Type++)
+    {
+        printf(", %llu %s", (unsigned long long)Counts[Type], TypeNames[Type]);
+    }
+    printf(" (%llu PTD bytes)\n", (unsigned long long)PTDBytes);
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    CapindexOptions_t Options = {NULL, NULL, 0, 0, 0, UINT64_MAX};
+    fee_capture_t *Capture = NULL;
+    fee_capture_index_t *Index = NULL;
+    int Status = EXIT_FAILURE;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        const char *Value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--rebuild") == 0)
+        {
+            Options.Rebuild = 1;
+            continue;
+        }
+        if (strncmp(argv[i], "--", 2) != 0 && Options.Capture == NULL)
+        {
+            Options.Capture = argv[i];
+            continue;
+        }
+        if (Value == NULL)
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        i++;
+
+        if (strcmp(argv[i - 1], "--index") == 0)
+        {
+            Options.Index = Value;
+        }
+        else if (strcmp(argv[i - 1], "--stride") == 0)
+        {
+            Options.Stride = strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--from") == 0)
+        {
+            Options.First = strtoull(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--to") == 0)
+        {
+            Options.Last = strtoull(Value, NULL, 10);
+        }
+        else
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (Options.Capture == NULL || Options.Stride > UINT32_MAX)
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (fee_capture_open(Options.Capture, &Capture) != FEE_EXIT_SUCCESS)
+    {
+        fprintf(stderr, "Error opening %s\n", Options.Capture);
+        return EXIT_FAILURE;
+    }
+
+    if (Options.Rebuild && fee_capture_index_build(Capture, Options.Index, (uint32_t)Options.Stride) != FEE_EXIT_SUCCESS)
+    {
+        fprintf(stderr, "Error writing the index of %s\n", Options.Capture);
+    }
+    else if (fee_capture_index_open(Capture, Options.Index, (uint32_t)Options.Stride, &Index) != FEE_EXIT_SUCCESS)
+    {
+        fprintf(stderr, "Error indexing %s\n", Options.Capture);
+    }
+    else
+    {
+        Status = Summarize(&Options, Capture, Index);
+    }
+
+    fee_capture_index_close(Index);
+    fee_capture_close(Capture);
+
+    return Status;
+}
@@ -0,0 +1,345 @@
+/**
+ * @file fee_ptdgen.c
+ * @author David Rodríguez Muñoz. (david.rodriguez@iac.es)
+ * @brief Command line synthetic capture generator. It writes TC, TM and PTD "_Analysis.txt" files for a given geometry
+ *  and pixel pattern, or the PTD file matching the operational TM packets of an existing TM capture.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Instuto de Astrofísica de Canarias (IAC)
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fee_generator.h>
+
+#define TM_LINE_CHARS (TM_PACKET_BYTES * 10)
+#define FIRST_TIMESTAMP 1647259994121ULL /*Timestamp (ms) of the first generated frame*/
+#define FRAME_PERIOD_MS 160              /*Time between generated frames*/
+
+typedef struct
+{
+    const char *TC_File;
+    const char *TM_File;
+    const char *PTD_File;
+    const char *TM_Input;
+    unsigned long NumFrames;
+
+} PtdgenOptions_t;
+
+static void Usage(const char *Program)
+{
+    printf("Usage: %s [options]\n"
+           "  --tc-out FILE         Write the TC capture\n"
+           "  --tm-out FILE         Write the TM capture\n"
+           "  --ptd-out FILE        Write the PTD capture\n"
+           "  --tm-input FILE       Generate the PTD of the operational packets of a TM capture\n"
+           "  --frames N            Number of frames (default 1)\n"
+           "  --max                 Largest geometry allowed by the TC limits\n"
+           "  --woisize N           Rows of the window of interest\n"
+           "  --nbtail N            Over-scan rows\n"
+           "  --sbm N               Spatial binning mode (0 or 1)\n"
+           "  --band B:BINNING:SIZE Band B (1-5) binning and size in pixels. Size 0 disables the band\n"
+           "  --pattern NAME        ramp, noise, synthetic1, synthetic2 or constant\n"
+           "  --value N             Ramp step or constant value\n"
+           "  --seed N              Seed of the noise pattern\n"
+           "  --counter N           Counters of the first frame\n",
+           Program);
+}
+
+static int ParsePattern(const char *Name, fee_gen_pattern_t *Pattern)
+{
+    static const struct
+    {
+        const char *Name;
+        fee_gen_pattern_t Pattern;
+    } Patterns[] = {{"ramp", FEE_GEN_PATTERN_RAMP},
+                    {"noise", FEE_GEN_PATTERN_NOISE},
+                    {"synthetic1", FEE_GEN_PATTERN_SYNTHETIC_1},
+                    {"synthetic2", FEE_GEN_PATTERN_SYNTHETIC_2},
+                    {"constant", FEE_GEN_PATTERN_CONSTANT}};
+    size_t i;
+
+    for (i = 0; i < sizeof(Patterns) / sizeof(Patterns[0]); i++)
+    {
+        if (strcmp(Name, Patterns[i].Name) == 0)
+        {
+            *Pattern = Patterns[i].Pattern;
+            return FEE_EXIT_SUCCESS;
+        }
+    }
+
+    return FEE_EXIT_ERROR;
+}
+
+static FILE *OpenOutput(const char *FileName)
+{
+    FILE *fp = NULL;
+
+    if (FileName != NULL)
+    {
+        fp = fopen(FileName, "w");
+        if (fp == NULL)
+        {
+            perror(FileName);
+        }
+    }
+
+    return fp;
+}
+
+/*Generate frames from the configured geometry*/
+static int GenerateFrames(const fee_gen_config_t *Config, const PtdgenOptions_t *Options)
+{
+    fee_gen_frame_t Frame;
+    FILE *fTC, *fTM, *fPTD;
+    unsigned long FrameIt;
+    uint64_t Timestamp;
+    int Status = FEE_EXIT_SUCCESS;
+
+    memset(&Frame, 0, sizeof(Frame));
+
+    fTC = OpenOutput(Options->TC_File);
+    fTM = OpenOutput(Options->TM_File);
+    fPTD = OpenOutput(Options->PTD_File);
+
+    if ((Options->TC_File != NULL && fTC == NULL) || (Options->TM_File != NULL && fTM == NULL) ||
+        (Options->PTD_File != NULL && fPTD == NULL))
+    {
+        Status = FEE_EXIT_ERROR;
+    }
+
+    for (FrameIt = 0; FrameIt < Options->NumFrames && Status == FEE_EXIT_SUCCESS; FrameIt++)
+    {
+        Timestamp = FIRST_TIMESTAMP + FrameIt * FRAME_PERIOD_MS;
+
+        if (fee_gen_frame(Config, (uint32_t)FrameIt, &Frame) != FEE_EXIT_SUCCESS)
+        {
+            fprintf(stderr, "Error generating frame %lu. Check the geometry against the TC limits\n", FrameIt);
+            Status = FEE_EXIT_ERROR;
+            break;
+        }
+
+        if (fTC != NULL)
+        {
+            Status |= fee_gen_fprint_packet(fTC, Timestamp, Frame.TC_Packet, TC_PACKET_BYTES, 0);
+        }
+        if (fTM != NULL)
+        {
+            Status |= fee_gen_fprint_packet(fTM, Timestamp, Frame.TM_Packet, TM_PACKET_BYTES, 0);
+        }
+        if (fPTD != NULL)
+        {
+            Status |= fee_gen_fprint_packet(fPTD, Timestamp, Frame.PTD_Packet, Frame.PTD.PTDSizes.DataPacketTotalBytes, 1);
+        }
+    }
+
+    if (Status == FEE_EXIT_SUCCESS)
+    {
+        printf("%lu frames of %zu PTD bytes generated\n", Options->NumFrames, Frame.PTD.PTDSizes.DataPacketTotalBytes);
+    }
+
+    fee_gen_frame_free(&Frame);
+    if (fTC != NULL)
+    {
+        fclose(fTC);
+    }
+    if (fTM != NULL)
+    {
+        fclose(fTM);
+    }
+    if (fPTD != NULL)
+    {
+        fclose(fPTD);
+    }
+
+    return Status;
+}
+
+/*Generate the PTD packets of the operational TM packets of a capture. PTD lines use the timestamp of their TM*/
+static int GenerateFromCapture(const fee_gen_config_t *Config, const PtdgenOptions_t *Options)
+{
+    char str[TM_LINE_CHARS];
+    fee_TM_Packet_t TM_Packet;
+    fee_TM_t TM_Data_Struct;
+    fee_PTDSizes_t PTDSizes;
+    fee_ImageMatrixTotalSizes_t ImageSizes;
+    fee_gen_frame_t Frame;
+    FILE *fIn, *fPTD;
+    char *tok;
+    int counter, byte_counter, Status = FEE_EXIT_SUCCESS;
+    unsigned long NumFrames = 0;
+    uint64_t Timestamp;
+
+    if (Options->PTD_File == NULL)
+    {
+        fprintf(stderr, "--tm-input requires --ptd-out\n");
+        return FEE_EXIT_ERROR;
+    }
+
+    fIn = fopen(Options->TM_Input, "r");
+    if (fIn == NULL)
+    {
+        perror(Options->TM_Input);
+        return FEE_EXIT_ERROR;
+    }
+
+    fPTD = OpenOutput(Options->PTD_File);
+    if (fPTD == NULL)
+    {
+        fclose(fIn);
+        return FEE_EXIT_ERROR;
+    }
+
+    memset(&Frame, 0, sizeof(Frame));
+
+    while (NumFrames < Options->NumFrames && Status == FEE_EXIT_SUCCESS && fgets(str, TM_LINE_CHARS, fIn))
+    {
+        Timestamp = 0;
+        byte_counter = 0;
+        for (tok = strtok(str, " "), counter = 0; tok != NULL; tok = strtok(NULL, " "), counter++)
+        {
+            if (tok[0] && strstr(tok, "\n") == NULL && counter == 0)
+            {
+                Timestamp = strtoull(tok, NULL, 10);
+            }
+            else if (tok[0] && strstr(tok, "\n") == NULL && counter > 1 && byte_counter < TM_PACKET_BYTES)
+            {
+                TM_Packet[byte_counter] = (uint8_t)atoi(tok);
+                byte_counter++;
+            }
+        }
+
+        /*Only packets followed by pixel data*/
+        if (byte_counter != TM_PACKET_BYTES ||
+            fee_CheckTelemetryChecksum(TM_Packet) != FEE_EXIT_SUCCESS ||
+            fee_TM_Read(TM_Packet, &TM_Data_Struct) != FEE_EXIT_SUCCESS ||
+            fee_Calculate_PTD_Sizes(TM_Data_Struct, &PTDSizes, &ImageSizes) != FEE_EXIT_SUCCESS ||
+            PTDSizes.DataPacketTotalBytes == 0)
+        {
+            continue;
+        }
+
+        Status |= fee_gen_frame_from_TM(Config, TM_Data_Struct, (uint32_t)NumFrames, &Frame);
+        Status |= fee_gen_fprint_packet(fPTD, Timestamp, Frame.PTD_Packet, Frame.PTD.PTDSizes.DataPacketTotalBytes, 1);
+        NumFrames++;
+    }
+
+    if (Status == FEE_EXIT_SUCCESS && NumFrames == 0)
+    {
+        fprintf(stderr, "No operational TM packets in %s\n", Options->TM_Input);
+        Status = FEE_EXIT_ERROR;
+    }
+    else if (Status == FEE_EXIT_SUCCESS)
+    {
+        printf("%lu PTD packets generated\n", NumFrames);
+    }
+
+    fee_gen_frame_free(&Frame);
+    fclose(fPTD);
+    fclose(fIn);
+
+    return Status;
+}
+
+int main(int argc, char *argv[])
+{
+    PtdgenOptions_t Options = {NULL, NULL, NULL, NULL, 1};
+    fee_gen_config_t Config;
+    unsigned long Band, Binning, Size;
+    int i;
+
+    fee_gen_config_default(&Config);
+
+    for (i = 1; i < argc; i++)
+    {
+        const char *Value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--max") == 0)
+        {
+            fee_gen_config_maximum(&Config);
+            continue;
+        }
+        if (Value == NULL)
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        i++;
+
+        if (strcmp(argv[i - 1], "--tc-out") == 0)
+        {
+            Options.TC_File = Value;
+        }
+        else if (strcmp(argv[i - 1], "--tm-out") == 0)
+        {
+            Options.TM_File = Value;
+        }
+        else if (strcmp(argv[i - 1], "--ptd-out") == 0)
+        {
+            Options.PTD_File = Value;
+        }
+        else if (strcmp(argv[i - 1], "--tm-input") == 0)
+        {
+            Options.TM_Input = Value;
+        }
+        else if (strcmp(argv[i - 1], "--frames") == 0)
+        {
+            Options.NumFrames = strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--woisize") == 0)
+        {
+            Config.WOISIZE = (uint16_t)strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--nbtail") == 0)
+        {
+            Config.NBTAIL = (uint16_t)strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--sbm") == 0)
+        {
+            Config.SPATIALBINNINGMODE = (spatialbinning_t)strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--band") == 0 &&
+                 sscanf(Value, "%lu:%lu:%lu", &Band, &Binning, &Size) == 3 &&
+                 Band >= 1 && Band <= FEE_GEN_NUM_BANDS)
+        {
+            Config.BinningSize[Band - 1] = (uint16_t)Binning;
+            Config.BandSize[Band - 1] = (uint16_t)Size;
+        }
+        else if (strcmp(argv[i - 1], "--pattern") == 0 && ParsePattern(Value, &Config.Pattern) == FEE_EXIT_SUCCESS)
+        {
+            continue;
+        }
+        else if (strcmp(argv[i - 1], "--value") == 0)
+        {
+            Config.PatternValue = (uint16_t)strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--seed") == 0)
+        {
+            Config.Seed = (uint32_t)strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(argv[i - 1], "--counter") == 0)
+        {
+            Config.FirstCounter = (uint32_t)strtoul(Value, NULL, 10);
+        }
+        else
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (Options.TC_File == NULL && Options.TM_File == NULL && Options.PTD_File == NULL)
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (Options.TM_Input != NULL)
+    {
+        return GenerateFromCapture(&Config, &Options) == FEE_EXIT_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    return GenerateFrames(&Config, &Options) == FEE_EXIT_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}